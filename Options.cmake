@@ -20,6 +20,7 @@ endmacro()
 macro(cge_setup_options)
   option(cge_ENABLE_HARDENING "Enable hardening" OFF)
   option(cge_ENABLE_COVERAGE "Enable coverage reporting" OFF)
+  option(cge_ENABLE_PROFILER "Enable CGE_PROFILE_SCOPE zones and the flight recorder" ON)
   cmake_dependent_option(cge_ENABLE_GLOBAL_HARDENING
     "Attempt to push hardening options to built dependencies"
     OFF
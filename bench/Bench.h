@@ -0,0 +1,47 @@
+#pragma once
+
+/**
+ * @file bench/Bench.h
+ * timing helpers for the benchmark executables, which print their results and are not run by CTest
+ */
+
+#include "Core/TimeUtils.h"
+#include "Core/Type.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace cge::bench
+{
+
+/** @fn measure
+ *  @brief runs `func` `repetitions` times and returns the fastest run in nanoseconds. The minimum filters out
+ *  preemptions and frequency transitions, which only ever add time
+ */
+template<typename F> F64_t measure(U32_t repetitions, F &&func)
+{
+    U64_t best = ~0ULL;
+    for (U32_t i = 0; i != repetitions; ++i)
+    {
+        U64_t const start = hiResTimer();
+        func();
+        best = std::min(best, hiResTimer() - start);
+    }
+    return static_cast<F64_t>(hiResToNanoseconds(best));
+}
+
+/// @fn report prints a result line, `nanoseconds` being the time taken by `operations` operations
+inline void report(Char8_t const *name, F64_t nanoseconds, U64_t operations)
+{
+    printf("%-48s %12.3f ms %10.2f ns/op\n", name, nanoseconds * 1e-6, nanoseconds / static_cast<F64_t>(operations));
+}
+
+inline U64_t volatile g_sink = 0;
+
+/// @fn consume keeps the compiler from discarding the computation of a value, fold results into one if needed
+inline void consume(U64_t value)
+{ //
+    g_sink = value;
+}
+
+} // namespace cge::bench
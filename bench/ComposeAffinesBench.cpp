@@ -0,0 +1,65 @@
+#include "Bench.h"
+
+#include "Core/Random.h"
+#include "Core/Transform.h"
+
+#include <vector>
+
+using namespace cge;
+
+static U32_t constexpr childCount  = 4'096; ///< children of a node, all composed with the same parent
+static U32_t constexpr repetitions = 50;
+
+I32_t main()
+{
+    Xoshiro256_t rng;
+    rng.seed(21);
+    auto const randomAffine = [&rng]() {
+        Affine3x4_t result;
+        for (glm::vec4 &row : result.rows)
+        { //
+            row = glm::vec4(toUnitFloat(rng()), toUnitFloat(rng()), toUnitFloat(rng()), toUnitFloat(rng())) - .5f;
+        }
+        return result;
+    };
+
+    Affine3x4_t const        parent = randomAffine();
+    std::vector<Affine3x4_t> locals(childCount);
+    std::vector<glm::mat4>   localMatrices(childCount);
+    for (U32_t i = 0; i != childCount; ++i)
+    {
+        locals[i]        = randomAffine();
+        localMatrices[i] = locals[i].toMat4();
+    }
+    std::vector<Affine3x4_t> out(childCount);
+    std::vector<glm::mat4>   outMatrices(childCount);
+    F32_t                    sum = 0.f;
+
+    // the scene graph update before Affine3x4_t: full 4x4 products
+    glm::mat4 const parentMatrix = parent.toMat4();
+    F64_t const     mat4Time     = bench::measure(repetitions, [&]() {
+        for (U32_t i = 0; i != childCount; ++i)
+        { //
+            outMatrices[i] = parentMatrix * localMatrices[i];
+        }
+    });
+    sum += outMatrices[childCount - 1][3][0];
+    bench::report("glm::mat4 product", mat4Time, childCount);
+
+    for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+    {
+        ComposeAffinesFunc_t const func = g_composeAffinesKernel.variant(static_cast<EIsa_t>(isa));
+        if (!func)
+        {
+            continue;
+        }
+        F64_t const time = bench::measure(repetitions, [&]() { func(parent, locals, out); });
+        sum += out[childCount - 1].rows[0].w;
+        Char8_t label[64];
+        snprintf(label, sizeof(label), "composeAffines %s", isaName(static_cast<EIsa_t>(isa)));
+        bench::report(label, time, childCount);
+    }
+
+    bench::consume(static_cast<U64_t>(sum * 1e3f));
+    return 0;
+}
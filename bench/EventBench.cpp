@@ -0,0 +1,70 @@
+#include "Bench.h"
+
+#include "Core/Event.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace cge;
+
+static U32_t constexpr eventTypeCount = 1'000;
+static U32_t constexpr listenerCount  = 10'000; ///< spread evenly over the event types
+static U32_t constexpr eventsPerFrame = 100'000;
+static U32_t constexpr repetitions    = 10;
+
+static U64_t s_accumulator = 0;
+
+static void accumulate(EventArg_t event, EventArg_t listener)
+{ //
+    s_accumulator += event.idata.u64 ^ listener.idata.u64;
+}
+
+I32_t main()
+{
+    EventQueue_t queue;
+    queue.init();
+
+    std::vector<Event_t> events(eventTypeCount);
+    for (U32_t i = 0; i != eventTypeCount; ++i)
+    {
+        Char8_t name[32];
+        snprintf(name, sizeof(name), "BenchEvent%u", i);
+        events[i] = Event_t{ CGE_SID(name) };
+    }
+
+    std::vector<ListenerHandle_t> handles(listenerCount);
+    F64_t const addTime = bench::measure(1, [&]() {
+        for (U32_t i = 0; i != listenerCount; ++i)
+        {
+            EventArg_t data{};
+            data.idata.u64 = i;
+            handles[i]     = queue.addListener(events[i % eventTypeCount], accumulate, data);
+        }
+    });
+    bench::report("addListener, 10k listeners", addTime, listenerCount);
+
+    // each frame emits 100k events over all types, every event reaching 10 listeners
+    F64_t const frameTime = bench::measure(repetitions, [&]() {
+        for (U32_t i = 0; i != eventsPerFrame; ++i)
+        {
+            EventArg_t data{};
+            data.idata.u64 = i;
+            queue.emit(events[(i * 7) % eventTypeCount], data);
+        }
+        queue.dispatch();
+    });
+    bench::report("emit + dispatch, 100k events per frame", frameTime, eventsPerFrame);
+    bench::report("  per listener invocation", frameTime, U64_t(eventsPerFrame) * (listenerCount / eventTypeCount));
+
+    // removal in a scattered order, as gameplay objects die
+    F64_t const removeTime = bench::measure(1, [&]() {
+        for (U32_t i = 0; i != listenerCount; ++i)
+        {
+            queue.removeListener(handles[(i * 7919) % listenerCount]);
+        }
+    });
+    bench::report("removeListener, 10k listeners", removeTime, listenerCount);
+
+    bench::consume(s_accumulator);
+    return 0;
+}
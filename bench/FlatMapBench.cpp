@@ -0,0 +1,102 @@
+#include "Bench.h"
+
+#include "Core/Containers.h"
+
+#include <map>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+using namespace cge;
+
+static U32_t constexpr repetitions = 5;
+
+/** per container: insertion of every key, lookups of present and absent keys, erasure of half the keys, then a
+ *  mix of insertions, erasures and lookups at steady size, as in the scene maps while objects spawn and die
+ */
+template<typename M>
+static void run(Char8_t const *name, std::vector<Sid_t> const &keys, std::vector<Sid_t> const &missing)
+{
+    U64_t const count = keys.size();
+    Char8_t     label[96];
+    U64_t       acc = 0;
+
+    F64_t insertTime = 0;
+    F64_t hitTime    = 0;
+    F64_t missTime   = 0;
+    F64_t eraseTime  = 0;
+    F64_t mixTime    = 0;
+    for (U32_t rep = 0; rep != repetitions; ++rep)
+    {
+        M    map;
+        auto best = [rep](F64_t &result, F64_t time) { result = rep == 0 ? time : std::min(result, time); };
+        best(insertTime, bench::measure(1, [&]() {
+                 for (Sid_t key : keys)
+                 {
+                     map.try_emplace(key, key.id);
+                 }
+             }));
+        best(hitTime, bench::measure(1, [&]() {
+                 for (Sid_t key : keys)
+                 {
+                     acc += map.find(key)->second;
+                 }
+             }));
+        best(missTime, bench::measure(1, [&]() {
+                 for (Sid_t key : missing)
+                 {
+                     acc += map.find(key) == map.end();
+                 }
+             }));
+        best(eraseTime, bench::measure(1, [&]() {
+                 for (U64_t i = 0; i < count; i += 2)
+                 {
+                     map.erase(keys[i]);
+                 }
+             }));
+        best(mixTime, bench::measure(1, [&]() {
+                 for (U64_t i = 0; i < count; i += 2)
+                 {
+                     map.try_emplace(keys[i], i);
+                     map.erase(keys[i + 1 < count ? i + 1 : 0]);
+                     auto const it = map.find(keys[(i * 7) % count]);
+                     acc += it != map.end() ? it->second : 0;
+                 }
+             }));
+    }
+    bench::consume(acc);
+
+    snprintf(label, sizeof(label), "%-14s %7zu insert", name, count);
+    bench::report(label, insertTime, count);
+    snprintf(label, sizeof(label), "%-14s %7zu lookup hit", name, count);
+    bench::report(label, hitTime, count);
+    snprintf(label, sizeof(label), "%-14s %7zu lookup miss", name, count);
+    bench::report(label, missTime, count);
+    snprintf(label, sizeof(label), "%-14s %7zu erase", name, count);
+    bench::report(label, eraseTime, count / 2);
+    snprintf(label, sizeof(label), "%-14s %7zu insert/erase/find", name, count);
+    bench::report(label, mixTime, count / 2 * 3);
+}
+
+I32_t main()
+{
+    for (U64_t count : { 100ULL, 10'000ULL, 200'000ULL })
+    {
+        // sids are CRC64 of their strings, hence uniformly distributed like these
+        std::vector<Sid_t> keys(count);
+        std::vector<Sid_t> missing(count);
+        for (U64_t i = 0; i != count; ++i)
+        {
+            U64_t const other = i + count;
+            keys[i]           = makeSid(std::string_view(reinterpret_cast<Char8_t const *>(&i), sizeof(i)));
+            missing[i]        = makeSid(std::string_view(reinterpret_cast<Char8_t const *>(&other), sizeof(other)));
+        }
+
+        run<std::pmr::unordered_map<Sid_t, U64_t>>("unordered_map", keys, missing);
+        run<std::pmr::map<Sid_t, U64_t>>("map", keys, missing);
+        run<FlatMap<Sid_t, U64_t>>("FlatMap", keys, missing);
+        run<StableFlatMap<Sid_t, U64_t>>("StableFlatMap", keys, missing);
+        printf("\n");
+    }
+    return 0;
+}
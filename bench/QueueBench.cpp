@@ -0,0 +1,129 @@
+#include "Bench.h"
+
+#include "Core/Queue.h"
+
+#include <atomic>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace cge;
+
+static U64_t constexpr itemCount   = 4'000'000;
+static U32_t constexpr ringSize    = 1'024;
+static U32_t constexpr repetitions = 3;
+
+/// the handoff the ring queues replace, with the same bound
+class MutexQueue_t
+{
+  public:
+    explicit MutexQueue_t(U32_t capacity) : m_capacity(capacity)
+    {
+    }
+
+    B8_t tryPush(U64_t value)
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_queue.size() >= m_capacity)
+        {
+            return false;
+        }
+        m_queue.push(value);
+        return true;
+    }
+
+    B8_t tryPop(U64_t &out)
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_queue.empty())
+        {
+            return false;
+        }
+        out = m_queue.front();
+        m_queue.pop();
+        return true;
+    }
+
+  private:
+    std::mutex        m_mutex;
+    std::queue<U64_t> m_queue;
+    U64_t             m_capacity;
+};
+
+/// time for `producers` threads to hand `itemCount` items over to `consumers` threads
+template<typename Q> static F64_t run(U32_t producers, U32_t consumers)
+{
+    U64_t sum = 0;
+    F64_t const time = bench::measure(repetitions, [&]() {
+        Q                        queue(ringSize);
+        std::atomic<U64_t>       popped{ 0 };
+        std::atomic<U64_t>       total{ 0 };
+        std::vector<std::thread> threads;
+        U64_t const              perProducer = itemCount / producers;
+        for (U32_t p = 0; p != producers; ++p)
+        {
+            threads.emplace_back([&queue, perProducer]() {
+                for (U64_t i = 0; i != perProducer; ++i)
+                {
+                    while (!queue.tryPush(i))
+                    { //
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (U32_t c = 0; c != consumers; ++c)
+        {
+            threads.emplace_back([&queue, &popped, &total, expected = perProducer * producers]() {
+                U64_t local = 0;
+                while (popped.load(std::memory_order_relaxed) != expected)
+                {
+                    U64_t item;
+                    if (queue.tryPop(item))
+                    {
+                        local += item;
+                        popped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                total.fetch_add(local, std::memory_order_relaxed);
+            });
+        }
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        sum += total.load();
+    });
+    bench::consume(sum);
+    return time;
+}
+
+I32_t main()
+{
+    printf("%u hardware threads, %llu items per run, rings of %u\n", std::thread::hardware_concurrency(),
+           static_cast<unsigned long long>(itemCount), ringSize);
+
+    bench::report("SpscQueue 1/1", run<SpscQueue<U64_t>>(1, 1), itemCount);
+    bench::report("mutex std::queue 1/1", run<MutexQueue_t>(1, 1), itemCount);
+
+    struct Config_t
+    {
+        U32_t producers;
+        U32_t consumers;
+    };
+    for (Config_t const config : { Config_t{ 1, 1 }, Config_t{ 2, 2 }, Config_t{ 4, 4 }, Config_t{ 4, 1 },
+                                   Config_t{ 1, 4 } })
+    {
+        Char8_t label[64];
+        snprintf(label, sizeof(label), "MpmcQueue %u/%u", config.producers, config.consumers);
+        bench::report(label, run<MpmcQueue<U64_t>>(config.producers, config.consumers), itemCount);
+        snprintf(label, sizeof(label), "mutex std::queue %u/%u", config.producers, config.consumers);
+        bench::report(label, run<MutexQueue_t>(config.producers, config.consumers), itemCount);
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "Bench.h"
+
+#include "Core/Random.h"
+
+#include <random>
+#include <vector>
+
+using namespace cge;
+
+static U32_t constexpr wordCount   = 1 << 16;
+static U32_t constexpr repetitions = 50;
+
+I32_t main()
+{
+    std::vector<U64_t> out(wordCount);
+    U64_t              sum = 0;
+
+    std::mt19937_64 twister(21);
+    F64_t const     twisterTime = bench::measure(repetitions, [&]() {
+        for (U64_t &word : out)
+        { //
+            word = twister();
+        }
+    });
+    sum += out[wordCount - 1];
+    bench::report("std::mt19937_64", twisterTime, wordCount);
+
+    Xoshiro256_t generator;
+    generator.seed(21);
+    F64_t const xoshiroTime = bench::measure(repetitions, [&]() {
+        for (U64_t &word : out)
+        { //
+            word = generator();
+        }
+    });
+    sum += out[wordCount - 1];
+    bench::report("Xoshiro256_t", xoshiroTime, wordCount);
+
+    F64_t const jumpTime = bench::measure(repetitions, [&]() { generator.jump(); });
+    sum += generator.s[0];
+    bench::report("Xoshiro256_t::jump", jumpTime, 1);
+
+    std::vector<F32_t> unit(wordCount);
+    Random             random;
+    random.seed(21);
+    F64_t const floatTime = bench::measure(repetitions, [&]() {
+        for (F32_t &value : unit)
+        { //
+            value = random.next<F32_t>();
+        }
+    });
+    sum += static_cast<U64_t>(unit[wordCount - 1] * 1e6f);
+    bench::report("Random::next<F32_t>", floatTime, wordCount);
+
+    for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+    {
+        RandomFillFunc_t const func = g_randomFillKernel.variant(static_cast<EIsa_t>(isa));
+        if (!func)
+        {
+            continue;
+        }
+        RandomLanes_t lanes;
+        lanes.seed(21);
+        F64_t const time = bench::measure(repetitions, [&]() { func(lanes, out.data(), wordCount); });
+        sum += out[wordCount - 1];
+        Char8_t label[64];
+        snprintf(label, sizeof(label), "randomFill %s", isaName(static_cast<EIsa_t>(isa)));
+        bench::report(label, time, wordCount);
+    }
+
+    bench::consume(sum);
+    return 0;
+}
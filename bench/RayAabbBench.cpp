@@ -0,0 +1,75 @@
+#include "Bench.h"
+
+#include "Core/Random.h"
+#include "Core/Utility.h"
+
+#include <bit>
+#include <vector>
+
+using namespace cge;
+
+static U32_t constexpr boxCount    = 4'096; ///< a picking query against a mid sized scene
+static U32_t constexpr rayCount    = 256;
+static U32_t constexpr repetitions = 10;
+
+I32_t main()
+{
+    Xoshiro256_t rng;
+    rng.seed(18);
+    auto const uniform = [&rng](F32_t lo, F32_t hi) { return lo + (hi - lo) * toUnitFloat(rng()); };
+
+    std::vector<AABB>        boxes(boxCount);
+    std::vector<AABBBatch_t> batches(boxCount / aabbBatchWidth);
+    for (U32_t i = 0; i != boxCount; ++i)
+    {
+        glm::vec3 const center{ uniform(-50.f, 50.f), uniform(-50.f, 50.f), uniform(-50.f, 50.f) };
+        glm::vec3 const half{ uniform(.5f, 3.f), uniform(.5f, 3.f), uniform(.5f, 3.f) };
+        boxes[i] = AABB(center - half, center + half);
+        batches[i / aabbBatchWidth].set(i % aabbBatchWidth, boxes[i]);
+    }
+    std::vector<Ray> rays;
+    rays.reserve(rayCount);
+    for (U32_t i = 0; i != rayCount; ++i)
+    {
+        glm::vec3 const target{ uniform(-50.f, 50.f), uniform(-50.f, 50.f), uniform(-50.f, 50.f) };
+        glm::vec3 const orig{ uniform(-80.f, 80.f), uniform(-80.f, 80.f), -80.f };
+        rays.emplace_back(orig, target - orig);
+    }
+
+    U64_t hits = 0;
+    // the loop the batches replace: one call per box
+    F64_t const scalarTime = bench::measure(repetitions, [&]() {
+        for (Ray const &ray : rays)
+        {
+            for (AABB const &box : boxes)
+            {
+                hits += intersect(ray, box).isect;
+            }
+        }
+    });
+    bench::report("intersect(Ray, AABB), per box", scalarTime, U64_t(rayCount) * boxCount);
+
+    for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+    {
+        BatchIntersectFunc_t const func = g_intersectKernel.variant(static_cast<EIsa_t>(isa));
+        if (!func)
+        {
+            continue;
+        }
+        F64_t const time = bench::measure(repetitions, [&]() {
+            for (Ray const &ray : rays)
+            {
+                for (AABBBatch_t const &batch : batches)
+                {
+                    hits += std::popcount(func(ray, batch).mask);
+                }
+            }
+        });
+        Char8_t label[64];
+        snprintf(label, sizeof(label), "intersect(Ray, AABBBatch_t) %s, per box", isaName(static_cast<EIsa_t>(isa)));
+        bench::report(label, time, U64_t(rayCount) * boxCount);
+    }
+
+    bench::consume(hits);
+    return 0;
+}
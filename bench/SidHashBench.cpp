@@ -0,0 +1,57 @@
+#include "Bench.h"
+
+#include "Core/Cpu.h"
+#include "Core/StringUtils.h"
+
+#include <string>
+
+using namespace cge;
+
+static U32_t constexpr bytesPerRun = 1U << 22;
+static U32_t constexpr repetitions = 10;
+
+I32_t main()
+{
+    printCpuInfo();
+    for (U32_t length : { 8U, 16U, 32U, 64U, 256U, 4096U })
+    {
+        // texture paths and glyph names are tens of bytes, hence the short lengths
+        std::string str(length, 'x');
+        U32_t const count = bytesPerRun / length;
+        Char8_t     name[64];
+
+        F64_t const bytewise = bench::measure(repetitions, [&]() {
+            U64_t acc = 0;
+            for (U32_t i = 0; i != count; ++i)
+            {
+                str[0] = static_cast<Char8_t>(i);
+                acc ^= hashCRC64Bytewise(str);
+            }
+            bench::consume(acc);
+        });
+        snprintf(name, sizeof(name), "%4u bytes, bytewise", length);
+        bench::report(name, bytewise, count);
+
+        for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+        {
+            CRC64Func_t const func = g_crc64Kernel.variant(static_cast<EIsa_t>(isa));
+            if (!func)
+            {
+                continue;
+            }
+            F64_t const time = bench::measure(repetitions, [&]() {
+                U64_t acc = 0;
+                for (U32_t i = 0; i != count; ++i)
+                {
+                    str[0] = static_cast<Char8_t>(i);
+                    acc ^= func(reinterpret_cast<U8_t const *>(str.data()), length, INITIAL_CRC64);
+                }
+                bench::consume(acc);
+            });
+            snprintf(
+              name, sizeof(name), "%4u bytes, %s (%.1fx)", length, isaName(static_cast<EIsa_t>(isa)), bytewise / time);
+            bench::report(name, time, count);
+        }
+    }
+    return 0;
+}
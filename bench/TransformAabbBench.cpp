@@ -0,0 +1,136 @@
+#include "Bench.h"
+
+#include "Core/Random.h"
+#include "Core/Utility.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <limits>
+#include <vector>
+
+using namespace cge;
+
+static U32_t constexpr boxCount    = 65'536;
+static U32_t constexpr repetitions = 20;
+
+/// the former world space bounds: every corner through the full matrix
+static AABB eightCorners(AABB const &box, glm::mat4 const &model)
+{
+    glm::vec3 lo(std::numeric_limits<F32_t>::max());
+    glm::vec3 hi(std::numeric_limits<F32_t>::lowest());
+    for (U32_t c = 0; c != 8; ++c)
+    {
+        glm::vec4 const corner{ (c & 1) ? box.mm.max.x : box.mm.min.x,
+                                (c & 2) ? box.mm.max.y : box.mm.min.y,
+                                (c & 4) ? box.mm.max.z : box.mm.min.z,
+                                1.f };
+        glm::vec3 const p(model * corner);
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    return { lo, hi };
+}
+
+/// the former NDC bounds: every corner through the full model-view-projection, then divided by w
+static AABB eightCornersNDC(AABB const &box, glm::mat4 const &mvp)
+{
+    glm::vec3 lo(std::numeric_limits<F32_t>::max());
+    glm::vec3 hi(std::numeric_limits<F32_t>::lowest());
+    for (U32_t c = 0; c != 8; ++c)
+    {
+        glm::vec4 const corner{ (c & 1) ? box.mm.max.x : box.mm.min.x,
+                                (c & 2) ? box.mm.max.y : box.mm.min.y,
+                                (c & 4) ? box.mm.max.z : box.mm.min.z,
+                                1.f };
+        glm::vec4 const clip = mvp * corner;
+        lo                   = glm::min(lo, glm::vec3(clip) / clip.w);
+        hi                   = glm::max(hi, glm::vec3(clip) / clip.w);
+    }
+    return { lo, hi };
+}
+
+static F32_t checksum(std::vector<AABB> const &boxes)
+{
+    F32_t sum = 0.f;
+    for (AABB const &box : boxes)
+    { //
+        sum += box.mm.min.x + box.mm.max.z;
+    }
+    return sum;
+}
+
+I32_t main()
+{
+    Xoshiro256_t rng;
+    rng.seed(19);
+    auto const uniform  = [&rng](F32_t lo, F32_t hi) { return lo + (hi - lo) * toUnitFloat(rng()); };
+    auto const uniform3 = [&uniform](F32_t lo, F32_t hi) {
+        return glm::vec3(uniform(lo, hi), uniform(lo, hi), uniform(lo, hi));
+    };
+
+    // boxes and models of a scene in front of the camera, each with rotation, scale and translation
+    std::vector<AABB>      boxes(boxCount);
+    std::vector<glm::mat4> models(boxCount);
+    for (U32_t i = 0; i != boxCount; ++i)
+    {
+        glm::vec3 const center = uniform3(-2.f, 2.f);
+        glm::vec3 const half   = uniform3(.1f, 1.f);
+        glm::vec3 const axis   = glm::normalize(uniform3(.1f, 1.f));
+        glm::mat4 const moved  = glm::translate(glm::mat4(1.f), uniform3(-30.f, 30.f) + glm::vec3(0.f, 0.f, -60.f));
+        boxes[i]               = AABB(center - half, center + half);
+        models[i]              = glm::scale(glm::rotate(moved, uniform(-3.f, 3.f), axis), uniform3(.5f, 2.f));
+    }
+    std::vector<AABB> out(boxCount);
+    F64_t             sum = 0.0;
+
+    F64_t const cornersTime = bench::measure(repetitions, [&]() {
+        for (U32_t i = 0; i != boxCount; ++i)
+        { //
+            out[i] = eightCorners(boxes[i], models[i]);
+        }
+    });
+    sum += checksum(out);
+    bench::report("world space, 8 corners", cornersTime, boxCount);
+
+    F64_t const singleTime = bench::measure(repetitions, [&]() {
+        for (U32_t i = 0; i != boxCount; ++i)
+        { //
+            out[i] = transformAABB(boxes[i], models[i]);
+        }
+    });
+    sum += checksum(out);
+    bench::report("world space, transformAABB per box", singleTime, boxCount);
+
+    for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+    {
+        TransformAABBsFunc_t const func = g_transformAABBsKernel.variant(static_cast<EIsa_t>(isa));
+        if (!func)
+        {
+            continue;
+        }
+        F64_t const time = bench::measure(repetitions, [&]() { func(boxes, models, out); });
+        sum += checksum(out);
+        Char8_t label[64];
+        snprintf(label, sizeof(label), "world space, transformAABBs %s", isaName(static_cast<EIsa_t>(isa)));
+        bench::report(label, time, boxCount);
+    }
+
+    glm::mat4 const viewProjection = glm::perspective(glm::radians(60.f), 16.f / 9.f, .1f, 200.f)
+                                     * glm::lookAt(glm::vec3(0.f), glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f, 1.f, 0.f));
+    F64_t const cornersNDCTime = bench::measure(repetitions, [&]() {
+        for (U32_t i = 0; i != boxCount; ++i)
+        { //
+            out[i] = eightCornersNDC(boxes[i], viewProjection * models[i]);
+        }
+    });
+    sum += checksum(out);
+    bench::report("NDC, 8 corners", cornersNDCTime, boxCount);
+
+    F64_t const ndcTime =
+      bench::measure(repetitions, [&]() { transformAABBsToNDC(boxes, models, viewProjection, out); });
+    sum += checksum(out);
+    bench::report("NDC, transformAABBsToNDC", ndcTime, boxCount);
+
+    bench::consume(static_cast<U64_t>(sum));
+    return 0;
+}
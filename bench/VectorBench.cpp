@@ -0,0 +1,54 @@
+#include "Bench.h"
+
+#include "Core/Containers.h"
+
+#include <memory_resource>
+#include <vector>
+
+using namespace cge;
+
+static U32_t constexpr vectorCount = 1'000'000;
+static U32_t constexpr repetitions = 5;
+
+/// time to build, read and destroy `vectorCount` vectors of `length` elements, as short-lived lists handed to a job
+template<typename MakeVector> static F64_t run(U32_t length, MakeVector const &makeVector)
+{
+    U64_t       sum  = 0;
+    F64_t const time = bench::measure(repetitions, [&]() {
+        for (U32_t v = 0; v != vectorCount; ++v)
+        {
+            auto vector = makeVector();
+            for (U32_t i = 0; i != length; ++i)
+            {
+                vector.push_back(v + i);
+            }
+            for (U32_t i = 0; i != length; ++i)
+            {
+                sum += vector[i];
+            }
+        }
+    });
+    bench::consume(sum);
+    return time;
+}
+
+I32_t main()
+{
+    std::pmr::unsynchronized_pool_resource pool;
+    for (U32_t const length : { 4U, 16U, 64U })
+    {
+        Char8_t label[64];
+        if (length <= 16)
+        {
+            snprintf(label, sizeof(label), "FixedVector<16>     %2u elements", length);
+            bench::report(label, run(length, []() { return FixedVector<U32_t, 16>(); }), vectorCount);
+        }
+        snprintf(label, sizeof(label), "SmallVector<16>     %2u elements", length);
+        bench::report(label, run(length, [&pool]() { return SmallVector<U32_t, 16>(&pool); }), vectorCount);
+        snprintf(label, sizeof(label), "std::pmr::vector    %2u elements", length);
+        bench::report(label, run(length, [&pool]() { return std::pmr::vector<U32_t>(&pool); }), vectorCount);
+        snprintf(label, sizeof(label), "std::vector         %2u elements", length);
+        bench::report(label, run(length, []() { return std::vector<U32_t>(); }), vectorCount);
+    }
+    return 0;
+}
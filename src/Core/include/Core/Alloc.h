@@ -0,0 +1,336 @@
+#pragma once
+
+/**
+ * @ref core
+ * @file Core/Alloc.h
+ * engine memory arena, as described in docs/notes/Core/memory.md. A single reservation of
+ * `arenaReservationSize` bytes is made at startup and split in 4 slots, each exposed as a
+ * `std::pmr::memory_resource`
+ */
+
+#include "Core/Type.h"
+
+#include <atomic>
+#include <memory_resource>
+
+namespace cge
+{
+
+inline U64_t constexpr arenaReservationSize = 1ULL << 30; // 1 GB
+inline U64_t constexpr arenaSlotSize        = arenaReservationSize >> 2;
+
+inline U32_t constexpr slabClassCount   = 8;
+inline U64_t constexpr slabMinBlockSize = 16;
+inline U64_t constexpr slabMaxBlockSize = slabMinBlockSize << (slabClassCount - 1); // 2 KB
+inline U64_t constexpr slabSize         = 64ULL << 10;                              // 64 KB
+inline U32_t constexpr slabBatchSize    = 32; ///< blocks moved between a thread cache and the global free-list at once
+static_assert(slabSize / slabMaxBlockSize >= slabBatchSize);
+
+/// @enum slots in which the engine arena is split, in address order
+enum class EArenaSlot_t : U32_t
+{
+    ePersistent = 0, ///< engine resources living for the whole application (upstream of the memory pool)
+    eFrame0,         ///< transient data of even frames
+    eFrame1,         ///< transient data of odd frames
+    eLevel,          ///< long lived level resources (geometry, textures, ...)
+    eArenaSlotCount
+};
+
+/// @enum which kind of pages backs the arena reservation
+enum class EPageKind_t : U32_t
+{
+    eHuge1GB = 0,   ///< explicit 1 GB huge page (MAP_HUGETLB | MAP_HUGE_1GB)
+    eHuge2MB,       ///< explicit default sized huge pages (MAP_HUGETLB, MEM_LARGE_PAGES)
+    eTransparent,   ///< regular pages, advised for transparent huge pages
+    eRegular,       ///< regular pages
+    ePageKindCount
+};
+
+/// @struct usage statistics of a single arena slot, all values in bytes
+struct ArenaSlotStats_t
+{
+    U64_t capacity;
+    U64_t used;
+    U64_t highWater;
+    U64_t overflow; ///< bytes which didn't fit in the slot and were served by the upstream resource
+};
+
+/** @class StackAllocator
+ * @brief linear allocator over a fixed memory region. Allocation is a lock free pointer bump.
+ * Deallocation rewinds the top of the stack only if the block is the last one allocated, otherwise
+ * it is a no-op. Use `clear` or `rewind` to release memory in bulk. Blocks still live when the stack is
+ * cleared or rewound can't be told apart from newer ones at the same address, hence deallocation stops
+ * rewinding until every live block has been deallocated
+ * If the region is exhausted, requests are forwarded to the upstream resource (and accounted in
+ * `ArenaSlotStats_t::overflow`) so that containers never observe a null pointer
+ * @warning destructors are not invoked on `clear`, hence store only trivially destructible types
+ */
+class StackAllocator : public std::pmr::memory_resource
+{
+  public:
+    StackAllocator() = default;
+    StackAllocator(Byte_t *base, U64_t capacity, std::pmr::memory_resource *upstream);
+    StackAllocator(StackAllocator const &)            = delete;
+    StackAllocator &operator=(StackAllocator const &) = delete;
+
+    /** @fn init
+     *  @brief assigns the region managed by the allocator. Must be called before any allocation
+     */
+    void init(Byte_t *base, U64_t capacity, std::pmr::memory_resource *upstream);
+
+    /** @fn marker
+     *  @brief returns the current top of the stack, to be later passed to @ref rewind
+     */
+    [[nodiscard]] U64_t marker() const;
+
+    /** @fn rewind
+     *  @brief sets the top of the stack to a marker previously returned by @ref marker
+     */
+    void rewind(U64_t marker);
+
+    /** @fn clear
+     *  @brief releases all the memory allocated from the region
+     */
+    void clear();
+
+    /** @fn owns
+     *  @brief true if the given pointer lies inside the region managed by this allocator
+     */
+    [[nodiscard]] B8_t owns(void const *ptr) const;
+
+    [[nodiscard]] ArenaSlotStats_t stats() const;
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void  do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+    B8_t  do_is_equal(std::pmr::memory_resource const &other) const noexcept override;
+
+  private:
+    Byte_t                    *m_base     = nullptr;
+    U64_t                      m_capacity = 0;
+    std::pmr::memory_resource *m_upstream = nullptr;
+    std::atomic<U64_t>         m_top{ 0 }; ///< offset, live block count and stale flag, see Alloc.cpp
+    std::atomic<U64_t>         m_highWater{ 0 };
+    std::atomic<U64_t>         m_overflow{ 0 };
+};
+
+/** @class DoubleBufferedAllocator
+ * @brief two stack allocators used alternatively, one per frame parity. Data allocated in frame i
+ * stays valid during frame i + 1, after which the buffer is cleared and reused
+ */
+class DoubleBufferedAllocator : public std::pmr::memory_resource
+{
+  public:
+    DoubleBufferedAllocator() = default;
+    DoubleBufferedAllocator(DoubleBufferedAllocator const &)            = delete;
+    DoubleBufferedAllocator &operator=(DoubleBufferedAllocator const &) = delete;
+
+    /** @fn init
+     *  @brief assigns to each of the two stacks its region
+     */
+    void init(Byte_t *base0, Byte_t *base1, U64_t capacity, std::pmr::memory_resource *upstream);
+
+    /** @fn swapBuffers
+     *  @brief makes the other stack the current one. To be called once per frame
+     */
+    void swapBuffers();
+
+    /** @fn clearCurrentBuffer
+     *  @brief releases all memory of the current stack
+     */
+    void clearCurrentBuffer();
+
+    [[nodiscard]] U32_t                 currentBuffer() const;
+    [[nodiscard]] StackAllocator       &buffer(U32_t index);
+    [[nodiscard]] StackAllocator const &buffer(U32_t index) const;
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void  do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+    B8_t  do_is_equal(std::pmr::memory_resource const &other) const noexcept override;
+
+  private:
+    StackAllocator m_stacks[2];
+    U32_t          m_curStack = 0;
+};
+
+/** @class EngineArena_s
+ * @brief owner of the single memory reservation of the engine. The reservation is tried first with
+ * 1 GB huge pages, then with default sized huge pages, then with transparent huge pages
+ */
+class EngineArena_s
+{
+  public:
+    EngineArena_s();
+    EngineArena_s(EngineArena_s const &)            = delete;
+    EngineArena_s &operator=(EngineArena_s const &) = delete;
+
+    [[nodiscard]] StackAllocator          &persistent();
+    [[nodiscard]] DoubleBufferedAllocator &frame();
+    [[nodiscard]] StackAllocator          &level();
+
+    [[nodiscard]] EPageKind_t      pageKind() const;
+    [[nodiscard]] ArenaSlotStats_t stats(EArenaSlot_t slot) const;
+
+    /** @fn printStats
+     *  @brief prints on stdout usage and high-water mark of each slot
+     */
+    void printStats() const;
+
+  private:
+    Byte_t                 *m_base     = nullptr;
+    EPageKind_t             m_pageKind = EPageKind_t::eRegular;
+    StackAllocator          m_persistent;
+    DoubleBufferedAllocator m_frame;
+    StackAllocator          m_level;
+};
+
+/// @struct occupancy statistics of a single size class of the @ref SlabPool
+struct SlabClassStats_t
+{
+    U64_t blockSize;
+    U64_t slabCount;
+    U64_t capacity;   ///< number of blocks carved from the slabs
+    U64_t globalFree; ///< number of blocks sitting in the global free-list
+    U64_t used;       ///< number of blocks handed out to threads, including those cached thread locally
+};
+
+struct SlabThreadCache_s;
+
+/** @class SlabPool
+ * @brief thread safe pool allocator with power of two size classes from `slabMinBlockSize` to `slabMaxBlockSize`.
+ * Each thread owns a cache of free blocks per size class, hence allocation and deallocation are plain
+ * singly linked list operations in the common case. When a cache is empty it is refilled with a batch of
+ * `slabBatchSize` blocks popped from the lock free global free-list of the class, and when it grows
+ * beyond two batches one batch is pushed back. If the global free-list is empty, a new slab of `slabSize`
+ * bytes is carved from the upstream resource and split into blocks.
+ * Requests larger than `slabMaxBlockSize` (or more aligned) are forwarded to the large resource.
+ * Slabs are never returned to the upstream
+ */
+class SlabPool : public std::pmr::memory_resource
+{
+    friend struct SlabThreadCache_s;
+
+  public:
+    SlabPool(std::pmr::memory_resource *upstream, std::pmr::memory_resource *large);
+    SlabPool(SlabPool const &)            = delete;
+    SlabPool &operator=(SlabPool const &) = delete;
+
+    [[nodiscard]] SlabClassStats_t stats(U32_t sizeClass) const;
+
+    /// @fn largeCount allocations forwarded to the large resource and not yet deallocated
+    [[nodiscard]] U64_t largeCount() const;
+
+    /** @fn printStats
+     *  @brief prints on stdout the occupancy of each size class and the number of large allocations
+     */
+    void printStats() const;
+
+  private:
+    struct alignas(64) FreeList_t
+    {
+        std::atomic<U64_t> head{ 0 }; ///< pointer to the first block of the first batch, ABA tag in the upper 16 bits
+        std::atomic<U64_t> freeCount{ 0 };
+        std::atomic<U64_t> slabCount{ 0 };
+    };
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void  do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+    B8_t  do_is_equal(std::pmr::memory_resource const &other) const noexcept override;
+
+    Byte_t *refill(SlabThreadCache_s &cache, U32_t sizeClass);
+    void    pushBatch(U32_t sizeClass, Byte_t *first, U32_t count);
+    Byte_t *popBatch(U32_t sizeClass);
+
+  private:
+    std::pmr::memory_resource *m_upstream;
+    std::pmr::memory_resource *m_large;
+    FreeList_t                 m_freeLists[slabClassCount];
+    std::atomic<U64_t>         m_largeCount{ 0 };
+};
+
+/// @enum subsystems to which the allocations of the memory pool are attributed in debug builds
+enum class EMemoryTag_t : U32_t
+{
+    eGeneric = 0,
+    eEvents,
+    eScene,
+    eHandleTable,
+    eRenderer2D,
+    eTasks,
+    eTimeSlice,
+    eMemoryTagCount
+};
+
+#if defined(CGE_DEBUG)
+/// @struct allocation statistics of a single memory tag
+struct MemoryTagStats_t
+{
+    U64_t bytes;      ///< bytes currently allocated
+    U64_t peakBytes;  ///< maximum value reached by `bytes`
+    U64_t count;      ///< total number of allocations
+    U64_t liveCount;  ///< number of allocations not yet freed
+};
+
+/** @class TrackingResource
+ * @brief debug only wrapper of a memory resource, which accounts every request forwarded to its upstream
+ */
+class TrackingResource : public std::pmr::memory_resource
+{
+  public:
+    TrackingResource() = default;
+    TrackingResource(TrackingResource const &)            = delete;
+    TrackingResource &operator=(TrackingResource const &) = delete;
+
+    void init(Char8_t const *name, std::pmr::memory_resource *upstream);
+
+    [[nodiscard]] Char8_t const   *name() const;
+    [[nodiscard]] MemoryTagStats_t stats() const;
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void  do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+    B8_t  do_is_equal(std::pmr::memory_resource const &other) const noexcept override;
+
+  private:
+    Char8_t const             *m_name     = "";
+    std::pmr::memory_resource *m_upstream = nullptr;
+    std::atomic<U64_t>         m_bytes{ 0 };
+    std::atomic<U64_t>         m_peakBytes{ 0 };
+    std::atomic<U64_t>         m_count{ 0 };
+    std::atomic<U64_t>         m_liveCount{ 0 };
+};
+
+/** @fn dbg_allocGuardInit
+ *  @brief arms the allocation guard if the environment variable `CGE_ALLOC_GUARD` is set. Its value is the
+ *  number of warm-up frames (default 120) after which every global operator new invoked inside a tick is
+ *  recorded together with its call stack
+ */
+void dbg_allocGuardInit();
+void dbg_allocGuardBeginTick();
+void dbg_allocGuardEndTick();
+
+/** @fn dbg_allocGuardReport
+ *  @brief prints on stderr the distinct call stacks which allocated after the warm-up, with their counts
+ */
+void dbg_allocGuardReport();
+
+#define CGEDBG_ALLOC_GUARD_INIT() ::cge::dbg_allocGuardInit()
+#define CGEDBG_ALLOC_GUARD_BEGIN_TICK() ::cge::dbg_allocGuardBeginTick()
+#define CGEDBG_ALLOC_GUARD_END_TICK() ::cge::dbg_allocGuardEndTick()
+#define CGEDBG_ALLOC_GUARD_REPORT() ::cge::dbg_allocGuardReport()
+#else
+#define CGEDBG_ALLOC_GUARD_INIT() ((void)0)
+#define CGEDBG_ALLOC_GUARD_BEGIN_TICK() ((void)0)
+#define CGEDBG_ALLOC_GUARD_END_TICK() ((void)0)
+#define CGEDBG_ALLOC_GUARD_REPORT() ((void)0)
+#endif
+
+/** @fn getEngineArena
+ *  @brief returns the engine arena, reserving its memory on first call
+ *  (function static, to avoid the static initialization order fiasco)
+ */
+EngineArena_s &getEngineArena();
+
+} // namespace cge
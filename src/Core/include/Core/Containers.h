@@ -1,8 +1,23 @@
 #pragma once
 
+#include "Core/StringUtils.h"
 #include "Core/Type.h"
 
 #include <array>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace cge
 {
@@ -71,4 +86,1302 @@ template<typename T> class ArrayView
     T*        m_data;
     size_type m_size;
 };
+
+/** @class FixedVector
+ * @brief vector whose elements live inline, up to `N` of them, hence it never allocates and can be a member of
+ * trivially relocated structures or live on the stack of a job. Exceeding the capacity is asserted in debug.
+ * Allocator aware as the `std::pmr` containers: elements are built by uses-allocator construction with the memory
+ * resource of the vector, so that the strings of a `FixedVector<std::pmr::string, N>` allocate from it. Assignments
+ * keep the resource of the destination
+ */
+template<typename T, U32_t N> class FixedVector
+{
+    static_assert(N > 0);
+
+  public:
+    using value_type     = T;
+    using allocator_type = std::pmr::polymorphic_allocator<T>;
+    using iterator       = T *;
+    using const_iterator = T const *;
+
+    explicit FixedVector(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : m_resource(resource)
+    {
+    }
+    FixedVector(std::initializer_list<T> values, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : m_resource(resource)
+    {
+        for (T const &value : values)
+        {
+            push_back(value);
+        }
+    }
+    FixedVector(FixedVector const &other) : FixedVector(other, other.m_resource)
+    {
+    }
+    FixedVector(FixedVector const &other, std::pmr::memory_resource *resource) : m_resource(resource)
+    {
+        for (T const &value : other)
+        {
+            push_back(value);
+        }
+    }
+    FixedVector(FixedVector &&other) noexcept : m_resource(other.m_resource)
+    {
+        for (T &value : other)
+        {
+            push_back(std::move(value));
+        }
+        other.clear();
+    }
+    FixedVector &operator=(FixedVector const &other)
+    {
+        if (this != &other)
+        {
+            clear();
+            for (T const &value : other)
+            {
+                push_back(value);
+            }
+        }
+        return *this;
+    }
+    FixedVector &operator=(FixedVector &&other) noexcept
+    {
+        if (this != &other)
+        {
+            clear();
+            for (T &value : other)
+            {
+                push_back(std::move(value));
+            }
+            other.clear();
+        }
+        return *this;
+    }
+    ~FixedVector()
+    { //
+        clear();
+    }
+
+    [[nodiscard]] U32_t size() const
+    { //
+        return m_size;
+    }
+    [[nodiscard]] static constexpr U32_t capacity()
+    { //
+        return N;
+    }
+    [[nodiscard]] B8_t empty() const
+    { //
+        return m_size == 0;
+    }
+    [[nodiscard]] B8_t full() const
+    { //
+        return m_size == N;
+    }
+    [[nodiscard]] allocator_type get_allocator() const
+    { //
+        return allocator_type(m_resource);
+    }
+
+    T *data()
+    { //
+        return std::launder(reinterpret_cast<T *>(m_storage));
+    }
+    T const *data() const
+    { //
+        return std::launder(reinterpret_cast<T const *>(m_storage));
+    }
+    iterator begin()
+    { //
+        return data();
+    }
+    const_iterator begin() const
+    { //
+        return data();
+    }
+    iterator end()
+    { //
+        return data() + m_size;
+    }
+    const_iterator end() const
+    { //
+        return data() + m_size;
+    }
+
+    T &operator[](U32_t index)
+    {
+        assert(index < m_size);
+        return data()[index];
+    }
+    T const &operator[](U32_t index) const
+    {
+        assert(index < m_size);
+        return data()[index];
+    }
+    T &front()
+    { //
+        return (*this)[0];
+    }
+    T &back()
+    { //
+        return (*this)[m_size - 1];
+    }
+
+    template<typename... Args> T &emplace_back(Args &&...args)
+    {
+        assert(m_size < N && "[FixedVector] capacity exceeded");
+        T *const element = std::uninitialized_construct_using_allocator(
+          reinterpret_cast<T *>(m_storage) + m_size, get_allocator(), std::forward<Args>(args)...);
+        ++m_size;
+        return *element;
+    }
+    void push_back(T const &value)
+    { //
+        emplace_back(value);
+    }
+    void push_back(T &&value)
+    { //
+        emplace_back(std::move(value));
+    }
+    void pop_back()
+    {
+        assert(m_size > 0);
+        data()[--m_size].~T();
+    }
+
+    /** @fn erase
+     *  @brief removes an element, shifting the following ones. Returns the iterator to the next one
+     */
+    iterator erase(const_iterator pos)
+    {
+        T *const element = data() + (pos - data());
+        std::move(element + 1, end(), element);
+        pop_back();
+        return element;
+    }
+
+    /** @fn resize
+     *  @brief destroys the elements past `count`, or value initializes the missing ones
+     */
+    void resize(U32_t count)
+    {
+        while (m_size > count)
+        {
+            pop_back();
+        }
+        while (m_size < count)
+        {
+            emplace_back();
+        }
+    }
+    void clear()
+    {
+        std::destroy_n(data(), m_size);
+        m_size = 0;
+    }
+
+  private:
+    std::pmr::memory_resource *m_resource;
+    U32_t                      m_size = 0;
+    alignas(T) Byte_t m_storage[N * sizeof(T)];
+};
+
+/** @class SmallVector
+ * @brief vector whose first `N` elements live inline, as the common case of a short list (children of a node,
+ * materials of a mesh) shouldn't allocate. Past them, the elements move to a block from the memory resource, and
+ * stay there even when the vector shrinks. As @ref FixedVector, elements are built by uses-allocator construction
+ * with the same resource. As for @ref FlatMap, copies are explicit (@ref assign, or the copy constructor taking the
+ * resource) so that they can't allocate by accident
+ */
+template<typename T, U32_t N> class SmallVector
+{
+    static_assert(N > 0);
+
+  public:
+    using value_type     = T;
+    using allocator_type = std::pmr::polymorphic_allocator<T>;
+    using iterator       = T *;
+    using const_iterator = T const *;
+
+    explicit SmallVector(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : m_data(reinterpret_cast<T *>(m_inline)), m_resource(resource)
+    {
+    }
+    SmallVector(SmallVector const &other, std::pmr::memory_resource *resource) : SmallVector(resource)
+    { //
+        assign(other.begin(), other.end());
+    }
+    SmallVector(SmallVector const &)            = delete;
+    SmallVector &operator=(SmallVector const &) = delete;
+    SmallVector(SmallVector &&other) noexcept;
+    SmallVector &operator=(SmallVector &&other) noexcept;
+    ~SmallVector();
+
+    [[nodiscard]] U32_t size() const
+    { //
+        return m_size;
+    }
+    [[nodiscard]] U32_t capacity() const
+    { //
+        return m_capacity;
+    }
+    [[nodiscard]] B8_t empty() const
+    { //
+        return m_size == 0;
+    }
+
+    /** @fn isInline
+     *  @brief true while the elements are still in the inline buffer
+     */
+    [[nodiscard]] B8_t isInline() const
+    { //
+        return m_data == reinterpret_cast<T const *>(m_inline);
+    }
+    [[nodiscard]] std::pmr::memory_resource *resource() const
+    { //
+        return m_resource;
+    }
+    [[nodiscard]] allocator_type get_allocator() const
+    { //
+        return allocator_type(m_resource);
+    }
+
+    T *data()
+    { //
+        return std::launder(m_data);
+    }
+    T const *data() const
+    { //
+        return std::launder(m_data);
+    }
+    iterator begin()
+    { //
+        return data();
+    }
+    const_iterator begin() const
+    { //
+        return data();
+    }
+    iterator end()
+    { //
+        return data() + m_size;
+    }
+    const_iterator end() const
+    { //
+        return data() + m_size;
+    }
+
+    T &operator[](U32_t index)
+    {
+        assert(index < m_size);
+        return data()[index];
+    }
+    T const &operator[](U32_t index) const
+    {
+        assert(index < m_size);
+        return data()[index];
+    }
+    T &front()
+    { //
+        return (*this)[0];
+    }
+    T &back()
+    { //
+        return (*this)[m_size - 1];
+    }
+
+    template<typename... Args> T &emplace_back(Args &&...args);
+    void push_back(T const &value)
+    { //
+        emplace_back(value);
+    }
+    void push_back(T &&value)
+    { //
+        emplace_back(std::move(value));
+    }
+    void pop_back()
+    {
+        assert(m_size > 0);
+        data()[--m_size].~T();
+    }
+
+    /** @fn erase
+     *  @brief removes an element, shifting the following ones. Returns the iterator to the next one
+     */
+    iterator erase(const_iterator pos)
+    {
+        T *const element = data() + (pos - data());
+        std::move(element + 1, end(), element);
+        pop_back();
+        return element;
+    }
+
+    /** @fn assign
+     *  @brief replaces the contents with a copy of the given range
+     */
+    template<std::input_iterator It> void assign(It first, It last);
+
+    void reserve(U32_t capacity);
+    void resize(U32_t count);
+    void clear()
+    {
+        std::destroy_n(data(), m_size);
+        m_size = 0;
+    }
+
+  private:
+    void moveFrom(SmallVector &other);
+    void release();
+
+  private:
+    T                         *m_data;
+    U32_t                      m_size     = 0;
+    U32_t                      m_capacity = N;
+    std::pmr::memory_resource *m_resource;
+    alignas(T) Byte_t m_inline[N * sizeof(T)];
+};
+
+template<typename T, U32_t N>
+SmallVector<T, N>::SmallVector(SmallVector &&other) noexcept
+  : m_data(reinterpret_cast<T *>(m_inline)), m_resource(other.m_resource)
+{
+    moveFrom(other);
+}
+
+template<typename T, U32_t N> SmallVector<T, N> &SmallVector<T, N>::operator=(SmallVector &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_resource == other.m_resource || other.isInline())
+        {
+            release();
+            moveFrom(other);
+        }
+        else
+        { // the block of the other vector can't be freed by our resource, move the elements one by one
+            clear();
+            reserve(other.m_size);
+            for (T &value : other)
+            {
+                emplace_back(std::move(value));
+            }
+            other.clear();
+        }
+    }
+    return *this;
+}
+
+template<typename T, U32_t N> SmallVector<T, N>::~SmallVector()
+{ //
+    release();
+}
+
+template<typename T, U32_t N> void SmallVector<T, N>::moveFrom(SmallVector &other)
+{
+    if (other.isInline())
+    { // rebuilt with our resource, which may differ
+        for (T &value : other)
+        {
+            std::uninitialized_construct_using_allocator(data() + m_size, get_allocator(), std::move(value));
+            ++m_size;
+        }
+        other.clear();
+    }
+    else
+    { // steal the block
+        m_data           = other.m_data;
+        m_size           = other.m_size;
+        m_capacity       = other.m_capacity;
+        other.m_data     = reinterpret_cast<T *>(other.m_inline);
+        other.m_size     = 0;
+        other.m_capacity = N;
+    }
+}
+
+template<typename T, U32_t N> void SmallVector<T, N>::release()
+{
+    clear();
+    if (!isInline())
+    {
+        m_resource->deallocate(m_data, m_capacity * sizeof(T), alignof(T));
+        m_data     = reinterpret_cast<T *>(m_inline);
+        m_capacity = N;
+    }
+}
+
+template<typename T, U32_t N> void SmallVector<T, N>::reserve(U32_t capacity)
+{
+    if (capacity <= m_capacity)
+    {
+        return;
+    }
+
+    T *const block = static_cast<T *>(m_resource->allocate(capacity * sizeof(T), alignof(T)));
+    std::uninitialized_move_n(data(), m_size, block);
+    std::destroy_n(data(), m_size);
+    if (!isInline())
+    {
+        m_resource->deallocate(m_data, m_capacity * sizeof(T), alignof(T));
+    }
+    m_data     = block;
+    m_capacity = capacity;
+}
+
+template<typename T, U32_t N> template<typename... Args> T &SmallVector<T, N>::emplace_back(Args &&...args)
+{
+    if (m_size == m_capacity)
+    { // the arguments may refer to an element, build the new one before moving them
+        T value = std::make_obj_using_allocator<T>(get_allocator(), std::forward<Args>(args)...);
+        reserve(m_capacity * 2);
+        T *const element =
+          std::uninitialized_construct_using_allocator(m_data + m_size, get_allocator(), std::move(value));
+        ++m_size;
+        return *element;
+    }
+    T *const element =
+      std::uninitialized_construct_using_allocator(m_data + m_size, get_allocator(), std::forward<Args>(args)...);
+    ++m_size;
+    return *element;
+}
+
+template<typename T, U32_t N> void SmallVector<T, N>::resize(U32_t count)
+{
+    reserve(count);
+    while (m_size > count)
+    {
+        pop_back();
+    }
+    while (m_size < count)
+    {
+        emplace_back();
+    }
+}
+
+template<typename T, U32_t N> template<std::input_iterator It> void SmallVector<T, N>::assign(It first, It last)
+{
+    clear();
+    if constexpr (std::forward_iterator<It>)
+    {
+        reserve(static_cast<U32_t>(std::distance(first, last)));
+    }
+    for (; first != last; ++first)
+    {
+        emplace_back(*first);
+    }
+}
+
+/// @struct hash used by @ref FlatMap. Sids are CRC64 of their string already, hence used as they are
+template<typename K> struct FlatHash;
+
+template<> struct FlatHash<Sid_t>
+{
+    U64_t operator()(Sid_t sid) const
+    { //
+        return sid.id;
+    }
+};
+
+/// integers are spread over the whole 64 bits, as the table takes the slot from the low bits and the tag from the high
+template<std::integral K> struct FlatHash<K>
+{
+    U64_t operator()(K key) const
+    {
+        U64_t const h = static_cast<U64_t>(key) * 0x9e37'79b9'7f4a'7c15ULL;
+        return h ^ (h >> 32);
+    }
+};
+
+/// @enum control byte of a @ref FlatMap slot. Full slots store the top 7 bits of the hash, hence are positive
+enum class EFlatCtrl_t : I8_t
+{
+    eEmpty   = -128,
+    eDeleted = -2,
+};
+
+inline U32_t constexpr flatGroupWidth = 16;
+
+/// @struct 16 control bytes, compared with a single SSE2 instruction
+struct FlatGroup_t
+{
+    explicit FlatGroup_t(I8_t const *ctrl) : m_ctrl(_mm_loadu_si128(reinterpret_cast<__m128i const *>(ctrl)))
+    {
+    }
+
+    /// bit i is set if the i-th byte equals tag
+    [[nodiscard]] U32_t match(I8_t tag) const
+    { //
+        return static_cast<U32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(m_ctrl, _mm_set1_epi8(tag))));
+    }
+
+    [[nodiscard]] U32_t matchEmpty() const
+    { //
+        return match(static_cast<I8_t>(EFlatCtrl_t::eEmpty));
+    }
+
+    /// empty or deleted, ie every negative value
+    [[nodiscard]] U32_t matchFree() const
+    { //
+        return static_cast<U32_t>(_mm_movemask_epi8(m_ctrl));
+    }
+
+    __m128i m_ctrl;
+};
+
+/** @class FlatMap
+ * @brief open addressing hash map in the style of Swiss tables: a control byte per slot holds 7 bits of the hash,
+ * and lookups compare 16 of them at once, touching the slots only on a tag match. Elements are stored inline,
+ * hence insertions may move them and invalidate iterators and references; erasing doesn't move the other ones.
+ * Use @ref StableFlatMap when addresses must survive insertions
+ */
+template<typename K, typename V, typename H = FlatHash<K>, typename Eq = std::equal_to<K>> class FlatMap
+{
+  public:
+    using key_type    = K;
+    using mapped_type = V;
+    using value_type  = std::pair<K const, V>;
+
+    template<B8_t isConst> class Iterator
+    {
+        friend class FlatMap;
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = FlatMap::value_type;
+        using reference         = std::conditional_t<isConst, value_type const &, value_type &>;
+        using pointer           = std::conditional_t<isConst, value_type const *, value_type *>;
+
+        Iterator() = default;
+        Iterator(Iterator<!isConst> const &other) requires isConst : m_map(other.m_map), m_index(other.m_index)
+        {
+        }
+
+        reference operator*() const
+        { //
+            return m_map->m_slots[m_index];
+        }
+        pointer operator->() const
+        { //
+            return &m_map->m_slots[m_index];
+        }
+        Iterator &operator++()
+        {
+            m_index = m_map->nextFull(m_index + 1);
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator it = *this;
+            ++*this;
+            return it;
+        }
+        B8_t operator==(Iterator const &other) const
+        { //
+            return m_index == other.m_index;
+        }
+
+      private:
+        using Map_t = std::conditional_t<isConst, FlatMap const, FlatMap>;
+
+        Iterator(Map_t *map, U64_t index) : m_map(map), m_index(index)
+        {
+        }
+
+        Map_t *m_map   = nullptr;
+        U64_t  m_index = 0;
+
+        friend class Iterator<!isConst>;
+    };
+
+    using iterator       = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+  public:
+    explicit FlatMap(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) : m_resource(resource)
+    {
+    }
+    FlatMap(FlatMap const &)            = delete;
+    FlatMap &operator=(FlatMap const &) = delete;
+    FlatMap(FlatMap &&other) noexcept;
+    FlatMap &operator=(FlatMap &&other) noexcept;
+    ~FlatMap();
+
+    [[nodiscard]] U64_t size() const
+    { //
+        return m_size;
+    }
+    [[nodiscard]] B8_t empty() const
+    { //
+        return m_size == 0;
+    }
+    [[nodiscard]] U64_t capacity() const
+    { //
+        return m_capacity;
+    }
+
+    iterator begin()
+    { //
+        return { this, nextFull(0) };
+    }
+    const_iterator begin() const
+    { //
+        return { this, nextFull(0) };
+    }
+    const_iterator cbegin() const
+    { //
+        return begin();
+    }
+    iterator end()
+    { //
+        return { this, m_capacity };
+    }
+    const_iterator end() const
+    { //
+        return { this, m_capacity };
+    }
+    const_iterator cend() const
+    { //
+        return end();
+    }
+
+    iterator       find(K const &key);
+    const_iterator find(K const &key) const;
+    [[nodiscard]] B8_t contains(K const &key) const
+    { //
+        return find(key) != end();
+    }
+
+    /// the key must be present
+    V       &at(K const &key);
+    V const &at(K const &key) const;
+    V       &operator[](K const &key)
+    { //
+        return try_emplace(key).first->second;
+    }
+
+    /** @fn try_emplace
+     *  @brief constructs the value from args if the key is not present. Returns the element with the key and
+     *  whether it was inserted
+     */
+    template<typename... Args> std::pair<iterator, B8_t> try_emplace(K const &key, Args &&...args);
+
+    U64_t    erase(K const &key);
+    iterator erase(const_iterator it);
+    void     clear();
+
+    /** @fn reserve
+     *  @brief makes room for count elements without further rehashes
+     */
+    void reserve(U64_t count);
+
+  private:
+    static I8_t tag(U64_t hash)
+    { //
+        return static_cast<I8_t>(hash >> 57);
+    }
+
+    U64_t nextFull(U64_t index) const;
+    U64_t findIndex(K const &key) const;
+    U64_t findFree(U64_t hash) const;
+    void  setCtrl(U64_t index, I8_t value);
+    void  rehash(U64_t capacity);
+    void  release();
+
+  private:
+    std::pmr::memory_resource *m_resource;
+    I8_t                      *m_ctrl       = nullptr; ///< capacity + group width bytes, the first group is cloned at the end
+    value_type                *m_slots      = nullptr;
+    U64_t                      m_capacity   = 0;       ///< 0 or a power of two not smaller than a group
+    U64_t                      m_size       = 0;
+    U64_t                      m_growthLeft = 0;       ///< insertions in empty slots before the next rehash
+};
+
+template<typename K, typename V, typename H, typename Eq>
+FlatMap<K, V, H, Eq>::FlatMap(FlatMap &&other) noexcept
+  : m_resource(other.m_resource)
+  , m_ctrl(std::exchange(other.m_ctrl, nullptr))
+  , m_slots(std::exchange(other.m_slots, nullptr))
+  , m_capacity(std::exchange(other.m_capacity, 0))
+  , m_size(std::exchange(other.m_size, 0))
+  , m_growthLeft(std::exchange(other.m_growthLeft, 0))
+{
+}
+
+template<typename K, typename V, typename H, typename Eq>
+FlatMap<K, V, H, Eq> &FlatMap<K, V, H, Eq>::operator=(FlatMap &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        m_resource   = other.m_resource;
+        m_ctrl       = std::exchange(other.m_ctrl, nullptr);
+        m_slots      = std::exchange(other.m_slots, nullptr);
+        m_capacity   = std::exchange(other.m_capacity, 0);
+        m_size       = std::exchange(other.m_size, 0);
+        m_growthLeft = std::exchange(other.m_growthLeft, 0);
+    }
+    return *this;
+}
+
+template<typename K, typename V, typename H, typename Eq>
+FlatMap<K, V, H, Eq>::~FlatMap()
+{ //
+    release();
+}
+
+template<typename K, typename V, typename H, typename Eq>
+U64_t FlatMap<K, V, H, Eq>::nextFull(U64_t index) const
+{
+    while (index < m_capacity && m_ctrl[index] < 0)
+    {
+        ++index;
+    }
+    return index < m_capacity ? index : m_capacity;
+}
+
+template<typename K, typename V, typename H, typename Eq>
+U64_t FlatMap<K, V, H, Eq>::findIndex(K const &key) const
+{
+    if (m_capacity == 0)
+    {
+        return m_capacity;
+    }
+
+    // triangular probing over groups, which visits every group when the capacity is a power of two
+    U64_t const hash = H{}(key);
+    U64_t const mask = m_capacity - 1;
+    U64_t       pos  = hash & mask;
+    for (U64_t step = flatGroupWidth;; pos = (pos + step) & mask, step += flatGroupWidth)
+    {
+        FlatGroup_t const group(m_ctrl + pos);
+        for (U32_t match = group.match(tag(hash)); match; match &= match - 1)
+        {
+            U64_t const index = (pos + std::countr_zero(match)) & mask;
+            if (Eq{}(m_slots[index].first, key))
+            {
+                return index;
+            }
+        }
+        if (group.matchEmpty())
+        {
+            return m_capacity;
+        }
+    }
+}
+
+template<typename K, typename V, typename H, typename Eq>
+U64_t FlatMap<K, V, H, Eq>::findFree(U64_t hash) const
+{
+    U64_t const mask = m_capacity - 1;
+    U64_t       pos  = hash & mask;
+    for (U64_t step = flatGroupWidth;; pos = (pos + step) & mask, step += flatGroupWidth)
+    {
+        if (U32_t const free = FlatGroup_t(m_ctrl + pos).matchFree(); free)
+        {
+            return (pos + std::countr_zero(free)) & mask;
+        }
+    }
+}
+
+template<typename K, typename V, typename H, typename Eq>
+void FlatMap<K, V, H, Eq>::setCtrl(U64_t index, I8_t value)
+{
+    m_ctrl[index] = value;
+    if (index < flatGroupWidth)
+    {
+        m_ctrl[m_capacity + index] = value;
+    }
+}
+
+template<typename K, typename V, typename H, typename Eq>
+typename FlatMap<K, V, H, Eq>::iterator FlatMap<K, V, H, Eq>::find(K const &key)
+{ //
+    return { this, findIndex(key) };
+}
+
+template<typename K, typename V, typename H, typename Eq>
+typename FlatMap<K, V, H, Eq>::const_iterator FlatMap<K, V, H, Eq>::find(K const &key) const
+{ //
+    return { this, findIndex(key) };
+}
+
+template<typename K, typename V, typename H, typename Eq>
+V &FlatMap<K, V, H, Eq>::at(K const &key)
+{
+    U64_t const index = findIndex(key);
+    assert(index != m_capacity && "[FlatMap] key not found");
+    return m_slots[index].second;
+}
+
+template<typename K, typename V, typename H, typename Eq>
+V const &FlatMap<K, V, H, Eq>::at(K const &key) const
+{
+    U64_t const index = findIndex(key);
+    assert(index != m_capacity && "[FlatMap] key not found");
+    return m_slots[index].second;
+}
+
+template<typename K, typename V, typename H, typename Eq>
+template<typename... Args>
+std::pair<typename FlatMap<K, V, H, Eq>::iterator, B8_t> FlatMap<K, V, H, Eq>::try_emplace(
+  K const &key,
+  Args &&...args)
+{
+    if (U64_t const index = findIndex(key); index != m_capacity)
+    {
+        return { iterator{ this, index }, false };
+    }
+
+    U64_t const hash  = H{}(key);
+    U64_t       index = m_capacity ? findFree(hash) : 0;
+    if (m_growthLeft == 0 && (m_capacity == 0 || m_ctrl[index] != static_cast<I8_t>(EFlatCtrl_t::eDeleted)))
+    {
+        // drop the tombstones if they are a good share of the table, grow otherwise
+        rehash(m_capacity == 0 ? flatGroupWidth : (m_size * 32 <= m_capacity * 25 ? m_capacity : m_capacity * 2));
+        index = findFree(hash);
+    }
+
+    if (m_ctrl[index] == static_cast<I8_t>(EFlatCtrl_t::eEmpty))
+    {
+        --m_growthLeft;
+    }
+    setCtrl(index, tag(hash));
+    new (&m_slots[index]) value_type(std::piecewise_construct,
+                                     std::forward_as_tuple(key),
+                                     std::forward_as_tuple(std::forward<Args>(args)...));
+    ++m_size;
+    return { iterator{ this, index }, true };
+}
+
+template<typename K, typename V, typename H, typename Eq>
+U64_t FlatMap<K, V, H, Eq>::erase(K const &key)
+{
+    U64_t const index = findIndex(key);
+    if (index == m_capacity)
+    {
+        return 0;
+    }
+    erase(const_iterator{ this, index });
+    return 1;
+}
+
+template<typename K, typename V, typename H, typename Eq>
+typename FlatMap<K, V, H, Eq>::iterator FlatMap<K, V, H, Eq>::erase(const_iterator it)
+{
+    U64_t const index = it.m_index;
+    U64_t const mask  = m_capacity - 1;
+    m_slots[index].~value_type();
+    --m_size;
+
+    // if no group containing the slot was ever full, no probe went past it and it can be empty again
+    U32_t const emptyAfter  = FlatGroup_t(m_ctrl + index).matchEmpty();
+    U32_t const emptyBefore = FlatGroup_t(m_ctrl + ((index - flatGroupWidth) & mask)).matchEmpty();
+    if (
+      emptyAfter && emptyBefore
+      && static_cast<U32_t>(std::countr_zero(emptyAfter) + std::countl_zero(static_cast<U16_t>(emptyBefore)))
+           < flatGroupWidth)
+    {
+        setCtrl(index, static_cast<I8_t>(EFlatCtrl_t::eEmpty));
+        ++m_growthLeft;
+    }
+    else
+    {
+        setCtrl(index, static_cast<I8_t>(EFlatCtrl_t::eDeleted));
+    }
+    return { this, nextFull(index + 1) };
+}
+
+template<typename K, typename V, typename H, typename Eq>
+void FlatMap<K, V, H, Eq>::clear()
+{
+    for (U64_t i = 0; i != m_capacity; ++i)
+    {
+        if (m_ctrl[i] >= 0)
+        {
+            m_slots[i].~value_type();
+        }
+    }
+    if (m_capacity)
+    {
+        std::memset(m_ctrl, static_cast<I8_t>(EFlatCtrl_t::eEmpty), m_capacity + flatGroupWidth);
+    }
+    m_size       = 0;
+    m_growthLeft = m_capacity - m_capacity / 8;
+}
+
+template<typename K, typename V, typename H, typename Eq>
+void FlatMap<K, V, H, Eq>::reserve(U64_t count)
+{
+    if (count <= m_size + m_growthLeft)
+    {
+        return;
+    }
+    // maximum load factor is 7/8
+    rehash(std::bit_ceil(std::max<U64_t>(flatGroupWidth, count + count / 7 + 1)));
+}
+
+template<typename K, typename V, typename H, typename Eq>
+void FlatMap<K, V, H, Eq>::rehash(U64_t capacity)
+{
+    I8_t *const       oldCtrl     = m_ctrl;
+    value_type *const oldSlots    = m_slots;
+    U64_t const       oldCapacity = m_capacity;
+
+    // a single block: control bytes first, slots after
+    U64_t const slotOffset = (capacity + flatGroupWidth + alignof(value_type) - 1) & ~(alignof(value_type) - 1);
+    auto *const block      = static_cast<Byte_t *>(m_resource->allocate(
+      slotOffset + capacity * sizeof(value_type), std::max<U64_t>(alignof(value_type), flatGroupWidth)));
+    m_ctrl                 = reinterpret_cast<I8_t *>(block);
+    m_slots                = reinterpret_cast<value_type *>(block + slotOffset);
+    m_capacity             = capacity;
+    m_growthLeft           = capacity - capacity / 8 - m_size;
+    std::memset(m_ctrl, static_cast<I8_t>(EFlatCtrl_t::eEmpty), capacity + flatGroupWidth);
+
+    for (U64_t i = 0; i != oldCapacity; ++i)
+    {
+        if (oldCtrl[i] >= 0)
+        {
+            U64_t const hash  = H{}(oldSlots[i].first);
+            U64_t const index = findFree(hash);
+            setCtrl(index, tag(hash));
+            new (&m_slots[index]) value_type(std::move(oldSlots[i]));
+            oldSlots[i].~value_type();
+        }
+    }
+
+    if (oldCapacity)
+    {
+        U64_t const oldSlotOffset =
+          (oldCapacity + flatGroupWidth + alignof(value_type) - 1) & ~(alignof(value_type) - 1);
+        m_resource->deallocate(oldCtrl,
+                               oldSlotOffset + oldCapacity * sizeof(value_type),
+                               std::max<U64_t>(alignof(value_type), flatGroupWidth));
+    }
+}
+
+template<typename K, typename V, typename H, typename Eq>
+void FlatMap<K, V, H, Eq>::release()
+{
+    if (m_capacity == 0)
+    {
+        return;
+    }
+    clear();
+    U64_t const slotOffset = (m_capacity + flatGroupWidth + alignof(value_type) - 1) & ~(alignof(value_type) - 1);
+    m_resource->deallocate(
+      m_ctrl, slotOffset + m_capacity * sizeof(value_type), std::max<U64_t>(alignof(value_type), flatGroupWidth));
+    m_ctrl       = nullptr;
+    m_slots      = nullptr;
+    m_capacity   = 0;
+    m_growthLeft = 0;
+}
+
+/** @fn erase_if
+ *  @brief erases the elements satisfying the predicate, returns how many
+ */
+template<typename K, typename V, typename H, typename Eq, typename Pred>
+U64_t erase_if(FlatMap<K, V, H, Eq> &map, Pred pred)
+{
+    U64_t const size = map.size();
+    for (auto it = map.begin(); it != map.end();)
+    {
+        if (pred(*it))
+        {
+            it = map.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return size - map.size();
+}
+
+inline U32_t constexpr stableFlatPageSize = 64; ///< elements per page, one bit each in the liveness mask
+
+/** @class StableFlatMap
+ * @brief elements live in pages which are never moved, hence pointers and references stay valid until the
+ * element is erased, and are indexed by a @ref FlatMap of slot indices. Iteration follows the slot order,
+ * which depends only on the sequence of insertions and erasures, not on hashes or capacity: erased slots are
+ * reused by the next insertions, most recent first
+ */
+template<typename K, typename V, typename H = FlatHash<K>, typename Eq = std::equal_to<K>> class StableFlatMap
+{
+  public:
+    using key_type    = K;
+    using mapped_type = V;
+    using value_type  = std::pair<K const, V>;
+
+    template<B8_t isConst> class Iterator
+    {
+        friend class StableFlatMap;
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = StableFlatMap::value_type;
+        using reference         = std::conditional_t<isConst, value_type const &, value_type &>;
+        using pointer           = std::conditional_t<isConst, value_type const *, value_type *>;
+
+        Iterator() = default;
+        Iterator(Iterator<!isConst> const &other) requires isConst : m_map(other.m_map), m_slot(other.m_slot)
+        {
+        }
+
+        reference operator*() const
+        { //
+            return m_map->slot(m_slot);
+        }
+        pointer operator->() const
+        { //
+            return &m_map->slot(m_slot);
+        }
+        Iterator &operator++()
+        {
+            m_slot = m_map->nextAlive(m_slot + 1);
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator it = *this;
+            ++*this;
+            return it;
+        }
+        B8_t operator==(Iterator const &other) const
+        { //
+            return m_slot == other.m_slot;
+        }
+
+      private:
+        using Map_t = std::conditional_t<isConst, StableFlatMap const, StableFlatMap>;
+
+        Iterator(Map_t *map, U32_t slot) : m_map(map), m_slot(slot)
+        {
+        }
+
+        Map_t *m_map  = nullptr;
+        U32_t  m_slot = 0;
+
+        friend class Iterator<!isConst>;
+    };
+
+    using iterator       = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+  public:
+    explicit StableFlatMap(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : m_index(resource), m_pages(resource), m_alive(resource), m_free(resource)
+    {
+    }
+    StableFlatMap(StableFlatMap const &)            = delete;
+    StableFlatMap &operator=(StableFlatMap const &) = delete;
+    ~StableFlatMap();
+
+    [[nodiscard]] U64_t size() const
+    { //
+        return m_index.size();
+    }
+    [[nodiscard]] B8_t empty() const
+    { //
+        return m_index.empty();
+    }
+
+    iterator begin()
+    { //
+        return { this, nextAlive(0) };
+    }
+    const_iterator begin() const
+    { //
+        return { this, nextAlive(0) };
+    }
+    const_iterator cbegin() const
+    { //
+        return begin();
+    }
+    iterator end()
+    { //
+        return { this, m_slotCount };
+    }
+    const_iterator end() const
+    { //
+        return { this, m_slotCount };
+    }
+    const_iterator cend() const
+    { //
+        return end();
+    }
+
+    iterator find(K const &key)
+    {
+        auto const it = m_index.find(key);
+        return { this, it != m_index.end() ? it->second : m_slotCount };
+    }
+    const_iterator find(K const &key) const
+    {
+        auto const it = m_index.find(key);
+        return { this, it != m_index.end() ? it->second : m_slotCount };
+    }
+    [[nodiscard]] B8_t contains(K const &key) const
+    { //
+        return m_index.contains(key);
+    }
+
+    /// the key must be present
+    V &at(K const &key)
+    { //
+        return slot(m_index.at(key)).second;
+    }
+    V const &at(K const &key) const
+    { //
+        return slot(m_index.at(key)).second;
+    }
+    V &operator[](K const &key)
+    { //
+        return try_emplace(key).first->second;
+    }
+
+    template<typename... Args> std::pair<iterator, B8_t> try_emplace(K const &key, Args &&...args);
+
+    U64_t    erase(K const &key);
+    iterator erase(const_iterator it);
+    void     clear();
+
+  private:
+    value_type &slot(U32_t index) const
+    { //
+        return m_pages[index / stableFlatPageSize][index % stableFlatPageSize];
+    }
+
+    U32_t nextAlive(U32_t index) const;
+
+  private:
+    FlatMap<K, U32_t, H, Eq>        m_index;
+    std::pmr::vector<value_type *>  m_pages;
+    std::pmr::vector<U64_t>         m_alive; ///< a bit per slot, a word per page
+    std::pmr::vector<U32_t>         m_free;
+    U32_t                           m_slotCount = 0; ///< slots ever used, ie one past the last one
+};
+
+template<typename K, typename V, typename H, typename Eq>
+StableFlatMap<K, V, H, Eq>::~StableFlatMap()
+{
+    clear();
+    std::pmr::memory_resource *resource = m_pages.get_allocator().resource();
+    for (value_type *page : m_pages)
+    {
+        resource->deallocate(page, stableFlatPageSize * sizeof(value_type), alignof(value_type));
+    }
+}
+
+template<typename K, typename V, typename H, typename Eq>
+U32_t StableFlatMap<K, V, H, Eq>::nextAlive(U32_t index) const
+{
+    while (index < m_slotCount)
+    {
+        U64_t const bits = m_alive[index / stableFlatPageSize] >> (index % stableFlatPageSize);
+        if (bits)
+        {
+            index += std::countr_zero(bits);
+            return index < m_slotCount ? index : m_slotCount;
+        }
+        index = (index / stableFlatPageSize + 1) * stableFlatPageSize;
+    }
+    return m_slotCount;
+}
+
+template<typename K, typename V, typename H, typename Eq>
+template<typename... Args>
+std::pair<typename StableFlatMap<K, V, H, Eq>::iterator, B8_t> StableFlatMap<K, V, H, Eq>::try_emplace(
+  K const &key,
+  Args &&...args)
+{
+    auto const [it, inserted] = m_index.try_emplace(key, 0);
+    if (!inserted)
+    {
+        return { iterator{ this, it->second }, false };
+    }
+
+    U32_t index;
+    if (!m_free.empty())
+    {
+        index = m_free.back();
+        m_free.pop_back();
+    }
+    else
+    {
+        index = m_slotCount++;
+        if (index / stableFlatPageSize == m_pages.size())
+        {
+            m_pages.push_back(static_cast<value_type *>(m_pages.get_allocator().resource()->allocate(
+              stableFlatPageSize * sizeof(value_type), alignof(value_type))));
+            m_alive.push_back(0);
+        }
+    }
+
+    it->second = index;
+    new (&slot(index)) value_type(std::piecewise_construct,
+                                  std::forward_as_tuple(key),
+                                  std::forward_as_tuple(std::forward<Args>(args)...));
+    m_alive[index / stableFlatPageSize] |= 1ULL << (index % stableFlatPageSize);
+    return { iterator{ this, index }, true };
+}
+
+template<typename K, typename V, typename H, typename Eq>
+U64_t StableFlatMap<K, V, H, Eq>::erase(K const &key)
+{
+    auto const it = m_index.find(key);
+    if (it == m_index.end())
+    {
+        return 0;
+    }
+    erase(const_iterator{ this, it->second });
+    return 1;
+}
+
+template<typename K, typename V, typename H, typename Eq>
+typename StableFlatMap<K, V, H, Eq>::iterator StableFlatMap<K, V, H, Eq>::erase(const_iterator it)
+{
+    U32_t const index = it.m_slot;
+    m_index.erase(slot(index).first);
+    slot(index).~value_type();
+    m_alive[index / stableFlatPageSize] &= ~(1ULL << (index % stableFlatPageSize));
+    m_free.push_back(index);
+    return { this, nextAlive(index + 1) };
+}
+
+template<typename K, typename V, typename H, typename Eq>
+void StableFlatMap<K, V, H, Eq>::clear()
+{
+    for (U32_t i = nextAlive(0); i != m_slotCount; i = nextAlive(i + 1))
+    {
+        slot(i).~value_type();
+    }
+    std::fill(m_alive.begin(), m_alive.end(), 0);
+    m_index.clear();
+    m_free.clear();
+    m_slotCount = 0;
+}
+
+/** @fn erase_if
+ *  @brief erases the elements satisfying the predicate, returns how many
+ */
+template<typename K, typename V, typename H, typename Eq, typename Pred>
+U64_t erase_if(StableFlatMap<K, V, H, Eq> &map, Pred pred)
+{
+    U64_t const size = map.size();
+    for (auto it = map.begin(); it != map.end();)
+    {
+        if (pred(*it))
+        {
+            it = map.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return size - map.size();
+}
 } // namespace cge
@@ -0,0 +1,164 @@
+#pragma once
+
+/**
+ * @ref core
+ * @file Core/Cpu.h
+ * CPU features detected once through CPUID, and dispatch of SIMD kernels. A kernel lists one implementation per
+ * instruction set level it has been written for, and is bound on first use to the best one the CPU (and the OS)
+ * supports, so that a single binary runs on any x86-64 CPU and still uses AVX2 or AVX-512 where available.
+ * `CGE_ISA=<scalar|sse2|sse4.2|avx2|avx512>` caps the level, to compare the variants in the whole program; tests
+ * and benchmarks can call any single variant supported by the CPU with @ref Kernel_s::variant
+ */
+
+#include "Core/Type.h"
+
+#include <atomic>
+#include <initializer_list>
+#include <type_traits>
+
+namespace cge
+{
+
+/// @enum instruction set extensions checked by the kernels. AVX ones are set only if the OS saves their registers
+enum class ECpuFeature_t : U32_t
+{
+    eSSE2 = 0,
+    eSSE3,
+    eSSSE3,
+    eSSE41,
+    eSSE42,
+    ePOPCNT,
+    ePCLMUL,
+    eAVX,
+    eFMA,
+    eAVX2,
+    eBMI2,
+    eAVX512F,
+    eAVX512DQ,
+    eAVX512BW,
+    eAVX512VL,
+    eCpuFeatureCount
+};
+
+/** @enum EIsa_t
+ *  @brief levels kernels are written for, each implying the previous ones. eSSE42 also requires SSSE3, POPCNT and
+ *  PCLMULQDQ (Westmere and later), eAVX2 AVX, FMA and BMI2 (Haswell and later), eAVX512 the F, DQ, BW and VL
+ *  subsets (Skylake-X and later). eScalar is plain C++, the reference the other variants are tested against
+ */
+enum class EIsa_t : U32_t
+{
+    eScalar = 0,
+    eSSE2,
+    eSSE42,
+    eAVX2,
+    eAVX512,
+    eIsaCount
+};
+
+struct CpuInfo_t
+{
+    U64_t   features; ///< a bit per ECpuFeature_t
+    EIsa_t  isa;      ///< highest level fully supported
+    Char8_t vendor[13];
+    Char8_t brand[49];
+};
+
+/** @fn cpuInfo
+ *  @brief detected on first call, which may happen during static initialization
+ */
+CpuInfo_t const &cpuInfo();
+
+B8_t cpuSupports(ECpuFeature_t feature);
+B8_t cpuSupports(EIsa_t isa);
+
+/** @fn dispatchIsa
+ *  @brief level the kernels are bound to: the one of the CPU, lowered by CGE_ISA if set
+ */
+EIsa_t dispatchIsa();
+
+Char8_t const *isaName(EIsa_t isa);
+
+/// @fn printCpuInfo vendor, brand and the level kernels dispatch to
+void printCpuInfo();
+
+template<typename Func> struct KernelVariant_t
+{
+    EIsa_t isa;
+    Func   func;
+};
+
+/** @class Kernel_s
+ * @brief function pointer table of a kernel, indexed by @ref EIsa_t. Meant to be a global initialized with
+ * `constinit`, so that it can be called during static initialization. The first call binds the best variant;
+ * binding concurrently from several threads is harmless, as they all store the same pointer
+ */
+template<typename Func>
+    requires std::is_pointer_v<Func> && std::is_function_v<std::remove_pointer_t<Func>>
+class Kernel_s
+{
+  public:
+    constexpr Kernel_s(Char8_t const *name, std::initializer_list<KernelVariant_t<Func>> variants) : m_name(name)
+    {
+        for (KernelVariant_t<Func> const &variant : variants)
+        { //
+            m_variants[static_cast<U32_t>(variant.isa)] = variant.func;
+        }
+    }
+    Kernel_s(Kernel_s const &)            = delete;
+    Kernel_s &operator=(Kernel_s const &) = delete;
+
+    /** @fn get
+     *  @brief best variant for @ref dispatchIsa
+     */
+    Func get() const
+    {
+        Func func = m_bound.load(std::memory_order_relaxed);
+        if (!func) [[unlikely]]
+        {
+            func = select(dispatchIsa());
+            m_bound.store(func, std::memory_order_relaxed);
+        }
+        return func;
+    }
+
+    template<typename... Args> decltype(auto) operator()(Args &&...args) const
+    { //
+        return get()(static_cast<Args &&>(args)...);
+    }
+
+    /** @fn variant
+     *  @brief the implementation for exactly the given level, nullptr if there is none or the CPU doesn't
+     *  support it
+     */
+    Func variant(EIsa_t isa) const
+    { //
+        return cpuSupports(isa) ? m_variants[static_cast<U32_t>(isa)] : nullptr;
+    }
+
+    /** @fn select
+     *  @brief the implementation for the highest level up to `maxIsa` which the CPU supports
+     */
+    Func select(EIsa_t maxIsa) const
+    {
+        for (U32_t isa = static_cast<U32_t>(maxIsa) + 1; isa-- != 0;)
+        {
+            if (Func func = variant(static_cast<EIsa_t>(isa)); func)
+            {
+                return func;
+            }
+        }
+        return nullptr;
+    }
+
+    Char8_t const *name() const
+    { //
+        return m_name;
+    }
+
+  private:
+    Char8_t const            *m_name;
+    Func                      m_variants[static_cast<U32_t>(EIsa_t::eIsaCount)]{};
+    mutable std::atomic<Func> m_bound{ nullptr };
+};
+
+} // namespace cge
@@ -5,8 +5,10 @@
 #include "Core/Type.h"
 #include "StringUtils.h"
 
-#include <queue>
+#include <atomic>
+#include <span>
 #include <unordered_map>
+#include <vector>
 
 namespace cge
 {
@@ -49,7 +51,17 @@ struct EventArg_t
     EventFloatArg_t fdata;
 };
 
-using EventFunc_t = void (*)(EventArg_t eventData, EventArg_t listenerData);
+using EventFunc_t      = void (*)(EventArg_t eventData, EventArg_t listenerData);
+using EventBatchFunc_t = void (*)(std::span<EventArg_t const> eventData, EventArg_t listenerData);
+
+/// @enum how events of the same type emitted between two dispatches are merged while queued
+enum class ECoalescePolicy_t : U32_t
+{
+    eKeepAll = 0, ///< every event is queued
+    eKeepLast,    ///< the payload of the queued event is overwritten by the newer one
+    eAccumulate,  ///< the payload of the newer event is summed, component wise, to the queued one (idata.i32, fdata.f32)
+    eCoalescePolicyCount
+};
 
 struct Event_t
 {
@@ -81,39 +93,216 @@ struct std::hash<cge::Event_t>
 namespace cge
 {
 
-struct EventDataSidPair
+/** @struct ListenerHandle_t
+ * @brief returned by @ref EventQueue_t::addListener. The generation is bumped whenever the slot is freed, so
+ * that a stale handle is recognized and ignored. Generation 0 is never used, hence a zeroed handle is null
+ */
+struct ListenerHandle_t
+{
+    U32_t slot;
+    U32_t generation;
+};
+
+inline ListenerHandle_t constexpr nullListenerHandle{ .slot = 0, .generation = 0 };
+
+/** @struct TimerHandle_t
+ * @brief returned by @ref EventQueue_t::emitAfter and @ref EventQueue_t::emitEvery, same scheme as @ref ListenerHandle_t
+ */
+struct TimerHandle_t
 {
-    Event_t ev;
-    Sid_t   dataSid;
+    U32_t slot;
+    U32_t generation;
 };
 
+inline TimerHandle_t constexpr nullTimerHandle{ .slot = 0, .generation = 0 };
+
+inline U32_t constexpr eventMaxProducers    = 64;   ///< threads other than the dispatching one which can emit
+inline U32_t constexpr eventStagingCapacity = 1024; ///< power of two, events staged per producer between dispatches
+
+struct EventStagingBuffer_t;
+
 class EventQueue_t
 {
   public:
+    EventQueue_t();
+    EventQueue_t(EventQueue_t const &)            = delete;
+    EventQueue_t &operator=(EventQueue_t const &) = delete;
+    ~EventQueue_t();
+
     EErr_t init();
 
+    /** @fn dispatch
+     *  @brief invokes, for each queued event in emission order, its listeners in registration order (modulo
+     *  removals), then the batch listeners. Events emitted during dispatch are handled in the same call.
+     *  Listeners added during dispatch don't receive the event being dispatched, listeners removed during
+     *  dispatch are not invoked anymore
+     */
     EErr_t dispatch();
 
-    EErr_t           emit(Event_t event, EventArg_t eventData);
-    EventDataSidPair addListener(Event_t event, EventFunc_t listener, EventArg_t listenerData);
-    void             removeListener(EventDataSidPair const &pair);
+    /** @fn emit
+     *  @brief queues an event. Can be called from any thread: the thread which called @ref init appends to the
+     *  queue directly, any other thread to a staging buffer of its own, merged in the queue at the beginning of
+     *  the next dispatch. Every event takes a ticket from a global counter, and the merge is ordered by ticket,
+     *  hence events emitted by the same thread are dispatched in emission order. If a staging buffer is full
+     *  the event is dropped, and accounted in @ref droppedEvents
+     */
+    EErr_t emit(Event_t event, EventArg_t eventData);
+
+    /** @fn droppedEvents
+     *  @brief number of events dropped because of full staging buffers, since the dispatch before the last one
+     */
+    [[nodiscard]] U32_t droppedEvents() const;
+
+    ListenerHandle_t addListener(Event_t event, EventFunc_t listener, EventArg_t listenerData);
+
+    /** @fn addBatchListener
+     *  @brief registers a listener invoked once per dispatch with the payloads of all the events of its type
+     *  handled in it, in emission order. Batch listeners are invoked after the queue has been drained, hence
+     *  after every per event listener. Removed with @ref removeListener
+     */
+    ListenerHandle_t addBatchListener(Event_t event, EventBatchFunc_t listener, EventArg_t listenerData);
+
+    /** @fn setCoalescePolicy
+     *  @brief sets how events of the given type are merged while waiting for dispatch. A coalesced event keeps
+     *  the position in the queue of the first one. Policies other than eKeepAll must not be used on events
+     *  carrying an owned `EventComplexArg_t`
+     */
+    void setCoalescePolicy(Event_t event, ECoalescePolicy_t policy);
+
+    /** @fn advanceTime
+     *  @brief advances the clock of the timers by `deltaTime` time units (1/timeUnit64 seconds), emitting the
+     *  events of the expired ones. Called once per frame before @ref dispatch, with the delta given to onTick
+     */
+    void advanceTime(U64_t deltaTime);
+
+    /** @fn emitAfter
+     *  @brief emits the event once, `delay` time units from now. Timers are main thread only
+     */
+    TimerHandle_t emitAfter(Event_t event, EventArg_t eventData, U64_t delay);
+
+    /** @fn emitEvery
+     *  @brief emits the event every `period` time units, starting `period` time units from now, until cancelled
+     */
+    TimerHandle_t emitEvery(Event_t event, EventArg_t eventData, U64_t period);
+
+    /** @fn cancelTimer
+     *  @brief O(1). Null, stale and already fired handles are ignored
+     */
+    void cancelTimer(TimerHandle_t handle);
+
+    /** @fn currentTime
+     *  @brief time units elapsed on the clock of the timers
+     */
+    [[nodiscard]] U64_t currentTime() const;
+
+    /** @fn removeListener
+     *  @brief O(1) removal, deferred to the end of the dispatch if called from a listener. Null or stale handles
+     *  are ignored
+     */
+    void removeListener(ListenerHandle_t handle);
 
   private:
-    struct DispatcherListenerPair
+    static U32_t constexpr invalidIndex = 0xffff'ffffU;
+
+    /// exactly one of func and batchFunc is set, both are cleared to disable the listener during dispatch
+    struct Listener_t
+    {
+        EventFunc_t      func;
+        EventBatchFunc_t batchFunc;
+        EventArg_t       data;
+        B8_t             batched;
+    };
+
+    /// listeners of a single event, stored densely. `slots[i]` is the slot of the handle of `listeners[i]`
+    struct ListenerList_t
     {
-        EventFunc_t listenerFunc;
-        EventArg_t  listenerData;
+        std::pmr::vector<Listener_t> listeners{ getMemoryPool(EMemoryTag_t::eEvents) };
+        std::pmr::vector<U32_t>      slots{ getMemoryPool(EMemoryTag_t::eEvents) };
+        std::pmr::vector<EventArg_t> batch{ getMemoryPool(EMemoryTag_t::eEvents) }; ///< payloads of this dispatch
+        U32_t                        batchListenerCount = 0;
+        ECoalescePolicy_t            policy             = ECoalescePolicy_t::eKeepAll;
+        U32_t                        pending            = invalidIndex; ///< position of the last queued event
     };
 
+    struct ListenerSlot_t
+    {
+        U32_t generation;
+        U32_t list;     ///< index in m_lists, or next free slot if the slot is free
+        U32_t position; ///< index in the list
+    };
+
+    struct QueuedEvent_t
+    {
+        U32_t      list;
+        U32_t      ticket;
+        EventArg_t data;
+    };
+
+    /// node of the doubly linked list of a wheel bucket, or of the free list (through next)
+    struct Timer_t
+    {
+        Event_t    event{};
+        EventArg_t data{};
+        U64_t      deadline   = 0;
+        U64_t      period     = 0; ///< 0 for one shot timers
+        U32_t      generation = 1;
+        U32_t      bucket     = invalidIndex;
+        U32_t      prev       = invalidIndex;
+        U32_t      next       = invalidIndex;
+    };
+
+    static U32_t constexpr timerWheelLevels = 4;
+    static U32_t constexpr timerWheelBits   = 8;
+    static U32_t constexpr timerWheelSlots  = 1U << timerWheelBits;
+
+  private:
+    U32_t                 listIndex(Event_t event);
+    ListenerHandle_t      insertListener(Event_t event, Listener_t const &listener);
+    void                  eraseListener(U32_t slotIndex);
+    void                  flushBatches();
+    TimerHandle_t         insertTimer(Event_t event, EventArg_t eventData, U64_t delay, U64_t period);
+    void                  linkTimer(U32_t timerIndex);
+    void                  unlinkTimer(U32_t timerIndex);
+    void                  freeTimer(U32_t timerIndex);
+    void                  growQueue();
+    void                  mergeStagedEvents();
+    EventStagingBuffer_t *stagingBuffer();
+
   private:
-    std::pmr::unordered_multimap<Event_t, DispatcherListenerPair> m_multimap{ getMemoryPool() };
+    std::pmr::unordered_map<Event_t, U32_t> m_listIndices{ getMemoryPool(EMemoryTag_t::eEvents) };
+    std::pmr::vector<ListenerList_t>        m_lists{ getMemoryPool(EMemoryTag_t::eEvents) };
+    std::pmr::vector<ListenerSlot_t>        m_slots{ getMemoryPool(EMemoryTag_t::eEvents) };
+    std::pmr::vector<U32_t>                 m_pendingRemovals{ getMemoryPool(EMemoryTag_t::eEvents) };
+    std::pmr::vector<U32_t>                 m_batchedLists{ getMemoryPool(EMemoryTag_t::eEvents) };
+    std::pmr::vector<EventArg_t>            m_batchScratch{ getMemoryPool(EMemoryTag_t::eEvents) };
+    U32_t                                   m_freeSlot    = invalidIndex;
+    B8_t                                    m_dispatching = false;
 
     /**
-     * Data structure containing emitted events to be handled on dispatch
+     * Ring buffer containing emitted events to be handled on dispatch. Its size is a power of two, and head and
+     * tail are free running counters, so that positions of queued events are stable until the next merge
      */
-    std::queue<std::pair<Event_t, EventArg_t>, std::pmr::deque<std::pair<Event_t, EventArg_t>>> m_queue{
-        getMemoryPool()
-    };
+    std::pmr::vector<QueuedEvent_t> m_queue{ getMemoryPool(EMemoryTag_t::eEvents) };
+    std::pmr::vector<QueuedEvent_t> m_mergeBuffer{ getMemoryPool(EMemoryTag_t::eEvents) };
+    U32_t                           m_head = 0;
+    U32_t                           m_tail = 0;
+
+    /**
+     * Hierarchical timing wheel: level l has 256 buckets of 256^l time units each. A timer due in less than
+     * 256^(l+1) units sits in level l, and is moved to a lower level when the clock reaches its bucket
+     */
+    std::pmr::vector<Timer_t> m_timers{ getMemoryPool(EMemoryTag_t::eEvents) };
+    U32_t                     m_wheel[timerWheelLevels * timerWheelSlots];
+    U32_t                     m_freeTimer = invalidIndex;
+    U64_t                     m_time      = 0;
+
+    /** staging buffers of the other threads, published by their producer on its first emission
+     */
+    std::atomic<EventStagingBuffer_t *> m_producers[eventMaxProducers]{};
+    std::atomic<U32_t>                  m_producerCount{ 0 };
+    std::atomic<U32_t>                  m_ticket{ 0 };
+    std::atomic<U32_t>                  m_droppedCount{ 0 };
+    U32_t                               m_lastDroppedCount = 0;
 };
 
 // TODO: when finish group all globals into singleton
@@ -0,0 +1,125 @@
+#pragma once
+
+/**
+ * @ref core
+ * @file Core/EventReplay.h
+ * recording of the input events of a session in a binary log, and their deterministic replay with a fixed time
+ * step, so that the same session can be profiled on every build. Selected through the environment:
+ * `CGE_RECORD=<file>` records, `CGE_REPLAY=<file>` replays and prints frame time statistics at the end
+ */
+
+#include "Core/Event.h"
+#include "Core/Type.h"
+
+#include <chrono>
+#include <cstdio>
+#include <initializer_list>
+#include <memory_resource>
+#include <vector>
+
+namespace cge
+{
+
+inline U32_t constexpr replayMagic         = 0x5245'4743U; // "CGER"
+inline U32_t constexpr replayVersion       = 1;
+inline U32_t constexpr replayMaxEventTypes = 16;
+
+/// @enum what @ref EventReplay_s is doing with the session
+enum class EReplayMode_t : U32_t
+{
+    eNone = 0,
+    eRecord,
+    eReplay,
+    eReplayModeCount
+};
+
+/// @struct header of the log. Followed by `recordCount` packed records of `replayRecordSize` bytes
+struct ReplayHeader_t
+{
+    U32_t magic;
+    U32_t version;
+    U32_t seed;     ///< for the random generators of the simulation
+    U32_t timeStep; ///< time units per frame during replay
+    U64_t frameCount;
+    U64_t recordCount;
+};
+static_assert(sizeof(ReplayHeader_t) == 32);
+
+/// frame index (U32), event sid (U64), idata (U64), fdata (4 x F32), without padding
+inline U32_t constexpr replayRecordSize = 36;
+
+/** @class EventReplay_s
+ * @brief the recorder listens to the given event types and appends, at each dispatch, the payloads it receives
+ * along with the index of the frame. The player emits them back right before the dispatch of the same frame.
+ * Payloads are copied bitwise, hence recorded events must not carry pointers (`EventComplexArg_t`)
+ */
+class EventReplay_s
+{
+  public:
+    EventReplay_s() = default;
+    EventReplay_s(EventReplay_s const &)            = delete;
+    EventReplay_s &operator=(EventReplay_s const &) = delete;
+    ~EventReplay_s();
+
+    /** @fn initFromEnvironment
+     *  @brief starts recording or replaying if CGE_RECORD or CGE_REPLAY are set. Must be called after
+     *  @ref EventQueue_t::init
+     */
+    EErr_t initFromEnvironment(std::initializer_list<Event_t> events);
+
+    EErr_t beginRecording(Char8_t const *path, std::initializer_list<Event_t> events);
+    EErr_t beginReplay(Char8_t const *path);
+
+    /** @fn injectFrame
+     *  @brief when replaying, emits the recorded events of the current frame. Called before the dispatch which
+     *  ends the frame
+     */
+    void injectFrame();
+
+    /** @fn endFrame
+     *  @brief advances the frame index. When replaying, returns false once the recorded frames are over
+     */
+    B8_t endFrame();
+
+    /** @fn shutdown
+     *  @brief flushes and closes the log. When replaying, prints the frame time statistics
+     */
+    void shutdown();
+
+    [[nodiscard]] EReplayMode_t mode() const;
+    [[nodiscard]] U32_t         seed() const;
+    [[nodiscard]] U32_t         timeStep() const;
+
+  private:
+    static void recordCallback(EventArg_t eventData, EventArg_t listenerData);
+
+    void record(Event_t event, EventArg_t const &eventData);
+    void flush();
+
+  private:
+    struct RecordedType_t
+    {
+        EventReplay_s   *self;
+        Event_t          event;
+        ListenerHandle_t listener;
+    };
+
+    std::FILE               *m_file = nullptr;
+    EReplayMode_t            m_mode = EReplayMode_t::eNone;
+    ReplayHeader_t           m_header{};
+    std::pmr::vector<Byte_t> m_buffer{ getMemoryPool(EMemoryTag_t::eEvents) }; ///< pending records, or the whole log
+    U64_t                    m_cursor = 0; ///< next record to replay
+    U32_t                    m_frame  = 0;
+    RecordedType_t           m_types[replayMaxEventTypes]{};
+    U32_t                    m_typeCount = 0;
+
+    // replay statistics, in nanoseconds
+    std::chrono::steady_clock::time_point m_frameStart{};
+    U64_t                                 m_totalTime = 0;
+    U64_t                                 m_minTime   = ~0ULL;
+    U64_t                                 m_maxTime   = 0;
+};
+
+extern EventReplay_s g_eventReplay;
+
+} // namespace cge
@@ -0,0 +1,138 @@
+#pragma once
+
+/**
+ * @ref core
+ * @file Core/FramePacing.h
+ * pacing of the main loop: the simulation advances in fixed steps of time units, consumed from an accumulator of
+ * measured time, while rendering happens once per frame and interpolates between the last two simulation states.
+ * A frame limiter caps the frame rate, and the frame times are collected in a histogram queried for percentiles
+ */
+
+#include "Core/TimeUtils.h"
+#include "Core/Type.h"
+
+namespace cge
+{
+
+inline U32_t constexpr fixedStepMaxSteps = 8; ///< steps simulated in a single frame, before dropping time
+
+/** @class FixedTimeStep_s
+ * @brief accumulates the elapsed time as `ticks * timeUnit64`, so that converting from time-stamp counter ticks to
+ * time units never truncates and the simulation time doesn't drift from the wall clock
+ */
+class FixedTimeStep_s
+{
+  public:
+    explicit FixedTimeStep_s(U32_t stepUnits = timeUnitsIn60FPS, U32_t maxSteps = fixedStepMaxSteps);
+
+    /** @fn advance
+     *  @brief adds the measured elapsed time and returns how many steps the simulation has to take this frame.
+     *  Past `maxSteps` the time left is dropped, so that a long stall (a breakpoint, a slow frame) doesn't trigger
+     *  an ever growing catch up
+     */
+    [[nodiscard]] U32_t advance(U64_t elapsedTicks);
+
+    /** @fn advanceUnits
+     *  @brief as @ref advance, with the elapsed time already in time units. Used by the replay
+     */
+    [[nodiscard]] U32_t advanceUnits(U64_t elapsedUnits);
+
+    /** @fn alpha
+     *  @brief fraction of a step accumulated but not simulated yet, in [0, 1). Rendering blends the previous state
+     *  with the current one by this factor
+     */
+    [[nodiscard]] F32_t alpha() const;
+
+    [[nodiscard]] U32_t step() const;
+
+  private:
+    U32_t consumeSteps();
+
+  private:
+    U64_t m_accumulator = 0; ///< ticks * time units
+    U64_t m_stepSize    = 0; ///< step, in ticks * time units
+    U32_t m_step;
+    U32_t m_maxSteps;
+};
+
+/** @class FrameLimiter_s
+ * @brief waits for the end of the frame period sleeping while the deadline is far, and spinning on the time-stamp
+ * counter for the last stretch. The stretch is the observed oversleep of the OS scheduler, estimated online as
+ * mean plus standard deviation
+ */
+class FrameLimiter_s
+{
+  public:
+    /** @fn setTargetFrameRate
+     *  @brief 0 disables the limiter
+     */
+    void setTargetFrameRate(U32_t framesPerSecond);
+
+    /** @fn initFromEnvironment
+     *  @brief sets the target from CGE_FPS_LIMIT if defined, otherwise to `defaultFramesPerSecond`
+     */
+    void initFromEnvironment(U32_t defaultFramesPerSecond);
+
+    /** @fn wait
+     *  @brief returns once a frame period has passed since `frameStart`, a @ref hiResTimer value. Returns the
+     *  time of the return, which is the start of the next frame
+     */
+    U64_t wait(U64_t frameStart);
+
+    [[nodiscard]] U32_t targetFrameRate() const;
+
+  private:
+    void updateSleepEstimate(F64_t observedNanoseconds);
+
+  private:
+    U64_t m_period          = 0; ///< ticks
+    U32_t m_framesPerSecond = 0;
+
+    // oversleep statistics of a 1 ms sleep, Welford's online variance, in nanoseconds
+    F64_t m_sleepEstimate = 2e6;
+    F64_t m_sleepMean     = 2e6;
+    F64_t m_sleepM2       = 0.;
+    U64_t m_sleepCount    = 1;
+};
+
+inline U32_t constexpr frameHistogramBucketWidth = 50'000;  ///< nanoseconds
+inline U32_t constexpr frameHistogramBuckets     = 2'000;   ///< up to 100 ms, slower frames fall in the last one
+
+/** @class FrameTimeHistogram_s
+ * @brief frame times bucketed with a fixed width, so that recording is a single increment and percentiles are a
+ * cumulative scan. Percentiles are exact up to the bucket width, which is plenty for frame times
+ */
+class FrameTimeHistogram_s
+{
+  public:
+    void record(U64_t nanoseconds);
+    void reset();
+
+    /** @fn percentile
+     *  @brief upper bound of the bucket holding the given percentile, in nanoseconds. `p` in [0, 1]. 0 if no
+     *  frame was recorded
+     */
+    [[nodiscard]] U64_t percentile(F32_t p) const;
+
+    [[nodiscard]] U64_t count() const;
+    [[nodiscard]] U64_t minimum() const;
+    [[nodiscard]] U64_t maximum() const;
+    [[nodiscard]] U64_t mean() const;
+
+    /** @fn print
+     *  @brief p50, p95, p99 and the extremes, in milliseconds
+     */
+    void print(Char8_t const *label) const;
+
+  private:
+    U32_t m_buckets[frameHistogramBuckets]{};
+    U64_t m_count   = 0;
+    U64_t m_total   = 0;
+    U64_t m_minimum = ~0ULL;
+    U64_t m_maximum = 0;
+};
+
+/// time between the starts of two consecutive frames of the main loop
+extern FrameTimeHistogram_s g_frameTimes;
+
+} // namespace cge
@@ -0,0 +1,149 @@
+#pragma once
+
+/**
+ * @ref core
+ * @file Core/FrameScheduler.h
+ * per frame graph of systems, as sketched in docs/notes/Core/event.md. Each system declares the data it reads
+ * and writes as sids; two systems conflict if one writes something the other reads or writes, in which case
+ * they run in registration order. Systems which don't conflict run in parallel on the @ref JobSystem
+ */
+
+#include "Core/Module.h"
+#include "Core/StringUtils.h"
+#include "Core/Type.h"
+
+#include <atomic>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cge
+{
+
+inline U32_t constexpr frameMaxSystems  = 64; ///< predecessors and successors are stored as 64 bit masks
+inline U32_t constexpr frameMaxAccesses = 8;
+
+/// @enum threads on which a system may run
+enum class ESystemAffinity_t : U32_t
+{
+    eAnyThread = 0,
+    eMainThread, ///< for systems issuing graphics API calls
+    eSystemAffinityCount
+};
+
+/// @struct timing of a system during the last executed frame, in nanoseconds from the start of the frame
+struct SystemTiming_t
+{
+    Sid_t name;
+    U64_t start;
+    U64_t end;
+    U32_t worker;
+};
+
+/** @class FrameScheduler_s
+ * @brief systems are registered every frame with @ref addSystem between @ref beginFrame and @ref run. Their
+ * callables are copied in the frame allocator, hence must be trivially destructible
+ */
+class FrameScheduler_s
+{
+  public:
+    FrameScheduler_s() = default;
+    FrameScheduler_s(FrameScheduler_s const &)            = delete;
+    FrameScheduler_s &operator=(FrameScheduler_s const &) = delete;
+
+    /** @fn beginFrame
+     *  @brief discards the systems of the previous frame
+     */
+    void beginFrame();
+
+    /** @fn addSystem
+     *  @brief registers a system for the current frame. Its dependencies on the systems registered before it
+     *  are derived from the read and write sets
+     */
+    template<typename F>
+    void addSystem(
+      Sid_t                        name,
+      std::initializer_list<Sid_t> reads,
+      std::initializer_list<Sid_t> writes,
+      F                          &&func,
+      ESystemAffinity_t            affinity = ESystemAffinity_t::eAnyThread);
+
+    /** @fn run
+     *  @brief executes the graph, returning when every system has completed. The calling thread must be the
+     *  main thread, which runs the main thread systems and helps with the others
+     */
+    void run();
+
+    /** @fn setPrintInterval
+     *  @brief every `frames` executed frames, per system timings and critical path are printed. 0 disables it
+     */
+    void setPrintInterval(U32_t frames);
+
+    /** @fn printTimings
+     *  @brief logs, at info level, start, duration and worker of each system of the last frame, followed by the
+     *  critical path, ie the chain of dependent systems with the longest total duration
+     */
+    void printTimings() const;
+
+    [[nodiscard]] U32_t          systemCount() const;
+    [[nodiscard]] SystemTiming_t timing(U32_t index) const;
+
+  private:
+    struct System_t
+    {
+        Sid_t             name;
+        Sid_t             reads[frameMaxAccesses];
+        Sid_t             writes[frameMaxAccesses];
+        U32_t             readCount;
+        U32_t             writeCount;
+        ESystemAffinity_t affinity;
+        U32_t             worker;
+        void (*invoke)(void *closure);
+        void *closure;
+        U64_t predecessors;
+        U64_t successors;
+        U64_t start; ///< @ref hiResTimer ticks from the start of the frame
+        U64_t end;
+    };
+
+  private:
+    void registerSystem(
+      Sid_t                        name,
+      std::initializer_list<Sid_t> reads,
+      std::initializer_list<Sid_t> writes,
+      void (*invoke)(void *closure),
+      void             *closure,
+      ESystemAffinity_t affinity);
+    void schedule(U32_t index);
+    void execute(U32_t index);
+
+  private:
+    System_t           m_systems[frameMaxSystems];
+    std::atomic<U32_t> m_pendingPredecessors[frameMaxSystems];
+    std::atomic<U64_t> m_mainThreadReady{ 0 }; ///< bitmask of ready main thread systems
+    std::atomic<U32_t> m_remaining{ 0 };
+    U32_t              m_systemCount   = 0;
+    U64_t              m_frameStart    = 0; ///< @ref hiResTimer value
+    U32_t              m_printInterval = 0;
+    U32_t              m_frameIndex    = 0;
+};
+
+template<typename F>
+void FrameScheduler_s::addSystem(
+  Sid_t                        name,
+  std::initializer_list<Sid_t> reads,
+  std::initializer_list<Sid_t> writes,
+  F                          &&func,
+  ESystemAffinity_t            affinity)
+{
+    using Func_t = std::decay_t<F>;
+    static_assert(std::is_trivially_destructible_v<Func_t>, "[FrameScheduler] captures must be trivially destructible");
+
+    void *closure = getScratchBuffer()->allocate(sizeof(Func_t), alignof(Func_t));
+    new (closure) Func_t(std::forward<F>(func));
+    registerSystem(
+      name, reads, writes, [](void *c) { (*std::launder(static_cast<Func_t *>(c)))(); }, closure, affinity);
+}
+
+} // namespace cge
@@ -0,0 +1,187 @@
+#pragma once
+
+/**
+ * @ref core
+ * @file Core/Job.h
+ * work stealing job system. Each worker thread (the main thread being worker 0) owns a Chase-Lev deque of
+ * jobs: the owner pushes and pops at the bottom, idle workers steal from the top of a random victim
+ */
+
+#include "Core/Type.h"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace cge
+{
+
+inline U32_t constexpr jobMaxWorkers    = 64;
+inline U32_t constexpr jobQueueCapacity = 4096; ///< power of two, jobs in flight per worker
+inline U64_t constexpr jobPayloadSize   = 40;
+inline U64_t constexpr jobPayloadAlign  = 16;
+inline U32_t constexpr jobInvalidWorker = 0xffff'ffffU;
+
+/// @struct options of @ref JobSystem::init
+struct JobSystemSpec_t
+{
+    U32_t workerCount = 0;     ///< number of threads besides the main one. 0 = hardware concurrency - 1
+    B8_t  pinToCores  = false; ///< pins worker i to logical core i (main thread to core 0)
+};
+
+/// @struct counter of unfinished jobs, incremented on submit and decremented when a job completes
+struct JobCounter_t
+{
+    std::atomic<U32_t> pending{ 0 };
+};
+
+/// @struct a unit of work. The callable is stored inline in the payload, which follows the pointers to be aligned
+struct alignas(64) Job_t
+{
+    void (*func)(Job_t &job);
+    JobCounter_t *counter;
+    alignas(jobPayloadAlign) Byte_t payload[jobPayloadSize];
+    std::atomic<B8_t>               live{ false }; ///< from submit until it has run, the record can't be reused
+};
+static_assert(sizeof(Job_t) == 64 && offsetof(Job_t, payload) % jobPayloadAlign == 0);
+
+struct JobWorker_t;
+
+/** @class JobSystem
+ * @brief pool of worker threads executing jobs. Jobs can be submitted only by the main thread and by the
+ * workers themselves, since each deque has a single owner; other threads get their submits rejected. A job
+ * submitted with a counter can be waited upon with @ref wait, during which the calling thread executes other jobs
+ * instead of blocking
+ */
+class JobSystem
+{
+  public:
+    JobSystem() = default;
+    JobSystem(JobSystem const &)            = delete;
+    JobSystem &operator=(JobSystem const &) = delete;
+
+    /** @fn init
+     *  @brief spawns the worker threads. Must be called by the main thread
+     */
+    void init(JobSystemSpec_t const &spec);
+
+    /** @fn shutdown
+     *  @brief waits for the workers to finish their current job and joins them. Pending jobs are discarded
+     */
+    void shutdown();
+
+    /** @fn submit
+     *  @brief schedules a callable on the queue of the calling thread. Its captures must be trivially copyable
+     *  and fit in `jobPayloadSize` bytes; anything larger should be captured by pointer. Returns false, leaving
+     *  the counter untouched, if the calling thread is not a worker, as it has no queue to push to
+     */
+    template<typename F>
+    B8_t submit(F &&func, JobCounter_t *counter = nullptr);
+
+    /** @fn parallelFor
+     *  @brief invokes `func(U32_t begin, U32_t end)` over subranges of [begin, end) of at most `grain` elements,
+     *  splitting the range recursively so that idle workers can steal its halves. Returns when the whole range
+     *  has been processed
+     */
+    template<typename F>
+    void parallelFor(U32_t begin, U32_t end, U32_t grain, F const &func);
+
+    /** @fn wait
+     *  @brief returns when the counter reaches zero, executing pending jobs in the meantime
+     */
+    void wait(JobCounter_t &counter);
+
+    /** @fn executeOne
+     *  @brief runs one pending job, taken from the queue of the calling thread or stolen. Returns false if
+     *  there was none. Useful to help while waiting on something which is not a counter
+     */
+    B8_t executeOne();
+
+    /** @fn workerCount
+     *  @brief number of threads executing jobs, main thread included
+     */
+    [[nodiscard]] U32_t workerCount() const;
+
+    /** @fn currentWorker
+     *  @brief index of the calling thread, 0 for the main thread, @ref jobInvalidWorker for threads which are
+     *  not workers
+     */
+    [[nodiscard]] static U32_t currentWorker();
+
+  private:
+    template<typename F>
+    void splitRange(U32_t begin, U32_t end, U32_t grain, F const &func, JobCounter_t *counter);
+
+    B8_t   acceptsSubmit() const;
+    Job_t *allocateJob();
+    void   push(Job_t *job);
+    Job_t *findJob(U32_t self);
+    void   execute(Job_t *job);
+    void   workerLoop(U32_t index);
+
+  private:
+    JobWorker_t       *m_workers     = nullptr;
+    std::thread       *m_threads     = nullptr;
+    U32_t              m_workerCount = 1;
+    std::atomic<B8_t>  m_running{ false };
+    std::atomic<U32_t> m_signal{ 0 };   ///< bumped on every submit, idle workers wait on it
+    std::atomic<U32_t> m_sleeping{ 0 };
+};
+
+template<typename F>
+B8_t JobSystem::submit(F &&func, JobCounter_t *counter)
+{
+    using Func_t = std::decay_t<F>;
+    static_assert(sizeof(Func_t) <= jobPayloadSize, "[JobSystem] job captures too large");
+    static_assert(alignof(Func_t) <= jobPayloadAlign, "[JobSystem] job captures overaligned");
+    static_assert(std::is_trivially_copyable_v<Func_t> && std::is_trivially_destructible_v<Func_t>,
+                  "[JobSystem] job captures must be trivially copyable");
+
+    if (!acceptsSubmit()) [[unlikely]]
+    {
+        return false;
+    }
+    Job_t *job = allocateJob();
+    new (job->payload) Func_t(std::forward<F>(func));
+    job->func    = [](Job_t &j) { (*std::launder(reinterpret_cast<Func_t *>(j.payload)))(); };
+    job->counter = counter;
+    if (counter)
+    {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    push(job);
+    return true;
+}
+
+template<typename F>
+void JobSystem::splitRange(U32_t begin, U32_t end, U32_t grain, F const &func, JobCounter_t *counter)
+{
+    // keep the lower half, give away the upper one
+    while (end - begin > grain)
+    {
+        U32_t const mid = begin + ((end - begin) >> 1);
+        submit([this, mid, end, grain, &func, counter]() { splitRange(mid, end, grain, func, counter); }, counter);
+        end = mid;
+    }
+    func(begin, end);
+}
+
+template<typename F>
+void JobSystem::parallelFor(U32_t begin, U32_t end, U32_t grain, F const &func)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    JobCounter_t counter;
+    splitRange(begin, end, grain ? grain : 1, func, &counter);
+    wait(counter);
+}
+
+extern JobSystem g_jobSystem;
+
+} // namespace cge
@@ -0,0 +1,295 @@
+#pragma once
+
+/**
+ * @ref core
+ * @file Core/Log.h
+ * asynchronous logger. A log call copies the format string pointer, a timestamp and its raw arguments into a
+ * fixed size record, and pushes it to a single producer queue owned by the calling thread. A writer thread drains
+ * the queues, formats the records in timestamp order and writes them, so the caller never takes the stdio lock nor
+ * waits on the terminal. When the queue of a thread is full the record is dropped and counted.
+ * Levels below `CGE_LOG_LEVEL` and categories outside the `CGE_LOG_CATEGORIES` mask compile to nothing
+ */
+
+#include "Core/MacroDefs.h"
+#include "Core/Queue.h"
+#include "Core/TimeUtils.h"
+#include "Core/Type.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+/// lowest level compiled in, see @ref ELogLevel_t. Debug builds keep everything, release ones from eInfo up
+#if !defined(CGE_LOG_LEVEL)
+#if defined(CGE_DEBUG)
+#define CGE_LOG_LEVEL 0
+#else
+#define CGE_LOG_LEVEL 2
+#endif
+#endif
+
+/// mask of the categories compiled in, a bit per @ref ELogCategory_t
+#if !defined(CGE_LOG_CATEGORIES)
+#define CGE_LOG_CATEGORIES 0xffff'ffffU
+#endif
+
+namespace cge
+{
+
+inline U32_t constexpr logMaxThreads     = 64;
+inline U32_t constexpr logThreadCapacity = 1024; ///< power of two, records in flight per thread
+inline U32_t constexpr logRecordSize     = 128;
+inline U32_t constexpr logMessageSize    = 512; ///< longer formatted messages are truncated
+
+enum class ELogLevel_t : U32_t
+{
+    eTrace = 0,
+    eDebug,
+    eInfo,
+    eWarning,
+    eError,
+    eLogLevelCount
+};
+
+enum class ELogCategory_t : U32_t
+{
+    eCore = 0,
+    eRender,
+    eResource,
+    eGame,
+    eLogCategoryCount
+};
+
+/// @fn logEnabled whether log calls with the given level and category are compiled in
+consteval B8_t logEnabled(ELogLevel_t level, ELogCategory_t category)
+{
+    return static_cast<U32_t>(level) >= CGE_LOG_LEVEL &&
+           ((CGE_LOG_CATEGORIES >> static_cast<U32_t>(category)) & 1U) != 0;
+}
+
+/// formats the arguments of a record, returns the number of characters written
+using LogDecodeFunc_t = U32_t (*)(Char8_t *out, U32_t size, Char8_t const *format, Byte_t const *args);
+
+/** @struct LogRecord_t
+ * @brief a log call as pushed by its thread. The arguments are packed 8 byte aligned, strings by value and
+ * truncated to the space left, so that the record doesn't point to anything the caller may free
+ */
+struct alignas(64) LogRecord_t
+{
+    static U32_t constexpr argsSize = logRecordSize - 32;
+
+    LogDecodeFunc_t decode;
+    Char8_t const  *format; ///< must have static storage duration, as literals do
+    U64_t           timestamp; ///< @ref hiResTimer ticks
+    ELogLevel_t     level;
+    ELogCategory_t  category;
+    Byte_t          args[argsSize];
+};
+static_assert(sizeof(LogRecord_t) == logRecordSize);
+
+namespace detail
+{
+    /// how a log argument is stored in the record: strings by value, other pointers as `void const *`, floats as
+    /// doubles, as they would be promoted to anyway
+    template<typename T> struct LogArg_t
+    {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>,
+                      "[Log] arguments must be scalars, pointers or C strings");
+        using Stored_t = std::conditional_t<
+          std::is_floating_point_v<T>,
+          F64_t,
+          std::conditional_t<std::is_pointer_v<T>, void const *, std::conditional_t<std::is_same_v<T, B8_t>, I32_t, T>>>;
+        static B8_t constexpr isString = false;
+    };
+    template<> struct LogArg_t<Char8_t const *>
+    {
+        using Stored_t                 = Char8_t const *;
+        static B8_t constexpr isString = true;
+    };
+    template<> struct LogArg_t<Char8_t *> : LogArg_t<Char8_t const *>
+    {
+    };
+
+    inline U32_t constexpr logAlign(U32_t offset)
+    { //
+        return (offset + 7) & ~7U;
+    }
+
+    /// space taken by the non string arguments, plus a terminator per string
+    template<typename... Args> consteval U32_t logFixedSize()
+    {
+        U32_t size = 0;
+        ((size = logAlign(size) + (LogArg_t<Args>::isString ? 1 : sizeof(typename LogArg_t<Args>::Stored_t))), ...);
+        return size;
+    }
+
+    template<typename T> CGE_forceinline inline void logEncode(Byte_t *args, U32_t &offset, T value)
+    {
+        using Arg_t = LogArg_t<T>;
+        offset      = logAlign(offset);
+        if constexpr (Arg_t::isString)
+        {
+            U32_t const space  = LogRecord_t::argsSize - offset;
+            U32_t const length = value ? static_cast<U32_t>(strnlen(value, space - 1)) : 0;
+            if (length)
+            {
+                std::memcpy(args + offset, value, length);
+            }
+            args[offset + length] = Byte_t{ 0 };
+            offset += length + 1;
+        }
+        else
+        {
+            auto const stored = static_cast<typename Arg_t::Stored_t>(value);
+            std::memcpy(args + offset, &stored, sizeof(stored));
+            offset += sizeof(stored);
+        }
+    }
+
+    /// reads the arguments back in the order they were written
+    struct LogReader_t
+    {
+        template<typename T> typename LogArg_t<T>::Stored_t read()
+        {
+            using Arg_t = LogArg_t<T>;
+            offset      = logAlign(offset);
+            if constexpr (Arg_t::isString)
+            {
+                auto const *str = reinterpret_cast<Char8_t const *>(args + offset);
+                offset += static_cast<U32_t>(std::strlen(str)) + 1;
+                return str;
+            }
+            else
+            {
+                typename Arg_t::Stored_t value;
+                std::memcpy(&value, args + offset, sizeof(value));
+                offset += sizeof(value);
+                return value;
+            }
+        }
+
+        Byte_t const *args;
+        U32_t         offset;
+    };
+
+    /// vsnprintf on the decoded arguments
+    U32_t logFormat(Char8_t *out, U32_t size, Char8_t const *format, ...);
+
+    template<typename... Args> U32_t logDecode(Char8_t *out, U32_t size, Char8_t const *format, Byte_t const *args)
+    {
+        [[maybe_unused]] LogReader_t reader{ .args = args, .offset = 0 };
+        // braced initialization evaluates left to right
+        std::tuple<typename LogArg_t<Args>::Stored_t...> const values{ reader.read<Args>()... };
+        return std::apply([&](auto... value) { return logFormat(out, size, format, value...); }, values);
+    }
+
+    /// never called, lets the compiler check the arguments against the format string
+    CGE_printf_format(1, 2) inline void logCheckFormat(Char8_t const *, ...)
+    {
+    }
+} // namespace detail
+
+struct LogThread_t;
+
+/** @class Logger_s
+ * @brief log calls can come from any thread. Until @ref init starts the writer thread, and after @ref shutdown,
+ * they are formatted and written synchronously
+ */
+class Logger_s
+{
+  public:
+    Logger_s() = default;
+    Logger_s(Logger_s const &)            = delete;
+    Logger_s &operator=(Logger_s const &) = delete;
+    ~Logger_s();
+
+    /** @fn init
+     *  @brief starts the writer thread, writing to the given file
+     */
+    void init(std::FILE *out = stdout);
+
+    /** @fn shutdown
+     *  @brief writes the pending records and joins the writer thread
+     */
+    void shutdown();
+
+    /** @fn log
+     *  @brief use the `CGE_LOG` macros instead, which check the format string and filter at compile time
+     */
+    template<typename... Args>
+    void log(ELogLevel_t level, ELogCategory_t category, Char8_t const *format, Args... args);
+
+    /** @fn dropped
+     *  @brief records dropped so far because the queue of their thread was full
+     */
+    [[nodiscard]] U64_t dropped() const;
+
+  private:
+    LogThread_t *threadQueue();
+
+    /// false if the record must be written synchronously, i.e. if the writer isn't running
+    B8_t         push(LogRecord_t const &record);
+    void         write(LogRecord_t const &record);
+    U32_t        drain();
+    void         writerLoop();
+
+  private:
+    std::atomic<LogThread_t *> m_threads[logMaxThreads]{};
+    std::atomic<U32_t>         m_threadCount{ 0 };
+    std::atomic<B8_t>          m_running{ false };
+    std::thread                m_writer;
+    std::FILE                 *m_out          = stdout;
+    U64_t                      m_reported     = 0; ///< dropped records already reported
+    LogRecord_t               *m_pending      = nullptr; ///< records drained in a pass, sorted before writing
+    U32_t                      m_pendingCount = 0;
+};
+
+extern Logger_s g_logger;
+
+template<typename... Args>
+void Logger_s::log(ELogLevel_t level, ELogCategory_t category, Char8_t const *format, Args... args)
+{
+    static_assert(
+      detail::logFixedSize<Args...>() <= LogRecord_t::argsSize, "[Log] too many arguments for a log record");
+
+    LogRecord_t record;
+    record.decode    = &detail::logDecode<Args...>;
+    record.format    = format;
+    record.timestamp = hiResTimer();
+    record.level     = level;
+    record.category  = category;
+    [[maybe_unused]] U32_t offset = 0;
+    (detail::logEncode(record.args, offset, args), ...);
+    if (!push(record))
+    {
+        write(record);
+    }
+}
+
+} // namespace cge
+
+/** @code CGE_LOG(level, category, format, ...): logs a printf style message, without a trailing newline. Level
+ * and category are the names of the enumerators without the `e`, e.g. `CGE_LOG(Info, Game, "score %u", score)`.
+ * The format string must be a literal
+ */
+#define CGE_LOG(level, category, ...)                                                                            \
+    do                                                                                                           \
+    {                                                                                                            \
+        if constexpr (::cge::logEnabled(::cge::ELogLevel_t::e##level, ::cge::ELogCategory_t::e##category))    \
+        {                                                                                                        \
+            if (false)                                                                                           \
+            {                                                                                                    \
+                ::cge::detail::logCheckFormat(__VA_ARGS__);                                                      \
+            }                                                                                                    \
+            ::cge::g_logger.log(::cge::ELogLevel_t::e##level, ::cge::ELogCategory_t::e##category, __VA_ARGS__); \
+        }                                                                                                        \
+    } while (0)
+
+#define CGE_LOG_TRACE(category, ...) CGE_LOG(Trace, category, __VA_ARGS__)
+#define CGE_LOG_DEBUG(category, ...) CGE_LOG(Debug, category, __VA_ARGS__)
+#define CGE_LOG_INFO(category, ...) CGE_LOG(Info, category, __VA_ARGS__)
+#define CGE_LOG_WARNING(category, ...) CGE_LOG(Warning, category, __VA_ARGS__)
+#define CGE_LOG_ERROR(category, ...) CGE_LOG(Error, category, __VA_ARGS__)
@@ -125,6 +125,37 @@
 #define CGE_API
 #endif
 
+/**
+ * @code CGE_target(features): function attribute. Allows the compiler to use the given instruction set
+ * extensions in the function, which must be called only after having checked the CPU supports them. MSVC
+ * doesn't need it
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define CGE_target(features) __attribute__((target(features)))
+#else
+#define CGE_target(features)
+#endif
+
+/**
+ * @code CGE_printf_format(formatIndex, firstArg): function attribute. The compiler checks the arguments from the
+ * `firstArg`-th on against the printf format string passed as the `formatIndex`-th (1 based) parameter
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define CGE_printf_format(formatIndex, firstArg) __attribute__((format(printf, formatIndex, firstArg)))
+#else
+#define CGE_printf_format(formatIndex, firstArg)
+#endif
+
+/**
+ * @code CGE_no_sanitize_thread: function attribute. ThreadSanitizer doesn't instrument the memory accesses of the
+ * function, for the races which are intended, such as a speculative read validated afterwards
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define CGE_no_sanitize_thread __attribute__((no_sanitize_thread))
+#else
+#define CGE_no_sanitize_thread
+#endif
+
 #if defined(__GNUC__)
 #define CGE_vectorcall
 #elif defined(_MSC_VER) || defined(__clang__)
@@ -144,3 +175,7 @@
 #if defined(_DEBUG) || _CGEDEBUG == 1
 #define CGE_DEBUG
 #endif
+
+#if _CGEPROFILE == 1
+#define CGE_PROFILE
+#endif
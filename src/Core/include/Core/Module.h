@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Core/Alloc.h"
+#include "Core/Containers.h"
 #include "Core/StringUtils.h"
 #include "Core/Type.h"
 #include "Core/Utility.h"
@@ -33,8 +35,19 @@ class IModule
 
   public:
     virtual void onInit();
+
+    /** @fn onTick
+     *  @brief advances the simulation by a fixed step of `deltaTime` time units. Called as many times per frame as
+     *  the elapsed time requires, possibly none, hence it shouldn't render
+     */
     virtual void onTick(U64_t deltaTime) = 0;
 
+    /** @fn onRender
+     *  @brief called once per frame, after the simulation steps. `alpha` in [0, 1) is how far the frame is between
+     *  the previous simulation state and the current one, scene node transforms are blended by it
+     */
+    virtual void onRender(F32_t alpha);
+
     bool  taggedForDestruction() const;
     Sid_t moduleSwitched() const;
     void  resetSwitchModule();
@@ -61,11 +74,38 @@ class GlobalStore
     void           put(Sid_t const &sid, UntypedData128 const &data);
 
   private:
-    std::pmr::unordered_map<Sid_t, UntypedData128> m_map;
+    FlatMap<Sid_t, UntypedData128> m_map;
 };
 
-std::pmr::unsynchronized_pool_resource *getMemoryPool();
-std::pmr::monotonic_buffer_resource    *getScratchBuffer();
-extern GlobalStore                      g_globalStore;
+/** @fn getMemoryPool
+ *  @brief general purpose thread safe pool used by engine containers, whose slabs are carved from the
+ *  persistent slot of the engine arena
+ */
+SlabPool *getMemoryPool();
+
+/** @fn getMemoryPool
+ *  @brief memory pool whose allocations are attributed to the given tag. In release builds it is the plain
+ *  memory pool, in debug builds a @ref TrackingResource over it
+ */
+#if defined(CGE_DEBUG)
+std::pmr::memory_resource *getMemoryPool(EMemoryTag_t tag);
+
+/** @fn dbg_printMemoryTagStats
+ *  @brief prints on stdout current bytes, peak bytes and allocation counts of each memory tag
+ */
+void dbg_printMemoryTagStats();
+#else
+inline std::pmr::memory_resource *getMemoryPool([[maybe_unused]] EMemoryTag_t tag)
+{ //
+    return getMemoryPool();
+}
+#endif
+
+/** @fn getScratchBuffer
+ *  @brief frame scoped linear allocator. Memory allocated from it stays valid until the end of the
+ *  next frame, as the main loop flips and rewinds it once per frame
+ */
+DoubleBufferedAllocator *getScratchBuffer();
+extern GlobalStore       g_globalStore;
 
 } // namespace cge
@@ -0,0 +1,133 @@
+#pragma once
+
+/**
+ * @ref core
+ * @file Core/Profiler.h
+ * scoped CPU zones timed with the calibrated time-stamp counter. Each thread appends its zones to a ring buffer of
+ * its own, without locks, and the flight recorder dumps the last frames as Chrome trace JSON (chrome://tracing,
+ * ui.perfetto.dev) whenever a frame goes over budget. Zones compile to nothing unless `CGE_PROFILE` is defined,
+ * see the `cge_ENABLE_PROFILER` CMake option
+ */
+
+#include "Core/TimeUtils.h"
+#include "Core/Type.h"
+
+#include <atomic>
+
+namespace cge
+{
+
+inline U32_t constexpr profileMaxThreads   = 64;
+inline U32_t constexpr profileRingCapacity = 1U << 15; ///< power of two, zones remembered per thread
+inline U32_t constexpr profileMaxFrames    = 64;       ///< power of two, frames remembered by the flight recorder
+inline U32_t constexpr profileThreadName   = 32;
+
+/// @struct a completed zone. The name must have static storage duration
+struct ProfileZone_t
+{
+    Char8_t const *name;
+    U64_t          start; ///< @ref hiResTimer ticks
+    U64_t          end;
+};
+
+struct ProfileThread_t;
+
+/** @class Profiler_s
+ * @brief zones can be recorded from any thread. Frames are delimited by the main thread with @ref beginFrame and
+ * @ref endFrame, which is also where the flight recorder checks the budget and writes its traces
+ */
+class Profiler_s
+{
+  public:
+    Profiler_s() = default;
+    Profiler_s(Profiler_s const &)            = delete;
+    Profiler_s &operator=(Profiler_s const &) = delete;
+    ~Profiler_s();
+
+    /** @fn initFromEnvironment
+     *  @brief enables the flight recorder if CGE_PROFILE_BUDGET is set, to the frame budget in milliseconds.
+     *  CGE_PROFILE_FRAMES sets how many frames each trace holds (8 by default)
+     */
+    void initFromEnvironment();
+
+    /** @fn setFlightRecorder
+     *  @brief when a frame takes longer than the budget, the last `frames` frames are written to
+     *  `cge_trace_<frame>.json`. A budget of 0 disables it
+     */
+    void setFlightRecorder(U64_t budgetNanoseconds, U32_t frames);
+
+    void beginFrame();
+    void endFrame();
+
+    /** @fn record
+     *  @brief appends a zone to the ring buffer of the calling thread, overwriting the oldest one. Wait free
+     */
+    void record(Char8_t const *name, U64_t start, U64_t end);
+
+    /** @fn setThreadName
+     *  @brief name under which the zones of the calling thread appear in the traces
+     */
+    void setThreadName(Char8_t const *name);
+
+    /** @fn dumpChromeTrace
+     *  @brief writes the zones of every thread overlapping the last `frames` completed frames. Can be called
+     *  while other threads keep recording
+     */
+    EErr_t dumpChromeTrace(Char8_t const *path, U32_t frames) const;
+
+  private:
+    struct Frame_t
+    {
+        U64_t start;
+        U64_t end;
+    };
+
+    ProfileThread_t *threadBuffer();
+
+  private:
+    std::atomic<ProfileThread_t *> m_threads[profileMaxThreads]{};
+    std::atomic<U32_t>             m_threadCount{ 0 };
+    Frame_t                        m_frames[profileMaxFrames]{};
+    U32_t                          m_frameIndex     = 0; ///< frames completed so far
+    U64_t                          m_budget         = 0; ///< ticks, 0 if the flight recorder is disabled
+    U32_t                          m_recordedFrames = 8;
+    U32_t                          m_nextDumpFrame  = 0; ///< traces don't overlap
+};
+
+extern Profiler_s g_profiler;
+
+/// @class ProfileScope_s records a zone spanning its lifetime
+class ProfileScope_s
+{
+  public:
+    explicit ProfileScope_s(Char8_t const *name) : m_name(name), m_start(hiResTimer())
+    {
+    }
+    ProfileScope_s(ProfileScope_s const &)            = delete;
+    ProfileScope_s &operator=(ProfileScope_s const &) = delete;
+    ~ProfileScope_s()
+    { //
+        g_profiler.record(m_name, m_start, hiResTimer());
+    }
+
+  private:
+    Char8_t const *m_name;
+    U64_t          m_start;
+};
+
+} // namespace cge
+
+#define CGE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CGE_PROFILE_CONCAT(a, b) CGE_PROFILE_CONCAT_IMPL(a, b)
+
+#if defined(CGE_PROFILE)
+#define CGE_PROFILE_SCOPE(name) ::cge::ProfileScope_s CGE_PROFILE_CONCAT(cgeProfileScope, __LINE__)(name)
+#define CGE_PROFILE_THREAD(name) ::cge::g_profiler.setThreadName(name)
+#define CGE_PROFILE_BEGIN_FRAME() ::cge::g_profiler.beginFrame()
+#define CGE_PROFILE_END_FRAME() ::cge::g_profiler.endFrame()
+#else
+#define CGE_PROFILE_SCOPE(name) ((void)0)
+#define CGE_PROFILE_THREAD(name) ((void)0)
+#define CGE_PROFILE_BEGIN_FRAME() ((void)0)
+#define CGE_PROFILE_END_FRAME() ((void)0)
+#endif
@@ -0,0 +1,308 @@
+#pragma once
+
+/**
+ * @ref core
+ * @file Core/Queue.h
+ * bounded lock free ring queues for handing data between threads, such as loaded assets to the main thread or log
+ * messages to a writer thread. @ref SpscQueue serves one producer and one consumer, @ref MpmcQueue any number of
+ * both. Neither blocks: a push on a full queue and a pop on an empty one return false, and the caller decides
+ * whether to retry, spin or do something else in the meantime
+ */
+
+#include "Core/Type.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cge
+{
+
+/// size of the blocks kept apart so that the producers and the consumers don't invalidate each other's cache lines
+inline U64_t constexpr queueCacheLine = 64;
+
+/** @class SpscQueue
+ * @brief ring of `capacity` elements, rounded up to a power of two, with a single producer and a single consumer.
+ * Each side owns its index on a separate cache line and keeps a copy of the other one, which it reloads only when
+ * the ring looks full (or empty), so that in the common case a push or a pop touches no line written by the other
+ * thread but the slot itself
+ */
+template<typename T> class SpscQueue
+{
+  public:
+    using value_type = T;
+
+    explicit SpscQueue(U32_t capacity, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    SpscQueue(SpscQueue const &)            = delete;
+    SpscQueue &operator=(SpscQueue const &) = delete;
+    ~SpscQueue();
+
+    /** @fn tryEmplace
+     *  @brief constructs an element at the back. Returns false, without constructing it, if the queue is full.
+     *  Producer only
+     */
+    template<typename... Args> B8_t tryEmplace(Args &&...args);
+
+    B8_t tryPush(T const &value)
+    { //
+        return tryEmplace(value);
+    }
+    B8_t tryPush(T &&value)
+    { //
+        return tryEmplace(std::move(value));
+    }
+
+    /** @fn tryPop
+     *  @brief moves the front element into `out`. Returns false if the queue is empty. Consumer only
+     */
+    B8_t tryPop(T &out);
+
+    /** @fn sizeApprox
+     *  @brief exact only if neither side is running. Meant for statistics
+     */
+    [[nodiscard]] U32_t sizeApprox() const;
+    [[nodiscard]] U32_t capacity() const
+    { //
+        return static_cast<U32_t>(m_mask + 1);
+    }
+
+  private:
+    T *slot(U64_t index) const
+    { //
+        return std::launder(reinterpret_cast<T *>(m_slots + (index & m_mask) * sizeof(T)));
+    }
+
+  private:
+    alignas(queueCacheLine) std::atomic<U64_t> m_head{ 0 }; ///< written by the consumer
+    U64_t m_cachedTail = 0;                                  ///< consumer's copy of m_tail
+    alignas(queueCacheLine) std::atomic<U64_t> m_tail{ 0 }; ///< written by the producer
+    U64_t m_cachedHead = 0;                                  ///< producer's copy of m_head
+    alignas(queueCacheLine) Byte_t *m_slots;
+    U64_t                      m_mask;
+    std::pmr::memory_resource *m_resource;
+};
+
+template<typename T>
+SpscQueue<T>::SpscQueue(U32_t capacity, std::pmr::memory_resource *resource)
+  : m_mask(std::bit_ceil(capacity < 1 ? 1U : capacity) - 1), m_resource(resource)
+{
+    m_slots = static_cast<Byte_t *>(
+      m_resource->allocate((m_mask + 1) * sizeof(T), std::max<U64_t>(alignof(T), queueCacheLine)));
+}
+
+template<typename T> SpscQueue<T>::~SpscQueue()
+{
+    U64_t const tail = m_tail.load(std::memory_order_relaxed);
+    for (U64_t i = m_head.load(std::memory_order_relaxed); i != tail; ++i)
+    {
+        slot(i)->~T();
+    }
+    m_resource->deallocate(m_slots, (m_mask + 1) * sizeof(T), std::max<U64_t>(alignof(T), queueCacheLine));
+}
+
+template<typename T> template<typename... Args> B8_t SpscQueue<T>::tryEmplace(Args &&...args)
+{
+    U64_t const tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_cachedHead > m_mask)
+    {
+        m_cachedHead = m_head.load(std::memory_order_acquire);
+        if (tail - m_cachedHead > m_mask)
+        {
+            return false;
+        }
+    }
+
+    new (m_slots + (tail & m_mask) * sizeof(T)) T(std::forward<Args>(args)...);
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T> B8_t SpscQueue<T>::tryPop(T &out)
+{
+    U64_t const head = m_head.load(std::memory_order_relaxed);
+    if (head == m_cachedTail)
+    {
+        m_cachedTail = m_tail.load(std::memory_order_acquire);
+        if (head == m_cachedTail)
+        {
+            return false;
+        }
+    }
+
+    T *const element = slot(head);
+    out              = std::move(*element);
+    element->~T();
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T> U32_t SpscQueue<T>::sizeApprox() const
+{
+    U64_t const head = m_head.load(std::memory_order_acquire);
+    U64_t const tail = m_tail.load(std::memory_order_acquire);
+    return tail > head ? static_cast<U32_t>(tail - head) : 0;
+}
+
+/** @class MpmcQueue
+ * @brief Vyukov's bounded queue: every slot carries a sequence number telling which lap of the ring it is ready
+ * for, so producers (and consumers) contend only on a compare-and-swap of their index, and an element is published
+ * by the release store of its sequence rather than of the index. The capacity is rounded up to a power of two, and
+ * is at least 2
+ */
+template<typename T> class MpmcQueue
+{
+  public:
+    using value_type = T;
+
+    explicit MpmcQueue(U32_t capacity, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    MpmcQueue(MpmcQueue const &)            = delete;
+    MpmcQueue &operator=(MpmcQueue const &) = delete;
+    ~MpmcQueue();
+
+    /** @fn tryEmplace
+     *  @brief constructs an element at the back. Returns false, without constructing it, if the queue is full
+     */
+    template<typename... Args> B8_t tryEmplace(Args &&...args);
+
+    B8_t tryPush(T const &value)
+    { //
+        return tryEmplace(value);
+    }
+    B8_t tryPush(T &&value)
+    { //
+        return tryEmplace(std::move(value));
+    }
+
+    /** @fn tryPop
+     *  @brief moves the front element into `out`. Returns false if the queue is empty
+     */
+    B8_t tryPop(T &out);
+
+    /** @fn sizeApprox
+     *  @brief exact only if no thread is pushing or popping. Meant for statistics
+     */
+    [[nodiscard]] U32_t sizeApprox() const;
+    [[nodiscard]] U32_t capacity() const
+    { //
+        return static_cast<U32_t>(m_mask + 1);
+    }
+
+  private:
+    struct Cell_t
+    {
+        std::atomic<U64_t> sequence;
+        alignas(T) Byte_t storage[sizeof(T)];
+
+        T *element()
+        { //
+            return std::launder(reinterpret_cast<T *>(storage));
+        }
+    };
+
+  private:
+    alignas(queueCacheLine) std::atomic<U64_t> m_head{ 0 }; ///< next position to pop, shared by the consumers
+    alignas(queueCacheLine) std::atomic<U64_t> m_tail{ 0 }; ///< next position to push, shared by the producers
+    alignas(queueCacheLine) Cell_t *m_cells;
+    U64_t                      m_mask;
+    std::pmr::memory_resource *m_resource;
+};
+
+template<typename T>
+MpmcQueue<T>::MpmcQueue(U32_t capacity, std::pmr::memory_resource *resource)
+  : m_mask(std::bit_ceil(capacity < 2 ? 2U : capacity) - 1), m_resource(resource)
+{
+    m_cells = static_cast<Cell_t *>(
+      m_resource->allocate((m_mask + 1) * sizeof(Cell_t), std::max<U64_t>(alignof(Cell_t), queueCacheLine)));
+    for (U64_t i = 0; i <= m_mask; ++i)
+    {
+        new (&m_cells[i].sequence) std::atomic<U64_t>(i);
+    }
+}
+
+template<typename T> MpmcQueue<T>::~MpmcQueue()
+{
+    U64_t const tail = m_tail.load(std::memory_order_relaxed);
+    for (U64_t i = m_head.load(std::memory_order_relaxed); i != tail; ++i)
+    {
+        m_cells[i & m_mask].element()->~T();
+    }
+    m_resource->deallocate(
+      m_cells, (m_mask + 1) * sizeof(Cell_t), std::max<U64_t>(alignof(Cell_t), queueCacheLine));
+}
+
+template<typename T> template<typename... Args> B8_t MpmcQueue<T>::tryEmplace(Args &&...args)
+{
+    Cell_t *cell;
+    U64_t   position = m_tail.load(std::memory_order_relaxed);
+    while (true)
+    {
+        cell                 = &m_cells[position & m_mask];
+        U64_t const sequence = cell->sequence.load(std::memory_order_acquire);
+        I64_t const lap      = static_cast<I64_t>(sequence - position);
+        if (lap == 0)
+        { // the slot is free for this lap, claim it
+            if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (lap < 0)
+        { // the slot still holds the element of the previous lap
+            return false;
+        }
+        else
+        { // another producer claimed it
+            position = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    new (cell->storage) T(std::forward<Args>(args)...);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T> B8_t MpmcQueue<T>::tryPop(T &out)
+{
+    Cell_t *cell;
+    U64_t   position = m_head.load(std::memory_order_relaxed);
+    while (true)
+    {
+        cell                 = &m_cells[position & m_mask];
+        U64_t const sequence = cell->sequence.load(std::memory_order_acquire);
+        I64_t const lap      = static_cast<I64_t>(sequence - (position + 1));
+        if (lap == 0)
+        { // the element is published, claim it
+            if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (lap < 0)
+        { // not yet pushed
+            return false;
+        }
+        else
+        { // another consumer claimed it
+            position = m_head.load(std::memory_order_relaxed);
+        }
+    }
+
+    T *const element = cell->element();
+    out              = std::move(*element);
+    element->~T();
+    cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T> U32_t MpmcQueue<T>::sizeApprox() const
+{
+    U64_t const head = m_head.load(std::memory_order_acquire);
+    U64_t const tail = m_tail.load(std::memory_order_acquire);
+    return tail > head ? static_cast<U32_t>(tail - head) : 0;
+}
+
+} // namespace cge
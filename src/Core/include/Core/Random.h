@@ -1,21 +1,161 @@
 #pragma once
+#include "Cpu.h"
 #include "Type.h"
 
+#include <bit>
 #include <concepts>
-#include <mutex>
+#include <limits>
 #include <random>
-#include <thread>
+#include <type_traits>
 
 namespace cge
 {
 
+/** @fn splitMix64
+ *  @brief advances the given state and returns the next output of SplitMix64. Used to expand seeds, as nearby seeds
+ *  give unrelated outputs
+ */
+inline U64_t splitMix64(U64_t &state)
+{
+    U64_t z = (state += 0x9e37'79b9'7f4a'7c15ULL);
+    z       = (z ^ (z >> 30)) * 0xbf58'476d'1ce4'e5b9ULL;
+    z       = (z ^ (z >> 27)) * 0x94d0'49bb'1331'11ebULL;
+    return z ^ (z >> 31);
+}
+
+/** @struct Xoshiro256_t
+ * @brief xoshiro256** by Blackman and Vigna: 32 bytes of state, a period of 2^256 - 1 and jumps of 2^128 and 2^192
+ * steps, which split a sequence into non overlapping streams. Satisfies UniformRandomBitGenerator, hence it works
+ * with the standard distributions and algorithms
+ */
+struct Xoshiro256_t
+{
+    using result_type = U64_t;
+
+    static constexpr result_type min()
+    { //
+        return 0;
+    }
+    static constexpr result_type max()
+    { //
+        return std::numeric_limits<result_type>::max();
+    }
+
+    /** @fn seed
+     *  @brief expands the seed with SplitMix64, so that no seed gives the all zero state
+     */
+    void seed(U64_t value)
+    {
+        for (U64_t &word : s)
+        { //
+            word = splitMix64(value);
+        }
+    }
+
+    /** @fn seed
+     *  @brief seeds from a seed and a key, such as the index of a tile or a frame. The same pair always gives the
+     *  same sequence, whichever thread draws it and in whatever order
+     */
+    void seed(U64_t value, U64_t key)
+    {
+        U64_t mixed = value;
+        mixed       = splitMix64(mixed) ^ key;
+        seed(mixed);
+    }
+
+    result_type operator()()
+    {
+        U64_t const result = std::rotl(s[1] * 5, 7) * 9;
+        U64_t const t      = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = std::rotl(s[3], 45);
+        return result;
+    }
+
+    /** @fn jump
+     *  @brief advances by 2^128 steps, the start of the next of 2^128 streams
+     */
+    void jump();
+
+    /** @fn longJump
+     *  @brief advances by 2^192 steps, the start of the next of 2^64 groups of streams
+     */
+    void longJump();
+
+    /** @fn stream
+     *  @brief generator for the given stream of a seed, i.e. seeded then jumped `index` times. Meant for a small
+     *  number of streams, such as one per worker thread
+     */
+    static Xoshiro256_t stream(U64_t seed, U32_t index);
+
+    U64_t s[4];
+};
+static_assert(std::is_trivial_v<Xoshiro256_t>);
+
+/// F32_t in [0, 1), from the upper 24 bits
+inline F32_t toUnitFloat(U64_t bits)
+{ //
+    return static_cast<F32_t>(bits >> 40) * 0x1.0p-24F;
+}
+
+/// F64_t in [0, 1), from the upper 53 bits
+inline F64_t toUnitDouble(U64_t bits)
+{ //
+    return static_cast<F64_t>(bits >> 11) * 0x1.0p-53;
+}
+
+inline U32_t constexpr randomLanes = 4;
+
+/** @struct RandomLanes_t
+ * @brief `randomLanes` xoshiro256** generators stepped together with SSE2, each lane being a different stream of
+ * the same seed. Fills buffers of random numbers for batch work, such as scattering procedural props
+ */
+struct alignas(16) RandomLanes_t
+{
+    void seed(U64_t value);
+    void seed(U64_t value, U64_t key);
+
+    /** @fn fill
+     *  @brief writes `count` random words, a multiple of `randomLanes` of them at a time
+     */
+    void fill(U64_t *out, U64_t count);
+
+    /** @fn fillUnit
+     *  @brief writes `count` floats uniformly distributed in [0, 1)
+     */
+    void fillUnit(F32_t *out, U64_t count);
+
+    U64_t s[4][randomLanes]; ///< word-major, so that each word of all lanes is a vector load
+};
+
+/// @fn randomFillScalar reference kernel of @ref RandomLanes_t::fill, one lane at a time
+void randomFillScalar(RandomLanes_t &lanes, U64_t *out, U64_t count);
+
+/// @fn randomFillSSE2 two vectors of two lanes per state word
+void randomFillSSE2(RandomLanes_t &lanes, U64_t *out, U64_t count);
+
+/// @fn randomFillAVX2 all lanes of a state word in a vector. The CPU must support AVX2
+void randomFillAVX2(RandomLanes_t &lanes, U64_t *out, U64_t count);
+
+/// @fn randomFillAVX512 as @ref randomFillAVX2, with native rotations. The CPU must support AVX-512F and VL
+void randomFillAVX512(RandomLanes_t &lanes, U64_t *out, U64_t count);
+
+using RandomFillFunc_t = void (*)(RandomLanes_t &lanes, U64_t *out, U64_t count);
+
+/// @var g_randomFillKernel the kernels above, as dispatched by @ref RandomLanes_t::fill
+extern Kernel_s<RandomFillFunc_t> const g_randomFillKernel;
+
 class Random
 {
   public:
     Random()
     {
         std::random_device rd;
-        m_generator.seed(rd());
+        m_generator.seed((static_cast<U64_t>(rd()) << 32) | rd());
     }
 
     // Generates a random number within the specified range (inclusive)
@@ -24,22 +164,56 @@ class Random
       T min = std::numeric_limits<T>::min(),
       T max = std::numeric_limits<T>::max())
     {
-        std::uniform_int_distribution<T> distribution(min, max);
-        return distribution(m_generator);
+        using U = std::make_unsigned_t<T>;
+        if constexpr (sizeof(T) <= sizeof(U32_t))
+        { // Lemire's multiply and shift, rejecting only the few values which would bias the result
+            U32_t const range = static_cast<U32_t>(static_cast<U>(static_cast<U>(max) - static_cast<U>(min))) + 1;
+            if (range == 0)
+            { // the full range of 32 bits
+                return static_cast<T>(static_cast<U32_t>(m_generator() >> 32));
+            }
+
+            U64_t product = (m_generator() >> 32) * range;
+            if (static_cast<U32_t>(product) < range)
+            {
+                U32_t const threshold = static_cast<U32_t>(-range) % range;
+                while (static_cast<U32_t>(product) < threshold)
+                { //
+                    product = (m_generator() >> 32) * range;
+                }
+            }
+            return static_cast<T>(static_cast<U>(static_cast<U>(min) + static_cast<U>(product >> 32)));
+        }
+        else
+        {
+            std::uniform_int_distribution<T> distribution(min, max);
+            return distribution(m_generator);
+        }
     }
 
-    // Generates a random double between 0.0 (inclusive) and 1.0 (exclusive)
+    // Generates a random number between 0.0 (inclusive) and 1.0 (exclusive)
     template<std::floating_point T> T next()
     {
-        std::uniform_real_distribution<T> distribution(0.0, 1.0);
-        return distribution(m_generator);
+        if constexpr (std::is_same_v<T, F32_t>)
+        { //
+            return toUnitFloat(m_generator());
+        }
+        else
+        { //
+            return static_cast<T>(toUnitDouble(m_generator()));
+        }
     }
 
-    std::mt19937 &getGen();
+    Xoshiro256_t &getGen();
+
+    // Restarts the sequence from the given seed, for reproducible runs
+    void seed(U64_t value);
+
+    // Restarts the sequence from the given seed and key, see Xoshiro256_t::seed
+    void seed(U64_t value, U64_t key);
 
   private:
-    // Thread-local random number m_generator
-    std::mt19937 m_generator;
+    Xoshiro256_t m_generator;
 
     // Disallow copying to prevent accidental sharing of the m_generator
     Random(const Random &)            = delete;
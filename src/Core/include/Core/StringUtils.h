@@ -1,8 +1,11 @@
 #pragma once
 
+#include "Core/Cpu.h"
 #include "Core/Type.h"
 
+#include <cstdio>
 #include <string_view>
+#include <type_traits>
 
 namespace cge
 {
@@ -90,17 +93,43 @@ inline U64_t constexpr g_CRC64Table[256] = {
 
 inline U64_t constexpr INITIAL_CRC64 = 0x43a04931514122ddull;
 
-// TODO: as a fast alternative, consider Fowler�Noll�Vo hash function
-inline U64_t constexpr hashCRC64(Char8_t const *str)
+/** @fn hashCRC64Bytewise
+ *  @brief reference implementation, one table lookup per byte. Used in constant evaluation
+ */
+inline U64_t constexpr hashCRC64Bytewise(std::string_view str, U64_t crc = INITIAL_CRC64)
 {
-    U64_t crc = INITIAL_CRC64;
-    while (*str)
+    for (Char8_t const c : str)
     {
-        crc = g_CRC64Table[(U8_t)(crc >> 56) ^ *str++] ^ (crc << 8);
+        crc = g_CRC64Table[static_cast<U8_t>(crc >> 56) ^ static_cast<U8_t>(c)] ^ (crc << 8);
     }
     return crc;
 }
 
+using CRC64Func_t = U64_t (*)(U8_t const *p, U64_t len, U64_t crc);
+
+/// @var g_crc64Kernel slicing-by-8 (eScalar) and PCLMULQDQ folding (eSSE42), same results of @ref hashCRC64Bytewise
+extern Kernel_s<CRC64Func_t> const g_crc64Kernel;
+
+/** @fn hashCRC64Runtime
+ *  @brief same result of @ref hashCRC64Bytewise, computed with PCLMULQDQ folding on CPUs supporting it and
+ *  slicing-by-8 otherwise, see @ref g_crc64Kernel
+ */
+U64_t hashCRC64Runtime(std::string_view str, U64_t crc = INITIAL_CRC64);
+
+inline U64_t constexpr hashCRC64(std::string_view str)
+{
+    if (std::is_constant_evaluated())
+    {
+        return hashCRC64Bytewise(str);
+    }
+    return hashCRC64Runtime(str);
+}
+
+inline U64_t constexpr hashCRC64(Char8_t const *str)
+{ //
+    return hashCRC64(std::string_view(str));
+}
+
 bool constexpr operator==(Sid_t a, Sid_t b)
 {
     return a.id == b.id;
@@ -110,26 +139,46 @@ bool constexpr operator<(Sid_t a, Sid_t b)
     return a.id < b.id;
 }
 
-inline Sid_t constexpr operator""_sid(Char8_t const *str, U64_t size)
-{
-    static_assert(hashCRC64("test"), "hashCRC64 is not constexpr");
+/// string literals are always hashed at compile time
+inline Sid_t consteval operator""_sid(Char8_t const *str, U64_t size)
+{ //
+    return { .id = hashCRC64Bytewise(std::string_view(str, size)) };
+}
+
+/// folded when evaluated in a constant expression, otherwise hashed with @ref hashCRC64Runtime
+inline Sid_t constexpr makeSid(std::string_view str)
+{ //
     return { .id = hashCRC64(str) };
 }
 
 #if defined(CGE_DEBUG)
-Sid_t          dbg_internString(Char8_t const *str);
+/** @fn dbg_internString
+ *  @brief hashes the string and stores a copy of it, if not known yet. Thread safe
+ */
+Sid_t dbg_internString(Char8_t const *str);
+
+/** @fn dbg_lookupString
+ *  @brief string from which the sid was computed, or an error string if it was never interned. Thread safe
+ */
 Char8_t const *dbg_lookupString(Sid_t sid);
 
+/** @fn dbg_dumpSids
+ *  @brief prints every interned sid along with its string, followed by the memory used by the table
+ */
+void dbg_dumpSids(std::FILE *out);
+
 #define CGE_DBG_SID(x) ::cge::dbg_internString(x)
 #define CGE_SID(x) ::cge::dbg_internString(x)
 #define CGE_CONSTEXPR_SID(x) (::cge::operator""_sid((x), std::string_view((x)).size()))
 #define CGE_DBG_STRLOOKUP(x) ::cge::dbg_lookupString(x)
+#define CGE_DBG_DUMPSIDS(file) ::cge::dbg_dumpSids(file)
 
 #else
-#define CGE_DBG_SID(x) (::cge::operator""_sid((x), std::string_view((x)).size()))
+#define CGE_DBG_SID(x) (::cge::makeSid((x)))
 #define CGE_CONSTEXPR_SID(x) (::cge::operator""_sid((x), std::string_view((x)).size()))
-#define CGE_SID(x) (::cge::operator""_sid((x), std::string_view((x)).size()))
+#define CGE_SID(x) (::cge::makeSid((x)))
 #define CGE_DBG_STRLOOKUP(x) ("")
+#define CGE_DBG_DUMPSIDS(file)
 #endif
 
 inline Sid_t constexpr nullSid = { .id = 0ULL };
@@ -0,0 +1,391 @@
+#pragma once
+
+/**
+ * @ref core
+ * @file Core/Task.h
+ * coroutines for gameplay behaviours spanning several frames. A `Task_s` is spawned on @ref g_taskScheduler, runs
+ * until its first suspension, and is then resumed on the main thread by @ref TaskScheduler_s::update only when
+ * what it awaits is ready: the next update (@ref nextFrame), a point in simulation time (@ref delay), an event of
+ * @ref g_eventQueue (@ref nextEvent) or the completion of jobs (@ref jobDone). Tasks can await other tasks, and a
+ * spawned task can be cancelled at any suspension point, which destroys its frame and the ones it awaits
+ */
+
+#include "Core/Alloc.h"
+#include "Core/Event.h"
+#include "Core/Job.h"
+#include "Core/Module.h"
+#include "Core/Type.h"
+
+#include <coroutine>
+#include <cstdlib>
+#include <utility>
+
+namespace cge
+{
+
+/** @struct TaskHandle_t
+ * @brief returned by @ref TaskScheduler_s::spawn, same scheme as @ref ListenerHandle_t: a stale handle is
+ * recognized and ignored, and a zeroed one is null
+ */
+struct TaskHandle_t
+{
+    U32_t slot;
+    U32_t generation;
+};
+
+inline TaskHandle_t constexpr nullTaskHandle{ .slot = 0, .generation = 0 };
+
+class Task_s;
+
+struct TaskPromise_t
+{
+    /// resumes the awaiting task, if any, when this one completes
+    struct FinalAwaiter_t
+    {
+        B8_t await_ready() const noexcept
+        { //
+            return false;
+        }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<TaskPromise_t> handle) const noexcept
+        {
+            std::coroutine_handle<> const continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    Task_s              get_return_object();
+    std::suspend_always initial_suspend() const noexcept
+    { //
+        return {};
+    }
+    FinalAwaiter_t final_suspend() const noexcept
+    { //
+        return {};
+    }
+    void return_void() const
+    {
+    }
+    void unhandled_exception() const
+    { //
+        std::abort();
+    }
+
+    /// frames come from the memory pool, as they are mostly small and short lived
+    static void *operator new(std::size_t size)
+    { //
+        return getMemoryPool(EMemoryTag_t::eTasks)->allocate(size);
+    }
+    static void operator delete(void *frame, std::size_t size)
+    { //
+        getMemoryPool(EMemoryTag_t::eTasks)->deallocate(frame, size);
+    }
+
+    std::coroutine_handle<> continuation = nullptr;       ///< the task awaiting this one
+    TaskHandle_t            task         = nullTaskHandle; ///< the spawned task this coroutine runs in
+};
+
+/** @class Task_s
+ * @brief a coroutine returning void. It starts suspended: either it is handed to @ref TaskScheduler_s::spawn, or
+ * awaited by another task with `co_await child(...)`, which runs it to completion before resuming the awaiting
+ * one. The frame is destroyed with the object, hence a task must not be awaited twice
+ */
+class Task_s
+{
+  public:
+    using promise_type = TaskPromise_t;
+
+    Task_s() = default;
+    explicit Task_s(std::coroutine_handle<TaskPromise_t> handle) : m_handle(handle)
+    {
+    }
+    Task_s(Task_s const &)            = delete;
+    Task_s &operator=(Task_s const &) = delete;
+    Task_s(Task_s &&other) noexcept : m_handle(std::exchange(other.m_handle, nullptr))
+    {
+    }
+    Task_s &operator=(Task_s &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_handle)
+            {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+    ~Task_s()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    /// @fn release gives up the ownership of the frame
+    std::coroutine_handle<TaskPromise_t> release()
+    { //
+        return std::exchange(m_handle, nullptr);
+    }
+
+    struct Awaiter_t
+    {
+        B8_t await_ready() const noexcept
+        { //
+            return !child || child.done();
+        }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<TaskPromise_t> parent) const noexcept
+        {
+            child.promise().continuation = parent;
+            child.promise().task         = parent.promise().task;
+            return child;
+        }
+        void await_resume() const noexcept
+        {
+        }
+
+        std::coroutine_handle<TaskPromise_t> child;
+    };
+
+    Awaiter_t operator co_await() && noexcept
+    { //
+        return { m_handle };
+    }
+
+  private:
+    std::coroutine_handle<TaskPromise_t> m_handle = nullptr;
+};
+
+inline Task_s TaskPromise_t::get_return_object()
+{ //
+    return Task_s{ std::coroutine_handle<TaskPromise_t>::from_promise(*this) };
+}
+
+/** @class TaskScheduler_s
+ * @brief owns the spawned tasks and the lists of the suspended ones, main thread only. Tasks waiting for a
+ * deadline sit in a binary heap and tasks waiting for an event in the listener lists of @ref g_eventQueue, so an
+ * update costs nothing for them until they are due; tasks waiting for jobs are polled, a load per task
+ */
+class TaskScheduler_s
+{
+  public:
+    TaskScheduler_s();
+    TaskScheduler_s(TaskScheduler_s const &)            = delete;
+    TaskScheduler_s &operator=(TaskScheduler_s const &) = delete;
+    ~TaskScheduler_s();
+
+    /** @fn spawn
+     *  @brief takes the ownership of the task and runs it until its first suspension
+     */
+    TaskHandle_t spawn(Task_s task);
+
+    /** @fn cancel
+     *  @brief destroys the task, or, if it is running, destroys it at its next suspension. Null, stale and
+     *  completed handles are ignored
+     */
+    void cancel(TaskHandle_t handle);
+
+    [[nodiscard]] B8_t isAlive(TaskHandle_t handle) const;
+
+    /** @fn update
+     *  @brief advances the clock of @ref delay by `deltaTime` time units, then resumes, in this order, the tasks
+     *  whose jobs are done, the ones whose deadline has passed, and the ones woken since the previous update
+     *  (@ref nextFrame and @ref nextEvent). Tasks suspending again during the update are resumed at the next one
+     */
+    void update(U64_t deltaTime);
+
+    /** @fn shutdown
+     *  @brief destroys every task. The ones capturing objects must be cancelled by their owners before
+     */
+    void shutdown();
+
+    /// @fn currentTime time units elapsed on the clock of @ref delay
+    [[nodiscard]] U64_t currentTime() const
+    { //
+        return m_time;
+    }
+    [[nodiscard]] U32_t taskCount() const
+    { //
+        return m_taskCount;
+    }
+
+    /// @struct a suspended coroutine, and the spawned task it belongs to
+    struct Waiter_t
+    {
+        std::coroutine_handle<> handle;
+        TaskHandle_t            task;
+    };
+
+    // used by the awaitables
+    void wakeNextUpdate(Waiter_t waiter);
+    void wakeAt(U64_t deadline, Waiter_t waiter);
+    void wakeOnJob(JobCounter_t const &counter, Waiter_t waiter);
+
+  private:
+    struct Slot_t
+    {
+        std::coroutine_handle<TaskPromise_t> root       = nullptr;
+        U32_t                                generation = 1;
+        U32_t                                nextFree   = 0;
+        B8_t                                 running    = false;
+        B8_t                                 cancelled  = false;
+    };
+
+    struct Sleeper_t
+    {
+        U64_t    deadline;
+        U64_t    sequence; ///< ties are resumed in suspension order
+        Waiter_t waiter;
+    };
+
+    struct JobWaiter_t
+    {
+        JobCounter_t const *counter;
+        Waiter_t            waiter;
+    };
+
+    static U32_t constexpr invalidSlot = 0xffff'ffffU;
+
+  private:
+    void resume(Waiter_t const &waiter);
+    void destroy(U32_t slotIndex);
+
+  private:
+    std::pmr::vector<Slot_t>      m_slots{ getMemoryPool(EMemoryTag_t::eTasks) };
+    std::pmr::vector<Waiter_t>    m_ready{ getMemoryPool(EMemoryTag_t::eTasks) };
+    std::pmr::vector<Waiter_t>    m_resuming{ getMemoryPool(EMemoryTag_t::eTasks) };
+    std::pmr::vector<Sleeper_t>   m_sleepers{ getMemoryPool(EMemoryTag_t::eTasks) }; ///< min heap on the deadline
+    std::pmr::vector<JobWaiter_t> m_jobWaiters{ getMemoryPool(EMemoryTag_t::eTasks) };
+    U32_t                         m_freeSlot      = invalidSlot;
+    U32_t                         m_taskCount     = 0;
+    U64_t                         m_time          = 0;
+    U64_t                         m_sleepSequence = 0;
+};
+
+extern TaskScheduler_s g_taskScheduler;
+
+/// @struct awaitable of @ref nextFrame
+struct NextFrameAwaiter_t
+{
+    B8_t await_ready() const noexcept
+    { //
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<TaskPromise_t> handle) const
+    { //
+        g_taskScheduler.wakeNextUpdate({ .handle = handle, .task = handle.promise().task });
+    }
+    void await_resume() const noexcept
+    {
+    }
+};
+
+/// @fn nextFrame resumes the task at the next @ref TaskScheduler_s::update
+inline NextFrameAwaiter_t nextFrame()
+{ //
+    return {};
+}
+
+/// @struct awaitable of @ref delay
+struct DelayAwaiter_t
+{
+    B8_t await_ready() const noexcept
+    { //
+        return duration == 0;
+    }
+    void await_suspend(std::coroutine_handle<TaskPromise_t> handle) const
+    {
+        g_taskScheduler.wakeAt(
+          g_taskScheduler.currentTime() + duration, { .handle = handle, .task = handle.promise().task });
+    }
+    void await_resume() const noexcept
+    {
+    }
+
+    U64_t duration;
+};
+
+/** @fn delay
+ *  @brief resumes the task at the first update at which at least `duration` time units (1/timeUnit64 seconds) of
+ *  simulation time have passed
+ */
+inline DelayAwaiter_t delay(U64_t duration)
+{ //
+    return { .duration = duration };
+}
+
+/** @class EventAwaiter_s
+ * @brief awaitable of @ref nextEvent. Registers a listener on suspension, removed as soon as the event arrives or
+ * the task is destroyed
+ */
+class EventAwaiter_s
+{
+  public:
+    explicit EventAwaiter_s(Event_t event) : m_event(event)
+    {
+    }
+    EventAwaiter_s(EventAwaiter_s const &)            = delete;
+    EventAwaiter_s &operator=(EventAwaiter_s const &) = delete;
+    ~EventAwaiter_s();
+
+    B8_t await_ready() const noexcept
+    { //
+        return false;
+    }
+    void       await_suspend(std::coroutine_handle<TaskPromise_t> handle);
+    EventArg_t await_resume() const noexcept
+    { //
+        return m_data;
+    }
+
+  private:
+    static void onEvent(EventArg_t eventData, EventArg_t listenerData);
+
+  private:
+    Event_t                   m_event;
+    EventArg_t                m_data{};
+    ListenerHandle_t          m_listener = nullListenerHandle;
+    TaskScheduler_s::Waiter_t m_waiter{};
+};
+
+/** @fn nextEvent
+ *  @brief resumes the task at the update following the dispatch of the next event of the given type, returning
+ *  its payload. Owned `EventComplexArg_t` payloads are freed by the dispatch, hence must not be awaited
+ */
+inline EventAwaiter_s nextEvent(Event_t event)
+{ //
+    return EventAwaiter_s{ event };
+}
+
+/// @struct awaitable of @ref jobDone
+struct JobAwaiter_t
+{
+    B8_t await_ready() const noexcept
+    { //
+        return counter->pending.load(std::memory_order_acquire) == 0;
+    }
+    void await_suspend(std::coroutine_handle<TaskPromise_t> handle) const
+    { //
+        g_taskScheduler.wakeOnJob(*counter, { .handle = handle, .task = handle.promise().task });
+    }
+    void await_resume() const noexcept
+    {
+    }
+
+    JobCounter_t const *counter;
+};
+
+/** @fn jobDone
+ *  @brief resumes the task at the first update after the jobs submitted with the counter have completed. Unlike
+ *  @ref JobSystem::wait the main thread keeps running frames in the meantime
+ */
+inline JobAwaiter_t jobDone(JobCounter_t const &counter)
+{ //
+    return { .counter = &counter };
+}
+
+} // namespace cge
@@ -0,0 +1,218 @@
+#pragma once
+
+/**
+ * @ref core
+ * @file Core/TimeSlice.h
+ * incremental execution of work too long for a single frame, such as loading a mesh file or rasterizing a font,
+ * on the main thread. A work item is a callable doing a bounded step of its work per call and returning its
+ * progress. Once per frame @ref TimeSliceScheduler_s::run calls steps, highest priority first, until the frame
+ * budget measured with @ref hiResTimer is spent, so a long job spreads over frames instead of causing a hitch.
+ * Unlike the @ref JobSystem this needs no spare core, and the steps may issue graphics API calls
+ */
+
+#include "Core/Alloc.h"
+#include "Core/Module.h"
+#include "Core/Type.h"
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cge
+{
+
+inline U64_t constexpr timeSliceDefaultBudget    = 2'000'000; ///< nanoseconds per frame
+inline U32_t constexpr timeSliceStarvationFrames = 15;        ///< frames an item may wait before getting a step anyway
+
+enum class EWorkPriority_t : U32_t
+{
+    eHigh = 0,
+    eNormal,
+    eLow,
+    eWorkPriorityCount
+};
+
+/// @struct value returned by each step of a work item, in units of the item's choice. Done when `done >= total`
+struct WorkProgress_t
+{
+    U32_t done;
+    U32_t total;
+
+    [[nodiscard]] B8_t finished() const
+    { //
+        return done >= total;
+    }
+    [[nodiscard]] F32_t fraction() const
+    { //
+        return total ? static_cast<F32_t>(done) / static_cast<F32_t>(total) : 1.f;
+    }
+};
+
+/** @struct WorkHandle_t
+ * @brief returned by @ref TimeSliceScheduler_s::submit, same scheme as @ref ListenerHandle_t: a stale handle is
+ * recognized and ignored, and a zeroed one is null
+ */
+struct WorkHandle_t
+{
+    U32_t slot;
+    U32_t generation;
+};
+
+inline WorkHandle_t constexpr nullWorkHandle{ .slot = 0, .generation = 0 };
+
+/** @class TimeSliceScheduler_s
+ * @brief main thread only. Items of the same priority run in submission order, each until it finishes or the
+ * budget is spent, so that the oldest completes first. An item which got no step for the last
+ * `starvationFrames` frames gets one at the start of the next frame, whatever its priority and the budget
+ */
+class TimeSliceScheduler_s
+{
+  public:
+    TimeSliceScheduler_s();
+    TimeSliceScheduler_s(TimeSliceScheduler_s const &)            = delete;
+    TimeSliceScheduler_s &operator=(TimeSliceScheduler_s const &) = delete;
+    ~TimeSliceScheduler_s();
+
+    /** @fn submit
+     *  @brief queues a work item. `step` is moved in the memory pool and called as `WorkProgress_t step()` until
+     *  the progress is finished, then destroyed. `name` must have static storage duration, as literals do. An item
+     *  submitted by a step gets its first step in the next @ref run, unless finished
+     */
+    template<typename F> WorkHandle_t submit(Char8_t const *name, EWorkPriority_t priority, F &&step);
+
+    /** @fn cancel
+     *  @brief destroys the item without calling it anymore. Null, stale and completed handles are ignored
+     */
+    void cancel(WorkHandle_t handle);
+
+    /** @fn finish
+     *  @brief runs the remaining steps of the item now, regardless of the budget, for when its result is needed
+     *  immediately
+     */
+    void finish(WorkHandle_t handle);
+
+    [[nodiscard]] B8_t isPending(WorkHandle_t handle) const;
+
+    /** @fn progress
+     *  @brief progress returned by the last step of the item, { 0, 0 } if it has completed, has been cancelled
+     *  or the handle is null, which counts as finished
+     */
+    [[nodiscard]] WorkProgress_t progress(WorkHandle_t handle) const;
+
+    /** @fn run
+     *  @brief called once per frame by the main loop: steps the starving items, then the others by priority until
+     *  the budget is spent. At least one step runs per frame if any item is queued
+     */
+    void run();
+
+    /** @fn shutdown
+     *  @brief destroys the items not yet completed
+     */
+    void shutdown();
+
+    void setBudget(U64_t nanoseconds);
+    void setStarvationFrames(U32_t frames);
+
+    /** @fn initFromEnvironment
+     *  @brief sets the budget from CGE_TIMESLICE_BUDGET_US, in microseconds, if defined
+     */
+    void initFromEnvironment();
+
+    /// @fn lastRunTime nanoseconds spent in the steps of the last @ref run
+    [[nodiscard]] U64_t lastRunTime() const
+    { //
+        return m_lastRunTime;
+    }
+    [[nodiscard]] U32_t itemCount() const
+    { //
+        return m_itemCount;
+    }
+
+    /** @fn printItems
+     *  @brief logs, at info level, name, priority, progress, steps, frames and time spent of each queued item
+     */
+    void printItems() const;
+
+  private:
+    struct Item_t
+    {
+        Char8_t const *name    = nullptr;
+        void          *closure = nullptr;
+        WorkProgress_t (*invoke)(void *closure)  = nullptr;
+        void (*destroy)(void *closure)           = nullptr;
+        U32_t           closureSize              = 0;
+        U32_t           closureAlign             = 0;
+        WorkProgress_t  progress{};
+        EWorkPriority_t priority     = EWorkPriority_t::eNormal;
+        U32_t           generation   = 1;
+        U32_t           nextFree     = 0;
+        U32_t           steps        = 0;
+        U32_t           frames       = 0; ///< frames in which the item got at least a step
+        U32_t           waitedFrames = 0; ///< consecutive frames without a step
+        U64_t           lastFrame    = 0; ///< last frame in which the item got a step
+        U64_t           firstFrame   = 0; ///< last frame run before the submission
+        U64_t           ticks        = 0; ///< @ref hiResTimer ticks spent in its steps
+        B8_t            running      = false;
+        B8_t            cancelled    = false;
+    };
+
+    /// the handle is kept, rather than the slot, as a slot freed during a run may be reused by a new item
+    struct OrderEntry_t
+    {
+        WorkHandle_t    handle;
+        EWorkPriority_t priority;
+    };
+
+    static U32_t constexpr invalidSlot = 0xffff'ffffU;
+
+  private:
+    WorkHandle_t enqueue(
+      Char8_t const  *name,
+      EWorkPriority_t priority,
+      void           *closure,
+      U32_t           closureSize,
+      U32_t           closureAlign,
+      WorkProgress_t (*invoke)(void *closure),
+      void (*destroy)(void *closure));
+    /// returns false if the item is gone, either completed or cancelled meanwhile
+    B8_t step(U32_t slotIndex);
+    void release(U32_t slotIndex);
+    void insertOrder(OrderEntry_t const &entry);
+    void compactOrder();
+
+  private:
+    std::pmr::vector<Item_t> m_items{ getMemoryPool(EMemoryTag_t::eTimeSlice) };
+    std::pmr::vector<OrderEntry_t> m_order{ getMemoryPool(EMemoryTag_t::eTimeSlice) }; ///< by priority, then age
+    std::pmr::vector<OrderEntry_t> m_submitted{ getMemoryPool(EMemoryTag_t::eTimeSlice) }; ///< by steps of this run
+    U32_t                          m_freeSlot         = invalidSlot;
+    U32_t                          m_itemCount        = 0;
+    U32_t                          m_starvationFrames = timeSliceStarvationFrames;
+    U64_t                          m_budget           = timeSliceDefaultBudget;
+    U64_t                          m_budgetTicks      = 0; ///< computed on first run, after the TSC calibration
+    U64_t                          m_frame            = 0;
+    U64_t                          m_lastRunTime      = 0;
+    U64_t                          m_lastStepEnd      = 0; ///< saves a timer read per step on the budget check
+    B8_t                           m_running          = false;
+};
+
+extern TimeSliceScheduler_s g_timeSliceScheduler;
+
+template<typename F> WorkHandle_t TimeSliceScheduler_s::submit(Char8_t const *name, EWorkPriority_t priority, F &&step)
+{
+    using Func_t = std::decay_t<F>;
+    static_assert(std::is_invocable_r_v<WorkProgress_t, Func_t &>, "[TimeSlice] a step must return WorkProgress_t");
+
+    void *closure = getMemoryPool(EMemoryTag_t::eTimeSlice)->allocate(sizeof(Func_t), alignof(Func_t));
+    new (closure) Func_t(std::forward<F>(step));
+    return enqueue(
+      name,
+      priority,
+      closure,
+      sizeof(Func_t),
+      alignof(Func_t),
+      [](void *c) -> WorkProgress_t { return (*std::launder(static_cast<Func_t *>(c)))(); },
+      [](void *c) { std::destroy_at(std::launder(static_cast<Func_t *>(c))); });
+}
+
+} // namespace cge
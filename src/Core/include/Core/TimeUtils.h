@@ -47,28 +47,42 @@ inline U64_t hiResTimer()
     CGE_unreachable();
 }
 
+/// @struct relation between @ref hiResTimer and the monotonic clock of the OS, measured once at startup
+struct HiResCalibration_t
+{
+    U64_t frequency;   ///< ticks per second
+    U64_t ticks;       ///< value of the timer at the time of the calibration
+    U64_t nanoseconds; ///< value of the monotonic clock at the same instant
+    B8_t  invariant;   ///< whether the tick rate is constant across power states and cores
+};
+
+/**
+ * @fn hiResCalibration.
+ * @brief on x86 the time-stamp counter runs at a fixed rate which the OS
+ * doesn't expose, so the first call measures it against CLOCK_MONOTONIC over
+ * a few milliseconds. Call it at startup to keep that out of the first frame
+ */
+HiResCalibration_t const &hiResCalibration();
+
 /**
  * @fn hiResFrequency.
  * @brief gets an unsigned integer which corresponts to the number of increments
  * of the time-stamp counter given by the current hardware in a single second
  */
 inline U64_t hiResFrequency()
-{
-#if defined(CGE_PLATFORM_WINDOWS)
-    LARGE_INTEGER li;
-    QueryPerformanceFrequency(&li);
-    return static_cast<U64_t>(li.QuadPart);
-#elif defined(CGE_PLATFORM_LINUX)
-    struct timespec res
-    {
-    };
-    clock_getres(CLOCK_MONOTONIC, &res);
-
-    // Convert to frequency (1 / delta time)
-    return static_cast<U64_t>(1e9 / (double)res.tv_nsec);
-#endif
+{ //
+    return hiResCalibration().frequency;
+}
 
-    CGE_unreachable();
+/**
+ * @fn hiResToNanoseconds.
+ * @brief converts a difference of @ref hiResTimer values to nanoseconds,
+ * without overflowing for any realistic uptime
+ */
+inline U64_t hiResToNanoseconds(U64_t ticks)
+{
+    U64_t const frequency = hiResFrequency();
+    return ticks / frequency * 1'000'000'000ULL + ticks % frequency * 1'000'000'000ULL / frequency;
 }
 
 inline U32_t constexpr timeUnit32       = 3000U;
@@ -0,0 +1,120 @@
+#pragma once
+
+/**
+ * @ref core
+ * @file Core/Transform.h
+ * compact transforms for scene nodes. `Affine3x4_t` keeps the 3 meaningful rows of an affine `glm::mat4` (48 bytes
+ * instead of 64), and `TRS_t` a rotation quaternion, a translation and a scale. Both are composed, inverted and
+ * applied to points with SSE, and convert to and from `glm::mat4` where the renderer or glm need one
+ */
+
+#include "Core/Cpu.h"
+#include "Core/Type.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <span>
+
+namespace cge
+{
+
+/** @struct Affine3x4_t
+ * @brief rows of an affine transform: `rows[i]` holds the i-th row of the linear part in xyz and the i-th
+ * component of the translation in w. The last row of the equivalent `glm::mat4` is always (0, 0, 0, 1), hence the
+ * conversions are exact
+ */
+struct alignas(16) Affine3x4_t
+{
+    static Affine3x4_t identity();
+
+    /** @fn fromMat4
+     *  @brief the matrix must be affine, i.e. with (0, 0, 0, 1) as last row. Asserted in debug
+     */
+    static Affine3x4_t fromMat4(glm::mat4 const &m);
+
+    glm::mat4 toMat4() const;
+    glm::vec3 translation() const;
+
+    B8_t operator==(Affine3x4_t const &other) const;
+
+    glm::vec4 rows[3];
+};
+static_assert(sizeof(Affine3x4_t) == 48 && std::is_trivially_copyable_v<Affine3x4_t>);
+
+/** @struct TRS_t
+ * @brief scale, then rotation, then translation. Compositions and inverses are exact as long as the scales
+ * involved are uniform; with a non uniform scale under a rotation the result would need a shear, which only
+ * `Affine3x4_t` can represent
+ */
+struct alignas(16) TRS_t
+{
+    /** @fn fromMat4
+     *  @brief decomposes a matrix made of a rotation, a scale and a translation, with no shear. A negative
+     *  determinant is accounted to the scale on x
+     */
+    static TRS_t fromMat4(glm::mat4 const &m);
+
+    glm::mat4   toMat4() const;
+    Affine3x4_t toAffine() const;
+
+    glm::quat rotation{ 1.f, 0.f, 0.f, 0.f }; ///< unit quaternion
+    glm::vec3 translation{ 0.f };
+    F32_t     translationPadding = 0.f; ///< so that each vector is a single aligned load
+    glm::vec3 scale{ 1.f };
+    F32_t     scalePadding = 0.f;
+};
+static_assert(sizeof(TRS_t) == 48);
+
+/** @fn compose
+ *  @brief `a * b`, i.e. `b` applied first
+ */
+Affine3x4_t compose(Affine3x4_t const &a, Affine3x4_t const &b);
+TRS_t       compose(TRS_t const &a, TRS_t const &b);
+
+/** @fn compose
+ *  @brief `m * a` as a `glm::mat4`, for the model view and model view projection matrices of a node, with `m`
+ *  computed once per frame
+ */
+glm::mat4 compose(glm::mat4 const &m, Affine3x4_t const &a);
+
+/** @fn composeAffines
+ *  @brief `out[i] = parent * locals[i]`, the update of the children of a node, with @ref g_composeAffinesKernel
+ */
+void composeAffines(Affine3x4_t const &parent, std::span<Affine3x4_t const> locals, std::span<Affine3x4_t> out);
+
+/// @fn composeAffinesScalar reference kernel, same results of the vector ones
+void composeAffinesScalar(Affine3x4_t const &parent, std::span<Affine3x4_t const> locals, std::span<Affine3x4_t> out);
+
+/// @fn composeAffinesSSE one @ref compose per child
+void composeAffinesSSE(Affine3x4_t const &parent, std::span<Affine3x4_t const> locals, std::span<Affine3x4_t> out);
+
+/// @fn composeAffinesAVX the first two rows of each result in a single vector. The CPU must support AVX
+void composeAffinesAVX(Affine3x4_t const &parent, std::span<Affine3x4_t const> locals, std::span<Affine3x4_t> out);
+
+/// @fn composeAffinesAVX512 a whole result in a single vector. The CPU must support AVX-512F
+void composeAffinesAVX512(Affine3x4_t const &parent, std::span<Affine3x4_t const> locals, std::span<Affine3x4_t> out);
+
+using ComposeAffinesFunc_t = void (*)(Affine3x4_t const &, std::span<Affine3x4_t const>, std::span<Affine3x4_t>);
+
+/// @var g_composeAffinesKernel the kernels above, as dispatched by @ref composeAffines
+extern Kernel_s<ComposeAffinesFunc_t> const g_composeAffinesKernel;
+
+/** @fn inverse
+ *  @brief the linear part must be invertible
+ */
+Affine3x4_t inverse(Affine3x4_t const &a);
+TRS_t       inverse(TRS_t const &t);
+
+glm::vec3 transformPoint(Affine3x4_t const &a, glm::vec3 const &p);
+glm::vec3 transformPoint(TRS_t const &t, glm::vec3 const &p);
+
+/// @fn transformVector as @ref transformPoint, ignoring the translation
+glm::vec3 transformVector(Affine3x4_t const &a, glm::vec3 const &v);
+glm::vec3 transformVector(TRS_t const &t, glm::vec3 const &v);
+
+/** @fn lerp
+ *  @brief component wise blend, as done for the interpolation between simulation steps
+ */
+Affine3x4_t lerp(Affine3x4_t const &a, Affine3x4_t const &b, F32_t alpha);
+
+} // namespace cge
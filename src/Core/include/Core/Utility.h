@@ -1,7 +1,10 @@
 #pragma once
 
+#include "Core/Cpu.h"
 #include "Core/Type.h"
 
+#include <span>
+
 namespace cge
 {
 
@@ -28,6 +31,7 @@ struct Hit_t
 
 union AABB
 {
+    AABB() : mm{} {}
     AABB(glm::vec3 const &min_, glm::vec3 const &max_) : mm(min_, max_) {}
 
     struct S
@@ -45,6 +49,50 @@ B8_t testOverlap(Ray const &ray, AABB const &box);
 
 Hit_t intersect(Ray const &ray, AABB const &box);
 
+inline U32_t constexpr aabbBatchWidth = 8;
+
+/** @struct AABBBatch_t
+ * @brief up to `aabbBatchWidth` boxes in structure of arrays layout, so that a coordinate of all of them is one
+ * vector load. Lanes not set are empty boxes, which are never hit
+ */
+struct alignas(32) AABBBatch_t
+{
+    AABBBatch_t();
+
+    void clear();
+    void set(U32_t lane, AABB const &box);
+
+    F32_t min[3][aabbBatchWidth];
+    F32_t max[3][aabbBatchWidth];
+};
+
+/// @struct result of a ray against an @ref AABBBatch_t, lanes as in the batch
+struct alignas(32) BatchHit_t
+{
+    F32_t t[aabbBatchWidth]; ///< as @ref Hit_t::t, -1 for the lanes which weren't hit
+    U32_t mask;              ///< bit i set if box i was hit
+};
+
+/** @fn intersect
+ *  @brief tests the ray against all the boxes of the batch with the widest kernel the CPU supports. Results are
+ *  bitwise equal to the ones of @ref intersect on each box, which debug builds assert
+ */
+BatchHit_t intersect(Ray const &ray, AABBBatch_t const &batch);
+
+/// @fn intersectScalar reference kernel, one box at a time
+BatchHit_t intersectScalar(Ray const &ray, AABBBatch_t const &batch);
+
+/// @fn intersectSSE two groups of 4 boxes
+BatchHit_t intersectSSE(Ray const &ray, AABBBatch_t const &batch);
+
+/// @fn intersectAVX2 all 8 boxes at once. The CPU must support AVX2
+BatchHit_t intersectAVX2(Ray const &ray, AABBBatch_t const &batch);
+
+using BatchIntersectFunc_t = BatchHit_t (*)(Ray const &ray, AABBBatch_t const &batch);
+
+/// @var g_intersectKernel the kernels above, as dispatched by @ref intersect
+extern Kernel_s<BatchIntersectFunc_t> const g_intersectKernel;
+
 AABB aUnion(AABB const &a, AABB const &b);
 
 // 00 -> x, 01 -> y, 10 -> z
@@ -58,6 +106,48 @@ glm::vec3 diagonal(AABB const &b);
 
 B8_t isPointInsideAABB(glm::vec3 const &point, AABB const &box);
 
+/** @fn transformAABB
+ *  @brief bounds of the box transformed by the matrix, with Arvo's method: the center is transformed as a point and
+ *  the half extents by the absolute value of the matrix. The same bounds as transforming the 8 corners, as the w
+ *  component is ignored in both cases, for a fraction of the work
+ */
+AABB transformAABB(AABB const &box, glm::mat4 const &transform);
+
+/** @fn transformAABBs
+ *  @brief @ref transformAABB of `boxes[i]` by `transforms[i]`, for all the boxes, with @ref g_transformAABBsKernel.
+ *  All spans have the same size, and `out` may be `boxes`
+ */
+void transformAABBs(std::span<AABB const> boxes, std::span<glm::mat4 const> transforms, std::span<AABB> out);
+
+/// @fn transformAABBsScalar reference kernel, same results of the vector ones and of @ref transformAABB
+void transformAABBsScalar(std::span<AABB const> boxes, std::span<glm::mat4 const> transforms, std::span<AABB> out);
+
+/// @fn transformAABBsSSE groups of 4 boxes, a coordinate of all of them per vector
+void transformAABBsSSE(std::span<AABB const> boxes, std::span<glm::mat4 const> transforms, std::span<AABB> out);
+
+/// @fn transformAABBsAVX groups of 8 boxes. The CPU must support AVX
+void transformAABBsAVX(std::span<AABB const> boxes, std::span<glm::mat4 const> transforms, std::span<AABB> out);
+
+using TransformAABBsFunc_t = void (*)(std::span<AABB const>, std::span<glm::mat4 const>, std::span<AABB>);
+
+/// @var g_transformAABBsKernel the kernels above, as dispatched by @ref transformAABBs
+extern Kernel_s<TransformAABBsFunc_t> const g_transformAABBsKernel;
+
+inline F32_t constexpr ndcMinW = 1e-5F; ///< clip space w below which a point counts as behind the camera
+
+/** @fn transformAABBsToNDC
+ *  @brief NDC bounds of `boxes[i]` transformed by `viewProjection * models[i]`. The 8 clip space corners are the
+ *  transformed center plus or minus the transformed half axes. Parts of a box behind the camera are clipped away,
+ *  and boxes entirely behind it come out empty (min +inf, max -inf), overlapping nothing. All spans have the same
+ *  size
+ */
+void transformAABBsToNDC(
+  std::span<AABB const>      boxes,
+  std::span<glm::mat4 const> models,
+  glm::mat4 const           &viewProjection,
+  std::span<AABB>            out);
+
+/// @fn transformAABBToNDC @ref transformAABBsToNDC of a single box
 AABB transformAABBToNDC(AABB const &aabb, glm::mat4 const &model, glm::mat4 const &view, glm::mat4 const &projection);
 
 } // namespace cge
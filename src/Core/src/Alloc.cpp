@@ -0,0 +1,612 @@
+#include "Alloc.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdio>
+
+#if defined(CGE_PLATFORM_WINDOWS)
+#include <windows.h>
+#elif defined(CGE_PLATFORM_LINUX)
+#include <sys/mman.h>
+#endif
+
+namespace cge
+{
+
+// -- StackAllocator --
+
+// m_top packs the offset of the top of the stack, the count of blocks allocated from the region and not yet
+// deallocated, and a flag set when the stack is cleared or rewound while some of them are live. A block of a
+// previous generation may match the top of the new one, so deallocation doesn't rewind while the flag is set,
+// that is until the live count drops to zero
+static U64_t constexpr stackOffsetBits = 32;
+static U64_t constexpr stackOffsetMask = (1ULL << stackOffsetBits) - 1;
+static U64_t constexpr stackBlockUnit  = 1ULL << stackOffsetBits;
+static U64_t constexpr stackStaleFlag  = 1ULL << 63;
+static U64_t constexpr stackBlockMask  = ~stackOffsetMask & ~stackStaleFlag;
+
+static U64_t stackOffset(U64_t top)
+{ //
+    return top & stackOffsetMask;
+}
+
+static U64_t stackBlocks(U64_t top)
+{ //
+    return (top & stackBlockMask) >> stackOffsetBits;
+}
+
+StackAllocator::StackAllocator(Byte_t *base, U64_t capacity, std::pmr::memory_resource *upstream)
+{
+    init(base, capacity, upstream);
+}
+
+void StackAllocator::init(Byte_t *base, U64_t capacity, std::pmr::memory_resource *upstream)
+{
+    assert(capacity <= stackOffsetMask && "[StackAllocator] region too large");
+    m_base     = base;
+    m_capacity = capacity;
+    m_upstream = upstream ? upstream : std::pmr::new_delete_resource();
+    m_top.store(0, std::memory_order_relaxed);
+    m_highWater.store(0, std::memory_order_relaxed);
+    m_overflow.store(0, std::memory_order_relaxed);
+}
+
+U64_t StackAllocator::marker() const
+{ //
+    return stackOffset(m_top.load(std::memory_order_acquire));
+}
+
+void StackAllocator::rewind(U64_t marker)
+{
+    assert(marker <= m_capacity && "[StackAllocator] invalid marker");
+    U64_t top = m_top.load(std::memory_order_relaxed);
+    U64_t next;
+    do
+    {
+        next = (top & ~stackOffsetMask) | marker | (stackBlocks(top) != 0 ? stackStaleFlag : 0);
+    } while (!m_top.compare_exchange_weak(top, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+}
+
+void StackAllocator::clear()
+{ //
+    rewind(0);
+}
+
+B8_t StackAllocator::owns(void const *ptr) const
+{
+    auto const *p = static_cast<Byte_t const *>(ptr);
+    return p >= m_base && p < m_base + m_capacity;
+}
+
+ArenaSlotStats_t StackAllocator::stats() const
+{
+    return { .capacity  = m_capacity,
+             .used      = stackOffset(m_top.load(std::memory_order_relaxed)),
+             .highWater = m_highWater.load(std::memory_order_relaxed),
+             .overflow  = m_overflow.load(std::memory_order_relaxed) };
+}
+
+void *StackAllocator::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    U64_t const base  = reinterpret_cast<U64_t>(m_base);
+    U64_t       top   = m_top.load(std::memory_order_relaxed);
+    U64_t       next  = 0;
+    U64_t       start = 0;
+    do
+    {
+        start = ((base + stackOffset(top) + alignment - 1) & ~(alignment - 1)) - base;
+        next  = start + bytes;
+        if (next > m_capacity)
+        {
+            if (m_overflow.fetch_add(bytes, std::memory_order_relaxed) == 0)
+            {
+                printf("[StackAllocator] region of %zu bytes exhausted, falling back to upstream\n", m_capacity);
+            }
+            return m_upstream->allocate(bytes, alignment);
+        }
+    } while (!m_top.compare_exchange_weak(
+      top, (top & ~stackOffsetMask) + stackBlockUnit + next, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    U64_t highWater = m_highWater.load(std::memory_order_relaxed);
+    while (next > highWater
+           && !m_highWater.compare_exchange_weak(highWater, next, std::memory_order_relaxed))
+    {
+    }
+
+    return m_base + start;
+}
+
+void StackAllocator::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment)
+{
+    if (!owns(ptr))
+    {
+        m_upstream->deallocate(ptr, bytes, alignment);
+        return;
+    }
+
+    // rewind only if the block is the top of the stack, otherwise the memory is reclaimed on clear
+    U64_t const start = static_cast<U64_t>(static_cast<Byte_t *>(ptr) - m_base);
+    U64_t       top   = m_top.load(std::memory_order_relaxed);
+    U64_t       next;
+    do
+    {
+        assert(stackBlocks(top) != 0 && "[StackAllocator] block deallocated twice");
+        next = top - stackBlockUnit;
+        if (stackBlocks(next) == 0)
+        { // no block of a previous generation is left
+            next &= ~stackStaleFlag;
+        }
+        if (!(top & stackStaleFlag) && stackOffset(top) == start + bytes)
+        {
+            next = (next & ~stackOffsetMask) | start;
+        }
+    } while (!m_top.compare_exchange_weak(top, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+}
+
+B8_t StackAllocator::do_is_equal(std::pmr::memory_resource const &other) const noexcept
+{ //
+    return this == &other;
+}
+
+// -- DoubleBufferedAllocator --
+
+void DoubleBufferedAllocator::init(Byte_t *base0, Byte_t *base1, U64_t capacity, std::pmr::memory_resource *upstream)
+{
+    m_stacks[0].init(base0, capacity, upstream);
+    m_stacks[1].init(base1, capacity, upstream);
+    m_curStack = 0;
+}
+
+void DoubleBufferedAllocator::swapBuffers()
+{ //
+    m_curStack ^= 1U;
+}
+
+void DoubleBufferedAllocator::clearCurrentBuffer()
+{ //
+    m_stacks[m_curStack].clear();
+}
+
+U32_t DoubleBufferedAllocator::currentBuffer() const
+{ //
+    return m_curStack;
+}
+
+StackAllocator &DoubleBufferedAllocator::buffer(U32_t index)
+{ //
+    return m_stacks[index & 1U];
+}
+
+StackAllocator const &DoubleBufferedAllocator::buffer(U32_t index) const
+{ //
+    return m_stacks[index & 1U];
+}
+
+void *DoubleBufferedAllocator::do_allocate(std::size_t bytes, std::size_t alignment)
+{ //
+    return m_stacks[m_curStack].allocate(bytes, alignment);
+}
+
+void DoubleBufferedAllocator::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment)
+{
+    // memory allocated during the previous frame can still be freed in this one
+    U32_t const index = m_stacks[m_curStack ^ 1U].owns(ptr) ? m_curStack ^ 1U : m_curStack;
+    m_stacks[index].deallocate(ptr, bytes, alignment);
+}
+
+B8_t DoubleBufferedAllocator::do_is_equal(std::pmr::memory_resource const &other) const noexcept
+{ //
+    return this == &other;
+}
+
+// -- EngineArena_s --
+
+static Byte_t *reserveArena(U64_t size, EPageKind_t *pageKind)
+{
+#if defined(CGE_PLATFORM_LINUX)
+    // huge page mappings must not use MAP_NORESERVE: without a reservation an exhausted huge page pool
+    // is reported as SIGBUS on first touch instead of as a failure here
+    I32_t constexpr protection = PROT_READ | PROT_WRITE;
+    I32_t constexpr flags      = MAP_PRIVATE | MAP_ANONYMOUS;
+    void *ptr                  = MAP_FAILED;
+
+#if defined(MAP_HUGE_1GB)
+    ptr = mmap(nullptr, size, protection, flags | MAP_HUGETLB | MAP_HUGE_1GB, -1, 0);
+    if (ptr != MAP_FAILED)
+    {
+        *pageKind = EPageKind_t::eHuge1GB;
+        return static_cast<Byte_t *>(ptr);
+    }
+#endif
+
+    ptr = mmap(nullptr, size, protection, flags | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED)
+    {
+        *pageKind = EPageKind_t::eHuge2MB;
+        return static_cast<Byte_t *>(ptr);
+    }
+
+    ptr = mmap(nullptr, size, protection, flags | MAP_NORESERVE, -1, 0);
+    if (ptr == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    *pageKind = madvise(ptr, size, MADV_HUGEPAGE) == 0 ? EPageKind_t::eTransparent : EPageKind_t::eRegular;
+    return static_cast<Byte_t *>(ptr);
+#elif defined(CGE_PLATFORM_WINDOWS)
+    // large pages require the SeLockMemoryPrivilege, which is seldom granted
+    if (U64_t const largePage = GetLargePageMinimum(); largePage != 0 && size % largePage == 0)
+    {
+        void *ptr = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (ptr)
+        {
+            *pageKind = EPageKind_t::eHuge2MB;
+            return static_cast<Byte_t *>(ptr);
+        }
+    }
+
+    *pageKind = EPageKind_t::eRegular;
+    return static_cast<Byte_t *>(VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+#else
+#error "[EngineArena] no virtual memory reservation for this platform"
+#endif
+}
+
+EngineArena_s::EngineArena_s()
+{
+    m_base = reserveArena(arenaReservationSize, &m_pageKind);
+    if (!m_base)
+    { // every slot will forward to the global heap
+        printf("[EngineArena] could not reserve %zu bytes\n", arenaReservationSize);
+        m_pageKind = EPageKind_t::eRegular;
+    }
+
+    U64_t const capacity = m_base ? arenaSlotSize : 0;
+    auto        slotBase = [this](EArenaSlot_t slot) -> Byte_t *
+    { return m_base ? m_base + static_cast<U64_t>(slot) * arenaSlotSize : nullptr; };
+
+    std::pmr::memory_resource *upstream = std::pmr::new_delete_resource();
+    m_persistent.init(slotBase(EArenaSlot_t::ePersistent), capacity, upstream);
+    m_frame.init(slotBase(EArenaSlot_t::eFrame0), slotBase(EArenaSlot_t::eFrame1), capacity, upstream);
+    m_level.init(slotBase(EArenaSlot_t::eLevel), capacity, upstream);
+
+    // the reservation is intentionally never released: the OS reclaims it at exit, and function static
+    // objects destroyed after this one could still hand memory back to the slots
+}
+
+StackAllocator &EngineArena_s::persistent()
+{ //
+    return m_persistent;
+}
+
+DoubleBufferedAllocator &EngineArena_s::frame()
+{ //
+    return m_frame;
+}
+
+StackAllocator &EngineArena_s::level()
+{ //
+    return m_level;
+}
+
+EPageKind_t EngineArena_s::pageKind() const
+{ //
+    return m_pageKind;
+}
+
+ArenaSlotStats_t EngineArena_s::stats(EArenaSlot_t slot) const
+{
+    switch (slot)
+    {
+    case EArenaSlot_t::ePersistent:
+        return m_persistent.stats();
+    case EArenaSlot_t::eFrame0:
+        return m_frame.buffer(0).stats();
+    case EArenaSlot_t::eFrame1:
+        return m_frame.buffer(1).stats();
+    case EArenaSlot_t::eLevel:
+        return m_level.stats();
+    default:
+        return {};
+    }
+}
+
+void EngineArena_s::printStats() const
+{
+    static Char8_t const *const slotNames[] = { "Persistent", "Frame0", "Frame1", "Level" };
+    static Char8_t const *const pageNames[]  = { "1 GB huge", "2 MB huge", "transparent huge", "regular" };
+
+    printf("[EngineArena] backed by %s pages\n", pageNames[static_cast<U32_t>(m_pageKind)]);
+    for (U32_t i = 0; i != static_cast<U32_t>(EArenaSlot_t::eArenaSlotCount); ++i)
+    {
+        ArenaSlotStats_t const s = stats(static_cast<EArenaSlot_t>(i));
+        printf(
+          "[EngineArena] \t%-10s used: %10zu, high-water: %10zu / %10zu, overflow: %zu\n",
+          slotNames[i],
+          s.used,
+          s.highWater,
+          s.capacity,
+          s.overflow);
+    }
+}
+
+// -- SlabPool --
+
+// a free block stores the next block of its batch in the first word and, if it is the first block of a
+// batch in the global free-list, the next batch in the second word
+static Byte_t *&nextBlock(Byte_t *block)
+{ //
+    return reinterpret_cast<Byte_t **>(block)[0];
+}
+
+static std::atomic_ref<Byte_t *> nextBatch(Byte_t *block)
+{ //
+    return std::atomic_ref<Byte_t *>(reinterpret_cast<Byte_t **>(block)[1]);
+}
+
+/// reads @ref nextBatch of a block which may have been popped and reused meanwhile, its new owner writing it. Slabs
+/// are never unmapped, so the read is harmless, and the tag makes the compare-and-swap of the caller fail
+CGE_no_sanitize_thread static Byte_t *speculativeNextBatch(Byte_t *block)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return nextBatch(block).load(std::memory_order_relaxed);
+#else
+    // the builtin rather than std::atomic_ref, whose out of line load would be instrumented
+    return __atomic_load_n(reinterpret_cast<Byte_t **>(block) + 1, __ATOMIC_RELAXED);
+#endif
+}
+
+static U64_t constexpr slabPointerMask = (1ULL << 48) - 1;
+static U64_t constexpr slabTagUnit     = 1ULL << 48;
+static U32_t constexpr slabMinShift    = std::countr_zero(slabMinBlockSize);
+
+static U64_t blockSizeOf(U32_t sizeClass)
+{ //
+    return slabMinBlockSize << sizeClass;
+}
+
+struct SlabThreadCache_s
+{
+    ~SlabThreadCache_s()
+    { // give back the blocks of an exiting thread
+        if (!owner)
+        {
+            return;
+        }
+        for (U32_t i = 0; i != slabClassCount; ++i)
+        {
+            if (heads[i])
+            {
+                owner->pushBatch(i, heads[i], counts[i]);
+                heads[i]  = nullptr;
+                counts[i] = 0;
+            }
+        }
+
+        // static objects destroyed after the thread locals of the main thread use the global free-lists
+        owner   = nullptr;
+        retired = true;
+    }
+
+    SlabPool *owner                   = nullptr;
+    Byte_t   *heads[slabClassCount]  = {};
+    U32_t     counts[slabClassCount] = {};
+    B8_t      retired                = false;
+};
+
+// only the first pool used by a thread is cached, the others go through the global free-lists
+static thread_local SlabThreadCache_s s_slabCache;
+
+SlabPool::SlabPool(std::pmr::memory_resource *upstream, std::pmr::memory_resource *large)
+    : m_upstream(upstream), m_large(large)
+{
+}
+
+void SlabPool::pushBatch(U32_t sizeClass, Byte_t *first, U32_t count)
+{
+    FreeList_t &list = m_freeLists[sizeClass];
+    U64_t       head = list.head.load(std::memory_order_relaxed);
+    U64_t       next = 0;
+    do
+    {
+        nextBatch(first).store(reinterpret_cast<Byte_t *>(head & slabPointerMask), std::memory_order_relaxed);
+        next = reinterpret_cast<U64_t>(first) | ((head & ~slabPointerMask) + slabTagUnit);
+    } while (!list.head.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+    list.freeCount.fetch_add(count, std::memory_order_relaxed);
+}
+
+Byte_t *SlabPool::popBatch(U32_t sizeClass)
+{
+    FreeList_t &list  = m_freeLists[sizeClass];
+    U64_t       head  = list.head.load(std::memory_order_acquire);
+    Byte_t     *first = nullptr;
+    U64_t       next  = 0;
+    do
+    {
+        first = reinterpret_cast<Byte_t *>(head & slabPointerMask);
+        if (!first)
+        {
+            return nullptr;
+        }
+
+        Byte_t *const second = speculativeNextBatch(first);
+        next                 = reinterpret_cast<U64_t>(second) | ((head & ~slabPointerMask) + slabTagUnit);
+    } while (!list.head.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire));
+    return first;
+}
+
+Byte_t *SlabPool::refill(SlabThreadCache_s &cache, U32_t sizeClass)
+{
+    FreeList_t &list = m_freeLists[sizeClass];
+    Byte_t     *head = popBatch(sizeClass);
+    if (head)
+    {
+        U32_t count = 0;
+        for (Byte_t *block = head; block; block = nextBlock(block))
+        {
+            ++count;
+        }
+        list.freeCount.fetch_sub(count, std::memory_order_relaxed);
+        cache.heads[sizeClass]  = head;
+        cache.counts[sizeClass] = count;
+        return head;
+    }
+
+    // the global free-list is empty: carve a new slab. The first batch goes to the cache, the others to the
+    // global free-list
+    U64_t const   blockSize = blockSizeOf(sizeClass);
+    U64_t const   numBlocks = slabSize / blockSize;
+    Byte_t *const slab      = static_cast<Byte_t *>(m_upstream->allocate(slabSize, 4096));
+    list.slabCount.fetch_add(1, std::memory_order_relaxed);
+    for (U64_t batch = 0; batch != numBlocks / slabBatchSize; ++batch)
+    {
+        Byte_t *const first = slab + batch * slabBatchSize * blockSize;
+        for (U32_t i = 0; i != slabBatchSize - 1; ++i)
+        {
+            nextBlock(first + i * blockSize) = first + (i + 1) * blockSize;
+        }
+        nextBlock(first + (slabBatchSize - 1) * blockSize) = nullptr;
+
+        if (batch == 0)
+        {
+            cache.heads[sizeClass]  = first;
+            cache.counts[sizeClass] = slabBatchSize;
+        }
+        else
+        {
+            pushBatch(sizeClass, first, slabBatchSize);
+        }
+    }
+    return slab;
+}
+
+void *SlabPool::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    U64_t const size = std::max({ bytes, alignment, slabMinBlockSize });
+    if (size > slabMaxBlockSize)
+    {
+        m_largeCount.fetch_add(1, std::memory_order_relaxed);
+        return m_large->allocate(bytes, alignment);
+    }
+
+    U32_t const        sizeClass = std::bit_width(size - 1) - slabMinShift;
+    SlabThreadCache_s &cache     = s_slabCache;
+    if (!cache.owner && !cache.retired)
+    {
+        cache.owner = this;
+    }
+
+    if (cache.owner != this) [[unlikely]]
+    { // take one block out of a batch and give back the rest
+        SlabThreadCache_s temp;
+        Byte_t *const     block = refill(temp, sizeClass);
+        if (Byte_t *const rest = nextBlock(block); rest)
+        {
+            pushBatch(sizeClass, rest, temp.counts[sizeClass] - 1);
+        }
+        return block;
+    }
+
+    Byte_t *block = cache.heads[sizeClass];
+    if (!block)
+    {
+        block = refill(cache, sizeClass);
+    }
+    cache.heads[sizeClass] = nextBlock(block);
+    --cache.counts[sizeClass];
+    return block;
+}
+
+void SlabPool::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment)
+{
+    U64_t const size = std::max({ bytes, alignment, slabMinBlockSize });
+    if (size > slabMaxBlockSize)
+    {
+        m_largeCount.fetch_sub(1, std::memory_order_relaxed);
+        m_large->deallocate(ptr, bytes, alignment);
+        return;
+    }
+
+    U32_t const        sizeClass = std::bit_width(size - 1) - slabMinShift;
+    Byte_t *const      block     = static_cast<Byte_t *>(ptr);
+    SlabThreadCache_s &cache     = s_slabCache;
+    if (!cache.owner && !cache.retired)
+    {
+        cache.owner = this;
+    }
+
+    if (cache.owner != this) [[unlikely]]
+    {
+        nextBlock(block) = nullptr;
+        pushBatch(sizeClass, block, 1);
+        return;
+    }
+
+    nextBlock(block)       = cache.heads[sizeClass];
+    cache.heads[sizeClass] = block;
+    if (++cache.counts[sizeClass] < 2 * slabBatchSize)
+    {
+        return;
+    }
+
+    // the cache grew too much: move its first batch to the global free-list
+    Byte_t *tail = block;
+    for (U32_t i = 0; i != slabBatchSize - 1; ++i)
+    {
+        tail = nextBlock(tail);
+    }
+    cache.heads[sizeClass] = nextBlock(tail);
+    cache.counts[sizeClass] -= slabBatchSize;
+    nextBlock(tail) = nullptr;
+    pushBatch(sizeClass, block, slabBatchSize);
+}
+
+B8_t SlabPool::do_is_equal(std::pmr::memory_resource const &other) const noexcept
+{ //
+    return this == &other;
+}
+
+SlabClassStats_t SlabPool::stats(U32_t sizeClass) const
+{
+    FreeList_t const &list       = m_freeLists[sizeClass];
+    U64_t const       blockSize  = blockSizeOf(sizeClass);
+    U64_t const       slabCount  = list.slabCount.load(std::memory_order_relaxed);
+    U64_t const       capacity   = slabCount * (slabSize / blockSize);
+    U64_t const       globalFree = list.freeCount.load(std::memory_order_relaxed);
+    return { .blockSize  = blockSize,
+             .slabCount  = slabCount,
+             .capacity   = capacity,
+             .globalFree = globalFree,
+             .used       = capacity - std::min(capacity, globalFree) };
+}
+
+U64_t SlabPool::largeCount() const
+{ //
+    return m_largeCount.load(std::memory_order_relaxed);
+}
+
+void SlabPool::printStats() const
+{
+    for (U32_t i = 0; i != slabClassCount; ++i)
+    {
+        SlabClassStats_t const s = stats(i);
+        printf(
+          "[SlabPool] \t%4zu bytes: slabs: %4zu, used: %8zu / %8zu blocks, global free: %8zu\n",
+          s.blockSize,
+          s.slabCount,
+          s.used,
+          s.capacity,
+          s.globalFree);
+    }
+    printf("[SlabPool] \tlarge allocations alive: %zu\n", m_largeCount.load(std::memory_order_relaxed));
+}
+
+EngineArena_s &getEngineArena()
+{
+    static EngineArena_s g_engineArena;
+    return g_engineArena;
+}
+
+} // namespace cge
@@ -0,0 +1,375 @@
+#include "Alloc.h"
+
+#if defined(CGE_DEBUG)
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(CGE_PLATFORM_WINDOWS)
+#include <windows.h>
+#elif defined(CGE_PLATFORM_LINUX)
+#include <execinfo.h>
+#endif
+
+namespace cge
+{
+
+// -- TrackingResource --
+
+void TrackingResource::init(Char8_t const *name, std::pmr::memory_resource *upstream)
+{
+    m_name     = name;
+    m_upstream = upstream;
+}
+
+Char8_t const *TrackingResource::name() const
+{ //
+    return m_name;
+}
+
+MemoryTagStats_t TrackingResource::stats() const
+{
+    return { .bytes     = m_bytes.load(std::memory_order_relaxed),
+             .peakBytes = m_peakBytes.load(std::memory_order_relaxed),
+             .count     = m_count.load(std::memory_order_relaxed),
+             .liveCount = m_liveCount.load(std::memory_order_relaxed) };
+}
+
+void *TrackingResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    U64_t const current = m_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    U64_t       peak    = m_peakBytes.load(std::memory_order_relaxed);
+    while (current > peak && !m_peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+    {
+    }
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_liveCount.fetch_add(1, std::memory_order_relaxed);
+    return m_upstream->allocate(bytes, alignment);
+}
+
+void TrackingResource::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment)
+{
+    m_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    m_liveCount.fetch_sub(1, std::memory_order_relaxed);
+    m_upstream->deallocate(ptr, bytes, alignment);
+}
+
+B8_t TrackingResource::do_is_equal(std::pmr::memory_resource const &other) const noexcept
+{ //
+    return this == &other;
+}
+
+// -- allocation guard --
+
+static U32_t constexpr guardStackDepth    = 8;
+static U32_t constexpr guardCallSiteCount = 256; // power of two
+
+struct GuardCallSite_t
+{
+    U64_t hash;
+    void *frames[guardStackDepth];
+    I32_t depth;
+    U32_t count;
+    U64_t bytes;
+};
+
+// everything is statically allocated, as the guard runs inside operator new
+static B8_t              s_guardEnabled     = false;
+static U32_t             s_warmupFrames     = 0;
+static U32_t             s_frame            = 0;
+static U32_t             s_guardedFrames    = 0;
+static std::atomic<B8_t> s_guardArmed{ false };
+static std::atomic_flag  s_callSiteLock = ATOMIC_FLAG_INIT;
+static GuardCallSite_t   s_callSites[guardCallSiteCount];
+static U64_t             s_droppedCallSites = 0;
+static thread_local B8_t s_insideGuard      = false;
+
+static I32_t captureStack(void **frames)
+{
+#if defined(CGE_PLATFORM_LINUX)
+    return backtrace(frames, guardStackDepth);
+#elif defined(CGE_PLATFORM_WINDOWS)
+    return CaptureStackBackTrace(0, guardStackDepth, frames, nullptr);
+#endif
+}
+
+static void recordAllocation(U64_t bytes)
+{
+    if (s_insideGuard)
+    {
+        return;
+    }
+    s_insideGuard = true;
+
+    void       *frames[guardStackDepth];
+    I32_t const depth = captureStack(frames);
+    U64_t       hash  = 0xcbf29ce484222325ULL; // FNV-1a over the return addresses
+    for (I32_t i = 0; i != depth; ++i)
+    {
+        hash = (hash ^ reinterpret_cast<U64_t>(frames[i])) * 0x100000001b3ULL;
+    }
+    hash |= 1; // 0 marks an empty slot
+
+    while (s_callSiteLock.test_and_set(std::memory_order_acquire))
+    {
+    }
+    U32_t slot = static_cast<U32_t>(hash) & (guardCallSiteCount - 1);
+    U32_t i    = 0;
+    for (; i != guardCallSiteCount; ++i, slot = (slot + 1) & (guardCallSiteCount - 1))
+    {
+        GuardCallSite_t &site = s_callSites[slot];
+        if (site.hash == 0)
+        {
+            site.hash  = hash;
+            site.depth = depth;
+            for (I32_t f = 0; f != depth; ++f)
+            {
+                site.frames[f] = frames[f];
+            }
+        }
+        if (site.hash == hash)
+        {
+            ++site.count;
+            site.bytes += bytes;
+            break;
+        }
+    }
+    if (i == guardCallSiteCount)
+    {
+        ++s_droppedCallSites;
+    }
+    s_callSiteLock.clear(std::memory_order_release);
+
+    s_insideGuard = false;
+}
+
+void dbg_allocGuardInit()
+{
+    Char8_t const *value = std::getenv("CGE_ALLOC_GUARD");
+    if (!value)
+    {
+        return;
+    }
+
+    Char8_t    *end    = nullptr;
+    U64_t const frames = std::strtoul(value, &end, 10);
+    s_warmupFrames     = end != value ? static_cast<U32_t>(frames) : 120;
+    s_guardEnabled     = true;
+
+    // the first stack capture may allocate while loading the unwinder, do it before arming
+    void *frameBuf[guardStackDepth];
+    captureStack(frameBuf);
+    printf("[AllocGuard] recording heap allocations inside onTick after %u warm-up frames\n", s_warmupFrames);
+}
+
+void dbg_allocGuardBeginTick()
+{
+    if (s_guardEnabled && ++s_frame > s_warmupFrames)
+    {
+        ++s_guardedFrames;
+        s_guardArmed.store(true, std::memory_order_relaxed);
+    }
+}
+
+void dbg_allocGuardEndTick()
+{ //
+    s_guardArmed.store(false, std::memory_order_relaxed);
+}
+
+void dbg_allocGuardReport()
+{
+    if (!s_guardEnabled)
+    {
+        return;
+    }
+
+    U64_t totalCount = 0;
+    U32_t siteCount  = 0;
+    for (GuardCallSite_t const &site : s_callSites)
+    {
+        if (site.hash == 0)
+        {
+            continue;
+        }
+        totalCount += site.count;
+        ++siteCount;
+        fprintf(stderr, "[AllocGuard] %u allocations, %zu bytes from:\n", site.count, site.bytes);
+        fflush(stderr);
+#if defined(CGE_PLATFORM_LINUX)
+        backtrace_symbols_fd(site.frames, site.depth, 2);
+#else
+        for (I32_t f = 0; f != site.depth; ++f)
+        {
+            fprintf(stderr, "\t%p\n", site.frames[f]);
+        }
+#endif
+    }
+
+    fprintf(
+      stderr,
+      "[AllocGuard] %zu allocations from %u call sites in %u frames (%zu call sites dropped)\n",
+      totalCount,
+      siteCount,
+      s_guardedFrames,
+      s_droppedCallSites);
+}
+
+} // namespace cge
+
+// replaceable global allocation functions. Every form is replaced, so that none of them reaches the default
+// implementations, which would skip the guard and, on Windows, pair the aligned forms with a different heap
+namespace cge
+{
+
+static void *guardedAllocate(std::size_t bytes, std::size_t alignment) noexcept
+{
+    bytes = bytes ? bytes : 1;
+    void *ptr = nullptr;
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        ptr = std::malloc(bytes);
+    }
+    else
+    {
+#if defined(CGE_PLATFORM_WINDOWS)
+        ptr = _aligned_malloc(bytes, alignment);
+#else
+        // aligned_alloc requires a size multiple of the alignment
+        ptr = std::aligned_alloc(alignment, (bytes + alignment - 1) & ~(alignment - 1));
+#endif
+    }
+    if (ptr && s_guardArmed.load(std::memory_order_relaxed)) [[unlikely]]
+    {
+        recordAllocation(bytes);
+    }
+    return ptr;
+}
+
+static void *guardedAllocateOrAbort(std::size_t bytes, std::size_t alignment) noexcept
+{
+    void *ptr = guardedAllocate(bytes, alignment);
+    if (!ptr)
+    {
+        fprintf(stderr, "[AllocGuard] out of memory allocating %zu bytes\n", bytes);
+        std::abort();
+    }
+    return ptr;
+}
+
+static void guardedFree(void *ptr, std::size_t alignment) noexcept
+{
+#if defined(CGE_PLATFORM_WINDOWS)
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        _aligned_free(ptr);
+        return;
+    }
+#endif
+    (void)alignment;
+    std::free(ptr);
+}
+
+} // namespace cge
+
+void *operator new(std::size_t bytes)
+{ //
+    return cge::guardedAllocateOrAbort(bytes, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new[](std::size_t bytes)
+{ //
+    return cge::guardedAllocateOrAbort(bytes, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(std::size_t bytes, std::align_val_t alignment)
+{ //
+    return cge::guardedAllocateOrAbort(bytes, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t bytes, std::align_val_t alignment)
+{ //
+    return cge::guardedAllocateOrAbort(bytes, static_cast<std::size_t>(alignment));
+}
+
+void *operator new(std::size_t bytes, std::nothrow_t const &) noexcept
+{ //
+    return cge::guardedAllocate(bytes, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new[](std::size_t bytes, std::nothrow_t const &) noexcept
+{ //
+    return cge::guardedAllocate(bytes, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(std::size_t bytes, std::align_val_t alignment, std::nothrow_t const &) noexcept
+{ //
+    return cge::guardedAllocate(bytes, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t bytes, std::align_val_t alignment, std::nothrow_t const &) noexcept
+{ //
+    return cge::guardedAllocate(bytes, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept
+{ //
+    cge::guardedFree(ptr, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete[](void *ptr) noexcept
+{ //
+    cge::guardedFree(ptr, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete(void *ptr, [[maybe_unused]] std::size_t bytes) noexcept
+{ //
+    cge::guardedFree(ptr, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete[](void *ptr, [[maybe_unused]] std::size_t bytes) noexcept
+{ //
+    cge::guardedFree(ptr, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete(void *ptr, std::align_val_t alignment) noexcept
+{ //
+    cge::guardedFree(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void *ptr, std::align_val_t alignment) noexcept
+{ //
+    cge::guardedFree(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *ptr, [[maybe_unused]] std::size_t bytes, std::align_val_t alignment) noexcept
+{ //
+    cge::guardedFree(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void *ptr, [[maybe_unused]] std::size_t bytes, std::align_val_t alignment) noexcept
+{ //
+    cge::guardedFree(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *ptr, std::nothrow_t const &) noexcept
+{ //
+    cge::guardedFree(ptr, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete[](void *ptr, std::nothrow_t const &) noexcept
+{ //
+    cge::guardedFree(ptr, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete(void *ptr, std::align_val_t alignment, std::nothrow_t const &) noexcept
+{ //
+    cge::guardedFree(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void *ptr, std::align_val_t alignment, std::nothrow_t const &) noexcept
+{ //
+    cge::guardedFree(ptr, static_cast<std::size_t>(alignment));
+}
+
+#endif // CGE_DEBUG
@@ -0,0 +1,202 @@
+#include "Cpu.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace cge
+{
+
+static void cpuid(U32_t leaf, U32_t subleaf, U32_t (&regs)[4])
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (U32_t i = 0; i != 4; ++i)
+    { //
+        regs[i] = static_cast<U32_t>(r[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+/// register state the OS saves on context switches. Only to be called if OSXSAVE is set
+static U64_t xgetbv0()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    U32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<U64_t>(edx) << 32) | eax;
+#endif
+}
+
+static U64_t constexpr featureBit(ECpuFeature_t feature)
+{ //
+    return 1ULL << static_cast<U32_t>(feature);
+}
+
+static U64_t constexpr featureBits(std::initializer_list<ECpuFeature_t> features)
+{
+    U64_t bits = 0;
+    for (ECpuFeature_t feature : features)
+    { //
+        bits |= featureBit(feature);
+    }
+    return bits;
+}
+
+using enum ECpuFeature_t;
+
+// features required by each level, on top of the ones of the previous levels
+static U64_t constexpr s_isaFeatures[static_cast<U32_t>(EIsa_t::eIsaCount)]{
+    0,
+    featureBits({ eSSE2 }),
+    featureBits({ eSSE3, eSSSE3, eSSE41, eSSE42, ePOPCNT, ePCLMUL }),
+    featureBits({ eAVX, eFMA, eAVX2, eBMI2 }),
+    featureBits({ eAVX512F, eAVX512DQ, eAVX512BW, eAVX512VL }),
+};
+
+static Char8_t const *const s_isaNames[static_cast<U32_t>(EIsa_t::eIsaCount)]{
+    "scalar", "sse2", "sse4.2", "avx2", "avx512"
+};
+
+static CpuInfo_t detectCpu()
+{
+    CpuInfo_t info{};
+    U32_t     regs[4];
+    cpuid(0, 0, regs);
+    U32_t const maxLeaf = regs[0];
+    std::memcpy(info.vendor, &regs[1], 4);
+    std::memcpy(info.vendor + 4, &regs[3], 4);
+    std::memcpy(info.vendor + 8, &regs[2], 4);
+
+    cpuid(0x8000'0000U, 0, regs);
+    if (regs[0] >= 0x8000'0004U)
+    {
+        for (U32_t i = 0; i != 3; ++i)
+        {
+            cpuid(0x8000'0002U + i, 0, regs);
+            std::memcpy(info.brand + 16 * i, regs, sizeof(regs));
+        }
+    }
+
+    cpuid(1, 0, regs);
+    U32_t const ecx1    = regs[2];
+    U32_t const edx1    = regs[3];
+    U32_t       ebx7    = 0;
+    if (maxLeaf >= 7)
+    {
+        cpuid(7, 0, regs);
+        ebx7 = regs[1];
+    }
+
+    // AVX registers are usable only if the OS saves them: YMM needs the SSE and AVX state, ZMM the opmask and
+    // the two halves of the upper ZMM registers too
+    U64_t const xcr0 = (ecx1 & (1U << 27)) ? xgetbv0() : 0;
+    B8_t const  ymm  = (xcr0 & 0x06) == 0x06;
+    B8_t const  zmm  = (xcr0 & 0xe6) == 0xe6;
+
+    struct Bit_t
+    {
+        ECpuFeature_t feature;
+        U32_t         reg;
+        U32_t         bit;
+        B8_t          usable;
+    };
+    Bit_t const bits[]{
+        { eSSE2, edx1, 26, true },      { eSSE3, ecx1, 0, true },       { eSSSE3, ecx1, 9, true },
+        { eSSE41, ecx1, 19, true },     { eSSE42, ecx1, 20, true },     { ePOPCNT, ecx1, 23, true },
+        { ePCLMUL, ecx1, 1, true },     { eAVX, ecx1, 28, ymm },        { eFMA, ecx1, 12, ymm },
+        { eAVX2, ebx7, 5, ymm },        { eBMI2, ebx7, 8, true },       { eAVX512F, ebx7, 16, zmm },
+        { eAVX512DQ, ebx7, 17, zmm },   { eAVX512BW, ebx7, 30, zmm },   { eAVX512VL, ebx7, 31, zmm },
+    };
+    for (Bit_t const &bit : bits)
+    {
+        if (bit.usable && (bit.reg & (1U << bit.bit)))
+        {
+            info.features |= featureBit(bit.feature);
+        }
+    }
+
+    U64_t required = 0;
+    for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+    {
+        required |= s_isaFeatures[isa];
+        if ((info.features & required) != required)
+        {
+            break;
+        }
+        info.isa = static_cast<EIsa_t>(isa);
+    }
+    return info;
+}
+
+CpuInfo_t const &cpuInfo()
+{
+    static CpuInfo_t const s_info = detectCpu();
+    return s_info;
+}
+
+B8_t cpuSupports(ECpuFeature_t feature)
+{ //
+    return cpuInfo().features & featureBit(feature);
+}
+
+B8_t cpuSupports(EIsa_t isa)
+{ //
+    return static_cast<U32_t>(isa) <= static_cast<U32_t>(cpuInfo().isa);
+}
+
+static EIsa_t isaFromEnvironment()
+{
+    EIsa_t const   detected = cpuInfo().isa;
+    Char8_t const *limit    = std::getenv("CGE_ISA");
+    if (!limit)
+    {
+        return detected;
+    }
+
+    for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+    {
+        if (std::strcmp(limit, s_isaNames[isa]) == 0)
+        { //
+            return static_cast<U32_t>(detected) < isa ? detected : static_cast<EIsa_t>(isa);
+        }
+    }
+    printf("[Cpu] unknown CGE_ISA %s, using %s\n", limit, isaName(detected));
+    return detected;
+}
+
+EIsa_t dispatchIsa()
+{
+    static EIsa_t const s_isa = isaFromEnvironment();
+    return s_isa;
+}
+
+Char8_t const *isaName(EIsa_t isa)
+{ //
+    return isa < EIsa_t::eIsaCount ? s_isaNames[static_cast<U32_t>(isa)] : "unknown";
+}
+
+void printCpuInfo()
+{
+    CpuInfo_t const &info  = cpuInfo();
+    Char8_t const   *brand = info.brand;
+    while (*brand == ' ')
+    { //
+        ++brand;
+    }
+    printf(
+      "[Cpu] %s %s, supports %s, kernels use %s\n", info.vendor, brand, isaName(info.isa), isaName(dispatchIsa()));
+}
+
+} // namespace cge
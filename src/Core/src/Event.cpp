@@ -1,65 +1,664 @@
 #include "Event.h"
 
-#include <cstring>
-#include <tuple>
+#include "Alloc.h"
+#include "Log.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
 
 namespace cge
 {
 
 EventQueue_t g_eventQueue;
 
+static U32_t constexpr initialQueueCapacity = 256; // power of two
+static U32_t constexpr consumerIndex        = 0xffff'ffffU;
+
+/** @struct EventStagingBuffer_t
+ * @brief single producer single consumer ring of events emitted by a thread other than the dispatching one
+ */
+struct alignas(64) EventStagingBuffer_t
+{
+    struct Entry_t
+    {
+        Event_t    event;
+        U32_t      ticket;
+        EventArg_t data;
+    };
+
+    alignas(64) std::atomic<U32_t> head{ 0 }; ///< written by the consumer
+    alignas(64) std::atomic<U32_t> tail{ 0 }; ///< written by the producer
+    std::atomic<B8_t> owned{ true };          ///< cleared when the producer thread exits, so that it can be reused
+    Entry_t           entries[eventStagingCapacity];
+};
+
+/// @struct identity of the calling thread for an event queue: consumer, or owner of a staging buffer
+struct EventProducer_t
+{
+    void set(EventQueue_t const *q, U32_t i, EventStagingBuffer_t *b)
+    {
+        queue  = q;
+        index  = i;
+        buffer = b;
+    }
+
+    ~EventProducer_t()
+    {
+        if (buffer)
+        { // staged events are still merged, the buffer is handed to the next thread which needs one
+            buffer->owned.store(false, std::memory_order_release);
+        }
+    }
+
+    EventQueue_t const   *queue  = nullptr;
+    U32_t                 index  = 0;
+    EventStagingBuffer_t *buffer = nullptr;
+};
+
+static thread_local EventProducer_t s_eventProducer;
+
+static void coalesce(EventArg_t &queued, EventArg_t const &emitted, ECoalescePolicy_t policy)
+{
+    if (policy == ECoalescePolicy_t::eKeepLast)
+    {
+        queued = emitted;
+        return;
+    }
+
+    for (U32_t i = 0; i != 2; ++i)
+    {
+        queued.idata.i32[i] += emitted.idata.i32[i];
+    }
+    for (U32_t i = 0; i != 4; ++i)
+    {
+        queued.fdata.f32[i] += emitted.fdata.f32[i];
+    }
+}
+
+EventQueue_t::EventQueue_t()
+{ //
+    std::fill(std::begin(m_wheel), std::end(m_wheel), invalidIndex);
+}
+
+EventQueue_t::~EventQueue_t()
+{
+    // producers must have been joined by now
+    for (std::atomic<EventStagingBuffer_t *> &producer : m_producers)
+    {
+        if (EventStagingBuffer_t *buffer = producer.load(std::memory_order_acquire); buffer)
+        {
+            buffer->~EventStagingBuffer_t();
+            getMemoryPool(EMemoryTag_t::eEvents)
+              ->deallocate(buffer, sizeof(EventStagingBuffer_t), alignof(EventStagingBuffer_t));
+        }
+    }
+}
+
 EErr_t EventQueue_t::init()
 {
-    m_multimap.reserve(256);
+    m_listIndices.reserve(64);
+    m_lists.reserve(64);
+    m_slots.reserve(256);
+    if (m_queue.empty())
+    {
+        m_queue.resize(initialQueueCapacity);
+    }
+    s_eventProducer.set(this, consumerIndex, nullptr);
     return EErr_t::eSuccess;
 }
 
+U32_t EventQueue_t::listIndex(Event_t event)
+{
+    auto const [it, wasInserted] = m_listIndices.try_emplace(event, static_cast<U32_t>(m_lists.size()));
+    if (wasInserted)
+    {
+        m_lists.emplace_back();
+    }
+    return it->second;
+}
+
+void EventQueue_t::growQueue()
+{
+    // rehash the ring in a buffer twice as big, keeping head and tail so that pending positions stay valid
+    U32_t const                     capacity = static_cast<U32_t>(m_queue.size());
+    U32_t const                     count    = m_tail - m_head;
+    std::pmr::vector<QueuedEvent_t> queue(capacity ? capacity << 1 : initialQueueCapacity, m_queue.get_allocator());
+    U32_t const                     mask = static_cast<U32_t>(queue.size()) - 1;
+    for (U32_t i = 0; i != count; ++i)
+    {
+        queue[(m_head + i) & mask] = m_queue[(m_head + i) & (capacity - 1)];
+    }
+    m_queue.swap(queue);
+}
+
 EErr_t EventQueue_t::dispatch()
 {
-    for (; !m_queue.empty(); m_queue.pop())
+    CGE_PROFILE_SCOPE("EventQueue::dispatch");
+    m_lastDroppedCount = m_droppedCount.exchange(0, std::memory_order_relaxed);
+    if (m_lastDroppedCount != 0)
+    {
+        CGE_LOG_WARNING(Core, "[EventQueue] %u events dropped, staging buffers full", m_lastDroppedCount);
+    }
+
+    mergeStagedEvents();
+    m_dispatching = true;
+    do
     {
-        auto const& [event, eventData] = m_queue.front();
-        auto const range               = m_multimap.equal_range(event);
-        for (auto it = range.first; it != range.second; ++it)
+        while (m_head != m_tail)
         {
-            it->second.listenerFunc(eventData, it->second.listenerData);
+            // copy, as listeners may emit and grow the queue
+            QueuedEvent_t const event = m_queue[m_head & (m_queue.size() - 1)];
+            ++m_head;
+
+            // index based, as listeners may add listeners and grow the lists
+            U32_t const count = static_cast<U32_t>(m_lists[event.list].listeners.size());
+            for (U32_t i = 0; i != count; ++i)
+            {
+                Listener_t const &listener = m_lists[event.list].listeners[i];
+                if (listener.func)
+                {
+                    listener.func(event.data, listener.data);
+                }
+            }
+
+            ListenerList_t &listenerList = m_lists[event.list];
+            if (listenerList.batchListenerCount != 0)
+            {
+                if (listenerList.batch.empty())
+                {
+                    m_batchedLists.push_back(event.list);
+                }
+                listenerList.batch.push_back(event.data);
+            }
         }
+
+        // batch listeners may emit in turn
+        flushBatches();
+    } while (m_head != m_tail);
+    m_dispatching = false;
+
+    for (U32_t const slot : m_pendingRemovals)
+    {
+        eraseListener(slot);
     }
+    m_pendingRemovals.clear();
     return EErr_t::eSuccess;
 }
 
+void EventQueue_t::flushBatches()
+{
+    for (U32_t const list : m_batchedLists)
+    {
+        // moved out, as batch listeners may add listeners and grow the lists
+        m_batchScratch.swap(m_lists[list].batch);
+        std::span<EventArg_t const> const batch{ m_batchScratch };
+
+        U32_t const count = static_cast<U32_t>(m_lists[list].listeners.size());
+        for (U32_t i = 0; i != count; ++i)
+        {
+            Listener_t const &listener = m_lists[list].listeners[i];
+            if (listener.batchFunc)
+            {
+                listener.batchFunc(batch, listener.data);
+            }
+        }
+        m_batchScratch.clear();
+    }
+    m_batchedLists.clear();
+}
+
+EventStagingBuffer_t *EventQueue_t::stagingBuffer()
+{
+    if (s_eventProducer.queue == this)
+    {
+        return s_eventProducer.buffer;
+    }
+
+    // first emission from this thread, adopt the buffer of an exited thread or claim a new one
+    U32_t const producerCount = std::min(m_producerCount.load(std::memory_order_acquire), eventMaxProducers);
+    for (U32_t i = 0; i != producerCount; ++i)
+    {
+        EventStagingBuffer_t *buffer = m_producers[i].load(std::memory_order_acquire);
+        B8_t                  owned  = false;
+        if (buffer && buffer->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+        {
+            s_eventProducer.set(this, i, buffer);
+            return buffer;
+        }
+    }
+
+    U32_t const index = m_producerCount.fetch_add(1, std::memory_order_relaxed);
+    if (index >= eventMaxProducers)
+    {
+        CGE_LOG_WARNING(
+          Core, "[EventQueue] more than %u threads emitting events, further events are dropped", eventMaxProducers);
+        s_eventProducer.set(this, index, nullptr);
+        return nullptr;
+    }
+
+    // the memory pool is thread safe, the engine arena isn't
+    void *memory = getMemoryPool(EMemoryTag_t::eEvents)
+                     ->allocate(sizeof(EventStagingBuffer_t), alignof(EventStagingBuffer_t));
+    EventStagingBuffer_t *buffer = new (memory) EventStagingBuffer_t();
+    m_producers[index].store(buffer, std::memory_order_release);
+    s_eventProducer.set(this, index, buffer);
+    return buffer;
+}
+
 EErr_t EventQueue_t::emit(Event_t event, EventArg_t eventData)
 {
-    m_queue.emplace(event, eventData);
+    U32_t const ticket = m_ticket.fetch_add(1, std::memory_order_relaxed);
+    if (s_eventProducer.queue == this && s_eventProducer.index == consumerIndex)
+    {
+        U32_t const     list         = listIndex(event);
+        ListenerList_t &listenerList = m_lists[list];
+        if (listenerList.policy != ECoalescePolicy_t::eKeepAll)
+        {
+            U32_t const pending = listenerList.pending;
+            if (pending - m_head < m_tail - m_head && m_queue[pending & (m_queue.size() - 1)].list == list)
+            { // an event of the same type is still queued
+                coalesce(m_queue[pending & (m_queue.size() - 1)].data, eventData, listenerList.policy);
+                return EErr_t::eSuccess;
+            }
+            listenerList.pending = m_tail;
+        }
+
+        if (m_tail - m_head == m_queue.size())
+        {
+            growQueue();
+        }
+
+        m_queue[m_tail & (m_queue.size() - 1)] = { .list = list, .ticket = ticket, .data = eventData };
+        ++m_tail;
+        return EErr_t::eSuccess;
+    }
+
+    EventStagingBuffer_t *buffer = stagingBuffer();
+    if (!buffer)
+    {
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return EErr_t::eMemory;
+    }
+
+    U32_t const tail = buffer->tail.load(std::memory_order_relaxed);
+    if (tail - buffer->head.load(std::memory_order_acquire) == eventStagingCapacity)
+    {
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return EErr_t::eMemory;
+    }
+
+    buffer->entries[tail & (eventStagingCapacity - 1)] = { .event = event, .ticket = ticket, .data = eventData };
+    buffer->tail.store(tail + 1, std::memory_order_release);
     return EErr_t::eSuccess;
 }
 
-static U64_t bytesSid(EventArg_t obj)
+void EventQueue_t::mergeStagedEvents()
+{
+    // k-way merge by ticket of the events queued by this thread and of each staging buffer, all already sorted
+    U32_t const producerCount = std::min(m_producerCount.load(std::memory_order_acquire), eventMaxProducers);
+    EventStagingBuffer_t *buffers[eventMaxProducers];
+    U32_t                 heads[eventMaxProducers];
+    U32_t                 tails[eventMaxProducers];
+    U32_t                 stagedCount = 0;
+    for (U32_t i = 0; i != producerCount; ++i)
+    {
+        buffers[i] = m_producers[i].load(std::memory_order_acquire);
+        if (!buffers[i])
+        { // claimed but not yet published
+            heads[i] = tails[i] = 0;
+            continue;
+        }
+        heads[i] = buffers[i]->head.load(std::memory_order_relaxed);
+        tails[i] = buffers[i]->tail.load(std::memory_order_acquire);
+        stagedCount += tails[i] - heads[i];
+    }
+    if (stagedCount == 0)
+    {
+        return;
+    }
+
+    // events of coalesced types are merged again, as the staged ones weren't. Pending positions of the lists
+    // found in the sequence are rewritten as indices of the merge buffer, those of the others point nowhere valid
+    auto const append = [this](QueuedEvent_t const &event) {
+        ListenerList_t &listenerList = m_lists[event.list];
+        if (listenerList.policy != ECoalescePolicy_t::eKeepAll)
+        {
+            U32_t const pending = listenerList.pending;
+            if (pending < m_mergeBuffer.size() && m_mergeBuffer[pending].list == event.list)
+            {
+                coalesce(m_mergeBuffer[pending].data, event.data, listenerList.policy);
+                return;
+            }
+            listenerList.pending = static_cast<U32_t>(m_mergeBuffer.size());
+        }
+        m_mergeBuffer.push_back(event);
+    };
+
+    m_mergeBuffer.clear();
+    m_mergeBuffer.reserve(stagedCount + (m_tail - m_head));
+    U32_t const mask = static_cast<U32_t>(m_queue.size()) - 1;
+    for (;;)
+    {
+        I32_t minProducer = -1; // -1 = queue of this thread
+        U32_t minTicket   = 0;
+        B8_t  found       = m_head != m_tail;
+        if (found)
+        {
+            minTicket = m_queue[m_head & mask].ticket;
+        }
+        for (U32_t i = 0; i != producerCount; ++i)
+        {
+            if (heads[i] == tails[i])
+            {
+                continue;
+            }
+            U32_t const ticket = buffers[i]->entries[heads[i] & (eventStagingCapacity - 1)].ticket;
+            if (!found || static_cast<I32_t>(ticket - minTicket) < 0) // wrap around safe comparison
+            {
+                found       = true;
+                minProducer = static_cast<I32_t>(i);
+                minTicket   = ticket;
+            }
+        }
+        if (!found)
+        {
+            break;
+        }
+
+        if (minProducer < 0)
+        {
+            append(m_queue[m_head & mask]);
+            ++m_head;
+        }
+        else
+        {
+            auto const &entry = buffers[minProducer]->entries[heads[minProducer] & (eventStagingCapacity - 1)];
+            append({ .list = listIndex(entry.event), .ticket = entry.ticket, .data = entry.data });
+            ++heads[minProducer];
+        }
+    }
+
+    for (U32_t i = 0; i != producerCount; ++i)
+    {
+        if (buffers[i])
+        {
+            buffers[i]->head.store(heads[i], std::memory_order_release);
+        }
+    }
+
+    // the queue is now empty, refill it with the merged sequence
+    m_head = m_tail = 0;
+    while (m_queue.size() < m_mergeBuffer.size())
+    {
+        growQueue();
+    }
+    for (QueuedEvent_t const &event : m_mergeBuffer)
+    {
+        m_queue[m_tail++] = event;
+    }
+}
+
+U32_t EventQueue_t::droppedEvents() const
+{ //
+    return m_lastDroppedCount;
+}
+
+ListenerHandle_t EventQueue_t::addListener(Event_t event, EventFunc_t listener, EventArg_t listenerData)
+{ //
+    return insertListener(event, { .func = listener, .batchFunc = nullptr, .data = listenerData, .batched = false });
+}
+
+ListenerHandle_t EventQueue_t::addBatchListener(Event_t event, EventBatchFunc_t listener, EventArg_t listenerData)
+{ //
+    return insertListener(event, { .func = nullptr, .batchFunc = listener, .data = listenerData, .batched = true });
+}
+
+void EventQueue_t::setCoalescePolicy(Event_t event, ECoalescePolicy_t policy)
+{
+    assert(policy < ECoalescePolicy_t::eCoalescePolicyCount);
+    ListenerList_t &listenerList = m_lists[listIndex(event)];
+    listenerList.policy          = policy;
+    listenerList.pending         = invalidIndex;
+}
+
+ListenerHandle_t EventQueue_t::insertListener(Event_t event, Listener_t const &listener)
 {
-    static U64_t constexpr size = sizeof(EventArg_t);
-    Char8_t memory[size + 1];
-    std::memcpy(memory, &obj, size);
-    memory[size] = '\0';
-    return hashCRC64(memory);
+    if (m_slots.empty())
+    { // slot 0 is never handed out, so that the zeroed handle is null
+        m_slots.push_back({ .generation = 1, .list = invalidIndex, .position = invalidIndex });
+    }
+
+    U32_t const list = listIndex(event);
+    U32_t       slot = m_freeSlot;
+    if (slot != invalidIndex)
+    {
+        m_freeSlot = m_slots[slot].list;
+    }
+    else
+    {
+        slot = static_cast<U32_t>(m_slots.size());
+        m_slots.push_back({ .generation = 1, .list = invalidIndex, .position = invalidIndex });
+    }
+
+    ListenerList_t &listenerList = m_lists[list];
+    m_slots[slot].list           = list;
+    m_slots[slot].position       = static_cast<U32_t>(listenerList.listeners.size());
+    listenerList.listeners.push_back(listener);
+    listenerList.slots.push_back(slot);
+    listenerList.batchListenerCount += listener.batched;
+
+    return { .slot = slot, .generation = m_slots[slot].generation };
 }
 
-EventDataSidPair EventQueue_t::addListener(Event_t event, EventFunc_t listener, EventArg_t listenerData)
+void EventQueue_t::removeListener(ListenerHandle_t handle)
 {
-    m_multimap.emplace(
-      std::piecewise_construct, std::forward_as_tuple(event), std::forward_as_tuple(listener, listenerData));
-    return { event, bytesSid(listenerData) };
+    if (handle.slot == 0 || handle.slot >= m_slots.size() || m_slots[handle.slot].generation != handle.generation)
+    { // null or stale handle
+        return;
+    }
+
+    ListenerSlot_t const &slot = m_slots[handle.slot];
+    if (m_dispatching)
+    { // positions must not change while the lists are walked: disable it, erase it after the dispatch
+        Listener_t &listener = m_lists[slot.list].listeners[slot.position];
+        if (listener.func || listener.batchFunc)
+        {
+            listener.func      = nullptr;
+            listener.batchFunc = nullptr;
+            m_pendingRemovals.push_back(handle.slot);
+        }
+        return;
+    }
+
+    eraseListener(handle.slot);
 }
 
-void EventQueue_t::removeListener(EventDataSidPair const& pair)
+void EventQueue_t::eraseListener(U32_t slotIndex)
 {
-    auto const range = m_multimap.equal_range(pair.ev);
-    for (auto it = range.first; it != range.second; ++it)
+    ListenerSlot_t &slot         = m_slots[slotIndex];
+    ListenerList_t &listenerList = m_lists[slot.list];
+    U32_t const     last         = static_cast<U32_t>(listenerList.listeners.size()) - 1;
+    assert(slot.position <= last && listenerList.slots[slot.position] == slotIndex);
+    listenerList.batchListenerCount -= listenerList.listeners[slot.position].batched;
+
+    // swap with the last listener of the list
+    if (slot.position != last)
     {
-        Sid_t const sid = { .id = bytesSid(it->second.listenerData) };
-        if (pair.dataSid == sid)
-        { //
-            m_multimap.erase(it);
-            break;
+        U32_t const movedSlot                 = listenerList.slots[last];
+        listenerList.listeners[slot.position] = listenerList.listeners[last];
+        listenerList.slots[slot.position]     = movedSlot;
+        m_slots[movedSlot].position           = slot.position;
+    }
+    listenerList.listeners.pop_back();
+    listenerList.slots.pop_back();
+
+    // bump the generation to invalidate outstanding handles, skipping 0
+    slot.generation = slot.generation + 1 ? slot.generation + 1 : 1;
+    slot.list       = m_freeSlot;
+    slot.position   = invalidIndex;
+    m_freeSlot      = slotIndex;
+}
+
+// -- timers --
+
+U64_t EventQueue_t::currentTime() const
+{ //
+    return m_time;
+}
+
+TimerHandle_t EventQueue_t::emitAfter(Event_t event, EventArg_t eventData, U64_t delay)
+{ //
+    return insertTimer(event, eventData, delay, 0);
+}
+
+TimerHandle_t EventQueue_t::emitEvery(Event_t event, EventArg_t eventData, U64_t period)
+{ //
+    return insertTimer(event, eventData, period, period ? period : 1);
+}
+
+TimerHandle_t EventQueue_t::insertTimer(Event_t event, EventArg_t eventData, U64_t delay, U64_t period)
+{
+    if (m_timers.empty())
+    { // timer 0 is never handed out, so that the zeroed handle is null
+        m_timers.emplace_back();
+    }
+
+    U32_t index = m_freeTimer;
+    if (index != invalidIndex)
+    {
+        m_freeTimer = m_timers[index].next;
+    }
+    else
+    {
+        index = static_cast<U32_t>(m_timers.size());
+        m_timers.emplace_back();
+    }
+
+    Timer_t &timer = m_timers[index];
+    timer.event    = event;
+    timer.data     = eventData;
+    timer.deadline = m_time + (delay ? delay : 1); // expires at the earliest on the next advance
+    timer.period   = period;
+    linkTimer(index);
+
+    return { .slot = index, .generation = timer.generation };
+}
+
+void EventQueue_t::cancelTimer(TimerHandle_t handle)
+{
+    if (handle.slot == 0 || handle.slot >= m_timers.size() || m_timers[handle.slot].generation != handle.generation)
+    { // null, stale or fired handle
+        return;
+    }
+
+    unlinkTimer(handle.slot);
+    freeTimer(handle.slot);
+}
+
+void EventQueue_t::linkTimer(U32_t timerIndex)
+{
+    // the level is given by the highest bit in which deadline and current time differ. Timers further than the
+    // range of the wheel are parked in the last bucket reached before the end of the range, and cascaded again
+    Timer_t    &timer    = m_timers[timerIndex];
+    U64_t const delta    = timer.deadline - m_time;
+    U64_t const maxDelta = (1ULL << (timerWheelLevels * timerWheelBits)) - 1;
+    U64_t const deadline = delta > maxDelta ? m_time + maxDelta : timer.deadline;
+
+    U32_t level = 0;
+    while (level + 1 != timerWheelLevels && (deadline - m_time) >> ((level + 1) * timerWheelBits))
+    {
+        ++level;
+    }
+
+    U32_t const bucket = level * timerWheelSlots + ((deadline >> (level * timerWheelBits)) & (timerWheelSlots - 1));
+    timer.bucket       = bucket;
+    timer.prev         = invalidIndex;
+    timer.next         = m_wheel[bucket];
+    if (timer.next != invalidIndex)
+    {
+        m_timers[timer.next].prev = timerIndex;
+    }
+    m_wheel[bucket] = timerIndex;
+}
+
+void EventQueue_t::unlinkTimer(U32_t timerIndex)
+{
+    Timer_t const &timer = m_timers[timerIndex];
+    if (timer.prev != invalidIndex)
+    {
+        m_timers[timer.prev].next = timer.next;
+    }
+    else
+    {
+        m_wheel[timer.bucket] = timer.next;
+    }
+    if (timer.next != invalidIndex)
+    {
+        m_timers[timer.next].prev = timer.prev;
+    }
+}
+
+void EventQueue_t::freeTimer(U32_t timerIndex)
+{
+    Timer_t &timer   = m_timers[timerIndex];
+    timer.generation = timer.generation + 1 ? timer.generation + 1 : 1;
+    timer.bucket     = invalidIndex;
+    timer.next       = m_freeTimer;
+    m_freeTimer      = timerIndex;
+}
+
+void EventQueue_t::advanceTime(U64_t deltaTime)
+{
+    for (U64_t const end = m_time + deltaTime; m_time != end;)
+    {
+        ++m_time;
+
+        // on a bucket boundary of level 1 and up, redistribute the timers of the buckets just reached, from the
+        // highest level down, as cascading a level refills the one below it
+        if ((m_time & (timerWheelSlots - 1)) == 0)
+        {
+            U32_t level = 1;
+            while (level + 1 != timerWheelLevels && ((m_time >> (level * timerWheelBits)) & (timerWheelSlots - 1)) == 0)
+            {
+                ++level;
+            }
+            for (; level != 0; --level)
+            {
+                U32_t const bucket = level * timerWheelSlots
+                                     + ((m_time >> (level * timerWheelBits)) & (timerWheelSlots - 1));
+                U32_t index     = m_wheel[bucket];
+                m_wheel[bucket] = invalidIndex;
+                while (index != invalidIndex)
+                {
+                    U32_t const next = m_timers[index].next;
+                    linkTimer(index);
+                    index = next;
+                }
+            }
+        }
+
+        // fire the timers of the current level 0 bucket, detached first as periodic timers may be linked back
+        U32_t const bucket = static_cast<U32_t>(m_time & (timerWheelSlots - 1));
+        U32_t       index  = m_wheel[bucket];
+        m_wheel[bucket]    = invalidIndex;
+        while (index != invalidIndex)
+        {
+            Timer_t    &timer = m_timers[index];
+            U32_t const next  = timer.next;
+            assert(timer.deadline == m_time);
+            emit(timer.event, timer.data);
+            if (timer.period != 0)
+            {
+                timer.deadline += timer.period;
+                linkTimer(index);
+            }
+            else
+            {
+                freeTimer(index);
+            }
+            index = next;
         }
     }
 }
@@ -0,0 +1,257 @@
+#include "EventReplay.h"
+
+#include "TimeUtils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+namespace cge
+{
+
+EventReplay_s g_eventReplay;
+
+static U64_t constexpr replayFlushSize = 64 * 1024;
+
+EventReplay_s::~EventReplay_s()
+{
+    // listeners can't be removed here, the event queue may be gone already
+    if (m_file)
+    {
+        std::fclose(m_file);
+    }
+}
+
+EErr_t EventReplay_s::initFromEnvironment(std::initializer_list<Event_t> events)
+{
+    if (Char8_t const *path = std::getenv("CGE_REPLAY"); path)
+    {
+        return beginReplay(path);
+    }
+    if (Char8_t const *path = std::getenv("CGE_RECORD"); path)
+    {
+        return beginRecording(path, events);
+    }
+    return EErr_t::eSuccess;
+}
+
+EErr_t EventReplay_s::beginRecording(Char8_t const *path, std::initializer_list<Event_t> events)
+{
+    if (m_mode != EReplayMode_t::eNone || events.size() > replayMaxEventTypes)
+    {
+        return EErr_t::eInvalid;
+    }
+
+    m_file = std::fopen(path, "wb");
+    if (!m_file)
+    {
+        printf("[EventReplay] cannot open %s for writing\n", path);
+        return EErr_t::eCreationFailure;
+    }
+
+    m_header = { .magic       = replayMagic,
+                 .version     = replayVersion,
+                 .seed        = std::random_device{}() | 1, // 0 means nondeterministic to the consumers
+                 .timeStep    = timeUnitsIn60FPS,
+                 .frameCount  = 0,
+                 .recordCount = 0 };
+
+    // the header is rewritten on shutdown, once the counts are known
+    std::fwrite(&m_header, sizeof(ReplayHeader_t), 1, m_file);
+    m_buffer.reserve(replayFlushSize + replayRecordSize);
+
+    for (Event_t const event : events)
+    {
+        RecordedType_t &type = m_types[m_typeCount++];
+        type.self            = this;
+        type.event           = event;
+
+        EventArg_t listenerData{};
+        listenerData.idata.p = reinterpret_cast<Byte_t *>(&type);
+        type.listener        = g_eventQueue.addListener(event, recordCallback, listenerData);
+    }
+
+    m_mode  = EReplayMode_t::eRecord;
+    m_frame = 0;
+    printf("[EventReplay] recording to %s, seed %u\n", path, m_header.seed);
+    return EErr_t::eSuccess;
+}
+
+EErr_t EventReplay_s::beginReplay(Char8_t const *path)
+{
+    if (m_mode != EReplayMode_t::eNone)
+    {
+        return EErr_t::eInvalid;
+    }
+
+    m_file = std::fopen(path, "rb");
+    if (!m_file)
+    {
+        printf("[EventReplay] cannot open %s for reading\n", path);
+        return EErr_t::eCreationFailure;
+    }
+
+    if (
+      std::fread(&m_header, sizeof(ReplayHeader_t), 1, m_file) != 1 || m_header.magic != replayMagic
+      || m_header.version != replayVersion)
+    {
+        printf("[EventReplay] %s is not a replay log\n", path);
+        std::fclose(m_file);
+        m_file = nullptr;
+        return EErr_t::eInvalid;
+    }
+
+    // the whole log is loaded upfront, so that no I/O happens while the frames are timed
+    m_buffer.resize(m_header.recordCount * replayRecordSize);
+    if (std::fread(m_buffer.data(), 1, m_buffer.size(), m_file) != m_buffer.size())
+    {
+        printf("[EventReplay] %s is truncated\n", path);
+        std::fclose(m_file);
+        m_file = nullptr;
+        return EErr_t::eInvalid;
+    }
+
+    m_mode       = EReplayMode_t::eReplay;
+    m_frame      = 0;
+    m_cursor     = 0;
+    m_frameStart = std::chrono::steady_clock::now();
+    printf(
+      "[EventReplay] replaying %s: %zu frames, %zu events, seed %u\n",
+      path,
+      m_header.frameCount,
+      m_header.recordCount,
+      m_header.seed);
+    return EErr_t::eSuccess;
+}
+
+void EventReplay_s::recordCallback(EventArg_t eventData, EventArg_t listenerData)
+{
+    auto const *type = reinterpret_cast<RecordedType_t const *>(listenerData.idata.p);
+    type->self->record(type->event, eventData);
+}
+
+void EventReplay_s::record(Event_t event, EventArg_t const &eventData)
+{
+    Byte_t record[replayRecordSize];
+    std::memcpy(record, &m_frame, sizeof(U32_t));
+    std::memcpy(record + 4, &event.m_id.id, sizeof(U64_t));
+    std::memcpy(record + 12, &eventData.idata.u64, sizeof(U64_t));
+    std::memcpy(record + 20, eventData.fdata.f32, 4 * sizeof(F32_t));
+    m_buffer.insert(m_buffer.end(), record, record + replayRecordSize);
+    ++m_header.recordCount;
+
+    if (m_buffer.size() >= replayFlushSize)
+    {
+        flush();
+    }
+}
+
+void EventReplay_s::flush()
+{
+    std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+    m_buffer.clear();
+}
+
+void EventReplay_s::injectFrame()
+{
+    if (m_mode != EReplayMode_t::eReplay)
+    {
+        return;
+    }
+
+    while (m_cursor != m_header.recordCount)
+    {
+        Byte_t const *record = m_buffer.data() + m_cursor * replayRecordSize;
+        U32_t         frame;
+        std::memcpy(&frame, record, sizeof(U32_t));
+        if (frame != m_frame)
+        {
+            assert(frame > m_frame);
+            break;
+        }
+
+        Event_t    event{};
+        EventArg_t eventData{};
+        std::memcpy(&event.m_id.id, record + 4, sizeof(U64_t));
+        std::memcpy(&eventData.idata.u64, record + 12, sizeof(U64_t));
+        std::memcpy(eventData.fdata.f32, record + 20, 4 * sizeof(F32_t));
+        g_eventQueue.emit(event, eventData);
+        ++m_cursor;
+    }
+}
+
+B8_t EventReplay_s::endFrame()
+{
+    switch (m_mode)
+    {
+    case EReplayMode_t::eRecord:
+        ++m_frame;
+        m_header.frameCount = m_frame;
+        return true;
+    case EReplayMode_t::eReplay:
+    {
+        auto const  now     = std::chrono::steady_clock::now();
+        U64_t const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_frameStart).count();
+        m_frameStart        = now;
+        m_totalTime += elapsed;
+        m_minTime = std::min(m_minTime, elapsed);
+        m_maxTime = std::max(m_maxTime, elapsed);
+        return ++m_frame < m_header.frameCount;
+    }
+    default:
+        return true;
+    }
+}
+
+void EventReplay_s::shutdown()
+{
+    if (m_mode == EReplayMode_t::eRecord)
+    {
+        flush();
+        std::fseek(m_file, 0, SEEK_SET);
+        std::fwrite(&m_header, sizeof(ReplayHeader_t), 1, m_file);
+        printf("[EventReplay] recorded %zu frames, %zu events\n", m_header.frameCount, m_header.recordCount);
+
+        for (U32_t i = 0; i != m_typeCount; ++i)
+        { //
+            g_eventQueue.removeListener(m_types[i].listener);
+        }
+        m_typeCount = 0;
+    }
+    else if (m_mode == EReplayMode_t::eReplay && m_frame != 0)
+    {
+        printf(
+          "[EventReplay] replayed %u frames in %.3f ms: avg %.3f ms, min %.3f ms, max %.3f ms\n",
+          m_frame,
+          m_totalTime * 1e-6,
+          m_totalTime * 1e-6 / m_frame,
+          m_minTime * 1e-6,
+          m_maxTime * 1e-6);
+    }
+
+    if (m_file)
+    {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+    m_mode = EReplayMode_t::eNone;
+}
+
+EReplayMode_t EventReplay_s::mode() const
+{ //
+    return m_mode;
+}
+
+U32_t EventReplay_s::seed() const
+{ //
+    return m_header.seed;
+}
+
+U32_t EventReplay_s::timeStep() const
+{ //
+    return m_header.timeStep;
+}
+
+} // namespace cge
@@ -0,0 +1,187 @@
+#include "FramePacing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <immintrin.h>
+#include <thread>
+
+namespace cge
+{
+
+FrameTimeHistogram_s g_frameTimes;
+
+FixedTimeStep_s::FixedTimeStep_s(U32_t stepUnits, U32_t maxSteps) : m_step(stepUnits), m_maxSteps(maxSteps)
+{ //
+    m_stepSize = m_step * hiResFrequency();
+}
+
+U32_t FixedTimeStep_s::advance(U64_t elapsedTicks)
+{
+    // clamped before scaling, so that a stall of any length can't overflow
+    U64_t const maxTicks = (m_maxSteps + 1ULL) * m_step * hiResFrequency() / timeUnit64;
+    m_accumulator += std::min(elapsedTicks, maxTicks) * timeUnit64;
+    return consumeSteps();
+}
+
+U32_t FixedTimeStep_s::advanceUnits(U64_t elapsedUnits)
+{
+    m_accumulator += std::min<U64_t>(elapsedUnits, (m_maxSteps + 1ULL) * m_step) * hiResFrequency();
+    return consumeSteps();
+}
+
+U32_t FixedTimeStep_s::consumeSteps()
+{
+    U32_t steps = 0;
+    while (m_accumulator >= m_stepSize && steps != m_maxSteps)
+    {
+        m_accumulator -= m_stepSize;
+        ++steps;
+    }
+
+    if (steps == m_maxSteps && m_accumulator >= m_stepSize)
+    { // the simulation can't keep up, slow it down instead of spiraling
+        m_accumulator %= m_stepSize;
+    }
+    return steps;
+}
+
+F32_t FixedTimeStep_s::alpha() const
+{ //
+    return static_cast<F32_t>(static_cast<F64_t>(m_accumulator) / static_cast<F64_t>(m_stepSize));
+}
+
+U32_t FixedTimeStep_s::step() const
+{ //
+    return m_step;
+}
+
+void FrameLimiter_s::setTargetFrameRate(U32_t framesPerSecond)
+{
+    m_framesPerSecond = framesPerSecond;
+    m_period          = framesPerSecond ? hiResFrequency() / framesPerSecond : 0;
+}
+
+void FrameLimiter_s::initFromEnvironment(U32_t defaultFramesPerSecond)
+{
+    Char8_t const *limit = std::getenv("CGE_FPS_LIMIT");
+    setTargetFrameRate(limit ? static_cast<U32_t>(std::atoi(limit)) : defaultFramesPerSecond);
+    if (m_framesPerSecond)
+    {
+        printf("[FramePacing] frame rate limited to %u fps\n", m_framesPerSecond);
+    }
+}
+
+U64_t FrameLimiter_s::wait(U64_t frameStart)
+{
+    U64_t now = hiResTimer();
+    if (!m_period)
+    {
+        return now;
+    }
+
+    U64_t const deadline = frameStart + m_period;
+    while (now < deadline && static_cast<F64_t>(hiResToNanoseconds(deadline - now)) > m_sleepEstimate)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        U64_t const woken = hiResTimer();
+        updateSleepEstimate(static_cast<F64_t>(hiResToNanoseconds(woken - now)));
+        now = woken;
+    }
+
+    // the wake up of the OS scheduler is too coarse for the last stretch
+    while (now < deadline)
+    {
+        _mm_pause();
+        now = hiResTimer();
+    }
+    return now;
+}
+
+void FrameLimiter_s::updateSleepEstimate(F64_t observedNanoseconds)
+{
+    ++m_sleepCount;
+    F64_t const delta = observedNanoseconds - m_sleepMean;
+    m_sleepMean += delta / static_cast<F64_t>(m_sleepCount);
+    m_sleepM2 += delta * (observedNanoseconds - m_sleepMean);
+    m_sleepEstimate = m_sleepMean + std::sqrt(m_sleepM2 / static_cast<F64_t>(m_sleepCount - 1));
+}
+
+U32_t FrameLimiter_s::targetFrameRate() const
+{ //
+    return m_framesPerSecond;
+}
+
+void FrameTimeHistogram_s::record(U64_t nanoseconds)
+{
+    U64_t const bucket = std::min<U64_t>(nanoseconds / frameHistogramBucketWidth, frameHistogramBuckets - 1);
+    ++m_buckets[bucket];
+    ++m_count;
+    m_total += nanoseconds;
+    m_minimum = std::min(m_minimum, nanoseconds);
+    m_maximum = std::max(m_maximum, nanoseconds);
+}
+
+void FrameTimeHistogram_s::reset()
+{ //
+    *this = {};
+}
+
+U64_t FrameTimeHistogram_s::percentile(F32_t p) const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+
+    // rank of the sample, 1 based
+    U64_t const rank       = std::max<U64_t>(1, static_cast<U64_t>(std::ceil(std::clamp(p, 0.f, 1.f) * m_count)));
+    U64_t       cumulative = 0;
+    for (U32_t i = 0; i != frameHistogramBuckets; ++i)
+    {
+        cumulative += m_buckets[i];
+        if (cumulative >= rank)
+        { // the last bucket is open ended
+            return i == frameHistogramBuckets - 1 ? m_maximum
+                                                  : std::min<U64_t>((i + 1ULL) * frameHistogramBucketWidth, m_maximum);
+        }
+    }
+    return m_maximum;
+}
+
+U64_t FrameTimeHistogram_s::count() const
+{ //
+    return m_count;
+}
+
+U64_t FrameTimeHistogram_s::minimum() const
+{ //
+    return m_count ? m_minimum : 0;
+}
+
+U64_t FrameTimeHistogram_s::maximum() const
+{ //
+    return m_maximum;
+}
+
+U64_t FrameTimeHistogram_s::mean() const
+{ //
+    return m_count ? m_total / m_count : 0;
+}
+
+void FrameTimeHistogram_s::print(Char8_t const *label) const
+{
+    printf(
+      "[FramePacing] %s: %zu frames, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, min %.3f ms, max %.3f ms\n",
+      label,
+      m_count,
+      percentile(0.50f) * 1e-6,
+      percentile(0.95f) * 1e-6,
+      percentile(0.99f) * 1e-6,
+      minimum() * 1e-6,
+      maximum() * 1e-6);
+}
+
+} // namespace cge
@@ -0,0 +1,237 @@
+#include "FrameScheduler.h"
+
+#include "Job.h"
+#include "Log.h"
+#include "Profiler.h"
+#include "TimeUtils.h"
+
+#include <bit>
+#include <cassert>
+
+namespace cge
+{
+
+static B8_t contains(Sid_t const *sids, U32_t count, Sid_t sid)
+{
+    for (U32_t i = 0; i != count; ++i)
+    {
+        if (sids[i] == sid)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FrameScheduler_s::beginFrame()
+{ //
+    m_systemCount = 0;
+}
+
+void FrameScheduler_s::registerSystem(
+  Sid_t                        name,
+  std::initializer_list<Sid_t> reads,
+  std::initializer_list<Sid_t> writes,
+  void (*invoke)(void *closure),
+  void             *closure,
+  ESystemAffinity_t affinity)
+{
+    assert(m_systemCount < frameMaxSystems && "[FrameScheduler] too many systems");
+    assert(
+      reads.size() <= frameMaxAccesses && writes.size() <= frameMaxAccesses && "[FrameScheduler] too many accesses");
+
+    U32_t const index  = m_systemCount++;
+    System_t   &system = m_systems[index];
+    system.name        = name;
+    system.readCount   = 0;
+    system.writeCount  = 0;
+    for (Sid_t const sid : reads)
+    {
+        system.reads[system.readCount++] = sid;
+    }
+    for (Sid_t const sid : writes)
+    {
+        system.writes[system.writeCount++] = sid;
+    }
+    system.affinity     = affinity;
+    system.worker       = 0;
+    system.invoke       = invoke;
+    system.closure      = closure;
+    system.predecessors = 0;
+    system.successors   = 0;
+    system.start        = 0;
+    system.end          = 0;
+
+    // read-after-write, write-after-read and write-after-write hazards against the previous systems
+    for (U32_t i = 0; i != index; ++i)
+    {
+        System_t &other    = m_systems[i];
+        B8_t      conflict = false;
+        for (U32_t w = 0; w != system.writeCount && !conflict; ++w)
+        {
+            conflict = contains(other.reads, other.readCount, system.writes[w])
+                       || contains(other.writes, other.writeCount, system.writes[w]);
+        }
+        for (U32_t r = 0; r != system.readCount && !conflict; ++r)
+        {
+            conflict = contains(other.writes, other.writeCount, system.reads[r]);
+        }
+
+        if (conflict)
+        {
+            system.predecessors |= 1ULL << i;
+            other.successors |= 1ULL << index;
+        }
+    }
+}
+
+void FrameScheduler_s::run()
+{
+    CGE_PROFILE_SCOPE("FrameScheduler::run");
+    m_frameStart = hiResTimer();
+    m_remaining.store(m_systemCount, std::memory_order_relaxed);
+    m_mainThreadReady.store(0, std::memory_order_relaxed);
+    for (U32_t i = 0; i != m_systemCount; ++i)
+    {
+        m_pendingPredecessors[i].store(std::popcount(m_systems[i].predecessors), std::memory_order_relaxed);
+    }
+
+    for (U32_t i = 0; i != m_systemCount; ++i)
+    {
+        if (m_systems[i].predecessors == 0)
+        {
+            schedule(i);
+        }
+    }
+
+    while (m_remaining.load(std::memory_order_acquire) != 0)
+    {
+        if (U64_t const ready = m_mainThreadReady.load(std::memory_order_acquire); ready != 0)
+        {
+            U32_t const index = std::countr_zero(ready);
+            m_mainThreadReady.fetch_and(~(1ULL << index), std::memory_order_acq_rel);
+            execute(index);
+        }
+        else if (!g_jobSystem.executeOne())
+        {
+            _mm_pause();
+        }
+    }
+
+    if (m_printInterval != 0 && ++m_frameIndex % m_printInterval == 0)
+    {
+        printTimings();
+    }
+}
+
+void FrameScheduler_s::schedule(U32_t index)
+{
+    if (m_systems[index].affinity == ESystemAffinity_t::eMainThread)
+    {
+        m_mainThreadReady.fetch_or(1ULL << index, std::memory_order_acq_rel);
+    }
+    else
+    {
+        g_jobSystem.submit([this, index]() { execute(index); });
+    }
+}
+
+void FrameScheduler_s::execute(U32_t index)
+{
+    System_t &system = m_systems[index];
+    system.worker    = JobSystem::currentWorker();
+    system.start     = hiResTimer() - m_frameStart;
+    system.invoke(system.closure);
+    system.end = hiResTimer() - m_frameStart;
+
+    for (U64_t successors = system.successors; successors != 0; successors &= successors - 1)
+    {
+        U32_t const next = std::countr_zero(successors);
+        if (m_pendingPredecessors[next].fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            schedule(next);
+        }
+    }
+    m_remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void FrameScheduler_s::setPrintInterval(U32_t frames)
+{ //
+    m_printInterval = frames;
+}
+
+U32_t FrameScheduler_s::systemCount() const
+{ //
+    return m_systemCount;
+}
+
+SystemTiming_t FrameScheduler_s::timing(U32_t index) const
+{
+    System_t const &system = m_systems[index];
+    return { .name   = system.name,
+             .start  = hiResToNanoseconds(system.start),
+             .end    = hiResToNanoseconds(system.end),
+             .worker = system.worker };
+}
+
+void FrameScheduler_s::printTimings() const
+{
+    // longest path ending in each system. Registration order is a topological order of the graph
+    U64_t pathLength[frameMaxSystems];
+    I32_t pathPrev[frameMaxSystems];
+    I32_t last = -1;
+    for (U32_t i = 0; i != m_systemCount; ++i)
+    {
+        System_t const &system = m_systems[i];
+        pathLength[i]          = system.end - system.start;
+        pathPrev[i]            = -1;
+        for (U64_t preds = system.predecessors; preds != 0; preds &= preds - 1)
+        {
+            U32_t const p = std::countr_zero(preds);
+            if (pathLength[p] + system.end - system.start > pathLength[i])
+            {
+                pathLength[i] = pathLength[p] + system.end - system.start;
+                pathPrev[i]   = static_cast<I32_t>(p);
+            }
+        }
+        if (last < 0 || pathLength[i] > pathLength[last])
+        {
+            last = static_cast<I32_t>(i);
+        }
+    }
+
+    // systems are also given by index, as release builds can't look their names up
+    CGE_LOG_INFO(Core, "[FrameScheduler] %u systems", m_systemCount);
+    for (U32_t i = 0; i != m_systemCount; ++i)
+    {
+        System_t const &system = m_systems[i];
+        CGE_LOG_INFO(
+          Core,
+          "[FrameScheduler] \t%2u %-20s worker %2u, start: %8.3f us, duration: %8.3f us",
+          i,
+          CGE_DBG_STRLOOKUP(system.name),
+          system.worker,
+          hiResToNanoseconds(system.start) * 1e-3,
+          hiResToNanoseconds(system.end - system.start) * 1e-3);
+    }
+
+    if (last < 0)
+    {
+        return;
+    }
+    // one record per system, as a record holds a single line of bounded length
+    CGE_LOG_INFO(Core, "[FrameScheduler] critical path (%.3f us):", hiResToNanoseconds(pathLength[last]) * 1e-3);
+    I32_t path[frameMaxSystems];
+    U32_t pathSize = 0;
+    for (I32_t i = last; i >= 0; i = pathPrev[i])
+    {
+        path[pathSize++] = i;
+    }
+    while (pathSize != 0)
+    {
+        I32_t const index = path[--pathSize];
+        CGE_LOG_INFO(Core, "[FrameScheduler] \t%2d %s", index, CGE_DBG_STRLOOKUP(m_systems[index].name));
+    }
+}
+
+} // namespace cge
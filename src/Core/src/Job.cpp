@@ -0,0 +1,330 @@
+#include "Job.h"
+
+#include "Alloc.h"
+#include "Log.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
+#if defined(CGE_PLATFORM_WINDOWS)
+#include <windows.h>
+#elif defined(CGE_PLATFORM_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace cge
+{
+
+/** @struct JobWorker_t
+ * @brief per thread state: Chase-Lev deque ("Correct and Efficient Work-Stealing for Weak Memory Models",
+ * Le et al.) of fixed capacity, and the ring of jobs allocated by the thread
+ */
+struct alignas(64) JobWorker_t
+{
+    B8_t push(Job_t *job)
+    {
+        I64_t const b = m_bottom.load(std::memory_order_relaxed);
+        I64_t const t = m_top.load(std::memory_order_acquire);
+        if (b - t >= static_cast<I64_t>(jobQueueCapacity))
+        {
+            return false;
+        }
+        m_buffer[b & (jobQueueCapacity - 1)].store(job, std::memory_order_relaxed);
+        m_bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    Job_t *pop()
+    {
+        I64_t const b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        I64_t t = m_top.load(std::memory_order_relaxed);
+        if (t > b)
+        { // empty
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job_t *job = m_buffer[b & (jobQueueCapacity - 1)].load(std::memory_order_relaxed);
+        if (t == b)
+        { // last job, race against thieves
+            if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                job = nullptr;
+            }
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    Job_t *steal()
+    {
+        I64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        I64_t const b = m_bottom.load(std::memory_order_acquire);
+        if (t >= b)
+        {
+            return nullptr;
+        }
+
+        Job_t *job = m_buffer[t & (jobQueueCapacity - 1)].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+        return job;
+    }
+
+    std::atomic<I64_t>             m_top{ 0 };
+    alignas(64) std::atomic<I64_t> m_bottom{ 0 };
+    std::atomic<Job_t *>           m_buffer[jobQueueCapacity];
+    Job_t                         *m_jobs    = nullptr; ///< ring of `jobQueueCapacity` jobs, reused once run
+    U32_t                          m_nextJob = 0;
+    U32_t                          m_rng     = 0; ///< xorshift state to pick victims
+};
+
+static thread_local U32_t s_workerIndex = jobInvalidWorker;
+static thread_local U32_t s_outsiderRng = 0x2545f491U; ///< victim selection of threads which are not workers
+
+JobSystem g_jobSystem;
+
+static void pinThread(std::thread::native_handle_type handle, U32_t core)
+{
+#if defined(CGE_PLATFORM_LINUX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    if (pthread_setaffinity_np(handle, sizeof(cpu_set_t), &set) != 0)
+    {
+        printf("[JobSystem] could not pin thread to core %u\n", core);
+    }
+#elif defined(CGE_PLATFORM_WINDOWS)
+    if (!SetThreadAffinityMask(handle, 1ULL << core))
+    {
+        printf("[JobSystem] could not pin thread to core %u\n", core);
+    }
+#endif
+}
+
+void JobSystem::init(JobSystemSpec_t const &spec)
+{
+    U32_t const hwThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    U32_t const workers   = spec.workerCount ? spec.workerCount : hwThreads - 1;
+    m_workerCount         = std::min(workers + 1, jobMaxWorkers);
+
+    // worker state lives for the whole application, carve it from the persistent slot
+    StackAllocator &persistent = getEngineArena().persistent();
+    m_workers = static_cast<JobWorker_t *>(persistent.allocate(m_workerCount * sizeof(JobWorker_t), alignof(JobWorker_t)));
+    for (U32_t i = 0; i != m_workerCount; ++i)
+    {
+        JobWorker_t *worker = new (&m_workers[i]) JobWorker_t();
+        worker->m_jobs = static_cast<Job_t *>(persistent.allocate(jobQueueCapacity * sizeof(Job_t), alignof(Job_t)));
+        std::uninitialized_default_construct_n(worker->m_jobs, jobQueueCapacity);
+        worker->m_rng  = 0x9e3779b9U * (i + 1);
+    }
+
+    s_workerIndex = 0;
+    m_running.store(true, std::memory_order_release);
+    m_threads = static_cast<std::thread *>(
+      persistent.allocate(m_workerCount * sizeof(std::thread), alignof(std::thread)));
+    for (U32_t i = 1; i != m_workerCount; ++i)
+    {
+        new (&m_threads[i]) std::thread([this, i]() { workerLoop(i); });
+        if (spec.pinToCores)
+        {
+            pinThread(m_threads[i].native_handle(), i % hwThreads);
+        }
+    }
+    if (spec.pinToCores)
+    {
+#if defined(CGE_PLATFORM_LINUX)
+        pinThread(pthread_self(), 0);
+#elif defined(CGE_PLATFORM_WINDOWS)
+        pinThread(GetCurrentThread(), 0);
+#endif
+    }
+
+    printf("[JobSystem] started %u workers\n", m_workerCount - 1);
+}
+
+void JobSystem::shutdown()
+{
+    if (!m_running.exchange(false, std::memory_order_acq_rel))
+    {
+        return;
+    }
+
+    m_signal.fetch_add(1, std::memory_order_seq_cst);
+    m_signal.notify_all();
+    for (U32_t i = 1; i != m_workerCount; ++i)
+    {
+        m_threads[i].join();
+        m_threads[i].~thread();
+    }
+    m_workerCount = 1;
+}
+
+U32_t JobSystem::workerCount() const
+{ //
+    return m_workerCount;
+}
+
+U32_t JobSystem::currentWorker()
+{ //
+    return s_workerIndex;
+}
+
+B8_t JobSystem::acceptsSubmit() const
+{
+    // before init no thread is a worker, the main thread included
+    if (s_workerIndex >= m_workerCount || !m_workers)
+    {
+        CGE_LOG_ERROR(Core, "[JobSystem] submit from a thread which is not a worker, job rejected");
+        return false;
+    }
+    return true;
+}
+
+Job_t *JobSystem::allocateJob()
+{
+    JobWorker_t &worker = m_workers[s_workerIndex];
+    while (true)
+    {
+        // records are released out of order, as thieves complete them. Jobs submitted by a job run while
+        // helping below take records too, hence m_nextJob is read again on every iteration
+        for (U32_t i = 0; i != jobQueueCapacity; ++i)
+        {
+            Job_t *job       = &worker.m_jobs[worker.m_nextJob];
+            worker.m_nextJob = (worker.m_nextJob + 1) & (jobQueueCapacity - 1);
+            if (!job->live.load(std::memory_order_acquire))
+            {
+                job->live.store(true, std::memory_order_relaxed);
+                return job;
+            }
+        }
+
+        // every record is queued or running
+        if (!executeOne())
+        {
+            _mm_pause();
+        }
+    }
+}
+
+void JobSystem::push(Job_t *job)
+{
+    if (!m_workers[s_workerIndex].push(job))
+    { // queue full, run it right away
+        execute(job);
+        return;
+    }
+
+    m_signal.fetch_add(1, std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_seq_cst) != 0)
+    {
+        m_signal.notify_one();
+    }
+}
+
+Job_t *JobSystem::findJob(U32_t self)
+{
+    // a thread which is not a worker waiting on a counter can only steal
+    if (Job_t *job = self < m_workerCount ? m_workers[self].pop() : nullptr; job)
+    {
+        return job;
+    }
+
+    // start from a random victim so that thieves spread over the workers
+    U32_t &rng = self < m_workerCount ? m_workers[self].m_rng : s_outsiderRng;
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    for (U32_t i = 0; i != m_workerCount; ++i)
+    {
+        U32_t const victim = (rng + i) % m_workerCount;
+        if (victim == self)
+        {
+            continue;
+        }
+        if (Job_t *job = m_workers[victim].steal(); job)
+        {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(Job_t *job)
+{
+    CGE_PROFILE_SCOPE("Job");
+    job->func(*job);
+    if (job->counter)
+    {
+        job->counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+    job->live.store(false, std::memory_order_release);
+}
+
+void JobSystem::wait(JobCounter_t &counter)
+{
+    while (counter.pending.load(std::memory_order_acquire) != 0)
+    {
+        if (!executeOne())
+        {
+            _mm_pause();
+        }
+    }
+}
+
+B8_t JobSystem::executeOne()
+{
+    if (Job_t *job = findJob(s_workerIndex); job)
+    {
+        execute(job);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::workerLoop(U32_t index)
+{
+    U32_t constexpr spinCount = 256;
+
+    s_workerIndex = index;
+#if defined(CGE_PROFILE)
+    Char8_t threadName[profileThreadName];
+    snprintf(threadName, sizeof(threadName), "Worker %u", index);
+    CGE_PROFILE_THREAD(threadName);
+#endif
+    while (m_running.load(std::memory_order_acquire))
+    {
+        U32_t const signal = m_signal.load(std::memory_order_seq_cst);
+        if (Job_t *job = findJob(index); job)
+        {
+            execute(job);
+            continue;
+        }
+
+        B8_t found = false;
+        for (U32_t spin = 0; spin != spinCount && !found; ++spin)
+        {
+            _mm_pause();
+            found = m_signal.load(std::memory_order_relaxed) != signal;
+        }
+        if (found)
+        {
+            continue;
+        }
+
+        // nothing was submitted since the last look at the queues: sleep until the next submit
+        m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+        m_signal.wait(signal, std::memory_order_seq_cst);
+        m_sleeping.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+} // namespace cge
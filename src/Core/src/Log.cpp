@@ -0,0 +1,250 @@
+#include "Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+
+namespace cge
+{
+
+Logger_s g_logger;
+
+static U32_t constexpr logPassCapacity = 4096; ///< records written per pass of the writer thread
+static auto constexpr logFlushPeriod   = std::chrono::milliseconds(2);
+
+static Char8_t const s_levelTags[static_cast<U32_t>(ELogLevel_t::eLogLevelCount)]{ 'T', 'D', 'I', 'W', 'E' };
+
+/// @struct queue of the records of a thread
+struct alignas(64) LogThread_t
+{
+    LogThread_t() : queue(logThreadCapacity)
+    {
+    }
+
+    SpscQueue<LogRecord_t> queue;
+    std::atomic<U64_t>     dropped{ 0 };
+    std::atomic<B8_t>      owned{ true }; ///< cleared when the thread exits, so that another one can reuse the queue
+    std::atomic<B8_t>      pushing{ false }; ///< set by the owner while it pushes, see Logger_s::shutdown
+};
+
+struct LogThreadHandle_t
+{
+    ~LogThreadHandle_t()
+    {
+        if (queue)
+        { // the records still queued are written anyway, the queue goes to the next thread which needs one
+            queue->owned.store(false, std::memory_order_release);
+        }
+    }
+
+    LogThread_t *queue      = nullptr;
+    B8_t         registered = false;
+};
+
+static thread_local LogThreadHandle_t s_logThread;
+
+namespace detail
+{
+    U32_t logFormat(Char8_t *out, U32_t size, Char8_t const *format, ...)
+    {
+        va_list args;
+        va_start(args, format);
+        I32_t const length = vsnprintf(out, size, format, args);
+        va_end(args);
+        return length < 0 ? 0 : std::min(static_cast<U32_t>(length), size - 1);
+    }
+} // namespace detail
+
+Logger_s::~Logger_s()
+{
+    shutdown();
+    for (std::atomic<LogThread_t *> &thread : m_threads)
+    {
+        delete thread.load(std::memory_order_acquire);
+    }
+}
+
+void Logger_s::init(std::FILE *out)
+{
+    if (m_running.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    m_out = out;
+    if (!m_pending)
+    { // outside of the memory pools, as the profiler buffers
+        m_pending = new LogRecord_t[logPassCapacity];
+    }
+    m_running.store(true, std::memory_order_release);
+    m_writer = std::thread([this] { writerLoop(); });
+}
+
+void Logger_s::shutdown()
+{
+    if (!m_running.exchange(false, std::memory_order_seq_cst))
+    {
+        return;
+    }
+    m_writer.join();
+
+    // a thread which saw the writer running may still be pushing, after its final drain. Once the flags are clear
+    // every later call sees m_running false and writes synchronously, so one more drain writes all that is left
+    U32_t const threadCount = std::min(m_threadCount.load(std::memory_order_seq_cst), logMaxThreads);
+    for (U32_t i = 0; i != threadCount; ++i)
+    {
+        LogThread_t const *thread = m_threads[i].load(std::memory_order_seq_cst);
+        while (thread && thread->pushing.load(std::memory_order_seq_cst))
+        {
+            std::this_thread::yield();
+        }
+    }
+    while (drain() != 0)
+    {
+    }
+
+    delete[] m_pending;
+    m_pending = nullptr;
+}
+
+U64_t Logger_s::dropped() const
+{
+    U64_t       dropped     = 0;
+    U32_t const threadCount = std::min(m_threadCount.load(std::memory_order_acquire), logMaxThreads);
+    for (U32_t i = 0; i != threadCount; ++i)
+    {
+        if (LogThread_t const *thread = m_threads[i].load(std::memory_order_acquire); thread)
+        {
+            dropped += thread->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    return dropped;
+}
+
+LogThread_t *Logger_s::threadQueue()
+{
+    if (s_logThread.registered)
+    {
+        return s_logThread.queue;
+    }
+    s_logThread.registered = true;
+
+    // adopt the queue of an exited thread, or claim a new one
+    U32_t const threadCount = std::min(m_threadCount.load(std::memory_order_acquire), logMaxThreads);
+    for (U32_t i = 0; i != threadCount; ++i)
+    {
+        LogThread_t *thread = m_threads[i].load(std::memory_order_acquire);
+        B8_t         owned  = false;
+        if (thread && thread->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+        {
+            s_logThread.queue = thread;
+            return thread;
+        }
+    }
+
+    // sequentially consistent, so that shutdown sees the queue if this thread sees the writer running
+    U32_t const index = m_threadCount.fetch_add(1, std::memory_order_seq_cst);
+    if (index >= logMaxThreads)
+    {
+        fprintf(m_out, "[Log] more than %u threads logging, their records are written synchronously\n", logMaxThreads);
+        return nullptr;
+    }
+
+    auto *thread = new LogThread_t();
+    m_threads[index].store(thread, std::memory_order_seq_cst);
+    s_logThread.queue = thread;
+    return thread;
+}
+
+B8_t Logger_s::push(LogRecord_t const &record)
+{
+    if (!m_running.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    LogThread_t *thread = threadQueue();
+    if (!thread)
+    {
+        return false;
+    }
+
+    // checked again once the flag is set: either shutdown waits for the push, or this thread sees it started
+    thread->pushing.store(true, std::memory_order_seq_cst);
+    if (!m_running.load(std::memory_order_seq_cst))
+    {
+        thread->pushing.store(false, std::memory_order_release);
+        return false;
+    }
+
+    if (!thread->queue.tryPush(record))
+    { // only this thread writes the counter, the writer thread reads it
+        thread->dropped.store(thread->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    thread->pushing.store(false, std::memory_order_release);
+    return true;
+}
+
+void Logger_s::write(LogRecord_t const &record)
+{
+    Char8_t message[logMessageSize];
+    record.decode(message, logMessageSize, record.format, record.args);
+
+    HiResCalibration_t const &calibration = hiResCalibration();
+    F64_t const milliseconds =
+      record.timestamp > calibration.ticks ? hiResToNanoseconds(record.timestamp - calibration.ticks) * 1e-6 : 0.;
+    fprintf(m_out, "[%10.3f] %c %s\n", milliseconds, s_levelTags[static_cast<U32_t>(record.level)], message);
+}
+
+U32_t Logger_s::drain()
+{
+    U32_t       count       = 0;
+    U32_t const threadCount = std::min(m_threadCount.load(std::memory_order_acquire), logMaxThreads);
+    for (U32_t i = 0; i != threadCount; ++i)
+    {
+        LogThread_t *thread = m_threads[i].load(std::memory_order_acquire);
+        while (thread && count != logPassCapacity && thread->queue.tryPop(m_pending[count]))
+        {
+            ++count;
+        }
+    }
+
+    // records of a thread are already ordered, the stable sort interleaves the threads
+    std::stable_sort(m_pending, m_pending + count, [](LogRecord_t const &a, LogRecord_t const &b) {
+        return a.timestamp < b.timestamp;
+    });
+    for (U32_t i = 0; i != count; ++i)
+    {
+        write(m_pending[i]);
+    }
+
+    if (U64_t const dropped = this->dropped(); dropped != m_reported)
+    {
+        fprintf(
+          m_out, "[Log] %llu records dropped, queues full\n", static_cast<unsigned long long>(dropped - m_reported));
+        m_reported = dropped;
+    }
+    if (count)
+    {
+        fflush(m_out);
+    }
+    return count;
+}
+
+void Logger_s::writerLoop()
+{
+    while (m_running.load(std::memory_order_acquire))
+    {
+        if (drain() == 0)
+        {
+            std::this_thread::sleep_for(logFlushPeriod);
+        }
+    }
+
+    // records pushed before shutdown
+    while (drain() != 0)
+    {
+    }
+}
+
+} // namespace cge
@@ -1,5 +1,7 @@
 #include "Module.h"
 
+#include "Alloc.h"
+
 #include <unordered_map>
 
 namespace cge
@@ -22,6 +24,10 @@ void IModule::onInit()
     moduleInitOnce.at(m_id) = true;
 }
 
+void IModule::onRender([[maybe_unused]] F32_t alpha)
+{
+}
+
 bool IModule::taggedForDestruction() const
 {
     return m_taggedForDestruction;
@@ -48,26 +54,56 @@ void IModule::resetSwitchModule()
 }
 
 
-std::pmr::unsynchronized_pool_resource *getMemoryPool()
+SlabPool *getMemoryPool()
 {
-    static U32_t constexpr bufferSize = 1U << 10;
-    static unsigned char                       poolBuffer[bufferSize];
-    static std::pmr::monotonic_buffer_resource poolUpstream{ poolBuffer, bufferSize };
-
-    static std::pmr::unsynchronized_pool_resource g_memoryPool{ std::pmr::pool_options{
-                                                                  .max_blocks_per_chunk        = 16,
-                                                                  .largest_required_pool_block = 256,
-                                                                },
-                                                                &poolUpstream };
+    // slabs are carved from the persistent slot of the engine arena, larger blocks go to the global heap
+    static SlabPool g_memoryPool{ &getEngineArena().persistent(), std::pmr::new_delete_resource() };
     return &g_memoryPool;
 }
 
-std::pmr::monotonic_buffer_resource *getScratchBuffer()
+#if defined(CGE_DEBUG)
+static TrackingResource *getTrackingResources()
 {
-    static U32_t constexpr bufferSize = 4096;
-    static unsigned char                       scratchBuffer[bufferSize * bufferSize];
-    static std::pmr::monotonic_buffer_resource g_scratchBuffer{ scratchBuffer, bufferSize };
-    return &g_scratchBuffer;
+    static TrackingResource g_trackingResources[static_cast<U32_t>(EMemoryTag_t::eMemoryTagCount)];
+    [[maybe_unused]] static B8_t const initialized = []()
+    {
+        static Char8_t const *const tagNames[] = {
+            "Generic", "Events", "Scene", "HandleTable", "Renderer2D", "Tasks", "TimeSlice",
+        };
+        for (U32_t i = 0; i != static_cast<U32_t>(EMemoryTag_t::eMemoryTagCount); ++i)
+        {
+            g_trackingResources[i].init(tagNames[i], getMemoryPool());
+        }
+        return true;
+    }();
+    return g_trackingResources;
+}
+
+std::pmr::memory_resource *getMemoryPool(EMemoryTag_t tag)
+{ //
+    return &getTrackingResources()[static_cast<U32_t>(tag)];
+}
+
+void dbg_printMemoryTagStats()
+{
+    TrackingResource const *resources = getTrackingResources();
+    for (U32_t i = 0; i != static_cast<U32_t>(EMemoryTag_t::eMemoryTagCount); ++i)
+    {
+        MemoryTagStats_t const s = resources[i].stats();
+        printf(
+          "[MemoryTag] \t%-12s bytes: %10zu, peak: %10zu, allocations: %8zu, live: %8zu\n",
+          resources[i].name(),
+          s.bytes,
+          s.peakBytes,
+          s.count,
+          s.liveCount);
+    }
+}
+#endif
+
+DoubleBufferedAllocator *getScratchBuffer()
+{ // frame slots of the engine arena
+    return &getEngineArena().frame();
 }
 
 GlobalStore::GlobalStore() : m_map(getMemoryPool())
@@ -0,0 +1,267 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace cge
+{
+
+Profiler_s g_profiler;
+
+// fields are relaxed atomics so that the dump can read a slot being overwritten; on x86 they are plain moves
+struct ProfileSlot_t
+{
+    std::atomic<Char8_t const *> name;
+    std::atomic<U64_t>           start;
+    std::atomic<U64_t>           end;
+};
+
+struct alignas(64) ProfileThread_t
+{
+    std::atomic<U64_t> head{ 0 };     ///< zones ever recorded, the oldest ones being overwritten
+    std::atomic<B8_t>  owned{ true }; ///< cleared when the thread exits, so that another one can reuse the buffer
+    U32_t              index = 0;
+    Char8_t            name[profileThreadName]{};
+    ProfileSlot_t      zones[profileRingCapacity];
+};
+
+struct ProfileThreadHandle_t
+{
+    ~ProfileThreadHandle_t()
+    {
+        if (buffer)
+        {
+            buffer->owned.store(false, std::memory_order_release);
+        }
+    }
+
+    ProfileThread_t *buffer     = nullptr;
+    B8_t             registered = false;
+};
+
+static thread_local ProfileThreadHandle_t s_profileThread;
+
+Profiler_s::~Profiler_s()
+{
+    for (std::atomic<ProfileThread_t *> &thread : m_threads)
+    {
+        if (ProfileThread_t *buffer = thread.load(std::memory_order_acquire); buffer)
+        {
+            delete buffer;
+        }
+    }
+}
+
+void Profiler_s::initFromEnvironment()
+{
+    Char8_t const *budget = std::getenv("CGE_PROFILE_BUDGET");
+    if (!budget)
+    {
+        return;
+    }
+
+    Char8_t const *frames = std::getenv("CGE_PROFILE_FRAMES");
+    setFlightRecorder(static_cast<U64_t>(std::atof(budget) * 1e6), frames ? std::atoi(frames) : 8);
+}
+
+void Profiler_s::setFlightRecorder(U64_t budgetNanoseconds, U32_t frames)
+{
+    m_budget         = budgetNanoseconds * hiResFrequency() / 1'000'000'000ULL;
+    m_recordedFrames = std::clamp(frames, 1U, profileMaxFrames);
+    if (m_budget)
+    {
+        printf(
+          "[Profiler] flight recorder: traces of %u frames when a frame exceeds %.3f ms\n",
+          m_recordedFrames,
+          budgetNanoseconds * 1e-6);
+    }
+}
+
+void Profiler_s::beginFrame()
+{ //
+    m_frames[m_frameIndex & (profileMaxFrames - 1)].start = hiResTimer();
+}
+
+void Profiler_s::endFrame()
+{
+    Frame_t &frame = m_frames[m_frameIndex & (profileMaxFrames - 1)];
+    frame.end      = hiResTimer();
+    record("Frame", frame.start, frame.end);
+    ++m_frameIndex;
+
+    if (m_budget && frame.end - frame.start > m_budget && m_frameIndex >= m_nextDumpFrame)
+    {
+        Char8_t path[64];
+        snprintf(path, sizeof(path), "cge_trace_%u.json", m_frameIndex - 1);
+        if (dumpChromeTrace(path, m_recordedFrames) == EErr_t::eSuccess)
+        {
+            printf(
+              "[Profiler] frame %u took %.3f ms, trace of the last %u frames written to %s\n",
+              m_frameIndex - 1,
+              hiResToNanoseconds(frame.end - frame.start) * 1e-6,
+              std::min(m_recordedFrames, m_frameIndex),
+              path);
+        }
+        m_nextDumpFrame = m_frameIndex + m_recordedFrames;
+    }
+}
+
+ProfileThread_t *Profiler_s::threadBuffer()
+{
+    if (s_profileThread.registered)
+    {
+        return s_profileThread.buffer;
+    }
+    s_profileThread.registered = true;
+
+    // adopt the buffer of an exited thread, or claim a new one
+    U32_t const threadCount = std::min(m_threadCount.load(std::memory_order_acquire), profileMaxThreads);
+    for (U32_t i = 0; i != threadCount; ++i)
+    {
+        ProfileThread_t *buffer = m_threads[i].load(std::memory_order_acquire);
+        B8_t             owned  = false;
+        if (buffer && buffer->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+        {
+            snprintf(buffer->name, profileThreadName, "Thread %u", i);
+            s_profileThread.buffer = buffer;
+            return buffer;
+        }
+    }
+
+    U32_t const index = m_threadCount.fetch_add(1, std::memory_order_relaxed);
+    if (index >= profileMaxThreads)
+    {
+        printf("[Profiler] more than %u threads recording zones, further zones are dropped\n", profileMaxThreads);
+        return nullptr;
+    }
+
+    // outside of the memory pools, so that profiling doesn't show up in their statistics
+    auto *buffer  = new ProfileThread_t();
+    buffer->index = index;
+    snprintf(buffer->name, profileThreadName, "Thread %u", index);
+    m_threads[index].store(buffer, std::memory_order_release);
+    s_profileThread.buffer = buffer;
+    return buffer;
+}
+
+void Profiler_s::record(Char8_t const *name, U64_t start, U64_t end)
+{
+    ProfileThread_t *buffer = threadBuffer();
+    if (!buffer)
+    {
+        return;
+    }
+
+    U64_t const    head = buffer->head.load(std::memory_order_relaxed);
+    ProfileSlot_t &slot = buffer->zones[head & (profileRingCapacity - 1)];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler_s::setThreadName(Char8_t const *name)
+{
+    if (ProfileThread_t *buffer = threadBuffer(); buffer)
+    {
+        snprintf(buffer->name, profileThreadName, "%s", name);
+    }
+}
+
+/// zone names are literals, but quotes would still break the JSON
+static void writeJsonString(std::FILE *file, Char8_t const *str)
+{
+    std::fputc('"', file);
+    for (; *str; ++str)
+    {
+        if (*str == '"' || *str == '\\')
+        {
+            std::fputc('\\', file);
+        }
+        std::fputc(*str, file);
+    }
+    std::fputc('"', file);
+}
+
+EErr_t Profiler_s::dumpChromeTrace(Char8_t const *path, U32_t frames) const
+{
+    U32_t const completed = std::min({ frames, m_frameIndex, profileMaxFrames });
+    if (completed == 0)
+    {
+        return EErr_t::eInvalid;
+    }
+
+    std::FILE *file = std::fopen(path, "w");
+    if (!file)
+    {
+        printf("[Profiler] cannot open %s for writing\n", path);
+        return EErr_t::eCreationFailure;
+    }
+
+    Frame_t const &first        = m_frames[(m_frameIndex - completed) & (profileMaxFrames - 1)];
+    Frame_t const &last         = m_frames[(m_frameIndex - 1) & (profileMaxFrames - 1)];
+    U64_t const    origin       = hiResCalibration().ticks;
+    F64_t const    microPerTick = 1e6 / static_cast<F64_t>(hiResFrequency());
+
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    B8_t                       firstEvent = true;
+    std::vector<ProfileZone_t> zones;
+    U32_t const                threadCount = std::min(m_threadCount.load(std::memory_order_acquire), profileMaxThreads);
+    for (U32_t t = 0; t != threadCount; ++t)
+    {
+        ProfileThread_t const *buffer = m_threads[t].load(std::memory_order_acquire);
+        if (!buffer)
+        {
+            continue;
+        }
+
+        // copy, then discard what the owner may have overwritten in the meantime
+        U64_t const head = buffer->head.load(std::memory_order_acquire);
+        U64_t const tail = head > profileRingCapacity ? head - profileRingCapacity : 0;
+        zones.clear();
+        for (U64_t i = tail; i != head; ++i)
+        {
+            ProfileSlot_t const &slot = buffer->zones[i & (profileRingCapacity - 1)];
+            zones.push_back({ .name  = slot.name.load(std::memory_order_relaxed),
+                              .start = slot.start.load(std::memory_order_relaxed),
+                              .end   = slot.end.load(std::memory_order_relaxed) });
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        U64_t const newHead = buffer->head.load(std::memory_order_relaxed);
+        U64_t const valid   = newHead > profileRingCapacity ? newHead - profileRingCapacity : 0;
+        U64_t const skipped = valid > tail ? std::min(valid - tail, head - tail) : 0;
+
+        fprintf(
+          file,
+          "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":",
+          firstEvent ? "" : ",\n",
+          buffer->index);
+        writeJsonString(file, buffer->name);
+        std::fputs("}}", file);
+        firstEvent = false;
+
+        for (U64_t i = skipped; i < zones.size(); ++i)
+        {
+            ProfileZone_t const &zone = zones[i];
+            if (zone.end < first.start || zone.start > last.end)
+            {
+                continue;
+            }
+            std::fputs(",\n{\"name\":", file);
+            writeJsonString(file, zone.name);
+            fprintf(
+              file,
+              ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+              buffer->index,
+              static_cast<F64_t>(static_cast<I64_t>(zone.start - origin)) * microPerTick,
+              static_cast<F64_t>(zone.end - zone.start) * microPerTick);
+        }
+    }
+    std::fputs("\n]}\n", file);
+    std::fclose(file);
+    return EErr_t::eSuccess;
+}
+
+} // namespace cge
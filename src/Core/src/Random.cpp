@@ -1,11 +1,272 @@
 #include "Random.h"
 
+#include "MacroDefs.h"
+
+#include <cstring>
+#include <immintrin.h>
+
 namespace cge
 {
 // Static mutex initialization (only once)
 thread_local Random g_random;
 
-std::mt19937 &Random::getGen()
+// jump polynomials of xoshiro256**
+static U64_t constexpr s_jump[4]{
+    0x180e'c6d3'3cfd'0abaULL, 0xd5a6'1266'f0c9'392cULL, 0xa958'2618'e03f'c9aaULL, 0x39ab'dc45'29b1'661cULL
+};
+static U64_t constexpr s_longJump[4]{
+    0x76e1'5d3e'fefd'cbbfULL, 0xc500'4e44'1c52'2fb3ULL, 0x7771'0069'854e'e241ULL, 0x3910'9bb0'2acb'e635ULL
+};
+
+static void jumpBy(Xoshiro256_t &generator, U64_t const (&polynomial)[4])
+{
+    U64_t result[4]{};
+    for (U64_t word : polynomial)
+    {
+        for (U32_t bit = 0; bit != 64; ++bit)
+        {
+            if (word & (1ULL << bit))
+            {
+                for (U32_t i = 0; i != 4; ++i)
+                { //
+                    result[i] ^= generator.s[i];
+                }
+            }
+            generator();
+        }
+    }
+    std::memcpy(generator.s, result, sizeof(result));
+}
+
+void Xoshiro256_t::jump()
+{ //
+    jumpBy(*this, s_jump);
+}
+
+void Xoshiro256_t::longJump()
+{ //
+    jumpBy(*this, s_longJump);
+}
+
+Xoshiro256_t Xoshiro256_t::stream(U64_t seed, U32_t index)
+{
+    Xoshiro256_t generator;
+    generator.seed(seed);
+    for (U32_t i = 0; i != index; ++i)
+    { //
+        generator.jump();
+    }
+    return generator;
+}
+
+void RandomLanes_t::seed(U64_t value)
+{
+    Xoshiro256_t generator;
+    generator.seed(value);
+    for (U32_t lane = 0; lane != randomLanes; ++lane)
+    {
+        for (U32_t i = 0; i != 4; ++i)
+        { //
+            s[i][lane] = generator.s[i];
+        }
+        generator.jump();
+    }
+}
+
+void RandomLanes_t::seed(U64_t value, U64_t key)
+{
+    U64_t mixed = value;
+    mixed       = splitMix64(mixed) ^ key;
+    seed(mixed);
+}
+
+void randomFillScalar(RandomLanes_t &lanes, U64_t *out, U64_t count)
+{
+    for (U64_t i = 0; i < count; i += randomLanes)
+    {
+        for (U32_t lane = 0; lane != randomLanes; ++lane)
+        {
+            Xoshiro256_t generator{ { lanes.s[0][lane], lanes.s[1][lane], lanes.s[2][lane], lanes.s[3][lane] } };
+            U64_t const  result = generator();
+            for (U32_t word = 0; word != 4; ++word)
+            { //
+                lanes.s[word][lane] = generator.s[word];
+            }
+            if (i + lane < count)
+            { //
+                out[i + lane] = result;
+            }
+        }
+    }
+}
+
+// SSE2 has neither 64 bit rotations nor multiplications, but the multipliers of xoshiro256** are 5 and 9
+static inline CGE_forceinline __m128i rotl64(__m128i x, I32_t k)
+{ //
+    return _mm_or_si128(_mm_slli_epi64(x, k), _mm_srli_epi64(x, 64 - k));
+}
+
+void randomFillSSE2(RandomLanes_t &lanes, U64_t *out, U64_t count)
+{
+    static_assert(randomLanes == 4, "two vectors of two lanes per state word");
+    __m128i s0[2], s1[2], s2[2], s3[2];
+    for (U32_t h = 0; h != 2; ++h)
+    {
+        s0[h] = _mm_load_si128(reinterpret_cast<__m128i const *>(&lanes.s[0][2 * h]));
+        s1[h] = _mm_load_si128(reinterpret_cast<__m128i const *>(&lanes.s[1][2 * h]));
+        s2[h] = _mm_load_si128(reinterpret_cast<__m128i const *>(&lanes.s[2][2 * h]));
+        s3[h] = _mm_load_si128(reinterpret_cast<__m128i const *>(&lanes.s[3][2 * h]));
+    }
+
+    for (U64_t i = 0; i < count; i += randomLanes)
+    {
+        alignas(16) U64_t batch[randomLanes];
+        for (U32_t h = 0; h != 2; ++h)
+        {
+            __m128i const x5     = _mm_add_epi64(_mm_slli_epi64(s1[h], 2), s1[h]);
+            __m128i const r      = rotl64(x5, 7);
+            __m128i const result = _mm_add_epi64(_mm_slli_epi64(r, 3), r);
+            __m128i const t      = _mm_slli_epi64(s1[h], 17);
+            s2[h]                = _mm_xor_si128(s2[h], s0[h]);
+            s3[h]                = _mm_xor_si128(s3[h], s1[h]);
+            s1[h]                = _mm_xor_si128(s1[h], s2[h]);
+            s0[h]                = _mm_xor_si128(s0[h], s3[h]);
+            s2[h]                = _mm_xor_si128(s2[h], t);
+            s3[h]                = rotl64(s3[h], 45);
+            _mm_store_si128(reinterpret_cast<__m128i *>(&batch[2 * h]), result);
+        }
+
+        U64_t const written = count - i < randomLanes ? count - i : randomLanes;
+        std::memcpy(out + i, batch, written * sizeof(U64_t));
+    }
+
+    for (U32_t h = 0; h != 2; ++h)
+    {
+        _mm_store_si128(reinterpret_cast<__m128i *>(&lanes.s[0][2 * h]), s0[h]);
+        _mm_store_si128(reinterpret_cast<__m128i *>(&lanes.s[1][2 * h]), s1[h]);
+        _mm_store_si128(reinterpret_cast<__m128i *>(&lanes.s[2][2 * h]), s2[h]);
+        _mm_store_si128(reinterpret_cast<__m128i *>(&lanes.s[3][2 * h]), s3[h]);
+    }
+}
+
+CGE_target("avx2") static inline CGE_forceinline void storeLanes(U64_t *out, U64_t left, __m256i values)
+{
+    if (left >= randomLanes)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), values);
+        return;
+    }
+    alignas(32) U64_t batch[randomLanes];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(batch), values);
+    std::memcpy(out, batch, left * sizeof(U64_t));
+}
+
+CGE_target("avx2") static inline CGE_forceinline __m256i rotl64(__m256i x, I32_t k)
+{ //
+    return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+}
+
+/// the 4 lanes of a state word in a single vector
+CGE_target("avx2") void randomFillAVX2(RandomLanes_t &lanes, U64_t *out, U64_t count)
+{
+    static_assert(randomLanes == 4, "one vector of four lanes per state word");
+    __m256i s0 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(lanes.s[0]));
+    __m256i s1 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(lanes.s[1]));
+    __m256i s2 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(lanes.s[2]));
+    __m256i s3 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(lanes.s[3]));
+
+    for (U64_t i = 0; i < count; i += randomLanes)
+    {
+        __m256i const x5     = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+        __m256i const r      = rotl64(x5, 7);
+        __m256i const result = _mm256_add_epi64(_mm256_slli_epi64(r, 3), r);
+        __m256i const t      = _mm256_slli_epi64(s1, 17);
+        s2                   = _mm256_xor_si256(s2, s0);
+        s3                   = _mm256_xor_si256(s3, s1);
+        s1                   = _mm256_xor_si256(s1, s2);
+        s0                   = _mm256_xor_si256(s0, s3);
+        s2                   = _mm256_xor_si256(s2, t);
+        s3                   = rotl64(s3, 45);
+        storeLanes(out + i, count - i, result);
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes.s[0]), s0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes.s[1]), s1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes.s[2]), s2);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes.s[3]), s3);
+}
+
+/// as @ref randomFillAVX2, with the rotations as single instructions and masked stores for the tail
+CGE_target("avx512f,avx512vl") void randomFillAVX512(RandomLanes_t &lanes, U64_t *out, U64_t count)
+{
+    __m256i s0 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(lanes.s[0]));
+    __m256i s1 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(lanes.s[1]));
+    __m256i s2 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(lanes.s[2]));
+    __m256i s3 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(lanes.s[3]));
+
+    for (U64_t i = 0; i < count; i += randomLanes)
+    {
+        __m256i const x5     = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+        __m256i const r      = _mm256_rol_epi64(x5, 7);
+        __m256i const result = _mm256_add_epi64(_mm256_slli_epi64(r, 3), r);
+        __m256i const t      = _mm256_slli_epi64(s1, 17);
+        s2                   = _mm256_xor_si256(s2, s0);
+        s3                   = _mm256_xor_si256(s3, s1);
+        s1                   = _mm256_xor_si256(s1, s2);
+        s0                   = _mm256_xor_si256(s0, s3);
+        s2                   = _mm256_xor_si256(s2, t);
+        s3                   = _mm256_rol_epi64(s3, 45);
+
+        __mmask8 const mask = count - i < randomLanes ? static_cast<__mmask8>((1U << (count - i)) - 1) : 0xf;
+        _mm256_mask_storeu_epi64(out + i, mask, result);
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes.s[0]), s0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes.s[1]), s1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes.s[2]), s2);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes.s[3]), s3);
+}
+
+constinit Kernel_s<RandomFillFunc_t> const g_randomFillKernel{
+    "randomFill",
+    { { EIsa_t::eScalar, randomFillScalar },
+      { EIsa_t::eSSE2, randomFillSSE2 },
+      { EIsa_t::eAVX2, randomFillAVX2 },
+      { EIsa_t::eAVX512, randomFillAVX512 } }
+};
+
+void RandomLanes_t::fill(U64_t *out, U64_t count)
+{ //
+    g_randomFillKernel(*this, out, count);
+}
+
+void RandomLanes_t::fillUnit(F32_t *out, U64_t count)
+{
+    // converted in chunks through a buffer on the stack
+    static U64_t constexpr chunk = 64;
+    U64_t                  bits[chunk];
+    for (U64_t i = 0; i < count; i += chunk)
+    {
+        U64_t const n = count - i < chunk ? count - i : chunk;
+        fill(bits, n);
+        for (U64_t j = 0; j != n; ++j)
+        { //
+            out[i + j] = toUnitFloat(bits[j]);
+        }
+    }
+}
+
+void Random::seed(U64_t value)
+{
+    m_generator.seed(value);
+}
+
+void Random::seed(U64_t value, U64_t key)
+{
+    m_generator.seed(value, key);
+}
+
+Xoshiro256_t &Random::getGen()
 { //
     return m_generator;
 }
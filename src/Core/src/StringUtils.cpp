@@ -1,55 +1,268 @@
 #include "StringUtils.h"
 
-#if defined(CGE_DEBUG)
+#include "MacroDefs.h"
+
 #include <cstring>
-#include <memory>
-#include <unordered_map>
-#endif
 
+#if defined(CGE_DEBUG)
+#include <cstdlib>
+#include <mutex>
+#endif
 
 namespace cge
 {
 
+// slicing-by-8: table k maps a byte to its contribution shifted by k further bytes, so that 8 bytes of input
+// are consumed with 8 independent lookups instead of a chain of 8 dependent ones
+struct CRC64SliceTables_t
+{
+    U64_t t[8][256];
+};
+
+static CRC64SliceTables_t constexpr computeSliceTables()
+{
+    CRC64SliceTables_t tables{};
+    for (U32_t i = 0; i != 256; ++i)
+    {
+        tables.t[0][i] = g_CRC64Table[i];
+    }
+    for (U32_t k = 1; k != 8; ++k)
+    {
+        for (U32_t i = 0; i != 256; ++i)
+        {
+            U64_t const prev = tables.t[k - 1][i];
+            tables.t[k][i]   = g_CRC64Table[prev >> 56] ^ (prev << 8);
+        }
+    }
+    return tables;
+}
+
+static CRC64SliceTables_t constexpr s_sliceTables = computeSliceTables();
+
+/// x^n mod P, with P the CRC64 polynomial with its implicit x^64 term
+static U64_t constexpr xPowModCRC64(U32_t n)
+{
+    U64_t r = 1;
+    for (U32_t i = 0; i != n; ++i)
+    {
+        r = (r << 1) ^ ((r >> 63) ? g_CRC64Table[1] : 0);
+    }
+    return r;
+}
+
+// folding constants: a 128 bit block H x^64 + L, moved 128 bits forward, is congruent to H x^192 + L x^128
+static U64_t constexpr s_foldK1 = xPowModCRC64(192);
+static U64_t constexpr s_foldK2 = xPowModCRC64(128);
+
+static inline CGE_forceinline U64_t loadBigEndian64(U8_t const *p)
+{
+    U64_t v;
+    std::memcpy(&v, p, sizeof(U64_t));
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _byteswap_uint64(v);
+#else
+    return __builtin_bswap64(v);
+#endif
+}
+
+/// (v x^64) mod P
+static inline CGE_forceinline U64_t reduceCRC64(U64_t v)
+{
+    return s_sliceTables.t[7][v >> 56] ^ s_sliceTables.t[6][(v >> 48) & 0xff] ^ s_sliceTables.t[5][(v >> 40) & 0xff]
+           ^ s_sliceTables.t[4][(v >> 32) & 0xff] ^ s_sliceTables.t[3][(v >> 24) & 0xff]
+           ^ s_sliceTables.t[2][(v >> 16) & 0xff] ^ s_sliceTables.t[1][(v >> 8) & 0xff] ^ s_sliceTables.t[0][v & 0xff];
+}
+
+static U64_t hashCRC64Slice8(U8_t const *p, U64_t len, U64_t crc)
+{
+    for (; len >= 8; len -= 8, p += 8)
+    {
+        crc = reduceCRC64(crc ^ loadBigEndian64(p));
+    }
+    for (; len != 0; --len)
+    {
+        crc = g_CRC64Table[static_cast<U8_t>(crc >> 56) ^ *p++] ^ (crc << 8);
+    }
+    return crc;
+}
+
+// below this length the setup of the folding costs more than it saves
+static U64_t constexpr s_clmulMinLength = 64;
+
+/// the register holds the polynomial of the input read so far, ie bit 127 is the first bit of the first byte
+CGE_target("pclmul,ssse3") static U64_t hashCRC64Clmul(U8_t const *p, U64_t len, U64_t crc)
+{
+    if (len < s_clmulMinLength)
+    {
+        return hashCRC64Slice8(p, len, crc);
+    }
+
+    __m128i const bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i const k     = _mm_set_epi64x(static_cast<I64_t>(s_foldK1), static_cast<I64_t>(s_foldK2));
+
+    __m128i acc = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const *>(p)), bswap);
+    acc         = _mm_xor_si128(acc, _mm_set_epi64x(static_cast<I64_t>(crc), 0));
+    p += 16;
+    len -= 16;
+
+    for (; len >= 16; len -= 16, p += 16)
+    {
+        __m128i const data = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const *>(p)), bswap);
+        __m128i const hi   = _mm_clmulepi64_si128(acc, k, 0x11);
+        __m128i const lo   = _mm_clmulepi64_si128(acc, k, 0x00);
+        acc                = _mm_xor_si128(_mm_xor_si128(hi, lo), data);
+    }
+
+    // (H x^128 + L x^64) mod P: H is folded onto the low half, whose top 64 bits go through the tables
+    __m128i const folded = _mm_clmulepi64_si128(acc, k, 0x01);
+    U64_t const   high   = static_cast<U64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(folded, folded)))
+                     ^ static_cast<U64_t>(_mm_cvtsi128_si64(acc));
+    U64_t const   low    = static_cast<U64_t>(_mm_cvtsi128_si64(folded));
+    return hashCRC64Slice8(p, len, reduceCRC64(high) ^ low);
+}
+
+constinit Kernel_s<CRC64Func_t> const g_crc64Kernel{
+    "crc64", { { EIsa_t::eScalar, hashCRC64Slice8 }, { EIsa_t::eSSE42, hashCRC64Clmul } }
+};
+
+U64_t hashCRC64Runtime(std::string_view str, U64_t crc)
+{ //
+    return g_crc64Kernel(reinterpret_cast<U8_t const *>(str.data()), str.size(), crc);
+}
+
 #if defined(CGE_DEBUG)
 
-// cannot store char array directly into table as table can get relocated
+// The intern table is split in shards selected by the top bits of the sid, each with its own lock, open addressing
+// table and arena, so that loader threads interning at the same time rarely contend. Strings are copied once,
+// contiguously, into chunks which are never freed nor moved, hence the pointers stored in Sid_t stay valid.
+// Everything is constant initialized and allocated with malloc, so that interning works during static
+// initialization and doesn't show up in the allocation tracking of the engine
+
+static U32_t constexpr internShardBits       = 4;
+static U32_t constexpr internShardCount      = 1U << internShardBits;
+static U32_t constexpr internInitialCapacity = 256; ///< power of two, slots per shard
+static U64_t constexpr internChunkSize       = 64 * 1024;
 
-using StringMap                    = std::unordered_map<U64_t, std::unique_ptr<Char8_t[]>>;
 static Char8_t const *const errStr = "Error: String Not Found";
 
-// Avoid static order initialization fiasco (MSVC map implementation)
-StringMap &getTable()
+struct InternEntry_t
+{
+    U64_t          id;
+    Char8_t const *str; ///< nullptr for empty slots
+};
+
+struct InternChunk_t
+{
+    InternChunk_t *next;
+    U64_t          size;
+    U64_t          used;
+    // characters follow
+};
+
+struct InternShard_t
 {
-    static StringMap table;
-    return table;
+    std::mutex     mutex;
+    InternEntry_t *entries  = nullptr;
+    U32_t          capacity = 0;
+    U32_t          count    = 0;
+    InternChunk_t *chunks   = nullptr; ///< the head is the one being filled
+    U64_t          bytes    = 0;       ///< characters stored, terminators included
+};
+
+static InternShard_t s_internShards[internShardCount];
+
+static InternShard_t &internShard(U64_t id)
+{ //
+    return s_internShards[id >> (64 - internShardBits)];
 }
 
-Sid_t dbg_internString(Char8_t const *str)
+/// returns the slot holding `id`, or the empty slot where it should be inserted. Requires the shard lock
+static InternEntry_t *findSlot(InternShard_t const &shard, U64_t id)
 {
-    Sid_t strId            = { .id = hashCRC64(str) };
-    auto [it, wasInserted] = getTable().try_emplace(strId.id, std::make_unique<Char8_t[]>(1024));
-    if (wasInserted)
+    U32_t const mask = shard.capacity - 1;
+    for (U32_t i = static_cast<U32_t>(id) & mask;; i = (i + 1) & mask)
     {
-        strcpy(it->second.get(), str);
-// debug print if needed
-#if 0
-        printf("[StringUtils] Interned new String, table has now size: %zu\n", table.size());
-        for (auto const &[num, ptr] : table)
+        InternEntry_t *entry = &shard.entries[i];
+        if (!entry->str || entry->id == id)
         {
-            auto const *const str1 = &ptr[0];
-            printf("[StringUtils] \t{ %zu, %s }\n", num, str1);
+            return entry;
         }
-#endif
-        strId.pStr = &it->second[0];
     }
-    else if (auto it1 = getTable().find(strId.id); it1 != getTable().cend())
+}
+
+static void growShard(InternShard_t &shard)
+{
+    InternEntry_t *old         = shard.entries;
+    U32_t const    oldCapacity = shard.capacity;
+
+    shard.capacity = oldCapacity ? oldCapacity << 1 : internInitialCapacity;
+    shard.entries  = static_cast<InternEntry_t *>(std::calloc(shard.capacity, sizeof(InternEntry_t)));
+    for (U32_t i = 0; i != oldCapacity; ++i)
     {
-        strId.pStr = &it1->second[0];
+        if (old[i].str)
+        {
+            *findSlot(shard, old[i].id) = old[i];
+        }
     }
-    else
+    std::free(old);
+}
+
+static Char8_t const *copyToArena(InternShard_t &shard, Char8_t const *str, U64_t length)
+{
+    U64_t const    size  = length + 1;
+    InternChunk_t *chunk = shard.chunks;
+    if (!chunk || chunk->size - chunk->used < size)
     {
-        strId.pStr = errStr;
+        U64_t const chunkSize = size > internChunkSize ? size : internChunkSize;
+        chunk                 = static_cast<InternChunk_t *>(std::malloc(sizeof(InternChunk_t) + chunkSize));
+        chunk->size           = chunkSize;
+        chunk->used           = 0;
+        if (shard.chunks && size > internChunkSize)
+        {
+            // an oversized string gets a chunk of its own, the current one keeps being filled
+            chunk->next        = shard.chunks->next;
+            shard.chunks->next = chunk;
+        }
+        else
+        {
+            chunk->next  = shard.chunks;
+            shard.chunks = chunk;
+        }
     }
+
+    auto *dst = reinterpret_cast<Char8_t *>(chunk + 1) + chunk->used;
+    std::memcpy(dst, str, length);
+    dst[length] = '\0';
+    chunk->used += size;
+    shard.bytes += size;
+    return dst;
+}
+
+Sid_t dbg_internString(Char8_t const *str)
+{
+    U64_t const    length = std::strlen(str);
+    Sid_t          strId  = { .id = hashCRC64Runtime(std::string_view(str, length)), .pStr = nullptr };
+    InternShard_t &shard  = internShard(strId.id);
+
+    std::lock_guard lock(shard.mutex);
+    if ((shard.count + 1) * 4 > shard.capacity * 3)
+    {
+        growShard(shard);
+    }
+
+    InternEntry_t *entry = findSlot(shard, strId.id);
+    if (!entry->str)
+    {
+        entry->id  = strId.id;
+        entry->str = copyToArena(shard, str, length);
+        ++shard.count;
+    }
+    else if (std::strcmp(entry->str, str) != 0)
+    {
+        printf("[StringUtils] sid collision: \"%s\" and \"%s\" both hash to 0x%016zx\n", entry->str, str, strId.id);
+    }
+
+    strId.pStr = entry->str;
     return strId;
 }
 
@@ -59,15 +272,42 @@ Char8_t const *dbg_lookupString(Sid_t sid)
     {
         return sid.pStr;
     }
-    else if (auto it = getTable().find(sid.id); it != getTable().cend())
+
+    InternShard_t  &shard = internShard(sid.id);
+    std::lock_guard lock(shard.mutex);
+    if (shard.capacity != 0)
     {
-        sid.pStr = &it->second[0];
-        return sid.pStr;
+        if (InternEntry_t const *entry = findSlot(shard, sid.id); entry->str)
+        {
+            return entry->str;
+        }
     }
-    else
+    return errStr;
+}
+
+void dbg_dumpSids(std::FILE *out)
+{
+    U64_t count  = 0;
+    U64_t bytes  = 0;
+    U64_t chunks = 0;
+    for (InternShard_t &shard : s_internShards)
     {
-        return errStr;
+        std::lock_guard lock(shard.mutex);
+        for (U32_t i = 0; i != shard.capacity; ++i)
+        {
+            if (shard.entries[i].str)
+            {
+                fprintf(out, "0x%016zx %s\n", shard.entries[i].id, shard.entries[i].str);
+            }
+        }
+        for (InternChunk_t const *chunk = shard.chunks; chunk; chunk = chunk->next)
+        {
+            ++chunks;
+        }
+        count += shard.count;
+        bytes += shard.bytes;
     }
+    fprintf(out, "[StringUtils] %zu interned strings, %zu bytes in %zu chunks\n", count, bytes, chunks);
 }
 #endif
 } // namespace cge
@@ -0,0 +1,207 @@
+#include "Task.h"
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace cge
+{
+
+TaskScheduler_s g_taskScheduler;
+
+static U32_t constexpr initialTaskCapacity = 64;
+
+/// std heap functions build max heaps, hence the comparison is reversed
+static B8_t laterThan(auto const &a, auto const &b)
+{ //
+    return a.deadline != b.deadline ? a.deadline > b.deadline : a.sequence > b.sequence;
+}
+
+TaskScheduler_s::TaskScheduler_s()
+{
+    m_slots.reserve(initialTaskCapacity);
+    m_ready.reserve(initialTaskCapacity);
+    m_resuming.reserve(initialTaskCapacity);
+}
+
+TaskScheduler_s::~TaskScheduler_s()
+{ //
+    shutdown();
+}
+
+TaskHandle_t TaskScheduler_s::spawn(Task_s task)
+{
+    std::coroutine_handle<TaskPromise_t> const root = task.release();
+    if (!root)
+    {
+        return nullTaskHandle;
+    }
+
+    U32_t slotIndex = m_freeSlot;
+    if (slotIndex != invalidSlot)
+    {
+        m_freeSlot = m_slots[slotIndex].nextFree;
+    }
+    else
+    {
+        slotIndex = static_cast<U32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    Slot_t &slot   = m_slots[slotIndex];
+    slot.root      = root;
+    slot.running   = false;
+    slot.cancelled = false;
+    ++m_taskCount;
+
+    TaskHandle_t const handle{ .slot = slotIndex, .generation = slot.generation };
+    root.promise().task = handle;
+    resume({ .handle = root, .task = handle });
+    return handle;
+}
+
+B8_t TaskScheduler_s::isAlive(TaskHandle_t handle) const
+{
+    return handle.generation != 0 && handle.slot < m_slots.size()
+           && m_slots[handle.slot].generation == handle.generation && m_slots[handle.slot].root;
+}
+
+void TaskScheduler_s::cancel(TaskHandle_t handle)
+{
+    if (!isAlive(handle))
+    {
+        return;
+    }
+
+    Slot_t &slot = m_slots[handle.slot];
+    if (slot.running)
+    { // a running coroutine can't be destroyed, resume() does it when it suspends
+        slot.cancelled = true;
+        return;
+    }
+    destroy(handle.slot);
+}
+
+void TaskScheduler_s::destroy(U32_t slotIndex)
+{
+    // the frame may own nested tasks and awaiters, whose destructors may cancel other tasks: free the slot first
+    Slot_t                              &slot = m_slots[slotIndex];
+    std::coroutine_handle<TaskPromise_t> root = std::exchange(slot.root, nullptr);
+    ++slot.generation;
+    slot.nextFree = m_freeSlot;
+    m_freeSlot    = slotIndex;
+    --m_taskCount;
+    root.destroy();
+}
+
+void TaskScheduler_s::resume(Waiter_t const &waiter)
+{
+    if (!isAlive(waiter.task))
+    { // cancelled while waiting
+        return;
+    }
+
+    U32_t const slotIndex      = waiter.task.slot;
+    m_slots[slotIndex].running = true;
+    waiter.handle.resume();
+    // the slots may have been reallocated by tasks spawned meanwhile
+    Slot_t &slot = m_slots[slotIndex];
+    slot.running = false;
+    if (slot.cancelled || slot.root.done())
+    {
+        destroy(slotIndex);
+    }
+}
+
+void TaskScheduler_s::update(U64_t deltaTime)
+{
+    CGE_PROFILE_SCOPE("TaskScheduler");
+    m_time += deltaTime;
+
+    // completed jobs, kept in suspension order
+    U32_t waiting = 0;
+    for (JobWaiter_t const &jobWaiter : m_jobWaiters)
+    {
+        if (jobWaiter.counter->pending.load(std::memory_order_acquire) == 0)
+        {
+            m_ready.push_back(jobWaiter.waiter);
+        }
+        else
+        {
+            m_jobWaiters[waiting++] = jobWaiter;
+        }
+    }
+    m_jobWaiters.resize(waiting);
+
+    // expired deadlines
+    while (!m_sleepers.empty() && m_sleepers.front().deadline <= m_time)
+    {
+        std::pop_heap(m_sleepers.begin(), m_sleepers.end(), laterThan<Sleeper_t, Sleeper_t>);
+        m_ready.push_back(m_sleepers.back().waiter);
+        m_sleepers.pop_back();
+    }
+
+    // tasks suspending from now on are appended to m_ready, and resumed at the next update
+    std::swap(m_ready, m_resuming);
+    for (Waiter_t const &waiter : m_resuming)
+    {
+        resume(waiter);
+    }
+    m_resuming.clear();
+}
+
+void TaskScheduler_s::shutdown()
+{
+    for (U32_t i = 0; i != m_slots.size(); ++i)
+    {
+        if (m_slots[i].root)
+        {
+            destroy(i);
+        }
+    }
+    m_ready.clear();
+    m_resuming.clear();
+    m_sleepers.clear();
+    m_jobWaiters.clear();
+}
+
+void TaskScheduler_s::wakeNextUpdate(Waiter_t waiter)
+{ //
+    m_ready.push_back(waiter);
+}
+
+void TaskScheduler_s::wakeAt(U64_t deadline, Waiter_t waiter)
+{
+    m_sleepers.push_back({ .deadline = deadline, .sequence = m_sleepSequence++, .waiter = waiter });
+    std::push_heap(m_sleepers.begin(), m_sleepers.end(), laterThan<Sleeper_t, Sleeper_t>);
+}
+
+void TaskScheduler_s::wakeOnJob(JobCounter_t const &counter, Waiter_t waiter)
+{ //
+    m_jobWaiters.push_back({ .counter = &counter, .waiter = waiter });
+}
+
+EventAwaiter_s::~EventAwaiter_s()
+{ // the task has been destroyed while waiting
+    g_eventQueue.removeListener(m_listener);
+}
+
+void EventAwaiter_s::await_suspend(std::coroutine_handle<TaskPromise_t> handle)
+{
+    m_waiter = { .handle = handle, .task = handle.promise().task };
+    EventArg_t listenerData{};
+    listenerData.idata.p = reinterpret_cast<Byte_t *>(this);
+    m_listener           = g_eventQueue.addListener(m_event, &EventAwaiter_s::onEvent, listenerData);
+}
+
+void EventAwaiter_s::onEvent(EventArg_t eventData, EventArg_t listenerData)
+{
+    auto *self   = reinterpret_cast<EventAwaiter_s *>(listenerData.idata.p);
+    self->m_data = eventData;
+    g_eventQueue.removeListener(self->m_listener);
+    self->m_listener = nullListenerHandle;
+    g_taskScheduler.wakeNextUpdate(self->m_waiter);
+}
+
+} // namespace cge
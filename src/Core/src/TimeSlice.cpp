@@ -0,0 +1,317 @@
+#include "TimeSlice.h"
+
+#include "Log.h"
+#include "Profiler.h"
+#include "TimeUtils.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace cge
+{
+
+TimeSliceScheduler_s g_timeSliceScheduler;
+
+static U32_t constexpr initialWorkCapacity = 32;
+
+static Char8_t const *const s_priorityNames[static_cast<U32_t>(EWorkPriority_t::eWorkPriorityCount)]{
+    "high", "normal", "low"
+};
+
+TimeSliceScheduler_s::TimeSliceScheduler_s()
+{
+    m_items.reserve(initialWorkCapacity);
+    m_order.reserve(initialWorkCapacity);
+}
+
+TimeSliceScheduler_s::~TimeSliceScheduler_s()
+{ //
+    shutdown();
+}
+
+WorkHandle_t TimeSliceScheduler_s::enqueue(
+  Char8_t const  *name,
+  EWorkPriority_t priority,
+  void           *closure,
+  U32_t           closureSize,
+  U32_t           closureAlign,
+  WorkProgress_t (*invoke)(void *closure),
+  void (*destroy)(void *closure))
+{
+    U32_t slotIndex = m_freeSlot;
+    if (slotIndex != invalidSlot)
+    {
+        m_freeSlot = m_items[slotIndex].nextFree;
+    }
+    else
+    {
+        slotIndex = static_cast<U32_t>(m_items.size());
+        m_items.emplace_back();
+    }
+
+    Item_t     &item       = m_items[slotIndex];
+    U32_t const generation = item.generation;
+    item                   = Item_t{};
+    item.name         = name;
+    item.closure      = closure;
+    item.invoke       = invoke;
+    item.destroy      = destroy;
+    item.closureSize  = closureSize;
+    item.closureAlign = closureAlign;
+    item.progress     = { .done = 0, .total = 1 };
+    item.priority     = priority;
+    item.generation   = generation;
+    item.firstFrame   = m_frame;
+    ++m_itemCount;
+
+    // submitted by a step: m_order is being walked by index, the item joins it at the end of the run
+    WorkHandle_t const handle{ .slot = slotIndex, .generation = generation };
+    if (m_running)
+    {
+        m_submitted.push_back({ .handle = handle, .priority = priority });
+        return handle;
+    }
+    insertOrder({ .handle = handle, .priority = priority });
+    return handle;
+}
+
+void TimeSliceScheduler_s::insertOrder(OrderEntry_t const &entry)
+{
+    // after the items of the same priority, so that the oldest keeps running first
+    auto const it = std::upper_bound(
+      m_order.begin(), m_order.end(), entry.priority, [](EWorkPriority_t p, OrderEntry_t const &other) {
+          return p < other.priority;
+      });
+    m_order.insert(it, entry);
+}
+
+B8_t TimeSliceScheduler_s::isPending(WorkHandle_t handle) const
+{
+    return handle.generation != 0 && handle.slot < m_items.size()
+           && m_items[handle.slot].generation == handle.generation && m_items[handle.slot].closure;
+}
+
+WorkProgress_t TimeSliceScheduler_s::progress(WorkHandle_t handle) const
+{
+    if (!isPending(handle))
+    {
+        return { .done = 0, .total = 0 };
+    }
+    return m_items[handle.slot].progress;
+}
+
+void TimeSliceScheduler_s::cancel(WorkHandle_t handle)
+{
+    if (!isPending(handle))
+    {
+        return;
+    }
+
+    Item_t &item = m_items[handle.slot];
+    if (item.running)
+    { // cancelled by its own step, step() releases it on return
+        item.cancelled = true;
+        return;
+    }
+    release(handle.slot);
+}
+
+void TimeSliceScheduler_s::finish(WorkHandle_t handle)
+{
+    while (isPending(handle) && !m_items[handle.slot].running && step(handle.slot))
+    {
+    }
+}
+
+void TimeSliceScheduler_s::release(U32_t slotIndex)
+{
+    Item_t &item    = m_items[slotIndex];
+    void   *closure = std::exchange(item.closure, nullptr);
+    ++item.generation;
+    item.nextFree = m_freeSlot;
+    m_freeSlot    = slotIndex;
+    --m_itemCount;
+
+    // the closure may cancel or submit other items while destroyed, nothing of the slot is used after this
+    void (*destroy)(void *) = item.destroy;
+    U32_t const size        = item.closureSize;
+    U32_t const align       = item.closureAlign;
+    destroy(closure);
+    getMemoryPool(EMemoryTag_t::eTimeSlice)->deallocate(closure, size, align);
+}
+
+B8_t TimeSliceScheduler_s::step(U32_t slotIndex)
+{
+    m_items[slotIndex].running = true;
+    U64_t const          start = hiResTimer();
+    WorkProgress_t const progress = m_items[slotIndex].invoke(m_items[slotIndex].closure);
+    U64_t const          end      = hiResTimer();
+    m_lastStepEnd                 = end;
+
+    // the items may have been reallocated by items submitted meanwhile
+    Item_t &item  = m_items[slotIndex];
+    item.running  = false;
+    item.progress = progress;
+    item.ticks += end - start;
+    ++item.steps;
+    item.waitedFrames = 0;
+    if (item.lastFrame != m_frame)
+    {
+        item.lastFrame = m_frame;
+        ++item.frames;
+    }
+
+    if (item.cancelled)
+    {
+        release(slotIndex);
+        return false;
+    }
+    if (progress.finished())
+    {
+        CGE_LOG_DEBUG(
+          Core,
+          "[TimeSlice] %s done in %u steps, run in %u of %llu frames, %.3f ms",
+          item.name,
+          item.steps,
+          item.frames,
+          static_cast<unsigned long long>(std::max<U64_t>(1, m_frame - item.firstFrame)),
+          hiResToNanoseconds(item.ticks) * 1e-6);
+        release(slotIndex);
+        return false;
+    }
+    return true;
+}
+
+void TimeSliceScheduler_s::compactOrder()
+{
+    std::erase_if(m_order, [this](OrderEntry_t const &entry) { return !isPending(entry.handle); });
+}
+
+void TimeSliceScheduler_s::run()
+{
+    ++m_frame;
+    if (m_order.empty())
+    {
+        m_lastRunTime = 0;
+        return;
+    }
+
+    CGE_PROFILE_SCOPE("TimeSlice");
+    if (m_budgetTicks == 0)
+    {
+        m_budgetTicks = std::max<U64_t>(1, m_budget * hiResFrequency() / 1'000'000'000ULL);
+    }
+    U64_t const start    = hiResTimer();
+    U64_t const deadline = start + m_budgetTicks;
+    m_lastStepEnd        = start;
+    m_running            = true;
+
+    // starving items get a step first, whatever the budget. Items submitted by the steps are kept apart until the
+    // end of the run, so that the entries of m_order don't shift under the index
+    B8_t stepped = false;
+    for (U32_t i = 0; i != m_order.size(); ++i)
+    {
+        WorkHandle_t const handle = m_order[i].handle;
+        if (isPending(handle) && m_items[handle.slot].waitedFrames >= m_starvationFrames)
+        {
+            step(handle.slot);
+            stepped = true;
+        }
+    }
+
+    // then by priority, the oldest item running until it is done or the budget is spent. The first step of the frame
+    // runs anyway, so that a budget smaller than a step doesn't stall the queue
+    for (U32_t i = 0; i != m_order.size(); ++i)
+    {
+        WorkHandle_t const handle = m_order[i].handle;
+        while (isPending(handle) && !m_items[handle.slot].running && (!stepped || m_lastStepEnd < deadline))
+        {
+            stepped = true;
+            step(handle.slot);
+        }
+        if (stepped && m_lastStepEnd >= deadline)
+        {
+            break;
+        }
+    }
+
+    m_running = false;
+    for (OrderEntry_t const &entry : m_submitted)
+    { // in submission order, hence after the older items of the same priority
+        insertOrder(entry);
+    }
+    m_submitted.clear();
+
+    for (OrderEntry_t const &entry : m_order)
+    {
+        if (isPending(entry.handle))
+        {
+            Item_t &item = m_items[entry.handle.slot];
+            if (item.lastFrame != m_frame)
+            {
+                ++item.waitedFrames;
+            }
+        }
+    }
+    compactOrder();
+    m_lastRunTime = hiResToNanoseconds(hiResTimer() - start);
+}
+
+void TimeSliceScheduler_s::shutdown()
+{
+    for (U32_t i = 0; i != m_items.size(); ++i)
+    {
+        if (m_items[i].closure)
+        {
+            release(i);
+        }
+    }
+    m_order.clear();
+    m_submitted.clear();
+}
+
+void TimeSliceScheduler_s::setBudget(U64_t nanoseconds)
+{
+    m_budget      = nanoseconds;
+    m_budgetTicks = 0;
+}
+
+void TimeSliceScheduler_s::setStarvationFrames(U32_t frames)
+{ //
+    m_starvationFrames = frames;
+}
+
+void TimeSliceScheduler_s::initFromEnvironment()
+{
+    if (Char8_t const *budget = std::getenv("CGE_TIMESLICE_BUDGET_US"); budget)
+    {
+        setBudget(std::strtoull(budget, nullptr, 10) * 1'000ULL);
+        CGE_LOG_INFO(Core, "[TimeSlice] budget of %.3f ms per frame", m_budget * 1e-6);
+    }
+}
+
+void TimeSliceScheduler_s::printItems() const
+{
+    CGE_LOG_INFO(Core, "[TimeSlice] %u items, last run %.3f ms", m_itemCount, m_lastRunTime * 1e-6);
+    for (OrderEntry_t const &entry : m_order)
+    {
+        if (!isPending(entry.handle))
+        {
+            continue;
+        }
+        Item_t const &item = m_items[entry.handle.slot];
+        CGE_LOG_INFO(
+          Core,
+          "[TimeSlice] \t%-24s %-6s %5.1f%% (%u/%u), steps: %6u, frames: %5u, time: %8.3f ms",
+          item.name,
+          s_priorityNames[static_cast<U32_t>(item.priority)],
+          item.progress.fraction() * 100.f,
+          item.progress.done,
+          item.progress.total,
+          item.steps,
+          item.frames,
+          hiResToNanoseconds(item.ticks) * 1e-6);
+    }
+}
+
+} // namespace cge
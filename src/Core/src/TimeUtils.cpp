@@ -0,0 +1,102 @@
+#include "TimeUtils.h"
+
+#include <cstdio>
+
+#if defined(CGE_PLATFORM_LINUX)
+#include <cpuid.h>
+#endif
+
+namespace cge
+{
+
+#if defined(CGE_PLATFORM_LINUX)
+static U64_t monotonicNanoseconds()
+{
+    struct timespec ts
+    {
+    };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<U64_t>(ts.tv_sec) * 1'000'000'000ULL + static_cast<U64_t>(ts.tv_nsec);
+}
+
+/// pairs a clock reading with the timer value in the middle of the tightest of a few brackets, so that an
+/// interrupt landing between the two reads doesn't skew the calibration
+static void sampleClocks(U64_t &ticks, U64_t &nanoseconds)
+{
+    U64_t bestBracket = ~0ULL;
+    for (U32_t i = 0; i != 8; ++i)
+    {
+        U64_t const before = hiResTimer();
+        U64_t const ns     = monotonicNanoseconds();
+        U64_t const after  = hiResTimer();
+        if (after - before < bestBracket)
+        {
+            bestBracket = after - before;
+            ticks       = before + (after - before) / 2;
+            nanoseconds = ns;
+        }
+    }
+}
+
+static B8_t invariantTimeStampCounter()
+{
+    U32_t eax = 0;
+    U32_t ebx = 0;
+    U32_t ecx = 0;
+    U32_t edx = 0;
+    if (!__get_cpuid(0x8000'0007U, &eax, &ebx, &ecx, &edx))
+    {
+        return false;
+    }
+    return (edx & (1U << 8)) != 0;
+}
+
+static HiResCalibration_t calibrate()
+{
+    U64_t constexpr calibrationTime = 20'000'000ULL; // 20 ms
+
+    HiResCalibration_t calibration{};
+    sampleClocks(calibration.ticks, calibration.nanoseconds);
+
+    U64_t endTicks       = 0;
+    U64_t endNanoseconds = 0;
+    while (monotonicNanoseconds() - calibration.nanoseconds < calibrationTime)
+    {
+    }
+    sampleClocks(endTicks, endNanoseconds);
+
+    calibration.frequency = static_cast<U64_t>(
+      static_cast<F64_t>(endTicks - calibration.ticks) * 1e9 / static_cast<F64_t>(endNanoseconds - calibration.nanoseconds));
+    calibration.invariant = invariantTimeStampCounter();
+    if (!calibration.invariant)
+    {
+        printf("[TimeUtils] the time-stamp counter is not invariant, timings may drift with the CPU frequency\n");
+    }
+    return calibration;
+}
+#elif defined(CGE_PLATFORM_WINDOWS)
+static HiResCalibration_t calibrate()
+{
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+
+    // the performance counter comes with its frequency already
+    HiResCalibration_t calibration{};
+    calibration.frequency   = static_cast<U64_t>(frequency.QuadPart);
+    calibration.ticks       = static_cast<U64_t>(counter.QuadPart);
+    calibration.nanoseconds = calibration.ticks / calibration.frequency * 1'000'000'000ULL
+                              + calibration.ticks % calibration.frequency * 1'000'000'000ULL / calibration.frequency;
+    calibration.invariant   = true;
+    return calibration;
+}
+#endif
+
+HiResCalibration_t const &hiResCalibration()
+{
+    static HiResCalibration_t const s_calibration = calibrate();
+    return s_calibration;
+}
+
+} // namespace cge
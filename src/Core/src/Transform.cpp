@@ -0,0 +1,425 @@
+#include "Transform.h"
+
+#include <cassert>
+#include <cstddef>
+
+namespace cge
+{
+
+template<I32_t lane> static inline CGE_forceinline V128f_t broadcast(V128f_t v)
+{ //
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(lane, lane, lane, lane));
+}
+
+static inline CGE_forceinline V128f_t load(glm::vec4 const &v)
+{ //
+    return _mm_load_ps(&v.x);
+}
+
+static inline CGE_forceinline V128f_t wMask()
+{ //
+    return _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+}
+
+static inline CGE_forceinline V128f_t xyzMask()
+{ //
+    return _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+}
+
+// glm stores quaternions as w, x, y, z unless GLM_FORCE_QUAT_DATA_XYZW is defined; vectors hold them in x, y, z, w
+static B8_t constexpr quatStoredWFirst = offsetof(glm::quat, w) == 0;
+
+static inline CGE_forceinline V128f_t loadQuat(glm::quat const &q)
+{
+    V128f_t const v = _mm_load_ps(reinterpret_cast<F32_t const *>(&q));
+    return quatStoredWFirst ? _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 3, 2, 1)) : v;
+}
+
+static inline CGE_forceinline void storeQuat(glm::quat &q, V128f_t v)
+{ //
+    _mm_store_ps(reinterpret_cast<F32_t *>(&q), quatStoredWFirst ? _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 1, 0, 3)) : v);
+}
+
+/// cross product of the xyz lanes. The w lane is `a.w * b.w - a.w * b.w`, 0 for finite inputs
+static inline CGE_forceinline V128f_t cross(V128f_t a, V128f_t b)
+{
+    V128f_t const aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    V128f_t const bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    V128f_t const c    = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+    return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+/// dot product of the xyz lanes, in all lanes
+static inline CGE_forceinline V128f_t dot3(V128f_t a, V128f_t b)
+{
+    V128f_t const m = _mm_mul_ps(a, b);
+    return _mm_add_ps(_mm_add_ps(broadcast<0>(m), broadcast<1>(m)), broadcast<2>(m));
+}
+
+/// `a * b` of two affine transforms, as rows
+static inline CGE_forceinline V128f_t composeRow(V128f_t aRow, V128f_t b0, V128f_t b1, V128f_t b2)
+{
+    V128f_t const xy = _mm_add_ps(_mm_mul_ps(broadcast<0>(aRow), b0), _mm_mul_ps(broadcast<1>(aRow), b1));
+    return _mm_add_ps(xy, _mm_add_ps(_mm_mul_ps(broadcast<2>(aRow), b2), _mm_and_ps(aRow, wMask())));
+}
+
+/// Hamilton product, quaternions in x, y, z, w order
+static inline CGE_forceinline V128f_t quatMul(V128f_t a, V128f_t b)
+{
+    V128f_t const forX = _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)), _mm_setr_ps(0.f, -0.f, 0.f, -0.f));
+    V128f_t const forY = _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)), _mm_setr_ps(0.f, 0.f, -0.f, -0.f));
+    V128f_t const forZ = _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), _mm_setr_ps(-0.f, 0.f, 0.f, -0.f));
+    V128f_t const wx   = _mm_add_ps(_mm_mul_ps(broadcast<3>(a), b), _mm_mul_ps(broadcast<0>(a), forX));
+    V128f_t const yz   = _mm_add_ps(_mm_mul_ps(broadcast<1>(a), forY), _mm_mul_ps(broadcast<2>(a), forZ));
+    return _mm_add_ps(wx, yz);
+}
+
+/// `q * v * conj(q)` for a unit quaternion, as `v + w * t + cross(q, t)` with `t = 2 * cross(q, v)`. `v.w` must be 0
+static inline CGE_forceinline V128f_t rotate(V128f_t q, V128f_t v)
+{
+    V128f_t const t = cross(q, _mm_add_ps(v, v));
+    return _mm_add_ps(_mm_add_ps(v, _mm_mul_ps(broadcast<3>(q), t)), cross(q, t));
+}
+
+/// rows times a vector, whose w is 1 for points and 0 for vectors
+static inline CGE_forceinline V128f_t transformRows(Affine3x4_t const &a, V128f_t v)
+{
+    V128f_t x = _mm_mul_ps(load(a.rows[0]), v);
+    V128f_t y = _mm_mul_ps(load(a.rows[1]), v);
+    V128f_t z = _mm_mul_ps(load(a.rows[2]), v);
+    V128f_t w = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    return _mm_add_ps(_mm_add_ps(x, y), _mm_add_ps(z, w));
+}
+
+static inline CGE_forceinline glm::vec3 toVec3(V128f_t v)
+{
+    alignas(16) F32_t f[4];
+    _mm_store_ps(f, v);
+    return { f[0], f[1], f[2] };
+}
+
+Affine3x4_t Affine3x4_t::identity()
+{ //
+    return { { { 1.f, 0.f, 0.f, 0.f }, { 0.f, 1.f, 0.f, 0.f }, { 0.f, 0.f, 1.f, 0.f } } };
+}
+
+Affine3x4_t Affine3x4_t::fromMat4(glm::mat4 const &m)
+{
+    assert(m[0].w == 0.f && m[1].w == 0.f && m[2].w == 0.f && m[3].w == 1.f && "[Transform] not an affine matrix");
+    V128f_t c0 = _mm_loadu_ps(&m[0].x);
+    V128f_t c1 = _mm_loadu_ps(&m[1].x);
+    V128f_t c2 = _mm_loadu_ps(&m[2].x);
+    V128f_t c3 = _mm_loadu_ps(&m[3].x);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    Affine3x4_t result;
+    _mm_store_ps(&result.rows[0].x, c0);
+    _mm_store_ps(&result.rows[1].x, c1);
+    _mm_store_ps(&result.rows[2].x, c2);
+    return result;
+}
+
+glm::mat4 Affine3x4_t::toMat4() const
+{
+    V128f_t r0 = load(rows[0]);
+    V128f_t r1 = load(rows[1]);
+    V128f_t r2 = load(rows[2]);
+    V128f_t r3 = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+    glm::mat4 result;
+    _mm_storeu_ps(&result[0].x, r0);
+    _mm_storeu_ps(&result[1].x, r1);
+    _mm_storeu_ps(&result[2].x, r2);
+    _mm_storeu_ps(&result[3].x, r3);
+    return result;
+}
+
+glm::vec3 Affine3x4_t::translation() const
+{ //
+    return { rows[0].w, rows[1].w, rows[2].w };
+}
+
+B8_t Affine3x4_t::operator==(Affine3x4_t const &other) const
+{ //
+    return rows[0] == other.rows[0] && rows[1] == other.rows[1] && rows[2] == other.rows[2];
+}
+
+TRS_t TRS_t::fromMat4(glm::mat4 const &m)
+{
+    glm::mat3 linear{ m };
+    TRS_t     result;
+    result.translation = glm::vec3(m[3]);
+    result.scale       = { glm::length(linear[0]), glm::length(linear[1]), glm::length(linear[2]) };
+    if (glm::determinant(linear) < 0.f)
+    {
+        result.scale.x = -result.scale.x;
+    }
+
+    linear[0] /= result.scale.x;
+    linear[1] /= result.scale.y;
+    linear[2] /= result.scale.z;
+    result.rotation = glm::normalize(glm::quat_cast(linear));
+    return result;
+}
+
+Affine3x4_t TRS_t::toAffine() const
+{
+    glm::mat3 const r = glm::mat3_cast(rotation);
+    Affine3x4_t     result;
+    for (I32_t i = 0; i != 3; ++i)
+    { //
+        result.rows[i] = { r[0][i] * scale.x, r[1][i] * scale.y, r[2][i] * scale.z, translation[i] };
+    }
+    return result;
+}
+
+glm::mat4 TRS_t::toMat4() const
+{ //
+    return toAffine().toMat4();
+}
+
+Affine3x4_t compose(Affine3x4_t const &a, Affine3x4_t const &b)
+{
+    V128f_t const b0 = load(b.rows[0]);
+    V128f_t const b1 = load(b.rows[1]);
+    V128f_t const b2 = load(b.rows[2]);
+
+    Affine3x4_t result;
+    _mm_store_ps(&result.rows[0].x, composeRow(load(a.rows[0]), b0, b1, b2));
+    _mm_store_ps(&result.rows[1].x, composeRow(load(a.rows[1]), b0, b1, b2));
+    _mm_store_ps(&result.rows[2].x, composeRow(load(a.rows[2]), b0, b1, b2));
+    return result;
+}
+
+TRS_t compose(TRS_t const &a, TRS_t const &b)
+{
+    V128f_t const aRotation = loadQuat(a.rotation);
+    V128f_t const aScale    = _mm_load_ps(&a.scale.x);
+    V128f_t const offset    = rotate(aRotation, _mm_mul_ps(aScale, _mm_load_ps(&b.translation.x)));
+
+    TRS_t result;
+    storeQuat(result.rotation, quatMul(aRotation, loadQuat(b.rotation)));
+    _mm_store_ps(&result.translation.x, _mm_add_ps(_mm_load_ps(&a.translation.x), offset));
+    _mm_store_ps(&result.scale.x, _mm_mul_ps(aScale, _mm_load_ps(&b.scale.x)));
+    return result;
+}
+
+glm::mat4 compose(glm::mat4 const &m, Affine3x4_t const &a)
+{
+    V128f_t const m0 = _mm_loadu_ps(&m[0].x);
+    V128f_t const m1 = _mm_loadu_ps(&m[1].x);
+    V128f_t const m2 = _mm_loadu_ps(&m[2].x);
+    V128f_t const m3 = _mm_loadu_ps(&m[3].x);
+    V128f_t const a0 = load(a.rows[0]);
+    V128f_t const a1 = load(a.rows[1]);
+    V128f_t const a2 = load(a.rows[2]);
+
+    // column j of the result is m times column j of a, whose last component is 1 only for the translation
+    glm::mat4 result;
+    _mm_storeu_ps(
+      &result[0].x,
+      _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(m0, broadcast<0>(a0)), _mm_mul_ps(m1, broadcast<0>(a1))),
+        _mm_mul_ps(m2, broadcast<0>(a2))));
+    _mm_storeu_ps(
+      &result[1].x,
+      _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(m0, broadcast<1>(a0)), _mm_mul_ps(m1, broadcast<1>(a1))),
+        _mm_mul_ps(m2, broadcast<1>(a2))));
+    _mm_storeu_ps(
+      &result[2].x,
+      _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(m0, broadcast<2>(a0)), _mm_mul_ps(m1, broadcast<2>(a1))),
+        _mm_mul_ps(m2, broadcast<2>(a2))));
+    _mm_storeu_ps(
+      &result[3].x,
+      _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(m0, broadcast<3>(a0)), _mm_mul_ps(m1, broadcast<3>(a1))),
+        _mm_add_ps(_mm_mul_ps(m2, broadcast<3>(a2)), m3)));
+    return result;
+}
+
+void composeAffinesScalar(Affine3x4_t const &parent, std::span<Affine3x4_t const> locals, std::span<Affine3x4_t> out)
+{
+    assert(locals.size() == out.size());
+    for (U64_t i = 0; i != locals.size(); ++i)
+    {
+        Affine3x4_t const &b = locals[i];
+        Affine3x4_t        result;
+        for (U32_t row = 0; row != 3; ++row)
+        {
+            glm::vec4 const &a = parent.rows[row];
+            for (I32_t j = 0; j != 4; ++j)
+            { // same order of the operations of the vector kernels, to get the same rounding
+                F32_t const w       = j == 3 ? a.w : 0.f;
+                result.rows[row][j] = (a.x * b.rows[0][j] + a.y * b.rows[1][j]) + (a.z * b.rows[2][j] + w);
+            }
+        }
+        out[i] = result;
+    }
+}
+
+void composeAffinesSSE(Affine3x4_t const &parent, std::span<Affine3x4_t const> locals, std::span<Affine3x4_t> out)
+{
+    assert(locals.size() == out.size());
+    for (U64_t i = 0; i != locals.size(); ++i)
+    { //
+        out[i] = compose(parent, locals[i]);
+    }
+}
+
+CGE_target("avx") void composeAffinesAVX(
+  Affine3x4_t const           &parent,
+  std::span<Affine3x4_t const> locals,
+  std::span<Affine3x4_t>       out)
+{
+    assert(locals.size() == out.size());
+
+    // coefficients of the first two rows of the parent, lower lanes for row 0 and upper lanes for row 1
+    V128f_t const p0 = load(parent.rows[0]);
+    V128f_t const p1 = load(parent.rows[1]);
+    V128f_t const p2 = load(parent.rows[2]);
+    V256f_t const x01 = _mm256_set_m128(broadcast<0>(p1), broadcast<0>(p0));
+    V256f_t const y01 = _mm256_set_m128(broadcast<1>(p1), broadcast<1>(p0));
+    V256f_t const z01 = _mm256_set_m128(broadcast<2>(p1), broadcast<2>(p0));
+    V256f_t const w01 = _mm256_set_m128(_mm_and_ps(p1, wMask()), _mm_and_ps(p0, wMask()));
+
+    for (U64_t i = 0; i != locals.size(); ++i)
+    {
+        Affine3x4_t const &local = locals[i];
+        V256f_t const      b0    = _mm256_broadcast_ps(reinterpret_cast<V128f_t const *>(&local.rows[0]));
+        V256f_t const      b1    = _mm256_broadcast_ps(reinterpret_cast<V128f_t const *>(&local.rows[1]));
+        V256f_t const      b2    = _mm256_broadcast_ps(reinterpret_cast<V128f_t const *>(&local.rows[2]));
+        V256f_t const      xy    = _mm256_add_ps(_mm256_mul_ps(x01, b0), _mm256_mul_ps(y01, b1));
+        V256f_t const      rows  = _mm256_add_ps(xy, _mm256_add_ps(_mm256_mul_ps(z01, b2), w01));
+
+        V128f_t const      row2  = composeRow(
+          p2, _mm256_castps256_ps128(b0), _mm256_castps256_ps128(b1), _mm256_castps256_ps128(b2));
+        _mm256_storeu_ps(&out[i].rows[0].x, rows);
+        _mm_store_ps(&out[i].rows[2].x, row2);
+    }
+}
+
+CGE_target("avx512f") void composeAffinesAVX512(
+  Affine3x4_t const           &parent,
+  std::span<Affine3x4_t const> locals,
+  std::span<Affine3x4_t>       out)
+{
+    assert(locals.size() == out.size());
+
+    // coefficients of the three rows of the parent, a group of 4 lanes per row, the last group unused
+    alignas(64) F32_t coefficients[4][16]{};
+    for (U32_t row = 0; row != 3; ++row)
+    {
+        for (U32_t lane = 0; lane != 4; ++lane)
+        {
+            coefficients[0][4 * row + lane] = parent.rows[row].x;
+            coefficients[1][4 * row + lane] = parent.rows[row].y;
+            coefficients[2][4 * row + lane] = parent.rows[row].z;
+        }
+        coefficients[3][4 * row + 3] = parent.rows[row].w;
+    }
+    __m512 const x = _mm512_load_ps(coefficients[0]);
+    __m512 const y = _mm512_load_ps(coefficients[1]);
+    __m512 const z = _mm512_load_ps(coefficients[2]);
+    __m512 const w = _mm512_load_ps(coefficients[3]);
+
+    // the zero masking form of the broadcast: the plain one passes GCC's uninitialized _mm512_undefined_ps() as
+    // the merge source, which -Wmaybe-uninitialized reports. With all lanes selected it is the same instruction
+    for (U64_t i = 0; i != locals.size(); ++i)
+    {
+        Affine3x4_t const &local = locals[i];
+        __m512 const       b0    = _mm512_maskz_broadcast_f32x4(0xffff, load(local.rows[0]));
+        __m512 const       b1    = _mm512_maskz_broadcast_f32x4(0xffff, load(local.rows[1]));
+        __m512 const       b2    = _mm512_maskz_broadcast_f32x4(0xffff, load(local.rows[2]));
+        __m512 const       xy    = _mm512_add_ps(_mm512_mul_ps(x, b0), _mm512_mul_ps(y, b1));
+        _mm512_mask_storeu_ps(&out[i].rows[0].x, 0x0fff, _mm512_add_ps(xy, _mm512_add_ps(_mm512_mul_ps(z, b2), w)));
+    }
+}
+
+constinit Kernel_s<ComposeAffinesFunc_t> const g_composeAffinesKernel{
+    "composeAffines",
+    { { EIsa_t::eScalar, composeAffinesScalar },
+      { EIsa_t::eSSE2, composeAffinesSSE },
+      { EIsa_t::eAVX2, composeAffinesAVX },
+      { EIsa_t::eAVX512, composeAffinesAVX512 } }
+};
+
+void composeAffines(Affine3x4_t const &parent, std::span<Affine3x4_t const> locals, std::span<Affine3x4_t> out)
+{ //
+    g_composeAffinesKernel(parent, locals, out);
+}
+
+Affine3x4_t inverse(Affine3x4_t const &a)
+{
+    V128f_t const r0 = load(a.rows[0]);
+    V128f_t const r1 = load(a.rows[1]);
+    V128f_t const r2 = load(a.rows[2]);
+
+    // the columns of the inverse of the linear part are the cross products of its rows, over the determinant
+    V128f_t const invDet = _mm_div_ps(_mm_set1_ps(1.f), dot3(r0, cross(r1, r2)));
+    V128f_t       c0     = _mm_mul_ps(cross(r1, r2), invDet);
+    V128f_t       c1     = _mm_mul_ps(cross(r2, r0), invDet);
+    V128f_t       c2     = _mm_mul_ps(cross(r0, r1), invDet);
+    V128f_t const tx     = _mm_mul_ps(c0, broadcast<3>(r0));
+    V128f_t const tyz    = _mm_add_ps(_mm_mul_ps(c1, broadcast<3>(r1)), _mm_mul_ps(c2, broadcast<3>(r2)));
+    V128f_t       t      = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(tx, tyz));
+    _MM_TRANSPOSE4_PS(c0, c1, c2, t);
+
+    Affine3x4_t result;
+    _mm_store_ps(&result.rows[0].x, c0);
+    _mm_store_ps(&result.rows[1].x, c1);
+    _mm_store_ps(&result.rows[2].x, c2);
+    return result;
+}
+
+TRS_t inverse(TRS_t const &t)
+{
+    V128f_t const rotation = _mm_xor_ps(loadQuat(t.rotation), _mm_setr_ps(-0.f, -0.f, -0.f, 0.f));
+    V128f_t const scale    = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.f), _mm_load_ps(&t.scale.x)), xyzMask());
+    V128f_t const offset   = rotate(rotation, _mm_mul_ps(scale, _mm_load_ps(&t.translation.x)));
+
+    TRS_t result;
+    storeQuat(result.rotation, rotation);
+    _mm_store_ps(&result.translation.x, _mm_sub_ps(_mm_setzero_ps(), offset));
+    _mm_store_ps(&result.scale.x, scale);
+    return result;
+}
+
+glm::vec3 transformPoint(Affine3x4_t const &a, glm::vec3 const &p)
+{ //
+    return toVec3(transformRows(a, _mm_setr_ps(p.x, p.y, p.z, 1.f)));
+}
+
+glm::vec3 transformPoint(TRS_t const &t, glm::vec3 const &p)
+{
+    V128f_t const scaled = _mm_mul_ps(_mm_load_ps(&t.scale.x), _mm_setr_ps(p.x, p.y, p.z, 0.f));
+    return toVec3(_mm_add_ps(rotate(loadQuat(t.rotation), scaled), _mm_load_ps(&t.translation.x)));
+}
+
+glm::vec3 transformVector(Affine3x4_t const &a, glm::vec3 const &v)
+{ //
+    return toVec3(transformRows(a, _mm_setr_ps(v.x, v.y, v.z, 0.f)));
+}
+
+glm::vec3 transformVector(TRS_t const &t, glm::vec3 const &v)
+{
+    V128f_t const scaled = _mm_mul_ps(_mm_load_ps(&t.scale.x), _mm_setr_ps(v.x, v.y, v.z, 0.f));
+    return toVec3(rotate(loadQuat(t.rotation), scaled));
+}
+
+Affine3x4_t lerp(Affine3x4_t const &a, Affine3x4_t const &b, F32_t alpha)
+{
+    V128f_t const s = _mm_set1_ps(alpha);
+    Affine3x4_t   result;
+    for (U32_t i = 0; i != 3; ++i)
+    {
+        V128f_t const from = load(a.rows[i]);
+        _mm_store_ps(&result.rows[i].x, _mm_add_ps(from, _mm_mul_ps(_mm_sub_ps(load(b.rows[i]), from), s)));
+    }
+    return result;
+}
+
+} // namespace cge
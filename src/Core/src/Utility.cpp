@@ -1,5 +1,13 @@
 #include "Utility.h"
 
+#include "MacroDefs.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
 namespace cge
 {
 
@@ -55,6 +63,132 @@ Hit_t intersect(Ray const &r, AABB const &box)
     return hit;
 }
 
+AABBBatch_t::AABBBatch_t()
+{ //
+    clear();
+}
+
+void AABBBatch_t::clear()
+{
+    // inverted infinite bounds: every slab test fails, whatever the direction of the ray
+    std::fill_n(&min[0][0], 3 * aabbBatchWidth, std::numeric_limits<F32_t>::infinity());
+    std::fill_n(&max[0][0], 3 * aabbBatchWidth, -std::numeric_limits<F32_t>::infinity());
+}
+
+void AABBBatch_t::set(U32_t lane, AABB const &box)
+{
+    assert(lane < aabbBatchWidth);
+    for (U32_t axis = 0; axis != 3; ++axis)
+    {
+        min[axis][lane] = box.mm.min[axis];
+        max[axis][lane] = box.mm.max[axis];
+    }
+}
+
+BatchHit_t intersectScalar(Ray const &ray, AABBBatch_t const &batch)
+{
+    BatchHit_t result{ .t{}, .mask = 0 };
+    for (U32_t lane = 0; lane != aabbBatchWidth; ++lane)
+    {
+        AABB const box{ { batch.min[0][lane], batch.min[1][lane], batch.min[2][lane] },
+                        { batch.max[0][lane], batch.max[1][lane], batch.max[2][lane] } };
+        Hit_t const hit = intersect(ray, box);
+        result.t[lane]  = hit.t;
+        result.mask |= static_cast<U32_t>(hit.isect) << lane;
+    }
+    return result;
+}
+
+// the kernels mirror the scalar slab test operation by operation: ordered comparisons, and selections rather than
+// min/max, so that NaNs from axis aligned rays are handled as in the scalar code and the results are bitwise equal
+static inline CGE_forceinline V128f_t select4(V128f_t a, V128f_t b, V128f_t mask)
+{ //
+    return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+}
+
+static U32_t intersectGroupSSE(Ray const &ray, AABBBatch_t const &batch, U32_t first, F32_t *t)
+{
+    V128f_t tmin = _mm_setzero_ps(), tmax = _mm_setzero_ps(), hit = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (U32_t axis = 0; axis != 3; ++axis)
+    {
+        F32_t const  *nearBound = ray.sign[axis] ? batch.max[axis] : batch.min[axis];
+        F32_t const  *farBound  = ray.sign[axis] ? batch.min[axis] : batch.max[axis];
+        V128f_t const orig      = _mm_set1_ps(ray.orig[axis]);
+        V128f_t const invdir    = _mm_set1_ps(ray.invdir[axis]);
+        V128f_t const slabNear  = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(nearBound + first), orig), invdir);
+        V128f_t const slabFar   = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(farBound + first), orig), invdir);
+        if (axis == 0)
+        {
+            tmin = slabNear;
+            tmax = slabFar;
+            continue;
+        }
+
+        hit  = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(tmin, slabFar), _mm_cmple_ps(slabNear, tmax)));
+        tmin = select4(tmin, slabNear, _mm_cmpgt_ps(slabNear, tmin));
+        tmax = select4(tmax, slabFar, _mm_cmplt_ps(slabFar, tmax));
+    }
+
+    _mm_store_ps(t + first, select4(_mm_set1_ps(-1.f), tmin, hit));
+    return static_cast<U32_t>(_mm_movemask_ps(hit)) << first;
+}
+
+BatchHit_t intersectSSE(Ray const &ray, AABBBatch_t const &batch)
+{
+    BatchHit_t result;
+    result.mask = intersectGroupSSE(ray, batch, 0, result.t) | intersectGroupSSE(ray, batch, 4, result.t);
+    return result;
+}
+
+CGE_target("avx2") BatchHit_t intersectAVX2(Ray const &ray, AABBBatch_t const &batch)
+{
+    V256f_t tmin = _mm256_setzero_ps(), tmax = _mm256_setzero_ps();
+    V256f_t hit  = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (U32_t axis = 0; axis != 3; ++axis)
+    {
+        F32_t const  *nearBound = ray.sign[axis] ? batch.max[axis] : batch.min[axis];
+        F32_t const  *farBound  = ray.sign[axis] ? batch.min[axis] : batch.max[axis];
+        V256f_t const orig      = _mm256_set1_ps(ray.orig[axis]);
+        V256f_t const invdir    = _mm256_set1_ps(ray.invdir[axis]);
+        V256f_t const slabNear  = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(nearBound), orig), invdir);
+        V256f_t const slabFar   = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(farBound), orig), invdir);
+        if (axis == 0)
+        {
+            tmin = slabNear;
+            tmax = slabFar;
+            continue;
+        }
+
+        V256f_t const overlap =
+          _mm256_and_ps(_mm256_cmp_ps(tmin, slabFar, _CMP_LE_OQ), _mm256_cmp_ps(slabNear, tmax, _CMP_LE_OQ));
+        hit  = _mm256_and_ps(hit, overlap);
+        tmin = _mm256_blendv_ps(tmin, slabNear, _mm256_cmp_ps(slabNear, tmin, _CMP_GT_OQ));
+        tmax = _mm256_blendv_ps(tmax, slabFar, _mm256_cmp_ps(slabFar, tmax, _CMP_LT_OQ));
+    }
+
+    BatchHit_t result;
+    _mm256_store_ps(result.t, _mm256_blendv_ps(_mm256_set1_ps(-1.f), tmin, hit));
+    result.mask = static_cast<U32_t>(_mm256_movemask_ps(hit));
+    return result;
+}
+
+constinit Kernel_s<BatchIntersectFunc_t> const g_intersectKernel{
+    "intersect",
+    { { EIsa_t::eScalar, intersectScalar }, { EIsa_t::eSSE2, intersectSSE }, { EIsa_t::eAVX2, intersectAVX2 } }
+};
+
+BatchHit_t intersect(Ray const &ray, AABBBatch_t const &batch)
+{
+    BatchHit_t const result = g_intersectKernel(ray, batch);
+#if defined(CGE_DEBUG)
+    BatchHit_t const reference = intersectScalar(ray, batch);
+    assert(
+      result.mask == reference.mask && std::memcmp(result.t, reference.t, sizeof(result.t)) == 0
+      && "[Utility] SIMD ray-box kernel diverged from the scalar one");
+#endif
+    return result;
+}
+
 AABB aUnion(AABB const &a, AABB const &b)
 {
     AABB const c{ glm::min(a.mm.min, b.mm.min), glm::max(a.mm.max, b.mm.max) };
@@ -102,40 +236,352 @@ B8_t isPointInsideAABB(glm::vec3 const &point, AABB const &box)
            && (point.z >= box.mm.min.z && point.z <= box.mm.max.z);
 }
 
-AABB transformAABBToNDC(AABB const &aabb, glm::mat4 const &model, glm::mat4 const &view, glm::mat4 const &projection)
+static inline CGE_forceinline void loadColumns(glm::mat4 const &m, V128f_t (&columns)[4])
+{
+    for (U32_t k = 0; k != 4; ++k)
+    { //
+        columns[k] = _mm_loadu_ps(&m[k][0]);
+    }
+}
+
+template<I32_t lane> static inline CGE_forceinline V128f_t broadcast(V128f_t v)
+{ //
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(lane, lane, lane, lane));
+}
+
+/// columns * (x, y, z, w)
+static inline CGE_forceinline V128f_t combine(V128f_t const (&columns)[4], F32_t x, F32_t y, F32_t z, V128f_t w)
+{
+    V128f_t const xy = _mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(x)), _mm_mul_ps(columns[1], _mm_set1_ps(y)));
+    return _mm_add_ps(xy, _mm_add_ps(_mm_mul_ps(columns[2], _mm_set1_ps(z)), w));
+}
+
+static inline CGE_forceinline void storeBounds(AABB &out, V128f_t min, V128f_t max)
+{
+    alignas(16) F32_t lo[4];
+    alignas(16) F32_t hi[4];
+    _mm_store_ps(lo, min);
+    _mm_store_ps(hi, max);
+    out.mm.min = { lo[0], lo[1], lo[2] };
+    out.mm.max = { hi[0], hi[1], hi[2] };
+}
+
+static AABB transformAABBSSE(AABB const &box, V128f_t const (&columns)[4])
+{
+    V128f_t const   absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fff'ffff));
+    glm::vec3 const center  = (box.mm.max + box.mm.min) * 0.5f;
+    glm::vec3 const extent  = (box.mm.max - box.mm.min) * 0.5f;
+
+    V128f_t const newCenter = combine(columns, center.x, center.y, center.z, columns[3]);
+    V128f_t const extentXY  = _mm_add_ps(
+      _mm_mul_ps(_mm_and_ps(columns[0], absMask), _mm_set1_ps(extent.x)),
+      _mm_mul_ps(_mm_and_ps(columns[1], absMask), _mm_set1_ps(extent.y)));
+    V128f_t const newExtent = _mm_add_ps(extentXY, _mm_mul_ps(_mm_and_ps(columns[2], absMask), _mm_set1_ps(extent.z)));
+
+    AABB result;
+    storeBounds(result, _mm_sub_ps(newCenter, newExtent), _mm_add_ps(newCenter, newExtent));
+    return result;
+}
+
+AABB transformAABB(AABB const &box, glm::mat4 const &transform)
+{
+    V128f_t columns[4];
+    loadColumns(transform, columns);
+    return transformAABBSSE(box, columns);
+}
+
+void transformAABBsScalar(std::span<AABB const> boxes, std::span<glm::mat4 const> transforms, std::span<AABB> out)
+{
+    assert(boxes.size() == transforms.size() && boxes.size() == out.size());
+    for (U64_t i = 0; i != boxes.size(); ++i)
+    {
+        glm::mat4 const &m      = transforms[i];
+        glm::vec3 const  center = (boxes[i].mm.max + boxes[i].mm.min) * 0.5f;
+        glm::vec3 const  extent = (boxes[i].mm.max - boxes[i].mm.min) * 0.5f;
+        for (U32_t r = 0; r != 3; ++r)
+        {
+            F32_t const newCenter = (m[0][r] * center.x + m[1][r] * center.y) + (m[2][r] * center.z + m[3][r]);
+            F32_t const newExtent = (std::abs(m[0][r]) * extent.x + std::abs(m[1][r]) * extent.y)
+                                    + std::abs(m[2][r]) * extent.z;
+            out[i].mm.min[r] = newCenter - newExtent;
+            out[i].mm.max[r] = newCenter + newExtent;
+        }
+    }
+}
+
+// The batched kernels keep a coordinate of 4 (or 8) boxes per register. A box is read and written as two
+// overlapping vectors, (min.x, min.y, min.z, max.x) and (min.z, max.x, max.y, max.z), which stay inside the 24
+// bytes of the AABB and transpose to 4 rows each. A matrix column transposes to its x, y, z rows across the boxes
+static inline CGE_forceinline void transpose4(V128f_t &r0, V128f_t &r1, V128f_t &r2, V128f_t &r3)
+{ //
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+}
+
+void transformAABBsSSE(std::span<AABB const> boxes, std::span<glm::mat4 const> transforms, std::span<AABB> out)
+{
+    assert(boxes.size() == transforms.size() && boxes.size() == out.size());
+    V128f_t const absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fff'ffff));
+    V128f_t const half    = _mm_set1_ps(0.5f);
+    U64_t         i       = 0;
+    for (; i + 4 <= boxes.size(); i += 4)
+    {
+        V128f_t lo[4], hi[4];
+        V128f_t m[4][4]; // m[k][r]: row r of column k of the 4 matrices
+        for (U32_t b = 0; b != 4; ++b)
+        {
+            lo[b] = _mm_loadu_ps(&boxes[i + b].mm.min.x);
+            hi[b] = _mm_loadu_ps(&boxes[i + b].mm.min.z);
+            for (U32_t k = 0; k != 4; ++k)
+            { //
+                m[k][b] = _mm_loadu_ps(&transforms[i + b][k][0]);
+            }
+        }
+        transpose4(lo[0], lo[1], lo[2], lo[3]); // min x, min y, min z, max x
+        transpose4(hi[0], hi[1], hi[2], hi[3]); // min z, max x, max y, max z
+        for (U32_t k = 0; k != 4; ++k)
+        { //
+            transpose4(m[k][0], m[k][1], m[k][2], m[k][3]);
+        }
+
+        V128f_t center[3], extent[3];
+        for (U32_t axis = 0; axis != 3; ++axis)
+        {
+            center[axis] = _mm_mul_ps(_mm_add_ps(hi[axis + 1], lo[axis]), half);
+            extent[axis] = _mm_mul_ps(_mm_sub_ps(hi[axis + 1], lo[axis]), half);
+        }
+        for (U32_t r = 0; r != 3; ++r)
+        {
+            V128f_t const centerXY  = _mm_add_ps(_mm_mul_ps(m[0][r], center[0]), _mm_mul_ps(m[1][r], center[1]));
+            V128f_t const newCenter = _mm_add_ps(centerXY, _mm_add_ps(_mm_mul_ps(m[2][r], center[2]), m[3][r]));
+            V128f_t const extentXY  = _mm_add_ps(
+              _mm_mul_ps(_mm_and_ps(m[0][r], absMask), extent[0]), _mm_mul_ps(_mm_and_ps(m[1][r], absMask), extent[1]));
+            V128f_t const newExtent = _mm_add_ps(extentXY, _mm_mul_ps(_mm_and_ps(m[2][r], absMask), extent[2]));
+            lo[r]                   = _mm_sub_ps(newCenter, newExtent);
+            hi[r + 1]               = _mm_add_ps(newCenter, newExtent);
+        }
+        lo[3] = hi[1];
+        hi[0] = lo[2];
+
+        transpose4(lo[0], lo[1], lo[2], lo[3]);
+        transpose4(hi[0], hi[1], hi[2], hi[3]);
+        for (U32_t b = 0; b != 4; ++b)
+        {
+            _mm_storeu_ps(&out[i + b].mm.min.x, lo[b]);
+            _mm_storeu_ps(&out[i + b].mm.min.z, hi[b]);
+        }
+    }
+
+    for (; i != boxes.size(); ++i)
+    { //
+        out[i] = transformAABB(boxes[i], transforms[i]);
+    }
+}
+
+CGE_target("avx") static inline CGE_forceinline void transpose4x2(V256f_t &r0, V256f_t &r1, V256f_t &r2, V256f_t &r3)
+{
+    V256f_t const t0 = _mm256_unpacklo_ps(r0, r1);
+    V256f_t const t1 = _mm256_unpacklo_ps(r2, r3);
+    V256f_t const t2 = _mm256_unpackhi_ps(r0, r1);
+    V256f_t const t3 = _mm256_unpackhi_ps(r2, r3);
+    r0               = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    r1               = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    r2               = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3               = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+CGE_target("avx") static inline CGE_forceinline V256f_t loadPair(F32_t const *low, F32_t const *high)
+{ //
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+}
+
+CGE_target("avx") void transformAABBsAVX(
+  std::span<AABB const>      boxes,
+  std::span<glm::mat4 const> transforms,
+  std::span<AABB>            out)
+{
+    assert(boxes.size() == transforms.size() && boxes.size() == out.size());
+    V256f_t const absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fff'ffff));
+    V256f_t const half    = _mm256_set1_ps(0.5f);
+    U64_t         i       = 0;
+    // as transformAABBsSSE, box b in the low half and box b + 4 in the high half of each vector
+    for (; i + 8 <= boxes.size(); i += 8)
+    {
+        V256f_t lo[4], hi[4];
+        V256f_t m[4][4];
+        for (U32_t b = 0; b != 4; ++b)
+        {
+            lo[b] = loadPair(&boxes[i + b].mm.min.x, &boxes[i + b + 4].mm.min.x);
+            hi[b] = loadPair(&boxes[i + b].mm.min.z, &boxes[i + b + 4].mm.min.z);
+            for (U32_t k = 0; k != 4; ++k)
+            { //
+                m[k][b] = loadPair(&transforms[i + b][k][0], &transforms[i + b + 4][k][0]);
+            }
+        }
+        transpose4x2(lo[0], lo[1], lo[2], lo[3]);
+        transpose4x2(hi[0], hi[1], hi[2], hi[3]);
+        for (U32_t k = 0; k != 4; ++k)
+        { //
+            transpose4x2(m[k][0], m[k][1], m[k][2], m[k][3]);
+        }
+
+        V256f_t center[3], extent[3];
+        for (U32_t axis = 0; axis != 3; ++axis)
+        {
+            center[axis] = _mm256_mul_ps(_mm256_add_ps(hi[axis + 1], lo[axis]), half);
+            extent[axis] = _mm256_mul_ps(_mm256_sub_ps(hi[axis + 1], lo[axis]), half);
+        }
+        for (U32_t r = 0; r != 3; ++r)
+        {
+            V256f_t const centerXY =
+              _mm256_add_ps(_mm256_mul_ps(m[0][r], center[0]), _mm256_mul_ps(m[1][r], center[1]));
+            V256f_t const newCenter =
+              _mm256_add_ps(centerXY, _mm256_add_ps(_mm256_mul_ps(m[2][r], center[2]), m[3][r]));
+            V256f_t const extentXY = _mm256_add_ps(
+              _mm256_mul_ps(_mm256_and_ps(m[0][r], absMask), extent[0]),
+              _mm256_mul_ps(_mm256_and_ps(m[1][r], absMask), extent[1]));
+            V256f_t const newExtent =
+              _mm256_add_ps(extentXY, _mm256_mul_ps(_mm256_and_ps(m[2][r], absMask), extent[2]));
+            lo[r]     = _mm256_sub_ps(newCenter, newExtent);
+            hi[r + 1] = _mm256_add_ps(newCenter, newExtent);
+        }
+        lo[3] = hi[1];
+        hi[0] = lo[2];
+
+        transpose4x2(lo[0], lo[1], lo[2], lo[3]);
+        transpose4x2(hi[0], hi[1], hi[2], hi[3]);
+        for (U32_t b = 0; b != 4; ++b)
+        {
+            _mm_storeu_ps(&out[i + b].mm.min.x, _mm256_castps256_ps128(lo[b]));
+            _mm_storeu_ps(&out[i + b].mm.min.z, _mm256_castps256_ps128(hi[b]));
+            _mm_storeu_ps(&out[i + b + 4].mm.min.x, _mm256_extractf128_ps(lo[b], 1));
+            _mm_storeu_ps(&out[i + b + 4].mm.min.z, _mm256_extractf128_ps(hi[b], 1));
+        }
+    }
+
+    for (; i != boxes.size(); ++i)
+    { //
+        out[i] = transformAABB(boxes[i], transforms[i]);
+    }
+}
+
+constinit Kernel_s<TransformAABBsFunc_t> const g_transformAABBsKernel{
+    "transformAABBs",
+    { { EIsa_t::eScalar, transformAABBsScalar },
+      { EIsa_t::eSSE2, transformAABBsSSE },
+      { EIsa_t::eAVX2, transformAABBsAVX } }
+};
+
+void transformAABBs(std::span<AABB const> boxes, std::span<glm::mat4 const> transforms, std::span<AABB> out)
+{ //
+    g_transformAABBsKernel(boxes, transforms, out);
+}
+
+/// bounds of the part of the box in front of the camera: the corners in front, and the points where the edges
+/// cross w = ndcMinW. Corner i has the maximum coordinate on axis k if bit k of i is set
+static AABB clippedNDCBounds(glm::vec4 const (&corners)[8])
 {
-    // Define the 8 vertices of the AABB in model space
-    glm::vec4 vertices[]{ { aabb.mm.min, 1.0f },
-                          { aabb.mm.max, 1.0f },
-                          { aabb.mm.min.x, aabb.mm.min.y, aabb.mm.max.z, 1.0f },
-                          { aabb.mm.min.x, aabb.mm.max.y, aabb.mm.min.z, 1.0f },
-                          { aabb.mm.max.x, aabb.mm.min.y, aabb.mm.min.z, 1.0f },
-                          { aabb.mm.min.x, aabb.mm.max.y, aabb.mm.max.z, 1.0f },
-                          { aabb.mm.max.x, aabb.mm.min.y, aabb.mm.max.z, 1.0f },
-                          { aabb.mm.max.x, aabb.mm.max.y, aabb.mm.min.z, 1.0f } };
-
-    // Combine model, view, and projection matrices
-    glm::mat4 const mvp = projection * view * model;
-
-    // Transform vertices to clip space
-    for (auto &vertex : vertices)
+    glm::vec3 lo{ std::numeric_limits<F32_t>::infinity() };
+    glm::vec3 hi{ -std::numeric_limits<F32_t>::infinity() };
+    for (glm::vec4 const &corner : corners)
     {
-        vertex = mvp * vertex;
-        // Perform perspective divide to transform to NDC
-        vertex /= vertex.w;
+        if (corner.w > ndcMinW)
+        {
+            lo = glm::min(lo, glm::vec3(corner) / corner.w);
+            hi = glm::max(hi, glm::vec3(corner) / corner.w);
+        }
     }
 
-    // Find the new min and max points in NDC space
-    glm::vec3 ndc_min(std::numeric_limits<float>::max());
-    glm::vec3 ndc_max(std::numeric_limits<float>::lowest());
+    for (U32_t axis = 0; axis != 3; ++axis)
+    {
+        for (U32_t i = 0; i != 8; ++i)
+        {
+            U32_t const j = i | (1U << axis);
+            if (i == j || (corners[i].w > ndcMinW) == (corners[j].w > ndcMinW))
+            {
+                continue;
+            }
 
-    for (const auto &vertex : vertices)
+            F32_t const     s     = (ndcMinW - corners[i].w) / (corners[j].w - corners[i].w);
+            glm::vec3 const point = glm::vec3(corners[i] + (corners[j] - corners[i]) * s) / ndcMinW;
+            lo                    = glm::min(lo, point);
+            hi                    = glm::max(hi, point);
+        }
+    }
+    return { lo, hi };
+}
+
+void transformAABBsToNDC(
+  std::span<AABB const>      boxes,
+  std::span<glm::mat4 const> models,
+  glm::mat4 const           &viewProjection,
+  std::span<AABB>            out)
+{
+    assert(boxes.size() == models.size() && boxes.size() == out.size());
+    V128f_t viewProj[4];
+    loadColumns(viewProjection, viewProj);
+
+    for (U64_t i = 0; i != boxes.size(); ++i)
     {
-        ndc_min = glm::min(ndc_min, glm::vec3(vertex));
-        ndc_max = glm::max(ndc_max, glm::vec3(vertex));
+        V128f_t model[4];
+        V128f_t mvp[4];
+        loadColumns(models[i], model);
+        for (U32_t k = 0; k != 4; ++k)
+        {
+            V128f_t const xy = _mm_add_ps(
+              _mm_mul_ps(viewProj[0], broadcast<0>(model[k])), _mm_mul_ps(viewProj[1], broadcast<1>(model[k])));
+            V128f_t const zw = _mm_add_ps(
+              _mm_mul_ps(viewProj[2], broadcast<2>(model[k])), _mm_mul_ps(viewProj[3], broadcast<3>(model[k])));
+            mvp[k] = _mm_add_ps(xy, zw);
+        }
+
+        // clip space corners, from the center and the half axes, as clip space is linear in the position
+        glm::vec3 const center = (boxes[i].mm.max + boxes[i].mm.min) * 0.5f;
+        glm::vec3 const extent = (boxes[i].mm.max - boxes[i].mm.min) * 0.5f;
+        V128f_t const   clipCenter = combine(mvp, center.x, center.y, center.z, mvp[3]);
+        V128f_t const   axes[3]{ _mm_mul_ps(mvp[0], _mm_set1_ps(extent.x)),
+                                 _mm_mul_ps(mvp[1], _mm_set1_ps(extent.y)),
+                                 _mm_mul_ps(mvp[2], _mm_set1_ps(extent.z)) };
+        V128f_t         corners[8];
+        V128f_t         minW = _mm_set1_ps(std::numeric_limits<F32_t>::infinity());
+        for (U32_t c = 0; c != 8; ++c)
+        {
+            corners[c] = clipCenter;
+            for (U32_t axis = 0; axis != 3; ++axis)
+            {
+                corners[c] = (c & (1U << axis)) ? _mm_add_ps(corners[c], axes[axis])
+                                                : _mm_sub_ps(corners[c], axes[axis]);
+            }
+            minW = _mm_min_ps(minW, broadcast<3>(corners[c]));
+        }
+
+        if (_mm_cvtss_f32(minW) > ndcMinW)
+        { // entirely in front of the camera, the common case
+            V128f_t lo = _mm_set1_ps(std::numeric_limits<F32_t>::infinity());
+            V128f_t hi = _mm_set1_ps(-std::numeric_limits<F32_t>::infinity());
+            for (V128f_t const corner : corners)
+            {
+                V128f_t const ndc = _mm_div_ps(corner, broadcast<3>(corner));
+                lo                = _mm_min_ps(lo, ndc);
+                hi                = _mm_max_ps(hi, ndc);
+            }
+            storeBounds(out[i], lo, hi);
+        }
+        else
+        {
+            glm::vec4 clipCorners[8];
+            for (U32_t c = 0; c != 8; ++c)
+            { //
+                _mm_storeu_ps(&clipCorners[c].x, corners[c]);
+            }
+            out[i] = clippedNDCBounds(clipCorners);
+        }
     }
+}
 
-    // Return the transformed AABB in NDC space
-    return { ndc_min, ndc_max };
+AABB transformAABBToNDC(AABB const &aabb, glm::mat4 const &model, glm::mat4 const &view, glm::mat4 const &projection)
+{
+    AABB result;
+    transformAABBsToNDC({ &aabb, 1 }, { &model, 1 }, projection * view, { &result, 1 });
+    return result;
 }
 } // namespace cge
\ No newline at end of file
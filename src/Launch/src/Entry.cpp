@@ -2,16 +2,25 @@
 
 #include "Core/Alloc.h"
 #include "Core/Containers.h"
+#include "Core/Cpu.h"
 #include "Core/Event.h"
+#include "Core/EventReplay.h"
+#include "Core/Events.h"
+#include "Core/FramePacing.h"
+#include "Core/Job.h"
+#include "Core/Log.h"
 #include "Core/Module.h"
+#include "Core/Profiler.h"
+#include "Core/Task.h"
+#include "Core/TimeSlice.h"
 #include "Core/TimeUtils.h"
 #include "Core/Type.h"
 #include "Render/Renderer.h"
 #include "Render/Renderer2d.h"
 #include "Render/Window.h"
 
-#include <chrono>
 #include <cstdio>
+#include <cstdlib>
 
 namespace cge
 {
@@ -41,141 +50,18 @@ static void setMXCSR_DAZ_FTZ()
 
 using namespace cge;
 
-#if 1
-class MainTimer
-{
-    static constexpr U32_t timeWindowPower    = 2u;
-    static constexpr U32_t timeWindowCapacity = 1u << timeWindowPower;
-    static constexpr U32_t timeWindowMask     = (timeWindowCapacity - 1);
-    static constexpr U64_t timeUnitsPerSecond = timeUnit64;
-
-  public:
-    MainTimer()
-    {
-        std::fill_n(m_timeWindow.data(), timeWindowCapacity, timeUnitsIn60FPS);
-        reset();
-    }
-
-    void reset()
-    {
-        m_startTime = getCurrentTime();
-    }
-
-    // Returns elapsed time in units of 1/3000 seconds
-    U64_t elapsedTime()
-    {
-        TimePoint currentTime         = getCurrentTime();
-        U64_t     measuredElapsedTime = elapsedTimeUnits(currentTime, m_startTime);
-
-        m_startTime = currentTime; // Update start time for next calculation
-
-#if defined(CGE_DEBUG)
-        // Handle cases where a debugger causes a large pause
-        if (measuredElapsedTime > timeUnit32)
-        {
-            measuredElapsedTime = timeUnitsIn60FPS;
-        }
-#endif
-#undef min
-        // Store the measured time in the circular buffer
-        m_timeWindow[m_timeWindowIndex] = measuredElapsedTime;
-        ++m_timeWindowIndex;
-        m_timeWindowIndex &= timeWindowMask;
-        m_timeWindowSize = glm::min(m_timeWindowSize + 1, timeWindowCapacity);
-
-        // Compute the average elapsed time
-        U64_t totalElapsedTime = 0;
-        for (U32_t i = 0; i != m_timeWindowSize; ++i)
-        {
-            totalElapsedTime += m_timeWindow[i];
-        }
-        U64_t averagedElapsedTime = totalElapsedTime / m_timeWindowSize;
-
-        return averagedElapsedTime;
-    }
-
-  private:
-    using Clock     = std::chrono::high_resolution_clock;
-    using TimePoint = Clock::time_point;
-
-    TimePoint                             m_startTime;
-    std::array<U64_t, timeWindowCapacity> m_timeWindow{};
-    U32_t                                 m_timeWindowIndex = 0;
-    U32_t                                 m_timeWindowSize  = 0;
-
-    // Returns the current time in nanoseconds
-    TimePoint getCurrentTime() const
-    {
-        return Clock::now();
-    }
-
-    // Convert elapsed time from nanoseconds to 1/3000 seconds units
-    U64_t elapsedTimeUnits(const TimePoint &endTime, const TimePoint &startTime) const
-    {
-        auto deltaTimeNano = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
-        // Convert nanoseconds to time units (1/3000 seconds)
-        return (deltaTimeNano * timeUnitsPerSecond) / 1'000'000'000ULL;
-    }
-};
-#else
-class MainTimer
-{
-    static U32_t constexpr timeWindowPower    = 2u;
-    static U32_t constexpr timeWindowCapacity = 1u << timeWindowPower;
-    static U32_t constexpr timeWindowMask     = (timeWindowCapacity - 1);
-
-  public:
-    MainTimer()
-    {
-        std::fill_n(m_timeWindow.data(), timeWindowCapacity, timeUnitsIn60FPS);
-        reset();
-    }
-
-    void reset()
-    {
-        m_startTime = hiResTimer();
-    }
-
-    U32_t elapsedTime()
-    {
-        U32_t measuredElapsedTime = elapsedTimeUnits(hiResTimer(), m_startTime);
-#if defined(CGE_DEBUG)
-        // if the elapsed time is too big, we must have had a breakpoint. Set
-        // elapsed time to ideal
-        if (measuredElapsedTime > timeUnit32)
-        {
-            measuredElapsedTime = timeUnitsIn60FPS;
-        }
-#endif
-#undef min
-        m_timeWindow[m_timeWindowIndex] = measuredElapsedTime;
-        ++m_timeWindowIndex;
-        m_timeWindowIndex &= timeWindowMask;
-        m_timeWindowSize = glm::min(m_timeWindowSize + 1, timeWindowCapacity);
-
-        measuredElapsedTime = 0;
-        for (U32_t i = 0; i != m_timeWindowSize; ++i)
-        {
-            measuredElapsedTime += m_timeWindow[i];
-        }
-
-        measuredElapsedTime /= m_timeWindowSize;
-        return measuredElapsedTime;
-    }
-
-  private:
-    Array<U32_t, timeWindowCapacity> m_timeWindow{};
-    U64_t                            m_startTime       = 0;
-    U32_t                            m_timeWindowIndex = 0;
-    U32_t                            m_timeWindowSize  = 0;
-};
-#endif
 I32_t main(I32_t argc, Char8_t **argv)
 {
     setMXCSR_DAZ_FTZ();
+    CGEDBG_ALLOC_GUARD_INIT();
+    hiResCalibration(); // keeps the calibration out of the first frame
+    g_logger.init();
+    printCpuInfo();
+    g_profiler.initFromEnvironment();
+    CGE_PROFILE_THREAD("Main");
+    g_jobSystem.init({});
     g_eventQueue.init();
-    MainTimer mainTimer;
-    U64_t     elapsedTime = timeUnitsIn60FPS;
+    g_timeSliceScheduler.initFromEnvironment();
 
     WindowSpec_t const windowSpec{ .title = "Dune Run", .width = 600, .height = 480 };
     Window_s     window;
@@ -195,9 +81,28 @@ I32_t main(I32_t argc, Char8_t **argv)
 
     g_eventQueue.dispatch();
 
+    // input events are recorded, or replayed in place of the live ones
+    g_eventReplay.initFromEnvironment({ evKeyPressed, evMouseButtonPressed, evMouseMoved });
+    B8_t const replaying = g_eventReplay.mode() == EReplayMode_t::eReplay;
+    if (replaying)
+    {
+        window.setInputEnabled(false);
+    }
+
+    // the simulation takes fixed steps, the first frame one of them. Replays run as fast as possible
+    FixedTimeStep_s fixedStep;
+    FrameLimiter_s  frameLimiter;
+    frameLimiter.initFromEnvironment(replaying ? 0 : timeUnit32 / timeUnitsIn60FPS);
+    U64_t frameStart   = hiResTimer();
+    U64_t elapsedTicks = (fixedStep.step() * hiResFrequency() + timeUnit64 - 1) / timeUnit64;
+
     while (!window.shouldClose() && !getModuleMap().at(g_startupModule).pModule->taggedForDestruction())
     {
-        mainTimer.reset();
+        CGE_PROFILE_BEGIN_FRAME();
+
+        // the buffer being rewound was written two frames ago, last frame's one stays readable
+        getScratchBuffer()->swapBuffers();
+        getScratchBuffer()->clearCurrentBuffer();
 
         if (Sid_t const sid = getModuleMap().at(g_startupModule).pModule->moduleSwitched(); sid != nullSid)
         {
@@ -220,23 +125,71 @@ I32_t main(I32_t argc, Char8_t **argv)
             }
         }
 
-        // Do stuff...
+        // simulation steps owed by the elapsed time, fixed when replaying, then a single render
         g_renderer.clear();
-        getModuleMap().at(g_startupModule).pModule->onTick(elapsedTime);
+        U32_t const steps =
+          replaying ? fixedStep.advanceUnits(g_eventReplay.timeStep()) : fixedStep.advance(elapsedTicks);
+        CGEDBG_ALLOC_GUARD_BEGIN_TICK();
+        for (U32_t step = 0; step != steps; ++step)
+        {
+            CGE_PROFILE_SCOPE("onTick");
+            g_scene.storePreviousTransforms();
+            g_taskScheduler.update(fixedStep.step());
+            getModuleMap().at(g_startupModule).pModule->onTick(fixedStep.step());
+        }
+        {
+            CGE_PROFILE_SCOPE("onRender");
+            getModuleMap().at(g_startupModule).pModule->onRender(fixedStep.alpha());
+        }
+        CGEDBG_ALLOC_GUARD_END_TICK();
+
+        // incremental work queued by the modules, within its per frame budget
+        g_timeSliceScheduler.run();
 
         // swap buffers and poll events (and queue them)
-        window.swapBuffers();
+        {
+            CGE_PROFILE_SCOPE("swapBuffers");
+            window.swapBuffers();
+        }
         window.pollEvents(0);
 
-        // dispatch events
+        // fire the event timers expired in simulation time, then dispatch events
+        g_eventReplay.injectFrame();
+        g_eventQueue.advanceTime(static_cast<U64_t>(steps) * fixedStep.step());
         g_eventQueue.dispatch();
+        CGE_PROFILE_END_FRAME();
+        if (!g_eventReplay.endFrame())
+        { // replay over
+            break;
+        }
 
-        // Update timers
-        elapsedTime = mainTimer.elapsedTime();
+        // sleep, then spin, until the end of the frame period
+        U64_t const frameEnd = frameLimiter.wait(frameStart);
+        g_frameTimes.record(hiResToNanoseconds(frameEnd - frameStart));
+        elapsedTicks = frameEnd - frameStart;
+        frameStart   = frameEnd;
     }
+    g_eventReplay.shutdown();
+    g_frameTimes.print("frame times");
 
     for (auto &[sid, moduleCtorPair] : getModuleMap())
     { // if the pointer is nullptr delete is nop
         delete moduleCtorPair.pModule;
     }
+    g_taskScheduler.shutdown();
+    g_timeSliceScheduler.shutdown();
+    g_jobSystem.shutdown();
+    g_logger.shutdown();
+
+#if defined(CGE_DEBUG)
+    // high-water marks are used to size the arena slots for our content
+    getEngineArena().printStats();
+    getMemoryPool()->printStats();
+    dbg_printMemoryTagStats();
+    CGEDBG_ALLOC_GUARD_REPORT();
+    if (std::getenv("CGE_DUMP_SIDS"))
+    {
+        dbg_dumpSids(stdout);
+    }
+#endif
 }
@@ -26,11 +26,17 @@ class Renderer_s
 {
   public:
     void init();
+
+    /** @fn renderScene
+     *  @brief draws every node with its transform interpolated by `alpha`, see
+     *  @ref SceneNode_s::getInterpolatedTransform. 1 draws the current simulation state
+     */
     void renderScene(
       Scene_s const   &scene,
       glm::mat4 const &view,
       glm::mat4 const &proj,
-      glm::vec3        eye) const;
+      glm::vec3        eye,
+      F32_t            alpha = 1.f) const;
     void clear() const;
 
     void renderCube() const;
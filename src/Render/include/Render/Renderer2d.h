@@ -1,4 +1,5 @@
 #include "Core/Module.h"
+#include "Core/TimeSlice.h"
 #include "Core/Type.h"
 #include "Resource/Rendering/GpuProgram.h"
 #include "Resource/Rendering/cgeTexture.h"
@@ -58,9 +59,25 @@ class Renderer2D
     Renderer2D &operator=(Renderer2D &&)      = delete;
     ~Renderer2D();
 
+    /** @fn init
+     *  @brief builds the GPU programs and queues the rasterization of the glyphs with
+     *  @ref fillCharaterMapIncremental, so that text is drawn from the first frames on rather than delaying the first
+     */
     void init();
+
+    /** @fn fillCharaterMap
+     *  @brief rasterizes the glyphs at the given pixel size now, cancelling a pending incremental fill. Returns
+     *  true on error
+     */
     bool fillCharaterMap(U32_t points);
 
+    /** @fn fillCharaterMapIncremental
+     *  @brief rasterizes the glyphs on @ref g_timeSliceScheduler, a few per step, in a separate map which replaces
+     *  the current one once complete, so that text keeps being drawn with the old glyphs meanwhile. A pending
+     *  incremental fill is cancelled
+     */
+    WorkHandle_t fillCharaterMapIncremental(U32_t points, EWorkPriority_t priority = EWorkPriority_t::eNormal);
+
     void renderText(Char8_t const *text, glm::vec3 xyScale, glm::vec3 color) const;
     void renderButton(ButtonSpec const &specs) const;
     void renderRectangle(RectangleSpec const &spec) const;
@@ -68,8 +85,15 @@ class Renderer2D
 
     void onFramebufferSize(I32_t width, I32_t height);
 
+    /** @fn letterSize
+     *  @brief advance of 'O' in pixels. Finishes the pending fill if no glyph has been rasterized yet, zero if the
+     *  font couldn't be loaded
+     */
     glm::ivec2 letterSize() const;
 
+  private:
+    class GlyphLoader_s;
+
   private:
     void                             prepare(GpuProgram_s const &) const;
     Renderer2D::TextureMap::iterator uploadTextureToGPU(Sid_t sid);
@@ -113,14 +137,15 @@ class Renderer2D
 
     glm::mat4                                m_projection{ glm::mat4(1.f) };
     void                                    *m_freeType{ nullptr };
-    std::pmr::unordered_map<char, Character> m_characterMap{ getMemoryPool() };
-    TextureMap                               m_textureMap{ getMemoryPool() };
+    std::pmr::unordered_map<char, Character> m_characterMap{ getMemoryPool(EMemoryTag_t::eRenderer2D) };
+    TextureMap                               m_textureMap{ getMemoryPool(EMemoryTag_t::eRenderer2D) };
     U32_t                                    m_textVAO{ 0 }, m_textVBO{ 0 };
     U32_t                                    m_buttonVAO{ 0 }, m_buttonVBO{ 0 }; // rectangle and button share VAO/VBO
     U                                        m_delayedCtor;
     glm::ivec2                               m_windowSize{ 0, 0 };
     bool                                     m_init{ false };
     U32_t                                    m_points{ 0 };
+    WorkHandle_t                             m_glyphWork{ nullWorkHandle };
 };
 
 extern Renderer2D g_renderer2D;
@@ -61,6 +61,11 @@ class Window_s
     void enableCursor();
     void disableCursor();
 
+    /** @fn setInputEnabled
+     *  @brief when disabled, key, mouse button and cursor callbacks don't emit events (eg. while replaying)
+     */
+    void setInputEnabled(B8_t enabled);
+
   private:
     void onKey(I32_t key, I32_t scancode, I32_t action, I32_t mods) const;
     void onMouseButton(I32_t button, I32_t action, I32_t mods) const;
@@ -68,7 +73,8 @@ class Window_s
     void onFramebufferSize(I32_t width, I32_t height) const;
 
   private:
-    gsl::owner<void *> m_handle = nullptr;
+    gsl::owner<void *> m_handle       = nullptr;
+    B8_t               m_inputEnabled = true;
 };
 
 class FocusedWindow_s
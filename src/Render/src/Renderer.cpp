@@ -10,6 +10,8 @@
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <cstdio>
+
 namespace cge
 {
 
@@ -56,51 +58,55 @@ void Renderer_s::init()
     glEnable(GL_CULL_FACE);
 }
 
+// builds "lights[i].field" in the scratch string, keeping the "lights[i]." prefix across calls
+static I32_t lightUniformLocation(I32_t glid, std::pmr::string &name, U64_t prefixLength, Char8_t const *field)
+{
+    name.resize(prefixLength);
+    name.append(field);
+    return glGetUniformLocation(glid, name.c_str());
+}
+
 static void uploadLightData(Scene_s const &scene, I32_t glid)
 {
+    // per frame strings live in the frame allocator, hence cost a pointer bump
+    std::pmr::string name{ getScratchBuffer() };
+    name.reserve(64);
+
     U32_t i = 0;
     for (auto it = scene.lightBegin(); it != scene.lightEnd(); ++it)
     {
-        std::pmr::string index{ std::to_string(i), getMemoryPool() };
-        auto const      &light = it->second;
+        Char8_t     prefix[32];
+        I32_t const prefixLength = snprintf(prefix, sizeof(prefix), "lights[%u].", i);
+        auto const &light        = it->second;
+        name.assign(prefix, prefixLength);
 
         glUniform3f(
-          glGetUniformLocation(glid, ("lights[" + index + "].ambient").c_str()),
-          light.ambient.x,
-          light.ambient.y,
-          light.ambient.z);
-        glUniform3f(
-          glGetUniformLocation(glid, ("lights[" + index + "].color").c_str()),
-          light.color.x,
-          light.color.y,
-          light.color.z);
+          lightUniformLocation(glid, name, prefixLength, "ambient"), light.ambient.x, light.ambient.y, light.ambient.z);
+        glUniform3f(lightUniformLocation(glid, name, prefixLength, "color"), light.color.x, light.color.y, light.color.z);
         glUniform3f(
-          glGetUniformLocation(glid, ("lights[" + index + "].position").c_str()),
+          lightUniformLocation(glid, name, prefixLength, "position"),
           light.position.x,
           light.position.y,
           light.position.z);
         glUniform3f(
-          glGetUniformLocation(glid, ("lights[" + index + "].halfVector").c_str()),
+          lightUniformLocation(glid, name, prefixLength, "halfVector"),
           light.halfVector.x,
           light.halfVector.y,
           light.halfVector.z);
         glUniform3f(
-          glGetUniformLocation(glid, ("lights[" + index + "].coneDirection").c_str()),
+          lightUniformLocation(glid, name, prefixLength, "coneDirection"),
           light.coneDirection.x,
           light.coneDirection.y,
           light.coneDirection.z);
-        glUniform1f(glGetUniformLocation(glid, ("lights[" + index + "].spotCosCutoff").c_str()), light.spotCosCutoff);
-        glUniform1f(glGetUniformLocation(glid, ("lights[" + index + "].spotExponent").c_str()), light.spotExponent);
-        glUniform1f(
-          glGetUniformLocation(glid, ("lights[" + index + "].constantAttenuation").c_str()), light.constantAttenuation);
-        glUniform1f(
-          glGetUniformLocation(glid, ("lights[" + index + "].linearAttenuation").c_str()), light.linearAttenuation);
+        glUniform1f(lightUniformLocation(glid, name, prefixLength, "spotCosCutoff"), light.spotCosCutoff);
+        glUniform1f(lightUniformLocation(glid, name, prefixLength, "spotExponent"), light.spotExponent);
+        glUniform1f(lightUniformLocation(glid, name, prefixLength, "constantAttenuation"), light.constantAttenuation);
+        glUniform1f(lightUniformLocation(glid, name, prefixLength, "linearAttenuation"), light.linearAttenuation);
         glUniform1f(
-          glGetUniformLocation(glid, ("lights[" + index + "].quadraticAttenuation").c_str()),
-          light.quadraticAttenuation);
-        glUniform1i(glGetUniformLocation(glid, ("lights[" + index + "].isEnabled").c_str()), light.isEnabled);
-        glUniform1i(glGetUniformLocation(glid, ("lights[" + index + "].isLocal").c_str()), light.isLocal);
-        glUniform1i(glGetUniformLocation(glid, ("lights[" + index + "].isSpot").c_str()), light.isSpot);
+          lightUniformLocation(glid, name, prefixLength, "quadraticAttenuation"), light.quadraticAttenuation);
+        glUniform1i(lightUniformLocation(glid, name, prefixLength, "isEnabled"), light.isEnabled);
+        glUniform1i(lightUniformLocation(glid, name, prefixLength, "isLocal"), light.isLocal);
+        glUniform1i(lightUniformLocation(glid, name, prefixLength, "isSpot"), light.isSpot);
         ++i;
     }
 }
@@ -124,18 +130,24 @@ static void printfMatrix(glm::mat4 const &t) {
 }
 #endif
 
-void Renderer_s::renderScene(Scene_s const &scene, glm::mat4 const &view, glm::mat4 const &proj, glm::vec3 eye) const
+void Renderer_s::renderScene(
+  Scene_s const   &scene,
+  glm::mat4 const &view,
+  glm::mat4 const &proj,
+  glm::vec3        eye,
+  F32_t            alpha) const
 {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glm::mat4 const viewProj = proj * view;
     for (auto const &[sid, sceneNode] : scene.m_nodeMap)
     {
         auto const &mesh = g_handleTable.getMesh(sceneNode.getSid());
 
-        glm::mat4 const     modelView = view * sceneNode.getTransform();
-        MeshUniform_t const uniforms{ .modelView     = modelView,
-                                      .modelViewProj = proj * modelView,
-                                      .model         = sceneNode.getTransform() };
+        Affine3x4_t const   model = sceneNode.getInterpolatedTransform(alpha);
+        MeshUniform_t const uniforms{ .modelView     = compose(view, model),
+                                      .modelViewProj = compose(viewProj, model),
+                                      .model         = model.toMat4() };
 // turn on if debug is needed
 #if 0
         if (sid == "Cube"_sid)
@@ -11,7 +11,9 @@
 #include <glad/gl.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
 #include <unordered_map>
+#include <utility>
 
 namespace cge
 {
@@ -132,10 +134,14 @@ void Renderer2D::init()
     }
 
     auto *p = reinterpret_cast<FT_Library *>(&m_freeType);
-    if (FT_Init_FreeType(p) || fillCharaterMap(48))
+    if (FT_Init_FreeType(p))
     {
         printf("[Renderer2D] ERROR: couldn't initialize Renderer2D\n");
     }
+    else
+    { // rasterized during the first frames, until then text is skipped. See letterSize
+        fillCharaterMapIncremental(48, EWorkPriority_t::eHigh);
+    }
 
     static U32_t constexpr stagesCount{ 2 };
     char const *sources[stagesCount]{ textVS, textFS };
@@ -220,33 +226,85 @@ void Renderer2D::onFramebufferSize(I32_t width, I32_t height)
     m_projection = glm::ortho(0.0f, F32_t(width), 0.0f, F32_t(height));
 }
 
-bool Renderer2D::fillCharaterMap(U32_t points)
+static U32_t constexpr glyphCount    = 128;
+static U32_t constexpr glyphsPerStep = 8;
+
+/** @class Renderer2D::GlyphLoader_s
+ * @brief fills a character map a few glyphs per call, and swaps it with the one of the renderer when done
+ */
+class Renderer2D::GlyphLoader_s
 {
-    FT_Face face;
-    if (FT_New_Face(reinterpret_cast<FT_Library>(m_freeType), "../assets/mobyb.ttf", 0, &face))
+  public:
+    GlyphLoader_s(Renderer2D &renderer, U32_t points) : m_renderer(&renderer), m_points(points)
+    {
+    }
+    GlyphLoader_s(GlyphLoader_s const &)            = delete;
+    GlyphLoader_s &operator=(GlyphLoader_s const &) = delete;
+    GlyphLoader_s(GlyphLoader_s &&other) noexcept
+      : m_renderer(other.m_renderer)
+      , m_characterMap(std::move(other.m_characterMap))
+      , m_face(std::exchange(other.m_face, nullptr))
+      , m_points(other.m_points)
+      , m_next(other.m_next)
+      , m_failed(other.m_failed)
+    {
+    }
+    GlyphLoader_s &operator=(GlyphLoader_s &&) = delete;
+    ~GlyphLoader_s()
     {
-        printf("[Renderer2D] ERROR: Failed to load Comic Sans Font\n");
-        return true;
+        if (m_face)
+        { //
+            FT_Done_Face(m_face);
+        }
+    }
+
+    WorkProgress_t operator()();
+
+    [[nodiscard]] B8_t failed() const
+    { //
+        return m_failed;
     }
 
-    m_characterMap.clear();
+  private:
+    Renderer2D                              *m_renderer;
+    std::pmr::unordered_map<char, Character> m_characterMap{ getMemoryPool(EMemoryTag_t::eRenderer2D) };
+    FT_Face                                  m_face   = nullptr;
+    U32_t                                    m_points = 0;
+    U32_t                                    m_next   = 0;
+    B8_t                                     m_failed = false;
+};
+
+WorkProgress_t Renderer2D::GlyphLoader_s::operator()()
+{
+    if (!m_face)
+    {
+        if (FT_New_Face(reinterpret_cast<FT_Library>(m_renderer->m_freeType), "../assets/mobyb.ttf", 0, &m_face))
+        {
+            printf("[Renderer2D] ERROR: Failed to load Comic Sans Font\n");
+            m_face   = nullptr;
+            m_failed = true;
+            return { .done = 0, .total = 0 };
+        }
 
-    // set which pixel size you want to retrieve
-    // width = 0 -> computed dynamically from height
-    FT_Set_Pixel_Sizes(face, 0, points);
+        // set which pixel size you want to retrieve
+        // width = 0 -> computed dynamically from height
+        FT_Set_Pixel_Sizes(m_face, 0, m_points);
+    }
 
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // disable byte-alignment restriction
 
-    for (unsigned char c = 0; c < 128; c++)
+    for (U32_t const end = std::min(m_next + glyphsPerStep, glyphCount); m_next != end; ++m_next)
     {
+        auto const c = static_cast<unsigned char>(m_next);
+
         // load character glyph
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+        if (FT_Load_Char(m_face, c, FT_LOAD_RENDER))
         {
             printf("[Renderer2D] ERROR: Failed to load Glyph %c\n", c);
             continue;
         }
 
-        auto &glyph = *face->glyph;
+        auto &glyph = *m_face->glyph;
 
         // generate texture
         U32_t texture;
@@ -282,12 +340,32 @@ bool Renderer2D::fillCharaterMap(U32_t points)
             glyph.advance.x));
     }
 
-    FT_Done_Face(face);
     glBindTexture(GL_TEXTURE_2D, 0);
     glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
-    m_points = points;
-    return false;
+    if (m_next == glyphCount)
+    { // the old glyphs are freed with the loader
+        m_renderer->m_characterMap.swap(m_characterMap);
+        m_renderer->m_points = m_points;
+    }
+    return { .done = m_next, .total = glyphCount };
+}
+
+bool Renderer2D::fillCharaterMap(U32_t points)
+{
+    g_timeSliceScheduler.cancel(m_glyphWork);
+    GlyphLoader_s loader{ *this, points };
+    while (!loader().finished())
+    {
+    }
+    return loader.failed();
+}
+
+WorkHandle_t Renderer2D::fillCharaterMapIncremental(U32_t points, EWorkPriority_t priority)
+{
+    g_timeSliceScheduler.cancel(m_glyphWork);
+    m_glyphWork = g_timeSliceScheduler.submit("glyphs", priority, GlyphLoader_s{ *this, points });
+    return m_glyphWork;
 }
 
 void Renderer2D::renderButton(ButtonSpec const &specs) const
@@ -347,6 +425,12 @@ void Renderer2D::renderButton(ButtonSpec const &specs) const
     glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+    // no label while the glyphs of the first fill are being rasterized
+    if (str.empty() || m_characterMap.empty())
+    { //
+        return;
+    }
+
     F32_t ySize = letterSize().y;
     F32_t xSize = letterSize().x * str.size();
 
@@ -356,10 +440,7 @@ void Renderer2D::renderButton(ButtonSpec const &specs) const
                              (specs.position.y + specs.size.y * 0.5f) * m_windowSize.y - ySize * sizeRatio / 2,
                              sizeRatio };
 
-    if (!str.empty())
-    {
-        renderText(specs.text, xyScale, specs.textColor);
-    }
+    renderText(specs.text, xyScale, specs.textColor);
 }
 
 Renderer2D::Character::~Character()
@@ -404,7 +485,7 @@ void Renderer2D::prepare(GpuProgram_s const &program) const
 
 void Renderer2D::renderText(Char8_t const *text, glm::vec3 xyScale, glm::vec3 color) const
 {
-    if (m_windowSize.x <= 0 || m_windowSize.y <= 0)
+    if (m_windowSize.x <= 0 || m_windowSize.y <= 0 || m_characterMap.empty())
     { //
         return;
     }
@@ -425,7 +506,13 @@ void Renderer2D::renderText(Char8_t const *text, glm::vec3 xyScale, glm::vec3 co
     // iterate through all characters
     for (auto const c : str)
     {
-        Character const &ch = m_characterMap.at(c);
+        // glyphs which failed to load are skipped
+        auto const it = m_characterMap.find(c);
+        if (it == m_characterMap.cend())
+        { //
+            continue;
+        }
+        Character const &ch = it->second;
 
         F32_t const xpos = xyScale.x + ch.bearing.x * xyScale.z;
         F32_t const ypos = xyScale.y - (ch.size.y - ch.bearing.y) * xyScale.z;
@@ -455,8 +542,13 @@ void Renderer2D::renderText(Char8_t const *text, glm::vec3 xyScale, glm::vec3 co
 
 glm::ivec2 Renderer2D::letterSize() const
 {
-    Character const &c = m_characterMap.at('O');
-    return glm::ivec2{ c.advance  >> 6 };
+    // the metrics are needed now: completes the first fill if still pending, as the map is swapped in by the loader
+    if (m_characterMap.empty())
+    { //
+        g_timeSliceScheduler.finish(m_glyphWork);
+    }
+    auto const it = m_characterMap.find('O');
+    return it != m_characterMap.cend() ? glm::ivec2{ it->second.advance >> 6 } : glm::ivec2{ 0 };
 }
 
 void Renderer2D::renderRectangle(const RectangleSpec &spec) const
@@ -108,6 +108,10 @@ EErr_t Window_s::init(WindowSpec_t const& spec)
     glfwSetFramebufferSizeCallback(
       reinterpret_cast<GLFWwindow*>(m_handle), &framebufferSizeCallback);
 
+    // only the latest cursor position and framebuffer size matter to the listeners
+    g_eventQueue.setCoalescePolicy(evMouseMoved, ECoalescePolicy_t::eKeepLast);
+    g_eventQueue.setCoalescePolicy(evFramebufferSize, ECoalescePolicy_t::eKeepLast);
+
     // enable V-Sync (TODO configurable?)
     glfwSwapInterval(0);
 
@@ -182,6 +186,7 @@ void framebufferSizeCallback(GLFWwindow* window, I32_t width, I32_t height)
 void Window_s::onKey(I32_t key, I32_t scancode, I32_t action, I32_t mods) const
 {
     // Handle key events here (queued)
+    if (!m_inputEnabled) { return; }
     EventArg_t keyPressedData{};
     keyPressedData.idata.i32[0] = key;
     keyPressedData.idata.i32[1] = action;
@@ -191,6 +196,7 @@ void Window_s::onKey(I32_t key, I32_t scancode, I32_t action, I32_t mods) const
 void Window_s::onMouseButton(I32_t button, I32_t action, I32_t mods) const
 {
     // Handle button events here (queued)
+    if (!m_inputEnabled) { return; }
     EventArg_t keyPressedData{};
     keyPressedData.idata.i32[0] = button;
     keyPressedData.idata.i32[1] = action;
@@ -200,6 +206,7 @@ void Window_s::onMouseButton(I32_t button, I32_t action, I32_t mods) const
 void Window_s::onCursorMovement(F32_t xpos, F32_t ypos) const
 {
     // Handle mouse events here (queued)
+    if (!m_inputEnabled) { return; }
     EventArg_t cursorCoords{};
     cursorCoords.fdata.f32[0] = xpos;
     cursorCoords.fdata.f32[1] = ypos;
@@ -215,6 +222,11 @@ void Window_s::onFramebufferSize(I32_t width, I32_t height) const
     g_eventQueue.emit(evFramebufferSize, m_framebufferSize);
 }
 
+void Window_s::setInputEnabled(B8_t enabled)
+{
+    m_inputEnabled = enabled;
+}
+
 void Window_s::swapBuffers()
 {
     glfwSwapBuffers(reinterpret_cast<GLFWwindow*>(m_handle));
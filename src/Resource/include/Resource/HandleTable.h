@@ -3,6 +3,7 @@
 #include "Core/Containers.h"
 #include "Core/Module.h"
 #include "Core/StringUtils.h"
+#include "Core/TimeSlice.h"
 #include "Core/Type.h"
 #include "Resource/Rendering/cgeLight.h"
 #include "Resource/Rendering/cgeMesh.h"
@@ -58,15 +59,30 @@ class HandleTable_s
     Mesh_s              &getMesh(Sid_t sid);
     TextureData_s       &getTexture(Sid_t sid);
 
+    /** @fn loadFromObj
+     *  @brief loads the meshes of an obj file now. A file already loaded is skipped, and one being loaded
+     *  incrementally is finished
+     */
     void loadFromObj(Char8_t const *path);
 
+    /** @fn loadFromObjIncremental
+     *  @brief queues the load of an obj file on @ref g_timeSliceScheduler: the first step parses the file, each of
+     *  the following loads a mesh with its textures and GPU buffers. `path` must have static storage duration.
+     *  If the load is cancelled, @ref loadFromObj loads the meshes left
+     */
+    WorkHandle_t loadFromObjIncremental(Char8_t const *path, EWorkPriority_t priority = EWorkPriority_t::eLow);
+
+  private:
+    class ObjLoader_s;
+
   private:
     void loadTextures(Char8_t const *path, void const *material, Mesh_s &mesh);
 
   private:
     // using map for iterator stability
-    std::pmr::map<Sid_t, Mesh_s>        m_meshTable{ getMemoryPool() };
-    std::pmr::map<Sid_t, TextureData_s> m_textureTable{ getMemoryPool() };
+    std::pmr::map<Sid_t, Mesh_s>        m_meshTable{ getMemoryPool(EMemoryTag_t::eHandleTable) };
+    std::pmr::map<Sid_t, TextureData_s> m_textureTable{ getMemoryPool(EMemoryTag_t::eHandleTable) };
+    std::pmr::map<Sid_t, WorkHandle_t>  m_objFiles{ getMemoryPool(EMemoryTag_t::eHandleTable) }; ///< null once loaded
 };
 
 extern HandleTable_s::Ref_s const nullRef;
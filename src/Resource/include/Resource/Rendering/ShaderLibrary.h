@@ -1,10 +1,10 @@
 #pragma once
 
+#include "Core/Containers.h"
 #include "Core/Module.h"
 #include "Core/StringUtils.h"
 #include "Core/Type.h"
 
-#include <map>
 #include <string>
 #include <tl/optional.hpp>
 
@@ -24,7 +24,8 @@ class ShaderLibrary_s
     tl::optional<Shader_s *> open(char const *);
 
   private:
-    std::pmr::map<Sid_t, Shader_s> m_shaderMap{ getMemoryPool() };
+    // stable, as the returned pointers are kept while opening the other stages of a program
+    StableFlatMap<Sid_t, Shader_s> m_shaderMap{ getMemoryPool() };
 };
 
 extern ShaderLibrary_s g_shaderLibrary;
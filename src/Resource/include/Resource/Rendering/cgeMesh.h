@@ -64,8 +64,8 @@ struct Mesh_s
         "model"
     };
 
-    std::pmr::vector<Vertex_t>        vertices{ getMemoryPool() };
-    std::pmr::vector<Array<U32_t, 3>> indices{ getMemoryPool() };
+    std::pmr::vector<Vertex_t>        vertices{ getMemoryPool(EMemoryTag_t::eHandleTable) };
+    std::pmr::vector<Array<U32_t, 3>> indices{ getMemoryPool(EMemoryTag_t::eHandleTable) };
 
     AABB box{ glm::vec3(0.f), glm::vec3(0.f) };
 
@@ -1,14 +1,14 @@
 #pragma once
 
+#include "Core/Containers.h"
 #include "Core/Module.h"
 #include "Core/StringUtils.h"
+#include "Core/Transform.h"
 #include "Core/Type.h"
 #include "cgeLight.h"
 
 #include <glm/glm.hpp>
 
-#include <unordered_map>
-
 namespace cge
 {
 
@@ -24,20 +24,38 @@ class SceneNode_s
     explicit SceneNode_s(Sid_t sid);
 
   public:
-    Sid_t            getSid() const;
-    glm::mat4 const &getTransform() const;
-    glm::vec4 const &getPosition() const;
+    Sid_t              getSid() const;
+    glm::mat4          getTransform() const;
+    Affine3x4_t const &getAffineTransform() const;
+    glm::vec4          getPosition() const;
+
+    /** @fn getInterpolatedTransform
+     *  @brief transform blended between the one before the last simulation step and the current one. Nodes
+     *  added or teleported during the step have no previous transform and are drawn where they are
+     */
+    Affine3x4_t getInterpolatedTransform(F32_t alpha) const;
 
     void setSid(Sid_t sid);
     void transform(glm::mat4 const &t);
+    void transform(Affine3x4_t const &t);
     void rightMul(glm::mat4 const &t);
+    void rightMul(Affine3x4_t const &t);
     void setTransform(glm::mat4 const &t);
+    void setTransform(Affine3x4_t const &t);
     void translate(glm::vec3 const &disp);
     void rotate(F32_t radians, glm::vec3 const &rotationAxis);
 
+    /** @fn resetInterpolation
+     *  @brief to be called after a discontinuous change of the transform, so that the node isn't swept across
+     *  the jump until the next simulation step
+     */
+    void resetInterpolation();
+
   private:
-    Sid_t     m_sid; // sid of the mesh
-    glm::mat4 m_transform = glm::mat4(1.f);
+    Sid_t       m_sid; // sid of the mesh
+    Affine3x4_t m_transform         = Affine3x4_t::identity();
+    Affine3x4_t m_previousTransform = Affine3x4_t::identity();
+    B8_t        m_interpolated      = false;
 };
 
 class Scene_s
@@ -46,8 +64,8 @@ class Scene_s
 
   public:
     using PairNode     = std::pair<Sid_t const, SceneNode_s>;
-    using LightIt      = std::pmr::unordered_map<Sid_t, Light_t>::iterator;
-    using LightConstIt = std::pmr::unordered_map<Sid_t, Light_t>::const_iterator;
+    using LightIt      = StableFlatMap<Sid_t, Light_t>::iterator;
+    using LightConstIt = StableFlatMap<Sid_t, Light_t>::const_iterator;
 
   public:
     SceneNode_s       &getNodeBySid(Sid_t sid);
@@ -66,9 +84,16 @@ class Scene_s
     B8_t  removeLight(Sid_t lightSid);
     void  clearSceneLights();
 
+    /** @fn storePreviousTransforms
+     *  @brief remembers the current transforms of all nodes as the previous simulation state. Called by the main
+     *  loop before each simulation step
+     */
+    void storePreviousTransforms();
+
   private:
-    std::pmr::unordered_map<Sid_t, SceneNode_s> m_nodeMap{ getMemoryPool() };
-    std::pmr::unordered_map<Sid_t, Light_t>     m_lightMap{ getMemoryPool() };
+    // stable, as node references are kept across insertions, and so that the draw order doesn't depend on hashes
+    StableFlatMap<Sid_t, SceneNode_s> m_nodeMap{ getMemoryPool(EMemoryTag_t::eScene) };
+    StableFlatMap<Sid_t, Light_t>     m_lightMap{ getMemoryPool(EMemoryTag_t::eScene) };
 };
 
 extern Scene_s g_scene;
@@ -1,6 +1,7 @@
 #include "HandleTable.h"
 
 #include "Core/Alloc.h"
+#include "Core/Log.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
@@ -9,6 +10,7 @@
 #include <stb/stb_image.h>
 
 #include <cassert>
+#include <memory>
 #include <string>
 
 namespace cge
@@ -262,7 +264,7 @@ Mesh_s &HandleTable_s::getMesh(Sid_t sid)
     return m_meshTable.at(sid);
 }
 
-static void pushInQueue(std::pmr::vector<aiNode *> &queue, aiNode *node)
+static void pushInQueue(std::pmr::vector<aiNode const *> &queue, aiNode const *node)
 {
     if (node->mNumMeshes > 0)
     {
@@ -274,21 +276,44 @@ static void pushInQueue(std::pmr::vector<aiNode *> &queue, aiNode *node)
     }
 }
 
-void HandleTable_s::loadFromObj(Char8_t const *path)
-{ //
-    Assimp::Importer importer;
-    aiScene const   *scene = importer.ReadFile(
-      path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_ForceGenNormals);
-    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+/** @class HandleTable_s::ObjLoader_s
+ * @brief an obj file loaded a step at a time: the first call parses it, each of the following loads a mesh
+ */
+class HandleTable_s::ObjLoader_s
+{
+  public:
+    ObjLoader_s(HandleTable_s &table, Char8_t const *path)
+      : m_importer(std::make_unique<Assimp::Importer>()), m_table(&table), m_path(path)
     {
-        printf("[HandleTable] couldn't load scene at %s\n", path);
-        return;
     }
 
-    static std::pmr::vector<aiNode *> queue{ getMemoryPool() };
-    queue.clear();
-    queue.reserve(64);
-    pushInQueue(queue, scene->mRootNode);
+    WorkProgress_t operator()()
+    {
+        if (!m_scene)
+        {
+            if (!parse())
+            { // nothing else to do
+                m_table->m_objFiles[CGE_SID(m_path)] = nullWorkHandle;
+                return { .done = 1, .total = 1 };
+            }
+        }
+        else if (m_next != m_nodes.size())
+        {
+            loadMesh(m_nodes[m_next++]);
+        }
+
+        if (m_next == m_nodes.size())
+        {
+            m_table->m_objFiles[CGE_SID(m_path)] = nullWorkHandle;
+        }
+        return { .done = 1 + m_next, .total = 1 + static_cast<U32_t>(m_nodes.size()) };
+    }
+
+  private:
+    B8_t parse();
+    void loadMesh(aiNode const *node);
+
+  private:
     // search for material colors, to use as fallback as color vertex when there is no texture and
     // no vertex color
     struct MaterialProperties
@@ -296,105 +321,160 @@ void HandleTable_s::loadFromObj(Char8_t const *path)
         glm::vec3 diffuse = glm::vec3{ 0.4f, 0.4f, 0.4f };
     };
     static U32_t constexpr maxNumMaterialProperties = 16;
-    MaterialProperties materialProperties[maxNumMaterialProperties]{};
 
-    for (U32_t i = 0; i != scene->mNumMaterials; ++i)
+    std::unique_ptr<Assimp::Importer> m_importer; ///< owns the scene
+    aiScene const                    *m_scene = nullptr;
+    HandleTable_s                    *m_table;
+    Char8_t const                    *m_path;
+    std::pmr::vector<aiNode const *>  m_nodes{ getMemoryPool(EMemoryTag_t::eHandleTable) };
+    U32_t                             m_next = 0;
+    MaterialProperties                m_materialProperties[maxNumMaterialProperties]{};
+};
+
+B8_t HandleTable_s::ObjLoader_s::parse()
+{
+    m_scene = m_importer->ReadFile(
+      m_path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_ForceGenNormals);
+    if (!m_scene || m_scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !m_scene->mRootNode)
     {
-        aiColor3D diffuse;
-        assert(scene->mMaterials[i]->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse) != AI_FAILURE && "WHAT");
-        materialProperties[i].diffuse.x = diffuse.r;
-        materialProperties[i].diffuse.y = diffuse.g;
-        materialProperties[i].diffuse.z = diffuse.b;
+        CGE_LOG_ERROR(Resource, "[HandleTable] couldn't load scene at %s", m_path);
+        return false;
     }
 
-    for (auto const *node : queue)
+    m_nodes.reserve(64);
+    pushInQueue(m_nodes, m_scene->mRootNode);
+    for (U32_t i = 0; i != m_scene->mNumMaterials; ++i)
     {
-        Sid_t sid = CGE_SID(node->mName.C_Str());
-        assert(node->mNumMeshes <= 1 && "[HandleTable] blender meshes should have 1 node");
-
-        // if the mesh is not allocated
-        if (!get(sid).hasValue() && node->mNumMeshes > 0)
-        { // then allocate the mesh and insert all the relevant attributes
-            Mesh_s       &mesh  = insertMesh(sid);
-            aiMesh const *aMesh = scene->mMeshes[node->mMeshes[0]];
-            assert(aMesh->HasPositions() && aMesh->HasNormals() && aMesh->HasFaces() && aMesh->HasTextureCoords(0));
-
-            aiVector3D const       *vertices  = aMesh->mVertices;
-            aiFace const           *indices   = aMesh->mFaces;
-            aiVector3D const       *normals   = aMesh->mNormals;
-            aiVector3D const       *texCoords = aMesh->mTextureCoords[0];
-            aiColor4D const *const *colors    = aMesh->mColors;
-
-            mesh.vertices.reserve(aMesh->mNumVertices);
-            for (U32_t i = 0; i != aMesh->mNumVertices; ++i)
-            {
-                Vertex_t vertex;
-                vertex.pos[0] = vertices[i].x;
-                vertex.pos[1] = vertices[i].y;
-                vertex.pos[2] = vertices[i].z;
-
-                vertex.norm[0] = normals[i].x;
-                vertex.norm[1] = normals[i].y;
-                vertex.norm[2] = normals[i].z;
-
-                vertex.texCoords[0] = texCoords[i].x;
-                vertex.texCoords[1] = texCoords[i].y;
-                vertex.texCoords[2] = texCoords[i].z;
-
-                vertex.color[0] =
-                  aMesh->HasVertexColors(0) ? colors[0][i].r : materialProperties[aMesh->mMaterialIndex].diffuse.r;
-                vertex.color[1] =
-                  aMesh->HasVertexColors(0) ? colors[0][i].g : materialProperties[aMesh->mMaterialIndex].diffuse.g;
-                vertex.color[2] =
-                  aMesh->HasVertexColors(0) ? colors[0][i].b : materialProperties[aMesh->mMaterialIndex].diffuse.b;
-                vertex.color[3] = aMesh->HasVertexColors(0) ? colors[0][i].a : 1.f;
-
-                if (aMesh->mMaterialIndex < (U32_t)-1)
-                {
-                    ai_real shininess;
-                    assert(
-                      scene->mMaterials[aMesh->mMaterialIndex]->Get(AI_MATKEY_SHININESS, shininess) != AI_FAILURE
-                      && "WHAT");
-                    vertex.shininess = shininess;
-                }
-                else
-                { //
-                    vertex.shininess = 1.f;
-                }
-
-                mesh.vertices.push_back(vertex);
-            }
+        aiColor3D diffuse;
+        assert(m_scene->mMaterials[i]->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse) != AI_FAILURE && "WHAT");
+        m_materialProperties[i].diffuse.x = diffuse.r;
+        m_materialProperties[i].diffuse.y = diffuse.g;
+        m_materialProperties[i].diffuse.z = diffuse.b;
+    }
+    return true;
+}
 
-            mesh.indices.reserve(aMesh->mNumFaces * 3);
-            for (U32_t i = 0; i != aMesh->mNumFaces; ++i)
-            {
-                assert(indices[i].mNumIndices == 3);
-                Array<U32_t, 3> arr = { indices[i].mIndices[0], indices[i].mIndices[1], indices[i].mIndices[2] };
-                mesh.indices.push_back(arr);
-            }
+void HandleTable_s::ObjLoader_s::loadMesh(aiNode const *node)
+{
+    Sid_t sid = CGE_SID(node->mName.C_Str());
+    assert(node->mNumMeshes <= 1 && "[HandleTable] blender meshes should have 1 node");
+
+    // if the mesh is not allocated
+    if (!m_table->get(sid).hasValue() && node->mNumMeshes > 0)
+    { // then allocate the mesh and insert all the relevant attributes
+        Mesh_s       &mesh  = m_table->insertMesh(sid);
+        aiMesh const *aMesh = m_scene->mMeshes[node->mMeshes[0]];
+        assert(aMesh->HasPositions() && aMesh->HasNormals() && aMesh->HasFaces() && aMesh->HasTextureCoords(0));
+
+        aiVector3D const         *vertices           = aMesh->mVertices;
+        aiFace const             *indices            = aMesh->mFaces;
+        aiVector3D const         *normals            = aMesh->mNormals;
+        aiVector3D const         *texCoords          = aMesh->mTextureCoords[0];
+        aiColor4D const *const   *colors             = aMesh->mColors;
+        MaterialProperties const *materialProperties = m_materialProperties;
+
+        mesh.vertices.reserve(aMesh->mNumVertices);
+        for (U32_t i = 0; i != aMesh->mNumVertices; ++i)
+        {
+            Vertex_t vertex;
+            vertex.pos[0] = vertices[i].x;
+            vertex.pos[1] = vertices[i].y;
+            vertex.pos[2] = vertices[i].z;
+
+            vertex.norm[0] = normals[i].x;
+            vertex.norm[1] = normals[i].y;
+            vertex.norm[2] = normals[i].z;
+
+            vertex.texCoords[0] = texCoords[i].x;
+            vertex.texCoords[1] = texCoords[i].y;
+            vertex.texCoords[2] = texCoords[i].z;
+
+            vertex.color[0] =
+              aMesh->HasVertexColors(0) ? colors[0][i].r : materialProperties[aMesh->mMaterialIndex].diffuse.r;
+            vertex.color[1] =
+              aMesh->HasVertexColors(0) ? colors[0][i].g : materialProperties[aMesh->mMaterialIndex].diffuse.g;
+            vertex.color[2] =
+              aMesh->HasVertexColors(0) ? colors[0][i].b : materialProperties[aMesh->mMaterialIndex].diffuse.b;
+            vertex.color[3] = aMesh->HasVertexColors(0) ? colors[0][i].a : 1.f;
 
             if (aMesh->mMaterialIndex < (U32_t)-1)
             {
-                aiMaterial const *material = scene->mMaterials[aMesh->mMaterialIndex];
-                loadTextures(path, material, mesh);
+                ai_real shininess;
+                assert(
+                  m_scene->mMaterials[aMesh->mMaterialIndex]->Get(AI_MATKEY_SHININESS, shininess) != AI_FAILURE
+                  && "WHAT");
+                vertex.shininess = shininess;
+            }
+            else
+            { //
+                vertex.shininess = 1.f;
             }
 
-            mesh.box = computeAABB(mesh);
+            mesh.vertices.push_back(vertex);
+        }
 
-            // finalize mesh loading
-            mesh.allocateTexturesToGpu();
+        mesh.indices.reserve(aMesh->mNumFaces * 3);
+        for (U32_t i = 0; i != aMesh->mNumFaces; ++i)
+        {
+            assert(indices[i].mNumIndices == 3);
+            Array<U32_t, 3> arr = { indices[i].mIndices[0], indices[i].mIndices[1], indices[i].mIndices[2] };
+            mesh.indices.push_back(arr);
+        }
 
-            static U32_t constexpr stagesCount = 2;
-            char const *sources[stagesCount]   = { vertexSource, fragSource };
-            U32_t       stages[stagesCount]    = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
-            mesh.shaderProgram.build(
-              { .sid = "DEFAULT_PROG"_sid, .pSources = sources, .pStages = stages, .sourcesCount = stagesCount });
-            mesh.setupUniforms();
-            mesh.allocateGeometryBuffersToGpu();
+        if (aMesh->mMaterialIndex < (U32_t)-1)
+        {
+            aiMaterial const *material = m_scene->mMaterials[aMesh->mMaterialIndex];
+            m_table->loadTextures(m_path, material, mesh);
         }
+
+        mesh.box = computeAABB(mesh);
+
+        // finalize mesh loading
+        mesh.allocateTexturesToGpu();
+
+        static U32_t constexpr stagesCount = 2;
+        char const *sources[stagesCount]   = { vertexSource, fragSource };
+        U32_t       stages[stagesCount]    = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+        mesh.shaderProgram.build(
+          { .sid = "DEFAULT_PROG"_sid, .pSources = sources, .pStages = stages, .sourcesCount = stagesCount });
+        mesh.setupUniforms();
+        mesh.allocateGeometryBuffersToGpu();
     }
 }
 
+void HandleTable_s::loadFromObj(Char8_t const *path)
+{
+    auto const [it, inserted] = m_objFiles.try_emplace(CGE_SID(path), nullWorkHandle);
+    if (!inserted && g_timeSliceScheduler.isPending(it->second))
+    {
+        g_timeSliceScheduler.finish(it->second);
+        return;
+    }
+    if (!inserted && it->second.generation == 0)
+    { // already loaded
+        return;
+    }
+
+    // a cancelled incremental load is done again, skipping the meshes it loaded
+    it->second = nullWorkHandle;
+    ObjLoader_s loader{ *this, path };
+    while (!loader().finished())
+    {
+    }
+}
+
+WorkHandle_t HandleTable_s::loadFromObjIncremental(Char8_t const *path, EWorkPriority_t priority)
+{
+    auto const [it, inserted] = m_objFiles.try_emplace(CGE_SID(path), nullWorkHandle);
+    if (!inserted && (it->second.generation == 0 || g_timeSliceScheduler.isPending(it->second)))
+    { // loaded or being loaded
+        return it->second;
+    }
+
+    it->second = g_timeSliceScheduler.submit(path, priority, ObjLoader_s{ *this, path });
+    return it->second;
+}
+
 static void setTextureTypePresentInMesh(Mesh_s &mesh, aiTextureType type)
 {
     switch (type)
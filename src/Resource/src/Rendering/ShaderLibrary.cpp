@@ -71,13 +71,8 @@ tl::optional<Shader_s *> cge::ShaderLibrary_s::open(const char *path)
         return tl::nullopt;
     }
 
-    auto [it, wasEmplaced] = m_shaderMap.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(pathSid),
-      std::forward_as_tuple(pathSid, glid, source));
-
-    if (wasEmplaced) { return &it->second; } // TODO insert check/warning
-    else { return &m_shaderMap.find(pathSid)->second; }
+    // TODO insert check/warning
+    return &m_shaderMap.try_emplace(pathSid, pathSid, glid, source).first->second;
 }
 
 ShaderLibrary_s g_shaderLibrary;
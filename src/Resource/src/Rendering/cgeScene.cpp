@@ -16,14 +16,31 @@ Sid_t SceneNode_s::getSid() const
     return m_sid;
 }
 
-glm::mat4 const &SceneNode_s::getTransform() const
+glm::mat4 SceneNode_s::getTransform() const
+{ //
+    return m_transform.toMat4();
+}
+
+Affine3x4_t const &SceneNode_s::getAffineTransform() const
 { //
     return m_transform;
 }
 
-glm::vec4 const &SceneNode_s::getPosition() const
+glm::vec4 SceneNode_s::getPosition() const
 { //
-    return m_transform[3];
+    return glm::vec4(m_transform.translation(), 1.f);
+}
+
+Affine3x4_t SceneNode_s::getInterpolatedTransform(F32_t alpha) const
+{
+    if (!m_interpolated)
+    {
+        return m_transform;
+    }
+
+    // a blend of the matrices rather than of the decomposed transforms, as steps are small enough that the
+    // shrinking of the rotated axes can't be seen
+    return lerp(m_previousTransform, m_transform, alpha);
 }
 
 void SceneNode_s::setSid(Sid_t sid)
@@ -32,28 +49,50 @@ void SceneNode_s::setSid(Sid_t sid)
 }
 
 void SceneNode_s::transform(glm::mat4 const &t)
-{
-    m_transform = t * m_transform;
+{ //
+    transform(Affine3x4_t::fromMat4(t));
 }
 
-void SceneNode_s::rightMul(glm::mat4 const &t) {
-    m_transform *= t;
+void SceneNode_s::transform(Affine3x4_t const &t)
+{ //
+    m_transform = compose(t, m_transform);
 }
 
-void SceneNode_s::setTransform(const glm::mat4 &t)
-{
+void SceneNode_s::rightMul(glm::mat4 const &t)
+{ //
+    rightMul(Affine3x4_t::fromMat4(t));
+}
+
+void SceneNode_s::rightMul(Affine3x4_t const &t)
+{ //
+    m_transform = compose(m_transform, t);
+}
+
+void SceneNode_s::setTransform(glm::mat4 const &t)
+{ //
+    m_transform = Affine3x4_t::fromMat4(t);
+}
+
+void SceneNode_s::setTransform(Affine3x4_t const &t)
+{ //
     m_transform = t;
 }
-void SceneNode_s::translate(const glm::vec3 &disp)
+
+void SceneNode_s::translate(glm::vec3 const &disp)
 {
-    m_transform[3].x += disp.x;
-    m_transform[3].y += disp.y;
-    m_transform[3].z += disp.z;
+    m_transform.rows[0].w += disp.x;
+    m_transform.rows[1].w += disp.y;
+    m_transform.rows[2].w += disp.z;
 }
 
 void SceneNode_s::rotate(F32_t radians, glm::vec3 const &rotationAxis)
-{
-    m_transform = glm::rotate(m_transform, radians, rotationAxis);
+{ //
+    rightMul(TRS_t{ .rotation = glm::angleAxis(radians, glm::normalize(rotationAxis)) }.toAffine());
+}
+
+void SceneNode_s::resetInterpolation()
+{ //
+    m_interpolated = false;
 }
 
 SceneNode_s &Scene_s::getNodeBySid(Sid_t sid)
@@ -71,7 +110,7 @@ Scene_s::PairNode const &Scene_s::getNodePairByNodeRef(SceneNode_s const &ref) c
     auto const it = std::ranges::find_if(
       m_nodeMap,
       [ref](std::pair<Sid_t const, SceneNode_s> const &p) -> B8_t
-      { return p.second.getSid() == ref.getSid() && p.second.getTransform() == ref.getTransform(); });
+      { return p.second.getSid() == ref.getSid() && p.second.m_transform == ref.m_transform; });
     if (it == m_nodeMap.cend()) { assert(false && "[Scene] searching for inexistent nodes is illegal"); }
 
     return *it;
@@ -82,7 +121,7 @@ Scene_s::PairNode &Scene_s::getNodePairByNodeRef(SceneNode_s const &ref)
     auto const it = std::ranges::find_if(
       m_nodeMap,
       [ref](std::pair<Sid_t const, SceneNode_s> const &p) -> B8_t
-      { return p.second.getSid() == ref.getSid() && p.second.getTransform() == ref.getTransform(); });
+      { return p.second.getSid() == ref.getSid() && p.second.m_transform == ref.m_transform; });
     if (it == m_nodeMap.cend()) { assert(false && "[Scene] searching for inexistent nodes is illegal"); }
 
     return *it;
@@ -110,6 +149,16 @@ void Scene_s::clearSceneNodes()
 { //
     m_nodeMap.clear();
 }
+
+void Scene_s::storePreviousTransforms()
+{
+    for (auto &[sid, node] : m_nodeMap)
+    {
+        node.m_previousTransform = node.m_transform;
+        node.m_interpolated      = true;
+    }
+}
+
 Scene_s::LightConstIt Scene_s::lightBegin() const
 { //
     return m_lightMap.cbegin();
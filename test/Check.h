@@ -0,0 +1,41 @@
+#pragma once
+
+/**
+ * @file test/Check.h
+ * minimal checking macros for the test executables. A failed check is reported and counted, and the test keeps
+ * going, so that a single run shows every mismatch. `main` returns @ref checkResult, which CTest reads
+ */
+
+#include "Core/Type.h"
+
+#include <cstdio>
+
+namespace cge::test
+{
+
+inline U32_t g_failedChecks = 0;
+
+inline I32_t checkResult(Char8_t const *testName)
+{
+    if (g_failedChecks != 0)
+    {
+        printf("[%s] %u checks failed\n", testName, g_failedChecks);
+        return 1;
+    }
+    printf("[%s] passed\n", testName);
+    return 0;
+}
+
+} // namespace cge::test
+
+#define CGE_CHECK(expr)                                                                                                \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(expr)) [[unlikely]]                                                                                      \
+        {                                                                                                              \
+            if (cge::test::g_failedChecks++ < 32)                                                                      \
+            {                                                                                                          \
+                printf("[Check] %s:%d: %s\n", __FILE__, __LINE__, #expr);                                              \
+            }                                                                                                          \
+        }                                                                                                              \
+    } while (0)
@@ -0,0 +1,100 @@
+#include "Check.h"
+
+#include "Core/Random.h"
+#include "Core/Transform.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace cge;
+
+static F32_t uniform(Xoshiro256_t &rng, F32_t lo, F32_t hi)
+{ //
+    return lo + (hi - lo) * toUnitFloat(rng());
+}
+
+/// random coefficients, one in 8 of them zero or negative zero, as in axis aligned or unscaled transforms
+static Affine3x4_t randomAffine(Xoshiro256_t &rng)
+{
+    Affine3x4_t result;
+    for (glm::vec4 &row : result.rows)
+    {
+        for (I32_t j = 0; j != 4; ++j)
+        {
+            U64_t const r = rng() % 16;
+            row[j]        = r == 0 ? 0.f : r == 1 ? -0.f : uniform(rng, -4.f, 4.f);
+        }
+    }
+    return result;
+}
+
+static B8_t sameBits(Affine3x4_t const &a, Affine3x4_t const &b)
+{ //
+    return std::memcmp(&a, &b, sizeof(Affine3x4_t)) == 0;
+}
+
+I32_t main()
+{
+    Xoshiro256_t rng;
+    rng.seed(21);
+
+    U32_t variants = 0;
+    for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+    {
+        variants += g_composeAffinesKernel.variant(static_cast<EIsa_t>(isa)) != nullptr;
+    }
+    CGE_CHECK(variants >= 2);
+
+    for (U32_t count : { 0U, 1U, 2U, 3U, 7U, 64U, 10'000U })
+    {
+        for (U32_t round = 0; round != 8; ++round)
+        {
+            Affine3x4_t const        parent = round == 0 ? Affine3x4_t::identity() : randomAffine(rng);
+            std::vector<Affine3x4_t> locals(count);
+            for (Affine3x4_t &local : locals)
+            { //
+                local = randomAffine(rng);
+            }
+
+            std::vector<Affine3x4_t> expected(count);
+            composeAffinesScalar(parent, locals, expected);
+            for (U32_t i = 0; i != count; ++i)
+            {
+                CGE_CHECK(sameBits(expected[i], compose(parent, locals[i])));
+
+                // the reference itself, against the product of the full matrices
+                glm::mat4 const product = parent.toMat4() * locals[i].toMat4();
+                glm::mat4 const result  = expected[i].toMat4();
+                for (I32_t c = 0; c != 4; ++c)
+                {
+                    for (I32_t r = 0; r != 4; ++r)
+                    { //
+                        CGE_CHECK(std::abs(product[c][r] - result[c][r]) <= 1e-5f * (1.f + std::abs(product[c][r])));
+                    }
+                }
+            }
+
+            for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+            {
+                ComposeAffinesFunc_t const func = g_composeAffinesKernel.variant(static_cast<EIsa_t>(isa));
+                if (!func)
+                {
+                    continue;
+                }
+                // the output is filled with garbage first, so that lanes left unwritten show up
+                std::vector<Affine3x4_t> out(count);
+                std::memset(out.data(), 0xa5, count * sizeof(Affine3x4_t));
+                func(parent, locals, out);
+                for (U32_t i = 0; i != count; ++i)
+                { //
+                    CGE_CHECK(sameBits(out[i], expected[i]));
+                }
+            }
+        }
+    }
+
+    printf("[ComposeAffinesTest] %u variants\n", variants);
+    return test::checkResult("ComposeAffinesTest");
+}
@@ -0,0 +1,484 @@
+#include "Check.h"
+
+#include "Core/Event.h"
+#include "Core/Random.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace cge;
+
+struct Record_t
+{
+    std::vector<U32_t> calls; ///< listener id and event payload, interleaved
+};
+
+static Record_t s_record;
+
+static EventArg_t listenerData(U32_t id)
+{
+    EventArg_t data{};
+    data.idata.u32[0] = id;
+    return data;
+}
+
+static EventArg_t eventData(U32_t value)
+{
+    EventArg_t data{};
+    data.idata.u32[0] = value;
+    return data;
+}
+
+static void recordListener(EventArg_t event, EventArg_t listener)
+{
+    s_record.calls.push_back(listener.idata.u32[0]);
+    s_record.calls.push_back(event.idata.u32[0]);
+}
+
+static void testDispatchOrder()
+{
+    EventQueue_t queue;
+    queue.init();
+    Event_t const ev{ CGE_SID("DispatchOrder") };
+    queue.addListener(ev, recordListener, listenerData(1));
+    queue.addListener(ev, recordListener, listenerData(2));
+
+    s_record.calls.clear();
+    queue.emit(ev, eventData(10));
+    queue.emit(ev, eventData(11));
+    queue.dispatch();
+    CGE_CHECK((s_record.calls == std::vector<U32_t>{ 1, 10, 2, 10, 1, 11, 2, 11 }));
+}
+
+// the former removal matched listeners by the hash of their data, and couldn't tell these apart
+static void testSameDataListeners()
+{
+    EventQueue_t queue;
+    queue.init();
+    Event_t const          ev{ CGE_SID("SameData") };
+    ListenerHandle_t const first = queue.addListener(ev, recordListener, listenerData(7));
+    queue.addListener(ev, recordListener, listenerData(7));
+    queue.removeListener(first);
+
+    s_record.calls.clear();
+    queue.emit(ev, eventData(1));
+    queue.dispatch();
+    CGE_CHECK((s_record.calls == std::vector<U32_t>{ 7, 1 }));
+}
+
+static void testStaleHandles()
+{
+    EventQueue_t queue;
+    queue.init();
+    Event_t const          ev{ CGE_SID("Stale") };
+    ListenerHandle_t const removed = queue.addListener(ev, recordListener, listenerData(1));
+    queue.removeListener(removed);
+    // reuses the slot of the removed listener, with a newer generation
+    ListenerHandle_t const reused = queue.addListener(ev, recordListener, listenerData(2));
+    CGE_CHECK(reused.slot == removed.slot && reused.generation != removed.generation);
+    queue.removeListener(removed);
+    queue.removeListener(nullListenerHandle);
+
+    s_record.calls.clear();
+    queue.emit(ev, eventData(3));
+    queue.dispatch();
+    CGE_CHECK((s_record.calls == std::vector<U32_t>{ 2, 3 }));
+}
+
+static EventQueue_t    *s_queue = nullptr;
+static ListenerHandle_t s_victim{};
+static ListenerHandle_t s_self{};
+static Event_t          s_lateEvent{};
+
+static void removingListener(EventArg_t event, EventArg_t listener)
+{
+    recordListener(event, listener);
+    s_queue->removeListener(s_victim);
+    s_queue->removeListener(s_self);
+    s_queue->addListener(s_lateEvent, recordListener, listenerData(9));
+}
+
+static void testChangesDuringDispatch()
+{
+    EventQueue_t queue;
+    queue.init();
+    Event_t const ev{ CGE_SID("DuringDispatch") };
+    s_queue     = &queue;
+    s_lateEvent = ev;
+    s_self      = queue.addListener(ev, removingListener, listenerData(1));
+    s_victim    = queue.addListener(ev, recordListener, listenerData(2));
+
+    // the removed listeners are not invoked anymore, the added one only from the next event on
+    s_record.calls.clear();
+    queue.emit(ev, eventData(5));
+    queue.dispatch();
+    CGE_CHECK((s_record.calls == std::vector<U32_t>{ 1, 5 }));
+
+    s_record.calls.clear();
+    queue.emit(ev, eventData(6));
+    queue.dispatch();
+    CGE_CHECK((s_record.calls == std::vector<U32_t>{ 9, 6 }));
+}
+
+static void chainingListener(EventArg_t event, EventArg_t listener)
+{
+    recordListener(event, listener);
+    if (event.idata.u32[0] < 3)
+    {
+        s_queue->emit(s_lateEvent, eventData(event.idata.u32[0] + 1));
+    }
+}
+
+static void testEmitDuringDispatch()
+{
+    EventQueue_t queue;
+    queue.init();
+    Event_t const ev{ CGE_SID("Chain") };
+    s_queue     = &queue;
+    s_lateEvent = ev;
+    queue.addListener(ev, chainingListener, listenerData(1));
+
+    s_record.calls.clear();
+    queue.emit(ev, eventData(0));
+    queue.dispatch();
+    CGE_CHECK((s_record.calls == std::vector<U32_t>{ 1, 0, 1, 1, 1, 2, 1, 3 }));
+}
+
+static void testQueueGrowth()
+{
+    EventQueue_t queue;
+    queue.init();
+    Event_t const ev{ CGE_SID("Growth") };
+    queue.addListener(ev, recordListener, listenerData(0));
+
+    U32_t constexpr eventCount = 10'000;
+    s_record.calls.clear();
+    for (U32_t i = 0; i != eventCount; ++i)
+    {
+        queue.emit(ev, eventData(i));
+    }
+    queue.dispatch();
+    CGE_CHECK(s_record.calls.size() == 2 * eventCount);
+    for (U32_t i = 0; i != eventCount && i * 2 + 1 < s_record.calls.size(); ++i)
+    {
+        CGE_CHECK(s_record.calls[i * 2 + 1] == i);
+    }
+}
+
+static U32_t constexpr producerCount     = 4;
+static U32_t constexpr eventsPerProducer = 50'000;
+
+/// last sequence number delivered per producer, the dispatching thread being the last one
+struct Delivery_t
+{
+    U32_t next[producerCount + 1];
+    U32_t delivered[producerCount + 1];
+    U32_t outOfOrder;
+};
+
+static Delivery_t s_delivery{};
+
+// payload: producer index and sequence number, which must grow for each producer
+static void orderListener(EventArg_t event, EventArg_t /*listener*/)
+{
+    U32_t const producer = event.idata.u32[0];
+    U32_t const sequence = event.idata.u32[1];
+    s_delivery.outOfOrder += sequence < s_delivery.next[producer];
+    s_delivery.next[producer] = sequence + 1;
+    ++s_delivery.delivered[producer];
+}
+
+static EventArg_t sequencedData(U32_t producer, U32_t sequence)
+{
+    EventArg_t data{};
+    data.idata.u32[0] = producer;
+    data.idata.u32[1] = sequence;
+    return data;
+}
+
+/** producers emit through their staging buffers while the dispatching thread emits to its queue and dispatches.
+ *  The merge must keep the emission order of each thread, and every event must be either delivered or counted
+ *  as dropped. Meant to also run with cge_ENABLE_SANITIZER_THREAD
+ */
+static void testConcurrentProducers()
+{
+    EventQueue_t queue;
+    queue.init();
+    Event_t const ev{ CGE_SID("Staged") };
+    queue.addListener(ev, orderListener, listenerData(0));
+    s_delivery = {};
+
+    std::atomic<U32_t>       running{ producerCount };
+    std::atomic<U32_t>       rejected{ 0 };
+    std::vector<std::thread> producers;
+    for (U32_t p = 0; p != producerCount; ++p)
+    {
+        producers.emplace_back([&, p]() {
+            for (U32_t i = 0; i != eventsPerProducer; ++i)
+            {
+                if (queue.emit(ev, sequencedData(p, i)) != EErr_t::eSuccess)
+                { // backs off, so that most events make it and the merge interleaves the producers
+                    rejected.fetch_add(1, std::memory_order_relaxed);
+                    std::this_thread::yield();
+                }
+            }
+            running.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    U32_t emitted = 0;
+    U32_t dropped = 0;
+    while (running.load(std::memory_order_acquire) != 0)
+    {
+        queue.emit(ev, sequencedData(producerCount, emitted++));
+        queue.dispatch();
+        dropped += queue.droppedEvents();
+    }
+    for (std::thread &producer : producers)
+    {
+        producer.join();
+    }
+    // the last dispatch merges what is left, and accounts the drops since the previous one
+    queue.dispatch();
+    dropped += queue.droppedEvents();
+
+    U32_t delivered = 0;
+    for (U32_t p = 0; p != producerCount; ++p)
+    {
+        delivered += s_delivery.delivered[p];
+    }
+    CGE_CHECK(s_delivery.outOfOrder == 0);
+    CGE_CHECK(s_delivery.delivered[producerCount] == emitted);
+    CGE_CHECK(dropped == rejected.load());
+    CGE_CHECK(delivered + dropped == producerCount * eventsPerProducer);
+}
+
+// a full staging buffer drops the newest events, the staged ones are delivered in order
+static void testStagingOverflow()
+{
+    EventQueue_t queue;
+    queue.init();
+    Event_t const ev{ CGE_SID("Overflow") };
+    queue.addListener(ev, orderListener, listenerData(0));
+    s_delivery = {};
+
+    U32_t constexpr extra    = 100;
+    U32_t           rejected = 0;
+    std::thread     producer([&]() {
+        for (U32_t i = 0; i != eventStagingCapacity + extra; ++i)
+        {
+            rejected += queue.emit(ev, sequencedData(0, i)) != EErr_t::eSuccess;
+        }
+    });
+    producer.join();
+    queue.dispatch();
+    CGE_CHECK(rejected == extra && queue.droppedEvents() == extra);
+    CGE_CHECK(s_delivery.delivered[0] == eventStagingCapacity && s_delivery.next[0] == eventStagingCapacity);
+    CGE_CHECK(s_delivery.outOfOrder == 0);
+
+    // the buffer of the exited thread is adopted by the next one, and was emptied by the merge
+    std::thread next([&]() { queue.emit(ev, sequencedData(1, 0)); });
+    next.join();
+    queue.dispatch();
+    CGE_CHECK(queue.droppedEvents() == 0 && s_delivery.delivered[1] == 1);
+}
+
+/// ticks at which each timer fired, indexed by the id in the payload
+struct Firings_t
+{
+    std::vector<std::vector<U64_t>> ticks;
+};
+
+/// dispatches the events of the timers fired by the last advance, which all expired on the current tick
+static void collectFirings(EventQueue_t &queue, Firings_t &firings)
+{
+    s_record.calls.clear();
+    queue.dispatch();
+    for (U32_t i = 1; i < s_record.calls.size(); i += 2)
+    {
+        firings.ticks[s_record.calls[i]].push_back(queue.currentTime());
+    }
+}
+
+/** one shot timers due just before, on and just after the range of each level, scheduled from an aligned and an
+ *  unaligned time. The clock jumps to the tick before each deadline and then steps once, so a timer which fires
+ *  on any other tick, or twice, is caught
+ */
+static void testTimerBoundaries()
+{
+    U64_t constexpr levelRanges[]{ 256, 65'536, 1ULL << 24 };
+    for (U64_t const start : { 0ULL, 77ULL })
+    {
+        EventQueue_t queue;
+        queue.init();
+        Event_t const ev{ CGE_SID("TimerBoundary") };
+        queue.addListener(ev, recordListener, listenerData(0));
+        queue.advanceTime(start);
+
+        std::vector<U64_t> deadlines;
+        for (U64_t const range : levelRanges)
+        {
+            for (U64_t const delay : { range - 1, range, range + 1 })
+            {
+                queue.emitAfter(ev, eventData(static_cast<U32_t>(deadlines.size())), delay);
+                deadlines.push_back(start + delay);
+            }
+        }
+
+        Firings_t firings{ .ticks = std::vector<std::vector<U64_t>>(deadlines.size()) };
+        std::vector<U64_t> stops = deadlines;
+        std::sort(stops.begin(), stops.end());
+        for (U64_t const stop : stops)
+        {
+            queue.advanceTime(stop - 1 - queue.currentTime());
+            collectFirings(queue, firings);
+            queue.advanceTime(1);
+            collectFirings(queue, firings);
+        }
+        queue.advanceTime(1ULL << 16);
+        collectFirings(queue, firings);
+
+        for (U32_t id = 0; id != deadlines.size(); ++id)
+        {
+            CGE_CHECK(firings.ticks[id].size() == 1 && firings.ticks[id][0] == deadlines[id]);
+        }
+    }
+}
+
+/** many timers over the whole range of the 3 lower levels, expired by a single advance: each fires once, and as
+ *  the events are emitted tick after tick, they are dispatched in deadline order
+ */
+static void testTimerLargeJump()
+{
+    EventQueue_t queue;
+    queue.init();
+    Event_t const ev{ CGE_SID("TimerJump") };
+    queue.addListener(ev, recordListener, listenerData(0));
+
+    U32_t constexpr timerCount = 4'096;
+    Xoshiro256_t    rng;
+    rng.seed(3);
+    std::vector<U64_t> deadlines(timerCount);
+    queue.advanceTime(12'345);
+    for (U32_t id = 0; id != timerCount; ++id)
+    {
+        U64_t const delay = 1 + rng() % (1ULL << 25);
+        deadlines[id]     = queue.currentTime() + delay;
+        queue.emitAfter(ev, eventData(id), delay);
+    }
+
+    // a periodic timer keeps firing across the cascades
+    U64_t constexpr period   = 70'001;
+    U64_t constexpr jump     = (1ULL << 25) + 1;
+    U64_t const     periodic = timerCount;
+    queue.emitEvery(ev, eventData(periodic), period);
+
+    s_record.calls.clear();
+    queue.advanceTime(jump);
+    queue.dispatch();
+
+    std::vector<U32_t> counts(timerCount + 1);
+    U32_t              outOfOrder = 0;
+    U64_t              last       = 0;
+    for (U32_t i = 1; i < s_record.calls.size(); i += 2)
+    {
+        U32_t const id = s_record.calls[i];
+        ++counts[id];
+        if (id != periodic)
+        {
+            outOfOrder += deadlines[id] < last;
+            last = deadlines[id];
+        }
+    }
+    CGE_CHECK(outOfOrder == 0);
+    CGE_CHECK(counts[periodic] == jump / period);
+    for (U32_t id = 0; id != timerCount; ++id)
+    {
+        CGE_CHECK(counts[id] == 1);
+    }
+}
+
+static std::vector<TimerHandle_t> s_cancelled;
+
+static void cancellingListener(EventArg_t event, EventArg_t listener)
+{
+    recordListener(event, listener);
+    for (TimerHandle_t const handle : s_cancelled)
+    {
+        s_queue->cancelTimer(handle);
+    }
+}
+
+/** timers cancelled right after a cascade moved them to a lower level, while other timers of the same buckets are
+ *  kept. The cancelling listener runs on the tick of the cascade, and a fired handle whose slot was reused must
+ *  not cancel the new timer
+ */
+static void testTimerCancelDuringCascade()
+{
+    EventQueue_t queue;
+    queue.init();
+    Event_t const trigger{ CGE_SID("TimerCascadeTrigger") };
+    Event_t const ev{ CGE_SID("TimerCascade") };
+    s_queue = &queue;
+    queue.addListener(trigger, cancellingListener, listenerData(1));
+    queue.addListener(ev, recordListener, listenerData(2));
+
+    U64_t constexpr boundary = 65'536;
+    queue.emitAfter(trigger, eventData(0), boundary);
+    // these sit in the same level 2 bucket until the boundary, then in level 0 and level 1 buckets
+    std::vector<U64_t> const delays{ boundary + 10, boundary + 10, boundary + 10, boundary + 10,
+                                     boundary + 10, boundary + 300, boundary + 300 };
+    std::vector<TimerHandle_t> handles;
+    for (U32_t id = 0; id != delays.size(); ++id)
+    {
+        handles.push_back(queue.emitAfter(ev, eventData(id), delays[id]));
+    }
+    // unlinking from the middle of a bucket, in an order which breaks the list if a link is left dangling
+    s_cancelled = { handles[1], handles[3], handles[2], handles[5] };
+
+    // a one shot timer which fired, whose slot is then reused: its handle is stale
+    TimerHandle_t const fired = queue.emitAfter(ev, eventData(100), 5);
+    queue.advanceTime(5);
+    queue.dispatch();
+    TimerHandle_t const reused = queue.emitAfter(ev, eventData(101), boundary + 20);
+    CGE_CHECK(reused.slot == fired.slot && reused.generation != fired.generation);
+    queue.cancelTimer(fired);
+
+    s_record.calls.clear();
+    queue.advanceTime(boundary - 5);
+    queue.dispatch();
+    CGE_CHECK((s_record.calls == std::vector<U32_t>{ 1, 0 }));
+
+    // cancelling twice, or after the timer fired, is ignored
+    queue.cancelTimer(handles[1]);
+    s_record.calls.clear();
+    queue.advanceTime(1'000);
+    queue.dispatch();
+    std::vector<U32_t> ids;
+    for (U32_t i = 1; i < s_record.calls.size(); i += 2)
+    {
+        ids.push_back(s_record.calls[i]);
+    }
+    std::sort(ids.begin(), ids.begin() + std::min<size_t>(ids.size(), 2)); // same tick, any order
+    CGE_CHECK((ids == std::vector<U32_t>{ 0, 4, 101, 6 }));
+    queue.cancelTimer(handles[0]);
+    s_cancelled.clear();
+}
+
+I32_t main()
+{
+    testDispatchOrder();
+    testSameDataListeners();
+    testStaleHandles();
+    testChangesDuringDispatch();
+    testEmitDuringDispatch();
+    testQueueGrowth();
+    testConcurrentProducers();
+    testStagingOverflow();
+    testTimerBoundaries();
+    testTimerLargeJump();
+    testTimerCancelDuringCascade();
+    return test::checkResult("EventTest");
+}
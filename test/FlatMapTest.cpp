@@ -0,0 +1,199 @@
+#include "Check.h"
+
+#include "Core/Containers.h"
+#include "Core/Random.h"
+
+#include <memory>
+#include <unordered_map>
+
+using namespace cge;
+
+/// owns heap memory and counts its live instances, so that leaks and double destructions show up
+struct Tracked_t
+{
+    static inline I32_t s_live = 0;
+
+    explicit Tracked_t(I32_t v) : value(std::make_unique<I32_t>(v))
+    { //
+        ++s_live;
+    }
+    Tracked_t(Tracked_t &&other) noexcept : value(std::move(other.value))
+    { //
+        ++s_live;
+    }
+    ~Tracked_t()
+    { //
+        --s_live;
+    }
+
+    std::unique_ptr<I32_t> value;
+};
+
+/// sends every key to one of 4 home slots, so that probe sequences are long and overlap
+struct CollidingHash_t
+{
+    U64_t operator()(U32_t key) const
+    { //
+        return (static_cast<U64_t>(key) * 0x9e37'79b9'7f4a'7c15ULL & 0xfe00'0000'0000'0000ULL) | (key & 3);
+    }
+};
+
+template<typename M> static void checkSameContent(M const &map, std::unordered_map<U32_t, I32_t> const &reference)
+{
+    CGE_CHECK(map.size() == reference.size());
+    U64_t count = 0;
+    for (auto const &[key, value] : map)
+    {
+        ++count;
+        auto const it = reference.find(key);
+        CGE_CHECK(it != reference.end() && it->second == *value.value);
+    }
+    CGE_CHECK(count == reference.size());
+}
+
+/** random sequence of insertions, lookups and erasures over a small key range, checked against
+ *  std::unordered_map. The range is small enough that erasures leave tombstones and insertions reuse them, and
+ *  the table both grows and rehashes in place to drop them
+ */
+template<typename M> static void differentialTest(U64_t seed, U32_t keyRange, U32_t operations)
+{
+    Xoshiro256_t rng;
+    rng.seed(seed);
+    std::unordered_map<U32_t, I32_t> reference;
+    {
+        M map;
+        for (U32_t i = 0; i != operations; ++i)
+        {
+            U32_t const key = static_cast<U32_t>(rng() % keyRange);
+            switch (rng() % 8)
+            {
+            case 0:
+            case 1:
+            case 2:
+            {
+                auto const [it, inserted]   = map.try_emplace(key, static_cast<I32_t>(i));
+                auto const [rit, rinserted] = reference.try_emplace(key, static_cast<I32_t>(i));
+                CGE_CHECK(inserted == rinserted && it->first == key && *it->second.value == rit->second);
+                break;
+            }
+            case 3:
+            case 4:
+                CGE_CHECK(map.erase(key) == reference.erase(key));
+                break;
+            case 5:
+            {
+                // erase through an iterator, then keep walking from the returned one
+                auto it = map.find(key);
+                if (it != map.end())
+                {
+                    reference.erase(key);
+                    it = map.erase(it);
+                    CGE_CHECK(it == map.end() || reference.contains(it->first));
+                }
+                break;
+            }
+            default:
+            {
+                auto const it  = map.find(key);
+                auto const rit = reference.find(key);
+                CGE_CHECK((it == map.end()) == (rit == reference.end()));
+                CGE_CHECK(it == map.end() || *it->second.value == rit->second);
+                CGE_CHECK(map.contains(key) == reference.contains(key));
+                break;
+            }
+            }
+
+            if (i % 20'000 == 0)
+            {
+                checkSameContent(map, reference);
+                erase_if(map, [&reference](auto const &entry) {
+                    B8_t const erase = entry.first % 7 == 0;
+                    if (erase)
+                    {
+                        reference.erase(entry.first);
+                    }
+                    return erase;
+                });
+                checkSameContent(map, reference);
+            }
+        }
+        checkSameContent(map, reference);
+
+        map.clear();
+        CGE_CHECK(map.empty() && map.begin() == map.end());
+        map.try_emplace(1U, 1);
+        CGE_CHECK(map.size() == 1 && *map.at(1U).value == 1);
+    }
+    CGE_CHECK(Tracked_t::s_live == 0);
+}
+
+// a steady number of live keys under churn must not grow the table: tombstones are dropped by rehashing in place
+static void tombstoneChurnTest()
+{
+    FlatMap<U32_t, I32_t> map;
+    U32_t constexpr liveKeys = 600;
+    for (U32_t key = 0; key != liveKeys; ++key)
+    {
+        map.try_emplace(key, 0);
+    }
+    U64_t const capacity = map.capacity();
+    for (U32_t key = liveKeys; key != liveKeys * 200; ++key)
+    {
+        map.erase(key - liveKeys);
+        map.try_emplace(key, 0);
+    }
+    CGE_CHECK(map.capacity() == capacity);
+    CGE_CHECK(map.size() == liveKeys);
+    for (U32_t key = liveKeys * 199; key != liveKeys * 200; ++key)
+    {
+        CGE_CHECK(map.contains(key));
+    }
+}
+
+static void reserveTest()
+{
+    FlatMap<Sid_t, U64_t> map;
+    map.reserve(1000);
+    U64_t const capacity = map.capacity();
+    for (U64_t i = 0; i != 1000; ++i)
+    {
+        map[makeSid(std::string_view(reinterpret_cast<Char8_t const *>(&i), sizeof(i)))] = i;
+    }
+    CGE_CHECK(map.capacity() == capacity && map.size() == 1000);
+}
+
+static void stableAddressTest()
+{
+    StableFlatMap<U32_t, I32_t> map;
+    I32_t *first = &map[0];
+    for (U32_t key = 1; key != 10'000; ++key)
+    {
+        map[key] = static_cast<I32_t>(key);
+    }
+    CGE_CHECK(first == &map[0]);
+
+    // iteration follows the slots, and an erased slot is reused by the next insertion
+    map.erase(5U);
+    map.try_emplace(20'000U, 0);
+    U32_t position = 0;
+    for (auto const &entry : map)
+    {
+        if (position++ == 5)
+        {
+            CGE_CHECK(entry.first == 20'000U);
+        }
+    }
+}
+
+I32_t main()
+{
+    differentialTest<FlatMap<U32_t, Tracked_t>>(1, 3'000, 400'000);
+    differentialTest<FlatMap<U32_t, Tracked_t>>(2, 64, 100'000);
+    differentialTest<FlatMap<U32_t, Tracked_t, CollidingHash_t>>(3, 2'000, 200'000);
+    differentialTest<StableFlatMap<U32_t, Tracked_t>>(4, 3'000, 400'000);
+    differentialTest<StableFlatMap<U32_t, Tracked_t, CollidingHash_t>>(5, 500, 100'000);
+    tombstoneChurnTest();
+    reserveTest();
+    stableAddressTest();
+    return test::checkResult("FlatMapTest");
+}
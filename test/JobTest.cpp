@@ -0,0 +1,154 @@
+#include "Check.h"
+
+#include "Core/Job.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace cge;
+
+// Meant to also run in a build with cge_ENABLE_SANITIZER_THREAD, where TSAN checks the publication of the jobs
+// through the deques and the release of their records
+
+static U32_t constexpr workerThreads = 3;
+static U32_t constexpr jobCount      = 3 * jobQueueCapacity; ///< more than the records of a worker, so they are reused
+static U32_t constexpr rounds        = 10;
+
+/// how many times each job ran
+struct Runs_t
+{
+    std::unique_ptr<std::atomic<U32_t>[]> counts;
+};
+
+static void runOnce(Runs_t *runs, U32_t index)
+{
+    runs->counts[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+static U32_t countMismatches(Runs_t const &runs, U32_t count)
+{
+    U32_t mismatches = 0;
+    for (U32_t i = 0; i != count; ++i)
+    {
+        mismatches += runs.counts[i].load(std::memory_order_relaxed) != 1;
+    }
+    return mismatches;
+}
+
+// every job submitted by the main thread runs exactly once, wherever it is executed
+static void submitFromMainTest()
+{
+    for (U32_t round = 0; round != rounds; ++round)
+    {
+        Runs_t runs{ .counts = std::make_unique<std::atomic<U32_t>[]>(jobCount) };
+        JobCounter_t counter;
+        U32_t        accepted = 0;
+        for (U32_t i = 0; i != jobCount; ++i)
+        {
+            accepted += g_jobSystem.submit([runs = &runs, i]() { runOnce(runs, i); }, &counter);
+        }
+        g_jobSystem.wait(counter);
+        CGE_CHECK(accepted == jobCount);
+        CGE_CHECK(counter.pending.load() == 0);
+        CGE_CHECK(countMismatches(runs, jobCount) == 0);
+    }
+}
+
+static U32_t constexpr parentCount   = 64;
+static U32_t constexpr childrenCount = 256;
+
+// jobs submitting jobs: the workers push to their own deques while being stolen from
+static void submitFromWorkersTest()
+{
+    Runs_t       runs{ .counts = std::make_unique<std::atomic<U32_t>[]>(parentCount * childrenCount) };
+    JobCounter_t counter;
+    for (U32_t parent = 0; parent != parentCount; ++parent)
+    {
+        g_jobSystem.submit(
+          [runs = &runs, parent, counter = &counter]() {
+              for (U32_t child = 0; child != childrenCount; ++child)
+              {
+                  U32_t const index = parent * childrenCount + child;
+                  g_jobSystem.submit([runs, index]() { runOnce(runs, index); }, counter);
+              }
+          },
+          &counter);
+    }
+    g_jobSystem.wait(counter);
+    CGE_CHECK(countMismatches(runs, parentCount * childrenCount) == 0);
+}
+
+// the main thread doesn't run the job while waiting for it, so a worker must steal it
+static void stealTest()
+{
+    std::atomic<U32_t> runner{ jobInvalidWorker };
+    JobCounter_t       counter;
+    g_jobSystem.submit(
+      [&runner]() { runner.store(JobSystem::currentWorker(), std::memory_order_release); }, &counter);
+
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (runner.load(std::memory_order_acquire) == jobInvalidWorker && std::chrono::steady_clock::now() < deadline)
+    { //
+        std::this_thread::yield();
+    }
+    g_jobSystem.wait(counter);
+    U32_t const worker = runner.load();
+    CGE_CHECK(worker != 0 && worker < g_jobSystem.workerCount());
+}
+
+static void parallelForTest()
+{
+    U32_t constexpr count = 1'000'000;
+    Runs_t runs{ .counts = std::make_unique<std::atomic<U32_t>[]>(count) };
+    g_jobSystem.parallelFor(0, count, 1'000, [&runs](U32_t begin, U32_t end) {
+        for (U32_t i = begin; i != end; ++i)
+        {
+            runs.counts[i].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    CGE_CHECK(countMismatches(runs, count) == 0);
+}
+
+// a thread which is not a worker has no deque: its submits are rejected, but it can wait by stealing
+static void foreignThreadTest()
+{
+    Runs_t       runs{ .counts = std::make_unique<std::atomic<U32_t>[]>(jobCount) };
+    JobCounter_t counter;
+    for (U32_t i = 0; i != jobCount; ++i)
+    {
+        g_jobSystem.submit([runs = &runs, i]() { runOnce(runs, i); }, &counter);
+    }
+
+    B8_t         accepted = true;
+    U32_t        worker   = 0;
+    JobCounter_t foreignCounter;
+    std::thread  foreign([&]() {
+        worker   = JobSystem::currentWorker();
+        accepted = g_jobSystem.submit([runs = &runs]() { runOnce(runs, 0); }, &foreignCounter);
+        g_jobSystem.wait(counter);
+    });
+    foreign.join();
+    g_jobSystem.wait(counter);
+
+    CGE_CHECK(worker == jobInvalidWorker);
+    CGE_CHECK(!accepted && foreignCounter.pending.load() == 0);
+    CGE_CHECK(counter.pending.load() == 0 && countMismatches(runs, jobCount) == 0);
+}
+
+I32_t main()
+{
+    // before init the main thread isn't a worker either
+    CGE_CHECK(!g_jobSystem.submit([]() {}));
+
+    g_jobSystem.init({ .workerCount = workerThreads });
+    CGE_CHECK(g_jobSystem.workerCount() == workerThreads + 1 && JobSystem::currentWorker() == 0);
+    submitFromMainTest();
+    submitFromWorkersTest();
+    stealTest();
+    parallelForTest();
+    foreignThreadTest();
+    g_jobSystem.shutdown();
+    return test::checkResult("JobTest");
+}
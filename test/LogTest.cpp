@@ -0,0 +1,123 @@
+#include "Check.h"
+
+#include "Core/Log.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace cge;
+
+/// lines of the file containing `marker`
+static U32_t countLines(std::FILE *file, Char8_t const *marker)
+{
+    U32_t   count = 0;
+    Char8_t line[1024];
+    std::rewind(file);
+    while (std::fgets(line, sizeof(line), file))
+    {
+        count += std::strstr(line, marker) != nullptr;
+    }
+    return count;
+}
+
+// A thread keeps the queue it got from the first logger it used, so only short lived threads log to the loggers
+// made here, each one outliving its threads
+
+/** threads keep logging while the logger shuts down: every record must be written exactly once, either by the
+ *  writer thread, by the final drain of shutdown or synchronously, unless it was dropped because its queue was full
+ */
+static void shutdownWhileLoggingTest(U32_t threadCount, U32_t recordsPerThread)
+{
+    std::FILE *file = std::tmpfile();
+    CGE_CHECK(file != nullptr);
+    if (!file)
+    {
+        return;
+    }
+
+    U64_t dropped = 0;
+    {
+        Logger_s logger;
+        logger.init(file);
+
+        std::atomic<U32_t>       started{ 0 };
+        std::vector<std::thread> threads;
+        for (U32_t t = 0; t != threadCount; ++t)
+        {
+            threads.emplace_back([&logger, &started, t, recordsPerThread]() {
+                started.fetch_add(1, std::memory_order_relaxed);
+                for (U32_t i = 0; i != recordsPerThread; ++i)
+                {
+                    logger.log(ELogLevel_t::eInfo, ELogCategory_t::eCore, "[LogTest] record %u %u", t, i);
+                }
+            });
+        }
+        while (started.load(std::memory_order_relaxed) != threadCount)
+        {
+            std::this_thread::yield();
+        }
+        logger.shutdown();
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        dropped = logger.dropped();
+    }
+
+    U32_t const written = countLines(file, "[LogTest] record");
+    CGE_CHECK(written + dropped == U64_t(threadCount) * recordsPerThread);
+    std::fclose(file);
+}
+
+/// records of a thread come out in order, with their level and string arguments
+static void orderTest()
+{
+    std::FILE *file = std::tmpfile();
+    CGE_CHECK(file != nullptr);
+    if (!file)
+    {
+        return;
+    }
+    {
+        Logger_s logger;
+        logger.init(file);
+        std::thread([&logger]() {
+            for (U32_t i = 0; i != 100; ++i)
+            {
+                logger.log(ELogLevel_t::eWarning, ELogCategory_t::eCore, "[LogTest] ordered %u %s", i, "text");
+            }
+        }).join();
+        logger.shutdown();
+        CGE_CHECK(logger.dropped() == 0);
+    }
+
+    Char8_t line[1024];
+    U32_t   expected = 0;
+    std::rewind(file);
+    while (std::fgets(line, sizeof(line), file))
+    {
+        U32_t index;
+        if (Char8_t const *found = std::strstr(line, "[LogTest] ordered"); found)
+        {
+            CGE_CHECK(std::sscanf(found, "[LogTest] ordered %u text", &index) == 1 && index == expected);
+            CGE_CHECK(std::strstr(line, " W ") != nullptr);
+            ++expected;
+        }
+    }
+    CGE_CHECK(expected == 100);
+    std::fclose(file);
+}
+
+I32_t main()
+{
+    hiResCalibration();
+    orderTest();
+    for (U32_t round = 0; round != 20; ++round)
+    {
+        shutdownWhileLoggingTest(4, 2'000);
+    }
+    return test::checkResult("LogTest");
+}
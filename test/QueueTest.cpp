@@ -0,0 +1,168 @@
+#include "Check.h"
+
+#include "Core/Queue.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cge;
+
+// Stress test of the ring queues, meant to also run in a build with cge_ENABLE_SANITIZER_THREAD, where TSAN checks
+// that every element is published by the release store and taken by the acquire load which pair up
+
+static U32_t constexpr producerShift = 40; ///< items are the producer index above this bit, a counter below
+
+/** `producers` threads push `perProducer` items each, `consumers` threads pop them all. Every consumer must see
+ *  the items of each producer in increasing order, and the items popped must be exactly the ones pushed
+ */
+template<typename Q> static void stress(Q &queue, U32_t producers, U32_t consumers, U64_t perProducer)
+{
+    std::atomic<U64_t>       popped{ 0 };
+    std::atomic<U64_t>       sum{ 0 };
+    std::atomic<U32_t>       orderViolations{ 0 };
+    std::vector<std::thread> threads;
+    U64_t const              total = perProducer * producers;
+    for (U32_t p = 0; p != producers; ++p)
+    {
+        threads.emplace_back([&queue, p, perProducer]() {
+            for (U64_t i = 0; i != perProducer; ++i)
+            {
+                while (!queue.tryPush((U64_t(p) << producerShift) | i))
+                { //
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (U32_t c = 0; c != consumers; ++c)
+    {
+        threads.emplace_back([&, producers]() {
+            std::vector<U64_t> next(producers, 0); // items of a producer below this one can't come anymore
+            U64_t              localSum = 0;
+            while (popped.load(std::memory_order_relaxed) != total)
+            {
+                U64_t item;
+                if (!queue.tryPop(item))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                U64_t const producer = item >> producerShift;
+                U64_t const index    = item & ((1ULL << producerShift) - 1);
+                if (producer >= producers || index < next[producer])
+                {
+                    orderViolations.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    next[producer] = index + 1;
+                }
+                localSum += item;
+                popped.fetch_add(1, std::memory_order_relaxed);
+            }
+            sum.fetch_add(localSum, std::memory_order_relaxed);
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    U64_t expected = 0;
+    for (U64_t p = 0; p != producers; ++p)
+    {
+        expected += (p << producerShift) * perProducer + perProducer * (perProducer - 1) / 2;
+    }
+    CGE_CHECK(orderViolations.load() == 0);
+    CGE_CHECK(popped.load() == total);
+    CGE_CHECK(sum.load() == expected);
+    U64_t leftover;
+    CGE_CHECK(!queue.tryPop(leftover));
+}
+
+/// owns heap memory and counts its live instances, so that leaks and double destructions show up
+struct Tracked_t
+{
+    static inline std::atomic<I32_t> s_live{ 0 };
+
+    Tracked_t() : text()
+    { //
+        s_live.fetch_add(1, std::memory_order_relaxed);
+    }
+    explicit Tracked_t(U32_t value) : text(64, static_cast<Char8_t>('a' + value % 26))
+    { //
+        s_live.fetch_add(1, std::memory_order_relaxed);
+    }
+    Tracked_t(Tracked_t &&other) noexcept : text(std::move(other.text))
+    { //
+        s_live.fetch_add(1, std::memory_order_relaxed);
+    }
+    Tracked_t &operator=(Tracked_t &&other) noexcept = default;
+    ~Tracked_t()
+    { //
+        s_live.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    std::string text;
+};
+
+/// full and empty queues, capacity rounding, and elements left in the queue destroyed with it
+template<typename Q> static void boundsTest(U32_t requested, U32_t expectedCapacity)
+{
+    {
+        Q queue(requested);
+        CGE_CHECK(queue.capacity() == expectedCapacity);
+        for (U32_t lap = 0; lap != 3; ++lap)
+        {
+            for (U32_t i = 0; i != expectedCapacity; ++i)
+            { //
+                CGE_CHECK(queue.tryEmplace(i));
+            }
+            CGE_CHECK(!queue.tryEmplace(0U));
+            CGE_CHECK(queue.sizeApprox() == expectedCapacity);
+            for (U32_t i = 0; i != expectedCapacity; ++i)
+            {
+                Tracked_t out;
+                CGE_CHECK(queue.tryPop(out) && out.text == std::string(64, static_cast<Char8_t>('a' + i % 26)));
+            }
+            Tracked_t out;
+            CGE_CHECK(!queue.tryPop(out));
+        }
+
+        for (U32_t i = 0; i != expectedCapacity - 1; ++i)
+        { //
+            queue.tryEmplace(i);
+        }
+    }
+    CGE_CHECK(Tracked_t::s_live.load() == 0);
+}
+
+I32_t main()
+{
+    boundsTest<SpscQueue<Tracked_t>>(5, 8);
+    boundsTest<SpscQueue<Tracked_t>>(1, 1);
+    boundsTest<MpmcQueue<Tracked_t>>(5, 8);
+    boundsTest<MpmcQueue<Tracked_t>>(1, 2);
+
+    // small rings, so that both sides keep hitting the full and empty cases and the indices wrap many times
+    for (U32_t capacity : { 2U, 64U })
+    {
+        SpscQueue<U64_t> spsc(capacity);
+        stress(spsc, 1, 1, 100'000);
+
+        struct Config_t
+        {
+            U32_t producers;
+            U32_t consumers;
+        };
+        for (Config_t const config : { Config_t{ 1, 1 }, Config_t{ 2, 2 }, Config_t{ 4, 1 }, Config_t{ 1, 4 },
+                                       Config_t{ 3, 3 } })
+        {
+            MpmcQueue<U64_t> mpmc(capacity);
+            stress(mpmc, config.producers, config.consumers, 100'000 / config.producers);
+        }
+    }
+    return test::checkResult("QueueTest");
+}
@@ -0,0 +1,164 @@
+#include "Check.h"
+
+#include "Core/Random.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace cge;
+
+static B8_t sameState(Xoshiro256_t const &generator, U64_t const (&expected)[4])
+{ //
+    return std::memcmp(generator.s, expected, sizeof(expected)) == 0;
+}
+
+// first outputs of the reference implementation of xoshiro256** from the state { 1, 2, 3, 4 }
+static void referenceSequenceTest()
+{
+    U64_t constexpr expected[]{ 11520ULL,
+                                0ULL,
+                                1509978240ULL,
+                                1215971899390074240ULL,
+                                1216172134540287360ULL,
+                                607988272756665600ULL,
+                                16172922978634559625ULL,
+                                8476171486693032832ULL,
+                                10595114339597558777ULL,
+                                2904607092377533576ULL };
+    Xoshiro256_t generator{ { 1, 2, 3, 4 } };
+    for (U64_t const value : expected)
+    { //
+        CGE_CHECK(generator() == value);
+    }
+}
+
+// the state words are consecutive outputs of SplitMix64, whose first output from 0 is a published value
+static void seedTest()
+{
+    U64_t state = 0;
+    CGE_CHECK(splitMix64(state) == 0xe220'a839'7b1d'cdafULL);
+
+    Xoshiro256_t generator;
+    generator.seed(42);
+    CGE_CHECK(sameState(generator, { 0xbdd7'3226'2feb'6e95ULL, 0x28ef'e333'b266'f103ULL, 0x4752'6757'130f'9f52ULL,
+                                     0x581c'e1ff'0e4a'e394ULL }));
+    CGE_CHECK(generator() == 0x1578'0b2e'0c2e'c716ULL);
+    CGE_CHECK(generator() == 0x6104'd986'6d11'3a7eULL);
+
+    // a key gives another sequence, the same pair the same one
+    Xoshiro256_t keyed, again;
+    keyed.seed(42, 1);
+    again.seed(42, 1);
+    CGE_CHECK(!sameState(keyed, { 0xbdd7'3226'2feb'6e95ULL, 0x28ef'e333'b266'f103ULL, 0x4752'6757'130f'9f52ULL,
+                                  0x581c'e1ff'0e4a'e394ULL }));
+    CGE_CHECK(std::memcmp(keyed.s, again.s, sizeof(keyed.s)) == 0);
+}
+
+/** the expected states were computed apart, by raising the transition matrix of the generator over GF(2) to the
+ *  power 2^128 and 2^192. Jumping also commutes with stepping, as both are powers of the same matrix
+ */
+static void jumpTest()
+{
+    Xoshiro256_t generator;
+    generator.seed(42);
+    generator.jump();
+    CGE_CHECK(sameState(generator, { 0x8174'6704'fde8'96b5ULL, 0x645e'9449'32da'e0aeULL, 0xf477'6829'231c'282cULL,
+                                     0x2393'f979'8732'dba1ULL }));
+
+    generator.seed(42);
+    generator.longJump();
+    CGE_CHECK(sameState(generator, { 0x1c55'92a8'd245'0a14ULL, 0xe09b'0d03'5aa0'6fd9ULL, 0xac4a'2ed7'fc28'e84cULL,
+                                     0xdb0c'5522'85ca'b3c6ULL }));
+
+    Xoshiro256_t stepFirst, jumpFirst;
+    stepFirst.seed(7);
+    jumpFirst.seed(7);
+    for (U32_t i = 0; i != 100; ++i)
+    { //
+        stepFirst();
+    }
+    stepFirst.jump();
+    jumpFirst.jump();
+    for (U32_t i = 0; i != 100; ++i)
+    { //
+        jumpFirst();
+    }
+    CGE_CHECK(std::memcmp(stepFirst.s, jumpFirst.s, sizeof(stepFirst.s)) == 0);
+
+    // stream i is the seed jumped i times
+    Xoshiro256_t jumped;
+    jumped.seed(42);
+    for (U32_t index = 0; index != 4; ++index)
+    {
+        Xoshiro256_t const stream = Xoshiro256_t::stream(42, index);
+        CGE_CHECK(std::memcmp(stream.s, jumped.s, sizeof(stream.s)) == 0);
+        jumped.jump();
+    }
+}
+
+/// lane l of the scalar kernel is stream l of the seed, drawn one word at a time
+static void lanesTest()
+{
+    RandomLanes_t lanes;
+    lanes.seed(42);
+    U64_t constexpr count = 4 * randomLanes;
+    U64_t out[count];
+    randomFillScalar(lanes, out, count);
+    for (U32_t lane = 0; lane != randomLanes; ++lane)
+    {
+        Xoshiro256_t stream = Xoshiro256_t::stream(42, lane);
+        for (U64_t i = lane; i < count; i += randomLanes)
+        { //
+            CGE_CHECK(out[i] == stream());
+        }
+    }
+}
+
+static U64_t constexpr sentinel = 0xa5a5'a5a5'a5a5'a5a5ULL;
+
+/** every variant available on this CPU, from the same seed, gives the words and the final state of the scalar
+ *  kernel bit for bit, over several calls whose counts aren't multiples of the lanes. The word after the last one
+ *  written must be left untouched
+ */
+static U32_t fillVariantsTest()
+{
+    U32_t variants = 0;
+    for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+    {
+        RandomFillFunc_t const func = g_randomFillKernel.variant(static_cast<EIsa_t>(isa));
+        if (!func)
+        {
+            continue;
+        }
+        ++variants;
+        for (U64_t const seed : { 0ULL, 1ULL, 42ULL, 0xffff'ffff'ffff'ffffULL })
+        {
+            RandomLanes_t expected, lanes;
+            expected.seed(seed);
+            lanes.seed(seed);
+            for (U64_t const count : { 0ULL, 1ULL, 2ULL, 3ULL, 4ULL, 5ULL, 7ULL, 64ULL, 1'001ULL })
+            {
+                std::vector<U64_t> reference(count + 1, sentinel);
+                std::vector<U64_t> out(count + 1, sentinel);
+                randomFillScalar(expected, reference.data(), count);
+                func(lanes, out.data(), count);
+                CGE_CHECK(out == reference && out[count] == sentinel);
+                CGE_CHECK(std::memcmp(lanes.s, expected.s, sizeof(lanes.s)) == 0);
+            }
+        }
+    }
+    CGE_CHECK(variants >= 2);
+    return variants;
+}
+
+I32_t main()
+{
+    referenceSequenceTest();
+    seedTest();
+    jumpTest();
+    lanesTest();
+    U32_t const variants = fillVariantsTest();
+    printf("[RandomTest] %u randomFill variants\n", variants);
+    return test::checkResult("RandomTest");
+}
@@ -0,0 +1,110 @@
+#include "Check.h"
+
+#include "Core/Random.h"
+#include "Core/Utility.h"
+
+#include <bit>
+#include <cstdio>
+#include <cstring>
+
+using namespace cge;
+
+static F32_t uniform(Xoshiro256_t &rng, F32_t lo, F32_t hi)
+{ //
+    return lo + (hi - lo) * toUnitFloat(rng());
+}
+
+/** a random direction, with each component zeroed (or negative zeroed) with probability 1/4, so that rays
+ *  parallel to one or two axes, whose slab distances are infinite or NaN, are frequent
+ */
+static glm::vec3 randomDirection(Xoshiro256_t &rng)
+{
+    glm::vec3 dir = {};
+    for (U32_t axis = 0; axis != 3; ++axis)
+    {
+        U64_t const r = rng() % 8;
+        dir[axis]     = r == 0 ? 0.f : r == 1 ? -0.f : uniform(rng, -1.f, 1.f);
+    }
+    return dir;
+}
+
+/// boxes on a coarse grid, so that origins often lie exactly on a face, where (bound - orig) * invdir is 0 * inf
+static AABB randomBox(Xoshiro256_t &rng)
+{
+    glm::vec3 min = {};
+    glm::vec3 max = {};
+    for (U32_t axis = 0; axis != 3; ++axis)
+    {
+        F32_t const a = static_cast<F32_t>(static_cast<I32_t>(rng() % 9) - 4);
+        F32_t const b = a + static_cast<F32_t>(rng() % 4);
+        min[axis]     = a;
+        max[axis]     = b;
+    }
+    return { min, max };
+}
+
+static glm::vec3 randomOrigin(Xoshiro256_t &rng)
+{
+    glm::vec3 orig = {};
+    for (U32_t axis = 0; axis != 3; ++axis)
+    {
+        orig[axis] = (rng() & 1) ? static_cast<F32_t>(static_cast<I32_t>(rng() % 13) - 6) : uniform(rng, -6.f, 6.f);
+    }
+    return orig;
+}
+
+I32_t main()
+{
+    Xoshiro256_t rng;
+    rng.seed(18);
+
+    U32_t constexpr rayCount = 200'000;
+    U64_t           hitCount = 0;
+    U32_t           variants = 0;
+    for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+    {
+        variants += g_intersectKernel.variant(static_cast<EIsa_t>(isa)) != nullptr;
+    }
+    CGE_CHECK(variants >= 2);
+
+    for (U32_t i = 0; i != rayCount; ++i)
+    {
+        Ray const ray(randomOrigin(rng), randomDirection(rng));
+
+        // the lanes past `used` stay cleared, and must never be hit
+        AABBBatch_t batch;
+        AABB        boxes[aabbBatchWidth] = {};
+        U32_t const used                  = 1 + static_cast<U32_t>(rng() % aabbBatchWidth);
+        for (U32_t lane = 0; lane != used; ++lane)
+        {
+            boxes[lane] = randomBox(rng);
+            batch.set(lane, boxes[lane]);
+        }
+
+        // reference: the single box test, lane by lane
+        BatchHit_t expected{ .t{}, .mask = 0 };
+        for (U32_t lane = 0; lane != aabbBatchWidth; ++lane)
+        {
+            Hit_t const hit = lane < used ? intersect(ray, boxes[lane]) : Hit_t{ .p{}, .t = -1.f, .isect = false };
+            expected.t[lane] = hit.t;
+            expected.mask |= static_cast<U32_t>(hit.isect) << lane;
+        }
+        hitCount += std::popcount(expected.mask);
+
+        for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+        {
+            if (BatchIntersectFunc_t const func = g_intersectKernel.variant(static_cast<EIsa_t>(isa)); func)
+            {
+                BatchHit_t const result = func(ray, batch);
+                CGE_CHECK(result.mask == expected.mask);
+                CGE_CHECK(std::memcmp(result.t, expected.t, sizeof(expected.t)) == 0);
+            }
+        }
+    }
+
+    // both outcomes must be well represented for the comparison to mean something
+    printf("[RayAabbTest] %u variants, %llu hits over %u rays\n", variants, static_cast<unsigned long long>(hitCount),
+           rayCount);
+    CGE_CHECK(hitCount > rayCount / 20 && hitCount < U64_t(rayCount) * aabbBatchWidth / 2);
+    return test::checkResult("RayAabbTest");
+}
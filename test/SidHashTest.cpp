@@ -0,0 +1,55 @@
+#include "Check.h"
+
+#include "Core/Cpu.h"
+#include "Core/Random.h"
+#include "Core/StringUtils.h"
+
+#include <vector>
+
+using namespace cge;
+
+// literals are hashed at compile time with the reference loop
+static_assert("PlayerModule"_sid.id == hashCRC64Bytewise("PlayerModule"));
+static_assert(CGE_CONSTEXPR_SID("").id == INITIAL_CRC64);
+
+I32_t main()
+{
+    // every length up to a few folding blocks, at every misalignment, for each variant the CPU supports
+    U32_t constexpr   maxLength = 1100;
+    U32_t constexpr   maxOffset = 8;
+    Xoshiro256_t      rng;
+    rng.seed(0x5eed);
+    std::vector<U8_t> bytes(maxLength + maxOffset);
+    for (U8_t &byte : bytes)
+    {
+        byte = static_cast<U8_t>(rng());
+    }
+
+    U32_t checkedVariants = 0;
+    for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+    {
+        CRC64Func_t const func = g_crc64Kernel.variant(static_cast<EIsa_t>(isa));
+        if (!func)
+        {
+            continue;
+        }
+        ++checkedVariants;
+        for (U32_t offset = 0; offset != maxOffset; ++offset)
+        {
+            for (U32_t length = 0; length <= maxLength; ++length)
+            {
+                U8_t const      *data = bytes.data() + offset;
+                std::string_view str(reinterpret_cast<Char8_t const *>(data), length);
+                CGE_CHECK(func(data, length, INITIAL_CRC64) == hashCRC64Bytewise(str));
+                CGE_CHECK(func(data, length, ~0ULL) == hashCRC64Bytewise(str, ~0ULL));
+            }
+        }
+        printf("[SidHashTest] %s checked\n", isaName(static_cast<EIsa_t>(isa)));
+    }
+    CGE_CHECK(checkedVariants != 0);
+
+    std::string_view const path = "assets/models/obstacle/obstacle.obj";
+    CGE_CHECK(hashCRC64Runtime(path) == hashCRC64Bytewise(path));
+    CGE_CHECK(makeSid(path).id == hashCRC64Bytewise(path));
+    return test::checkResult("SidHashTest");
+}
@@ -0,0 +1,198 @@
+#include "Check.h"
+
+#include "Core/Alloc.h"
+#include "Core/Queue.h"
+#include "Core/Random.h"
+
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+using namespace cge;
+
+// Stress test of the thread caches and of the tagged lock free free-lists, meant to also run in a build with
+// cge_ENABLE_SANITIZER_THREAD. Every block is filled with a canary unique to its allocation and checked before
+// being freed, so that a block handed out twice shows up as an overwritten canary
+
+static U32_t constexpr threadCount    = 4;
+static U32_t constexpr iterations     = 60'000;
+static U32_t constexpr maxLiveBlocks  = 512;
+static U32_t constexpr handoffSize    = 256;
+static U64_t constexpr largeBlockSize = 3 * slabMaxBlockSize;
+
+// statics, as the thread cache of a thread keeps a pointer to the first pool it used until the thread exits.
+// The upstream gives the slabs back on destruction
+static std::pmr::synchronized_pool_resource s_upstream;
+static SlabPool                             s_pool(&s_upstream, &s_upstream);
+static SlabPool                             s_otherPool(&s_upstream, &s_upstream); ///< never cached by a thread
+
+struct Block_t
+{
+    U64_t *words;
+    U64_t  size;
+    U64_t  canary;
+};
+
+struct Shared_t
+{
+    std::vector<std::unique_ptr<MpmcQueue<Block_t>>> inboxes; ///< blocks to be freed by another thread
+    std::atomic<U32_t>                               sending{ threadCount };
+    std::atomic<U32_t>                               corrupted{ 0 };
+};
+
+static void fill(Block_t const &block)
+{
+    for (U64_t i = 0; i != block.size / sizeof(U64_t); ++i)
+    {
+        block.words[i] = block.canary ^ i;
+    }
+}
+
+static void checkAndFree(Shared_t &shared, Block_t const &block, std::pmr::memory_resource *pool)
+{
+    for (U64_t i = 0; i != block.size / sizeof(U64_t); ++i)
+    {
+        if (block.words[i] != (block.canary ^ i))
+        {
+            shared.corrupted.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+    pool->deallocate(block.words, block.size, alignof(U64_t));
+}
+
+static void worker(Shared_t &shared, U32_t index)
+{
+    Xoshiro256_t rng;
+    rng.seed(index + 1);
+    std::vector<Block_t> live;
+    live.reserve(maxLiveBlocks);
+    U64_t serial = 0;
+
+    for (U32_t i = 0; i != iterations; ++i)
+    {
+        U64_t const roll = rng() % 16;
+        if (roll < 7 && live.size() != maxLiveBlocks)
+        {
+            // sizes over every class, and now and then a large block
+            U64_t const size = roll == 0 ? largeBlockSize : slabMinBlockSize << (rng() % slabClassCount);
+            Block_t const block{ .words  = static_cast<U64_t *>(s_pool.allocate(size, alignof(U64_t))),
+                                 .size   = size,
+                                 .canary = (U64_t{ index } << 56) | ++serial };
+            fill(block);
+            live.push_back(block);
+        }
+        else if (roll < 11 && !live.empty())
+        { // hand a block over to the next thread, to be freed into its cache
+            U64_t const slot = rng() % live.size();
+            if (shared.inboxes[(index + 1) % threadCount]->tryPush(live[slot]))
+            {
+                live[slot] = live.back();
+                live.pop_back();
+            }
+        }
+        else if (roll < 14 && !live.empty())
+        {
+            U64_t const slot = rng() % live.size();
+            checkAndFree(shared, live[slot], &s_pool);
+            live[slot] = live.back();
+            live.pop_back();
+        }
+        else if (roll == 14)
+        { // a pool which isn't the one of the thread cache goes straight to the global free-lists
+            Block_t const block{ .words  = static_cast<U64_t *>(s_otherPool.allocate(64, alignof(U64_t))),
+                                 .size   = 64,
+                                 .canary = (U64_t{ index } << 56) | ++serial };
+            fill(block);
+            checkAndFree(shared, block, &s_otherPool);
+        }
+        else
+        {
+            Block_t block;
+            while (shared.inboxes[index]->tryPop(block))
+            {
+                checkAndFree(shared, block, &s_pool);
+            }
+        }
+    }
+
+    for (Block_t const &block : live)
+    {
+        checkAndFree(shared, block, &s_pool);
+    }
+
+    // no block can arrive once every thread stopped sending
+    shared.sending.fetch_sub(1, std::memory_order_acq_rel);
+    Block_t block;
+    while (true)
+    {
+        B8_t const last = shared.sending.load(std::memory_order_acquire) == 0;
+        while (shared.inboxes[index]->tryPop(block))
+        {
+            checkAndFree(shared, block, &s_pool);
+        }
+        if (last)
+        {
+            break;
+        }
+        std::this_thread::yield();
+    }
+}
+
+static void stressTest()
+{
+    Shared_t shared;
+    for (U32_t i = 0; i != threadCount; ++i)
+    {
+        shared.inboxes.push_back(std::make_unique<MpmcQueue<Block_t>>(handoffSize));
+    }
+
+    std::vector<std::thread> threads;
+    for (U32_t i = 0; i != threadCount; ++i)
+    {
+        threads.emplace_back(worker, std::ref(shared), i);
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    CGE_CHECK(shared.corrupted.load() == 0);
+    CGE_CHECK(s_pool.largeCount() == 0);
+
+    // the caches of the exited threads went back to the global free-lists
+    for (U32_t sizeClass = 0; sizeClass != slabClassCount; ++sizeClass)
+    {
+        SlabClassStats_t const stats = s_pool.stats(sizeClass);
+        CGE_CHECK(stats.slabCount != 0 && stats.used == 0 && stats.globalFree == stats.capacity);
+        CGE_CHECK(s_otherPool.stats(sizeClass).used == 0);
+    }
+}
+
+// requests too large, or too aligned, for the size classes are forwarded and counted
+static void largeTest()
+{
+    std::pmr::memory_resource *const upstream = std::pmr::new_delete_resource();
+    SlabPool                         pool(upstream, upstream);
+    void *const                      large   = pool.allocate(slabMaxBlockSize + 1, 8);
+    void *const                      aligned = pool.allocate(16, 2 * slabMaxBlockSize);
+    CGE_CHECK(pool.largeCount() == 2);
+    CGE_CHECK(reinterpret_cast<U64_t>(aligned) % (2 * slabMaxBlockSize) == 0);
+    pool.deallocate(large, slabMaxBlockSize + 1, 8);
+    CGE_CHECK(pool.largeCount() == 1);
+    pool.deallocate(aligned, 16, 2 * slabMaxBlockSize);
+    CGE_CHECK(pool.largeCount() == 0);
+    for (U32_t sizeClass = 0; sizeClass != slabClassCount; ++sizeClass)
+    {
+        CGE_CHECK(pool.stats(sizeClass).slabCount == 0);
+    }
+}
+
+I32_t main()
+{
+    stressTest();
+    largeTest();
+    return test::checkResult("SlabPoolTest");
+}
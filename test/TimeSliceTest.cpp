@@ -0,0 +1,214 @@
+#include "Check.h"
+
+#include "Core/TimeSlice.h"
+
+#include <memory>
+#include <vector>
+
+using namespace cge;
+
+static U64_t constexpr unlimitedBudget  = 60'000'000'000ULL; ///< every queued step runs in the frame
+static U64_t constexpr singleStepBudget = 1;                  ///< only the first step of the frame runs
+
+/// ids of the items, in the order their steps ran
+static std::vector<U32_t> s_steps;
+
+/// step of an item which records its id, and is done after `total` steps
+static auto counting(U32_t id, U32_t total)
+{
+    return [id, total, done = 0U]() mutable -> WorkProgress_t {
+        s_steps.push_back(id);
+        return { .done = ++done, .total = total };
+    };
+}
+
+// by priority first, then in submission order, each item running until done
+static void priorityTest()
+{
+    TimeSliceScheduler_s scheduler;
+    scheduler.setBudget(unlimitedBudget);
+    s_steps.clear();
+    scheduler.submit("low", EWorkPriority_t::eLow, counting(0, 2));
+    scheduler.submit("normal", EWorkPriority_t::eNormal, counting(1, 2));
+    scheduler.submit("high", EWorkPriority_t::eHigh, counting(2, 2));
+    scheduler.submit("normal2", EWorkPriority_t::eNormal, counting(3, 2));
+    CGE_CHECK(scheduler.itemCount() == 4);
+    scheduler.run();
+    CGE_CHECK((s_steps == std::vector<U32_t>{ 2, 2, 1, 1, 3, 3, 0, 0 }));
+    CGE_CHECK(scheduler.itemCount() == 0);
+}
+
+// once the budget is spent no other step runs, but the first step of a frame always does
+static void budgetTest()
+{
+    TimeSliceScheduler_s scheduler;
+    scheduler.setBudget(singleStepBudget);
+    scheduler.setStarvationFrames(1'000);
+    s_steps.clear();
+    WorkHandle_t const first  = scheduler.submit("first", EWorkPriority_t::eNormal, counting(0, 3));
+    WorkHandle_t const second = scheduler.submit("second", EWorkPriority_t::eNormal, counting(1, 2));
+    for (U32_t frame = 1; frame <= 5; ++frame)
+    {
+        scheduler.run();
+        CGE_CHECK(s_steps.size() == frame);
+    }
+    CGE_CHECK((s_steps == std::vector<U32_t>{ 0, 0, 0, 1, 1 }));
+    CGE_CHECK(!scheduler.isPending(first) && !scheduler.isPending(second));
+}
+
+// a low priority item behind a long high priority one gets a step after waiting the starvation frames
+static void starvationTest()
+{
+    U32_t constexpr starvationFrames = 3;
+    TimeSliceScheduler_s scheduler;
+    scheduler.setBudget(singleStepBudget);
+    scheduler.setStarvationFrames(starvationFrames);
+    s_steps.clear();
+    scheduler.submit("long", EWorkPriority_t::eHigh, counting(0, 100));
+    WorkHandle_t const starving = scheduler.submit("starving", EWorkPriority_t::eLow, counting(1, 2));
+
+    for (U32_t frame = 0; frame != starvationFrames; ++frame)
+    {
+        scheduler.run();
+    }
+    CGE_CHECK((s_steps == std::vector<U32_t>{ 0, 0, 0 }));
+    CGE_CHECK(scheduler.progress(starving).done == 0);
+
+    // its step comes first, and spends the budget of the frame
+    scheduler.run();
+    CGE_CHECK((s_steps == std::vector<U32_t>{ 0, 0, 0, 1 }));
+    CGE_CHECK(scheduler.progress(starving).done == 1);
+
+    for (U32_t frame = 0; frame != starvationFrames + 1; ++frame)
+    {
+        scheduler.run();
+    }
+    CGE_CHECK((s_steps == std::vector<U32_t>{ 0, 0, 0, 1, 0, 0, 0, 1 }));
+    CGE_CHECK(!scheduler.isPending(starving));
+}
+
+static TimeSliceScheduler_s *s_scheduler = nullptr;
+static WorkHandle_t          s_self{};
+static WorkHandle_t          s_victim{};
+
+/** an item cancelled by its own step is destroyed once the step returns, and an item cancelled by the step of
+ *  another one before its turn never runs. In both cases the closure is destroyed exactly once
+ */
+static void cancelTest()
+{
+    TimeSliceScheduler_s scheduler;
+    scheduler.setBudget(unlimitedBudget);
+    s_scheduler = &scheduler;
+    s_steps.clear();
+
+    auto const                 selfToken   = std::make_shared<U32_t>(0);
+    auto const                 victimToken = std::make_shared<U32_t>(0);
+    std::weak_ptr<U32_t> const selfAlive   = selfToken;
+    std::weak_ptr<U32_t> const victimAlive = victimToken;
+
+    s_self = scheduler.submit("self", EWorkPriority_t::eHigh, [token = selfToken]() -> WorkProgress_t {
+        s_steps.push_back(0);
+        s_scheduler->cancel(s_self);
+        // still alive while its step runs
+        return { .done = static_cast<U32_t>(token.use_count()), .total = 10 };
+    });
+    scheduler.submit("killer", EWorkPriority_t::eNormal, []() -> WorkProgress_t {
+        s_steps.push_back(1);
+        s_scheduler->cancel(s_victim);
+        return { .done = 1, .total = 1 };
+    });
+    s_victim = scheduler.submit("victim", EWorkPriority_t::eLow, [token = victimToken]() -> WorkProgress_t {
+        s_steps.push_back(2);
+        return { .done = 1, .total = 1 };
+    });
+    CGE_CHECK(selfAlive.use_count() == 2 && victimAlive.use_count() == 2);
+
+    scheduler.run();
+    CGE_CHECK((s_steps == std::vector<U32_t>{ 0, 1 }));
+    CGE_CHECK(!scheduler.isPending(s_self) && !scheduler.isPending(s_victim) && scheduler.itemCount() == 0);
+    CGE_CHECK(selfAlive.use_count() == 1 && victimAlive.use_count() == 1);
+
+    // cancelling again is ignored
+    scheduler.cancel(s_self);
+    scheduler.cancel(s_victim);
+    scheduler.run();
+    CGE_CHECK(s_steps.size() == 2);
+}
+
+// finish runs the remaining steps now, whatever the budget
+static void finishTest()
+{
+    TimeSliceScheduler_s scheduler;
+    scheduler.setBudget(singleStepBudget);
+    s_steps.clear();
+    WorkHandle_t const handle = scheduler.submit("finish", EWorkPriority_t::eLow, counting(0, 10));
+    scheduler.run();
+    CGE_CHECK(scheduler.isPending(handle) && scheduler.progress(handle).done == 1);
+    scheduler.finish(handle);
+    CGE_CHECK(s_steps.size() == 10 && !scheduler.isPending(handle));
+    CGE_CHECK(scheduler.progress(handle).total == 0 && scheduler.progress(handle).finished());
+    scheduler.finish(handle);
+    scheduler.finish(nullWorkHandle);
+    CGE_CHECK(s_steps.size() == 10);
+}
+
+// a freed slot is reused with a new generation: the old handle is stale, and is ignored
+static void slotReuseTest()
+{
+    TimeSliceScheduler_s scheduler;
+    scheduler.setBudget(unlimitedBudget);
+    s_steps.clear();
+    WorkHandle_t const done = scheduler.submit("done", EWorkPriority_t::eNormal, counting(0, 1));
+    scheduler.run();
+    CGE_CHECK(!scheduler.isPending(done));
+
+    WorkHandle_t const reused = scheduler.submit("reused", EWorkPriority_t::eNormal, counting(1, 1));
+    CGE_CHECK(reused.slot == done.slot && reused.generation != done.generation);
+    CGE_CHECK(!scheduler.isPending(done) && scheduler.isPending(reused));
+    scheduler.cancel(done);
+    scheduler.finish(done);
+    CGE_CHECK(scheduler.isPending(reused) && s_steps.size() == 1);
+    CGE_CHECK(!scheduler.isPending(nullWorkHandle));
+    scheduler.run();
+    CGE_CHECK((s_steps == std::vector<U32_t>{ 0, 1 }) && !scheduler.isPending(reused));
+}
+
+/** items submitted by a step, whatever their priority, don't disturb the order walked by the run: each queued
+ *  item gets its steps once, and the new ones start in the next run, after the older items of their priority
+ */
+static void submitFromStepTest()
+{
+    TimeSliceScheduler_s scheduler;
+    scheduler.setBudget(unlimitedBudget);
+    s_scheduler = &scheduler;
+    s_steps.clear();
+    scheduler.submit("older", EWorkPriority_t::eLow, counting(0, 1));
+    scheduler.submit("submitter", EWorkPriority_t::eHigh, [done = 0U]() mutable -> WorkProgress_t {
+        s_steps.push_back(1);
+        if (done++ == 0)
+        {
+            s_scheduler->submit("low", EWorkPriority_t::eLow, counting(2, 1));
+            s_scheduler->submit("high", EWorkPriority_t::eHigh, counting(3, 1));
+            s_scheduler->submit("high2", EWorkPriority_t::eHigh, counting(4, 1));
+        }
+        return { .done = done, .total = 2 };
+    });
+    scheduler.run();
+    CGE_CHECK((s_steps == std::vector<U32_t>{ 1, 1, 0 }));
+    CGE_CHECK(scheduler.itemCount() == 3);
+    scheduler.run();
+    CGE_CHECK((s_steps == std::vector<U32_t>{ 1, 1, 0, 3, 4, 2 }));
+    CGE_CHECK(scheduler.itemCount() == 0);
+}
+
+I32_t main()
+{
+    priorityTest();
+    budgetTest();
+    starvationTest();
+    cancelTest();
+    finishTest();
+    slotReuseTest();
+    submitFromStepTest();
+    return test::checkResult("TimeSliceTest");
+}
@@ -0,0 +1,255 @@
+#include "Check.h"
+
+#include "Core/Random.h"
+#include "Core/Utility.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace cge;
+
+static F32_t uniform(Xoshiro256_t &rng, F32_t lo, F32_t hi)
+{ //
+    return lo + (hi - lo) * toUnitFloat(rng());
+}
+
+static glm::vec3 uniform3(Xoshiro256_t &rng, F32_t lo, F32_t hi)
+{ //
+    return { uniform(rng, lo, hi), uniform(rng, lo, hi), uniform(rng, lo, hi) };
+}
+
+/// one box in 16 is flat on an axis, one in 16 is a point
+static AABB randomBox(Xoshiro256_t &rng)
+{
+    glm::vec3 const center = uniform3(rng, -20.f, 20.f);
+    glm::vec3       half   = uniform3(rng, 0.f, 4.f);
+    U64_t const     shape  = rng() % 16;
+    half                   = shape == 0 ? glm::vec3(0.f) : shape == 1 ? glm::vec3(half.x, half.y, 0.f) : half;
+    return { center - half, center + half };
+}
+
+/// rotation, non uniform scale (possibly mirroring) and translation, like the scene node transforms
+static glm::mat4 randomModel(Xoshiro256_t &rng)
+{
+    glm::vec3 const axis  = glm::normalize(uniform3(rng, -1.f, 1.f) + glm::vec3(0.f, 0.f, 1e-3f));
+    glm::vec3       scale = uniform3(rng, .1f, 5.f);
+    scale.x               = (rng() & 1) ? -scale.x : scale.x;
+    glm::mat4 const translation = glm::translate(glm::mat4(1.f), uniform3(rng, -10.f, 10.f));
+    return glm::scale(glm::rotate(translation, uniform(rng, -3.1f, 3.1f), axis), scale);
+}
+
+static glm::dvec3 corner(AABB const &box, U32_t c)
+{
+    return { (c & 1) ? box.mm.max.x : box.mm.min.x,
+             (c & 2) ? box.mm.max.y : box.mm.min.y,
+             (c & 4) ? box.mm.max.z : box.mm.min.z };
+}
+
+/// the 8 transformed corners, in double precision
+static void referenceBounds(AABB const &box, glm::dmat4 const &m, glm::dvec3 &lo, glm::dvec3 &hi)
+{
+    lo = glm::dvec3(INFINITY);
+    hi = glm::dvec3(-INFINITY);
+    for (U32_t c = 0; c != 8; ++c)
+    {
+        glm::dvec3 const p(m * glm::dvec4(corner(box, c), 1.0));
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+}
+
+/** the 8 corners in clip space, divided by w if in front of the camera. Edges crossing w = ndcMinW contribute
+ *  the crossing point, computed in double precision
+ */
+static void referenceNDCBounds(AABB const &box, glm::dmat4 const &mvp, glm::dvec3 &lo, glm::dvec3 &hi)
+{
+    glm::dvec4 clip[8];
+    lo = glm::dvec3(INFINITY);
+    hi = glm::dvec3(-INFINITY);
+    for (U32_t c = 0; c != 8; ++c)
+    {
+        clip[c] = mvp * glm::dvec4(corner(box, c), 1.0);
+        if (clip[c].w > ndcMinW)
+        {
+            lo = glm::min(lo, glm::dvec3(clip[c]) / clip[c].w);
+            hi = glm::max(hi, glm::dvec3(clip[c]) / clip[c].w);
+        }
+    }
+    for (U32_t i = 0; i != 8; ++i)
+    {
+        for (U32_t j = i + 1; j != 8; ++j)
+        {
+            if (std::popcount(i ^ j) == 1 && (clip[i].w > ndcMinW) != (clip[j].w > ndcMinW))
+            {
+                F64_t const      s     = (ndcMinW - clip[i].w) / (clip[j].w - clip[i].w);
+                glm::dvec3 const point = glm::dvec3(clip[i] + (clip[j] - clip[i]) * s) / F64_t(ndcMinW);
+                lo                     = glm::min(lo, point);
+                hi                     = glm::max(hi, point);
+            }
+        }
+    }
+}
+
+/// largest difference from the reference, relative to the largest reference coordinate (at least 1)
+static F64_t relativeError(AABB const &box, glm::dvec3 const &lo, glm::dvec3 const &hi)
+{
+    F64_t scale = 1.0;
+    F64_t error = 0.0;
+    for (U32_t axis = 0; axis != 3; ++axis)
+    {
+        scale = std::max({ scale, std::abs(lo[axis]), std::abs(hi[axis]) });
+        error = std::max({ error, std::abs(box.mm.min[axis] - lo[axis]), std::abs(box.mm.max[axis] - hi[axis]) });
+    }
+    return error / scale;
+}
+
+static B8_t sameBits(AABB const &a, AABB const &b)
+{ //
+    return std::memcmp(&a, &b, sizeof(AABB)) == 0;
+}
+
+static void worldSpaceTest()
+{
+    Xoshiro256_t rng;
+    rng.seed(19);
+
+    // every count up to 2 full AVX groups plus a tail, then a large batch
+    for (U32_t count : { 0U, 1U, 3U, 4U, 5U, 7U, 8U, 9U, 15U, 16U, 17U, 23U, 65'536U })
+    {
+        std::vector<AABB>      boxes(count);
+        std::vector<glm::mat4> models(count);
+        for (U32_t i = 0; i != count; ++i)
+        {
+            boxes[i]  = randomBox(rng);
+            models[i] = randomModel(rng);
+        }
+
+        std::vector<AABB> expected(count);
+        transformAABBsScalar(boxes, models, expected);
+        F64_t maxError = 0.0;
+        for (U32_t i = 0; i != count; ++i)
+        {
+            glm::dvec3 lo;
+            glm::dvec3 hi;
+            referenceBounds(boxes[i], glm::dmat4(models[i]), lo, hi);
+            maxError = std::max(maxError, relativeError(expected[i], lo, hi));
+            CGE_CHECK(sameBits(expected[i], transformAABB(boxes[i], models[i])));
+        }
+        CGE_CHECK(maxError < 1e-5);
+
+        for (U32_t isa = 0; isa != static_cast<U32_t>(EIsa_t::eIsaCount); ++isa)
+        {
+            TransformAABBsFunc_t const func = g_transformAABBsKernel.variant(static_cast<EIsa_t>(isa));
+            if (!func)
+            {
+                continue;
+            }
+            std::vector<AABB> result(count);
+            func(boxes, models, result);
+            std::vector<AABB> inPlace = boxes;
+            func(inPlace, models, inPlace);
+            for (U32_t i = 0; i != count; ++i)
+            {
+                CGE_CHECK(sameBits(result[i], expected[i]));
+                CGE_CHECK(sameBits(inPlace[i], expected[i]));
+            }
+        }
+        if (count > 1'000)
+        {
+            printf("[TransformAabbTest] world space, max relative error %.3g over %u boxes\n", maxError, count);
+        }
+    }
+}
+
+static void ndcTest()
+{
+    Xoshiro256_t rng;
+    rng.seed(190);
+
+    glm::mat4 const projection = glm::perspective(glm::radians(60.f), 16.f / 9.f, .1f, 200.f);
+    U32_t constexpr boxesPerView = 4'096;
+    U32_t inFront  = 0;
+    U32_t crossing = 0;
+    U32_t behind   = 0;
+    F64_t maxError = 0.0;
+    for (U32_t view = 0; view != 16; ++view)
+    {
+        // the camera sits among the boxes, so that many are behind it or cross its plane
+        glm::vec3 const eye    = uniform3(rng, -15.f, 15.f);
+        glm::mat4 const camera = glm::lookAt(eye, uniform3(rng, -5.f, 5.f), glm::vec3(0.f, 1.f, 0.f));
+        glm::mat4 const viewProjection = projection * camera;
+
+        std::vector<AABB>      boxes;
+        std::vector<glm::mat4> models;
+        std::vector<F64_t>     minW;
+        std::vector<F64_t>     planeDistance; ///< smallest distance of a corner w from ndcMinW
+        while (boxes.size() != boxesPerView)
+        {
+            AABB const       box   = randomBox(rng);
+            glm::mat4 const  model = randomModel(rng);
+            glm::dmat4 const mvp   = glm::dmat4(viewProjection) * glm::dmat4(model);
+
+            // corners with w close to ndcMinW are classified by the rounding of w and divided by a tiny value:
+            // a w of 1e-5 wrong by 1e-7 moves the point by 1%. Such boxes are left out
+            F64_t smallestW = INFINITY;
+            F64_t distance  = INFINITY;
+            for (U32_t c = 0; c != 8; ++c)
+            {
+                F64_t const w = (mvp * glm::dvec4(corner(box, c), 1.0)).w;
+                smallestW     = std::min(smallestW, w);
+                distance      = std::min(distance, std::abs(w - ndcMinW));
+            }
+            if (distance >= 1e-2)
+            {
+                boxes.push_back(box);
+                models.push_back(model);
+                minW.push_back(smallestW);
+                planeDistance.push_back(distance);
+            }
+        }
+
+        std::vector<AABB> result(boxesPerView);
+        transformAABBsToNDC(boxes, models, viewProjection, result);
+        for (U32_t i = 0; i != boxesPerView; ++i)
+        {
+            glm::dvec3 lo;
+            glm::dvec3 hi;
+            referenceNDCBounds(boxes[i], glm::dmat4(viewProjection) * glm::dmat4(models[i]), lo, hi);
+            if (lo.x > hi.x)
+            { // entirely behind: empty, never contains a point
+                ++behind;
+                CGE_CHECK(std::isinf(result[i].mm.min.x) && result[i].mm.min.x > 0);
+                CGE_CHECK(std::isinf(result[i].mm.max.x) && result[i].mm.max.x < 0);
+                continue;
+            }
+
+            // the rounding error of w is amplified by the division, hence the looser bound close to the plane
+            F64_t const error     = relativeError(result[i], lo, hi);
+            F64_t const tolerance = 1e-5 / std::min(planeDistance[i], 0.1);
+            inFront += minW[i] > ndcMinW;
+            crossing += minW[i] <= ndcMinW;
+            maxError = std::max(maxError, error);
+            CGE_CHECK(error < tolerance);
+
+            AABB const single = transformAABBToNDC(boxes[i], models[i], camera, projection);
+            CGE_CHECK(relativeError(single, lo, hi) < tolerance);
+        }
+    }
+
+    printf("[TransformAabbTest] NDC, %u in front, %u crossing the camera plane, %u behind, max relative error %.3g\n",
+           inFront, crossing, behind, maxError);
+    CGE_CHECK(inFront > 1'000 && crossing > 1'000 && behind > 1'000);
+}
+
+I32_t main()
+{
+    worldSpaceTest();
+    ndcTest();
+    return test::checkResult("TransformAabbTest");
+}
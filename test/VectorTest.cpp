@@ -0,0 +1,294 @@
+#include "Check.h"
+
+#include "Core/Containers.h"
+#include "Core/Queue.h"
+
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+
+using namespace cge;
+
+/// owns heap memory and counts its live instances, so that leaks and double destructions show up
+struct Tracked_t
+{
+    static inline I32_t s_live = 0;
+
+    explicit Tracked_t(I32_t v = 0) : value(std::make_unique<I32_t>(v))
+    { //
+        ++s_live;
+    }
+    Tracked_t(Tracked_t const &other) : value(std::make_unique<I32_t>(*other.value))
+    { //
+        ++s_live;
+    }
+    Tracked_t(Tracked_t &&other) noexcept : value(std::move(other.value))
+    { //
+        ++s_live;
+    }
+    Tracked_t &operator=(Tracked_t const &other)
+    {
+        value = std::make_unique<I32_t>(*other.value);
+        return *this;
+    }
+    Tracked_t &operator=(Tracked_t &&other) noexcept = default;
+    ~Tracked_t()
+    { //
+        --s_live;
+    }
+
+    std::unique_ptr<I32_t> value;
+};
+
+/// counts the blocks handed out by the upstream resource and still outstanding
+class CountingResource_t : public std::pmr::memory_resource
+{
+  public:
+    U32_t allocations   = 0;
+    U32_t deallocations = 0;
+
+    [[nodiscard]] U32_t outstanding() const
+    { //
+        return allocations - deallocations;
+    }
+
+  private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    B8_t do_is_equal(std::pmr::memory_resource const &other) const noexcept override
+    { //
+        return this == &other;
+    }
+};
+
+template<typename V> static B8_t holds(V const &vector, std::initializer_list<I32_t> values)
+{
+    if (vector.size() != values.size())
+    {
+        return false;
+    }
+    U32_t i = 0;
+    for (I32_t const value : values)
+    {
+        if (!vector[i].value || *vector[i++].value != value)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// longer than any small string buffer, so that each string allocates
+static Char8_t const *const longString = "a string long enough to be out of the small string buffer";
+
+static void fixedVectorTest()
+{
+    CountingResource_t resource;
+    {
+        FixedVector<Tracked_t, 4> vector(&resource);
+        CGE_CHECK(vector.capacity() == 4 && vector.empty() && !vector.full());
+        for (I32_t i = 0; i != 4; ++i)
+        {
+            vector.emplace_back(i);
+        }
+        CGE_CHECK(vector.full() && vector.size() == vector.capacity());
+        CGE_CHECK(Tracked_t::s_live == 4);
+
+        // erasing shifts the following elements down, and frees a place
+        vector.erase(vector.begin() + 1);
+        CGE_CHECK(holds(vector, { 0, 2, 3 }) && !vector.full() && Tracked_t::s_live == 3);
+        vector.push_back(Tracked_t(7));
+        CGE_CHECK(holds(vector, { 0, 2, 3, 7 }) && Tracked_t::s_live == 4);
+
+        FixedVector<Tracked_t, 4> copy(vector);
+        CGE_CHECK(holds(copy, { 0, 2, 3, 7 }) && Tracked_t::s_live == 8);
+        CGE_CHECK(copy.get_allocator().resource() == &resource);
+
+        FixedVector<Tracked_t, 4> moved(std::move(copy));
+        CGE_CHECK(holds(moved, { 0, 2, 3, 7 }) && copy.empty() && Tracked_t::s_live == 8);
+
+        FixedVector<Tracked_t, 4> assigned;
+        assigned.emplace_back(42);
+        assigned = vector;
+        CGE_CHECK(holds(assigned, { 0, 2, 3, 7 }) && Tracked_t::s_live == 12);
+        CGE_CHECK(assigned.get_allocator().resource() == std::pmr::get_default_resource());
+        assigned = std::move(moved);
+        CGE_CHECK(holds(assigned, { 0, 2, 3, 7 }) && moved.empty() && Tracked_t::s_live == 8);
+
+        vector.resize(2);
+        CGE_CHECK(holds(vector, { 0, 2 }) && Tracked_t::s_live == 6);
+        vector.resize(3);
+        CGE_CHECK(holds(vector, { 0, 2, 0 }) && Tracked_t::s_live == 7);
+        vector.pop_back();
+        vector.clear();
+        CGE_CHECK(vector.empty() && Tracked_t::s_live == 4);
+    }
+    CGE_CHECK(Tracked_t::s_live == 0);
+
+    // the elements themselves, not the vector, allocate from the resource
+    CGE_CHECK(resource.allocations == 0);
+    {
+        FixedVector<std::pmr::string, 2> strings(&resource);
+        strings.emplace_back(longString);
+        strings.push_back(std::pmr::string(longString));
+        CGE_CHECK(strings[0].get_allocator().resource() == &resource);
+        CGE_CHECK(strings[1].get_allocator().resource() == &resource);
+        CGE_CHECK(strings[1] == longString);
+    }
+    CGE_CHECK(resource.allocations >= 2 && resource.outstanding() == 0);
+}
+
+static void smallVectorTest()
+{
+    CountingResource_t resource;
+    {
+        SmallVector<Tracked_t, 4> vector(&resource);
+        for (I32_t i = 0; i != 4; ++i)
+        {
+            vector.emplace_back(i);
+        }
+        CGE_CHECK(vector.isInline() && vector.capacity() == 4 && resource.allocations == 0);
+
+        // the fifth element spills every element to a block of twice the capacity
+        vector.emplace_back(4);
+        CGE_CHECK(!vector.isInline() && vector.capacity() == 8 && resource.allocations == 1);
+        CGE_CHECK(holds(vector, { 0, 1, 2, 3, 4 }) && Tracked_t::s_live == 5);
+
+        // the argument refers to an element of the block being replaced
+        for (I32_t i = 5; i != 8; ++i)
+        {
+            vector.emplace_back(i);
+        }
+        vector.push_back(vector[0]);
+        CGE_CHECK(vector.capacity() == 16 && resource.allocations == 2 && resource.outstanding() == 1);
+        CGE_CHECK(holds(vector, { 0, 1, 2, 3, 4, 5, 6, 7, 0 }) && Tracked_t::s_live == 9);
+
+        // shrinking keeps the block
+        vector.resize(2);
+        CGE_CHECK(!vector.isInline() && vector.capacity() == 16 && Tracked_t::s_live == 2);
+
+        // a spilled vector hands its block over, an inline one its elements
+        SmallVector<Tracked_t, 4> stolen(std::move(vector));
+        CGE_CHECK(holds(stolen, { 0, 1 }) && !stolen.isInline() && resource.allocations == 2);
+        CGE_CHECK(vector.empty() && vector.isInline() && Tracked_t::s_live == 2);
+
+        SmallVector<Tracked_t, 4> small(&resource);
+        small.emplace_back(9);
+        SmallVector<Tracked_t, 4> movedSmall(std::move(small));
+        CGE_CHECK(holds(movedSmall, { 9 }) && movedSmall.isInline() && small.empty() && Tracked_t::s_live == 3);
+
+        // copies are explicit and name their resource
+        SmallVector<Tracked_t, 4> copy(stolen, std::pmr::new_delete_resource());
+        CGE_CHECK(holds(copy, { 0, 1 }) && copy.isInline() && copy.resource() == std::pmr::new_delete_resource());
+        CGE_CHECK(Tracked_t::s_live == 5);
+
+        // the block of another resource can't be stolen: the elements move one by one
+        SmallVector<Tracked_t, 4> other(std::pmr::new_delete_resource());
+        for (I32_t i = 0; i != 6; ++i)
+        {
+            other.emplace_back(10 + i);
+        }
+        stolen = std::move(other);
+        CGE_CHECK(holds(stolen, { 10, 11, 12, 13, 14, 15 }) && stolen.resource() == &resource);
+        CGE_CHECK(other.empty() && Tracked_t::s_live == 9);
+    }
+    CGE_CHECK(Tracked_t::s_live == 0);
+    CGE_CHECK(resource.outstanding() == 0);
+
+    {
+        CountingResource_t               elements;
+        SmallVector<std::pmr::string, 2> strings(&elements);
+        for (U32_t i = 0; i != 3; ++i)
+        {
+            strings.emplace_back(longString);
+        }
+        // the 3 strings and the spilled block: moving the strings into it keeps their memory
+        CGE_CHECK(!strings.isInline() && elements.allocations == 4);
+        for (std::pmr::string const &string : strings)
+        {
+            CGE_CHECK(string.get_allocator().resource() == &elements && string == longString);
+        }
+        strings.clear();
+        CGE_CHECK(elements.outstanding() == 1);
+    }
+}
+
+static U32_t constexpr batchCount = 20'000;
+
+/** vectors filled on a producer thread and handed over through an SPSC queue, to be read and destroyed on the
+ *  consumer thread. The spilled blocks come from a synchronized pool, hence are freed on another thread than the
+ *  one which allocated them. Meant to also run with cge_ENABLE_SANITIZER_THREAD
+ */
+static void handoffTest()
+{
+    std::pmr::synchronized_pool_resource pool;
+    SpscQueue<FixedVector<U32_t, 8>>     fixedQueue(64);
+    SpscQueue<SmallVector<U32_t, 4>>     smallQueue(64);
+    U32_t                                mismatches = 0;
+
+    std::thread producer([&]() {
+        for (U32_t batch = 0; batch != batchCount; ++batch)
+        {
+            FixedVector<U32_t, 8>  fixed;
+            SmallVector<U32_t, 4> small(&pool);
+            for (U32_t i = 0; i != batch % 8 + 1; ++i)
+            {
+                fixed.push_back(batch + i);
+            }
+            for (U32_t i = 0; i != batch % 13; ++i)
+            {
+                small.push_back(batch * i);
+            }
+            while (!fixedQueue.tryPush(std::move(fixed)))
+            { //
+                std::this_thread::yield();
+            }
+            while (!smallQueue.tryPush(std::move(small)))
+            { //
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (U32_t batch = 0; batch != batchCount; ++batch)
+    {
+        FixedVector<U32_t, 8> fixed;
+        SmallVector<U32_t, 4> small(&pool);
+        while (!fixedQueue.tryPop(fixed))
+        { //
+            std::this_thread::yield();
+        }
+        while (!smallQueue.tryPop(small))
+        { //
+            std::this_thread::yield();
+        }
+        mismatches += fixed.size() != batch % 8 + 1 || small.size() != batch % 13;
+        for (U32_t i = 0; i != fixed.size(); ++i)
+        {
+            mismatches += fixed[i] != batch + i;
+        }
+        for (U32_t i = 0; i != small.size(); ++i)
+        {
+            mismatches += small[i] != batch * i;
+        }
+    }
+    producer.join();
+    CGE_CHECK(mismatches == 0);
+}
+
+I32_t main()
+{
+    fixedVectorTest();
+    smallVectorTest();
+    handoffTest();
+    return test::checkResult("VectorTest");
+}
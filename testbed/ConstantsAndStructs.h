@@ -14,6 +14,19 @@ inline Event_t constexpr evMagnetAcquired{ .m_id = "MAGNET POWERUP"_sid };
 inline Event_t constexpr evSpeedAcquired{ .m_id = "SPEED POWERUP"_sid };
 inline Event_t constexpr evDownAcquired{ .m_id = "DOWN POWERDOWN"_sid };
 
+/// meshes of the testbed, loaded a mesh per step while the menu is shown
+inline Char8_t const *const testbedObjFiles[]{
+    "../assets/ornithepter.obj",
+    "../assets/plane.obj",
+    "../assets/piece.obj",
+    "../assets/prop.obj",
+    "../assets/destructible.obj",
+    "../assets/magnet.obj",
+    "../assets/coin.obj",
+    "../assets/speed.obj",
+    "../assets/down.obj",
+};
+
 template <typename T>
 concept PowerDownListeneer = requires(T t) { t.onPowerDown(); };
 
@@ -3,6 +3,7 @@
 #include "Core/Event.h"
 #include "Core/Events.h"
 #include "Core/KeyboardKeys.h"
+#include "Core/Log.h"
 #include "Launch/Entry.h"
 #include "Render/Renderer2d.h"
 #include "Resource/HandleTable.h"
@@ -104,9 +105,9 @@ MenuModule::~MenuModule()
     if (m_init)
     {
         serializeScoresToFile();
-        for (auto const &pair : m_listeners.arr)
+        for (ListenerHandle_t const handle : m_listeners.arr)
         {
-            g_eventQueue.removeListener(pair);
+            g_eventQueue.removeListener(handle);
         }
 
         m_bop = nullptr;
@@ -177,6 +178,12 @@ void MenuModule::onInit()
         loadTexture(CGE_SID("EXTRAS"), "../assets/extras.png");
         loadTexture(CGE_SID("DUNE RUN"), "../assets/dune_run.png");
         loadTexture(CGE_SID("KEYBOARD"), "../assets/keyboard.png");
+
+        // the testbed meshes load while the menu is shown, instead of in a single frame when the game starts
+        for (Char8_t const *path : testbedObjFiles)
+        { //
+            g_handleTable.loadFromObjIncremental(path, EWorkPriority_t::eLow);
+        }
     }
 
     g_soundEngine()->play2D(m_musicSource, true);
@@ -220,6 +227,10 @@ static EDifficulty decrementDifficulty(EDifficulty currentDifficulty)
 }
 
 void MenuModule::onTick(U64_t deltaTime)
+{ // the menu has no simulation, it only draws
+}
+
+void MenuModule::onRender(F32_t alpha)
 {
     F32_t ratio = aspectRatio();
     switch (m_menuScreen)
@@ -249,7 +260,7 @@ void MenuModule::onTick(U64_t deltaTime)
     }
     case EMenuScreen::eExtras:
     {
-        std::pmr::string strBuf{ getMemoryPool() };
+        std::pmr::string strBuf{ getScratchBuffer() };
         glm::vec2 const  rectPos{ (ratio > 1.f ? 0.02f : 0.05f), (ratio > 1.f ? 0.05f : 0.02f) };
         g_renderer2D.renderTexture({ .position{ 0.f, 0.f },
                                      .size{ 1.f, 1.f },
@@ -326,7 +337,7 @@ void MenuModule::onMouseButton(I32_t key, I32_t action)
         return;
     }
 
-    printf("[MenuModule] position: \n\t%f\n\t%f\n", m_mousePosition.x, m_mousePosition.y);
+    CGE_LOG_TRACE(Game, "[MenuModule] position: \n\t%f\n\t%f", m_mousePosition.x, m_mousePosition.y);
     decltype(mainScreenButtons)::value_type const *beg = nullptr;
     decltype(mainScreenButtons)::value_type const *end = nullptr;
 
@@ -347,8 +358,9 @@ void MenuModule::onMouseButton(I32_t key, I32_t action)
     {
         assert(it);
         auto const &button = *it;
-        printf(
-          "[MenuModule] button: \n\t%f - %f\n\t%f - %f\n",
+        CGE_LOG_TRACE(
+          Game,
+          "[MenuModule] button: \n\t%f - %f\n\t%f - %f",
           button.position.x,
           button.position.x + button.size.x,
           button.position.y,
@@ -358,7 +370,7 @@ void MenuModule::onMouseButton(I32_t key, I32_t action)
           && m_mousePosition.x < button.position.x + button.size.x
           && m_mousePosition.y < button.position.y + button.size.y)
         {
-            printf("[MenuModule] pressed button \"%s\"\n", button.text);
+            CGE_LOG_DEBUG(Game, "[MenuModule] pressed button \"%s\"", button.text);
             m_bop = g_soundEngine()->play2D(m_bopSource);
             buttonPressed(
               CGE_SID(button.text), beg == std::addressof(*std::begin(extrasScreenButtons)) && index == 1, key);
@@ -27,6 +27,7 @@ class MenuModule : public IModule
   public:
     void onInit() override;
     void onTick(U64_t deltaTime) override;
+    void onRender(F32_t alpha) override;
     void onFramebufferSize(I32_t width, I32_t height);
     void onMouseMovement(F32_t x, F32_t y);
     void onMouseButton(I32_t key, I32_t action);
@@ -58,12 +59,12 @@ class MenuModule : public IModule
     {
         struct S
         {
-            EventDataSidPair framebufferSizeListener;
-            EventDataSidPair mouseMovementListener;
-            EventDataSidPair mouseButtonListener;
+            ListenerHandle_t framebufferSizeListener;
+            ListenerHandle_t mouseMovementListener;
+            ListenerHandle_t mouseButtonListener;
         };
         S                               s;
-        std::array<EventDataSidPair, 3> arr;
+        std::array<ListenerHandle_t, 3> arr;
         static_assert(std::is_standard_layout_v<S> && sizeof(S) == sizeof(decltype(arr)), "implementation failed");
     } m_listeners{};
 
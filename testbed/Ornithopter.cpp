@@ -1,6 +1,7 @@
 #include "Ornithopter.h"
 
 #include "Core/TimeUtils.h"
+#include "Core/Transform.h"
 #include "Resource/HandleTable.h"
 #include "Resource/Rendering/cgeScene.h"
 #include "SoundEngine.h"
@@ -65,38 +66,41 @@ void Ornithopter::onTick(U64_t deltaTime, OnTickTs const &transforms)
     // if the order in the struct of m_sids is changed, this needs to change too
     static F32_t constexpr rotationOrientations[]{ 1.f, -1.f, -1.f, 1.f };
     m_elapsedTime += deltaTime;
-    for (Sid_t const &sid : m_sids.arr)
-    {
-        g_scene.getNodeBySid(sid).setTransform(glm::mat4(1.f));
-    }
+
+    // every part is placed as parent * rotation of the part * local, the parent following the camera
+    Affine3x4_t const parent = Affine3x4_t::fromMat4(transforms.cameraTransform * transforms.playerTranslate);
+    Affine3x4_t const local  = Affine3x4_t::fromMat4(
+      transforms.playerTransform * glm::rotate(glm::mat4(1.f), glm::half_pi<F32_t>(), glm::vec3(1.f, 0.f, 0.f)));
+    Affine3x4_t locals[numParts];
 
     // Wings rotation
     U32_t index = 0;
-    for (auto const &sid : m_sids.arr)
+    for (U32_t part = 0; part != numParts; ++part)
     {
-        if (sid == m_sids.s.body)
+        if (m_sids.arr[part] == m_sids.s.body)
         {
+            locals[part] = local;
             continue;
         }
 
-        SceneNode_s &node    = g_scene.getNodeBySid(sid);
-        F32_t        radians = halfLimitAngle * glm::sin(rotationFrequency * m_elapsedTime / timeUnit64);
+        F32_t radians = halfLimitAngle * glm::sin(rotationFrequency * m_elapsedTime / timeUnit64);
         if (radians < 0.f)
         {
             radians *= negativeRotationSkew;
         }
         radians *= rotationOrientations[index];
-        node.rotate(radians, glm::vec3(0.f, -1.f, 0.f));
+        TRS_t const wing{ .rotation = glm::angleAxis(radians, glm::vec3(0.f, -1.f, 0.f)) };
+        locals[part] = compose(wing.toAffine(), local);
 
         ++index;
     }
 
     // TODO: shifting animation?
-    for (Sid_t const &sid : m_sids.arr)
-    {
-        g_scene.getNodeBySid(sid).rightMul(
-          transforms.playerTransform * glm::rotate(glm::mat4(1.f), glm::half_pi<F32_t>(), glm::vec3(1.f, 0.f, 0.f)));
-        g_scene.getNodeBySid(sid).transform(transforms.cameraTransform * transforms.playerTranslate);
+    Affine3x4_t worlds[numParts];
+    composeAffines(parent, locals, worlds);
+    for (U32_t part = 0; part != numParts; ++part)
+    { //
+        g_scene.getNodeBySid(m_sids.arr[part]).setTransform(worlds[part]);
     }
 }
 
@@ -43,6 +43,8 @@ class Ornithopter
     [[nodiscard]] AABB bodyBoundingBox() const;
 
   private:
+    static U32_t constexpr numParts = 5;
+
     // scene sids
     union U
     {
@@ -55,7 +57,7 @@ class Ornithopter
             Sid_t wingBottomL;
         };
         S     s;
-        Sid_t arr[5];
+        Sid_t arr[numParts];
         static_assert(std::is_trivial_v<S> && sizeof(s) == sizeof(arr));
     };
     U m_sids;
@@ -4,7 +4,9 @@
 #include "Core/Event.h"
 #include "Core/Events.h"
 #include "Core/KeyboardKeys.h"
+#include "Core/Log.h"
 #include "Core/StringUtils.h"
+#include "Core/Task.h"
 #include "Core/TimeUtils.h"
 #include "Core/Type.h"
 #include "Render/Renderer.h"
@@ -19,7 +21,9 @@
 #include <glm/geometric.hpp>
 
 #include <algorithm>
+#include <bit>
 #include <iterator>
+#include <span>
 
 namespace cge
 {
@@ -47,10 +51,11 @@ Player::~Player()
 {
     if (m_init)
     {
-        for (auto const &pair : m_listeners.arr)
+        for (ListenerHandle_t const handle : m_listeners.arr)
         { //
-            g_eventQueue.removeListener(pair);
+            g_eventQueue.removeListener(handle);
         }
+        g_taskScheduler.cancel(m_effectTask);
 
         if (m_invincibleMusic)
         {
@@ -127,26 +132,6 @@ void Player::onTick(U64_t deltaTimeI)
     }
 
     F32_t deltaTimeF = static_cast<F32_t>(deltaTimeI) / timeUnit64;
-    if (m_invincible)
-    {
-        m_invincibilityTimer += deltaTimeF;
-        printf("[Player] INVINCIBLE, Timer = %f\n", m_invincibilityTimer);
-        if (m_invincibilityTimer > invincibilityTime)
-        {
-            m_invincibilityTimer = -1.f;
-            stopInvincibleMusic();
-            resumeNormalMusic();
-            m_invincible = false;
-        }
-    }
-    if (m_invincibilityTimer >= 0.f)
-    {
-        m_invincibilityTimer += deltaTimeF;
-        if (m_invincibilityTimer > invincibilityTime)
-        {
-            m_invincibilityTimer = -1.f;
-        }
-    }
 
     if (m_intersected)
     {
@@ -220,9 +205,43 @@ void Player::stopInvincibleMusic()
     }
 }
 
+Task_s Player::effectTask(U64_t duration)
+{
+    co_await delay(duration);
+    onEffectExpired();
+}
+
+void Player::startEffect()
+{
+    U64_t constexpr duration = static_cast<U64_t>(invincibilityTime * timeUnit64);
+
+    // a new power up or malus restarts the effect
+    g_taskScheduler.cancel(m_effectTask);
+    m_effectDeadline = g_taskScheduler.currentTime() + duration;
+    m_effectActive   = true;
+    m_effectTask     = g_taskScheduler.spawn(effectTask(duration));
+}
+
+F32_t Player::remainingEffectTime() const
+{ //
+    return static_cast<F32_t>(m_effectDeadline - g_taskScheduler.currentTime()) / timeUnit64;
+}
+
+void Player::onEffectExpired()
+{
+    m_effectActive = false;
+    m_effectTask   = nullTaskHandle;
+    if (m_invincible)
+    {
+        stopInvincibleMusic();
+        resumeNormalMusic();
+        m_invincible = false;
+    }
+}
+
 void Player::onSpeedAcquired()
 { //
-    m_invincibilityTimer = 0.f;
+    startEffect();
     if (!m_invincible)
     {
         m_invincible      = true;
@@ -331,6 +350,10 @@ void ScrollingTerrain::init(InitData const &initData)
       glm::translate(glm::scale(glm::mat4(1.f), glm::vec3(1.f, 1.f, 2.f)), glm::vec3(0.f, 0.f, -5.f));
     static U32_t constexpr offset = 1;
 
+    // nondeterministic runs draw a seed, so that the tiles are seeded the same way in both cases
+    m_seed = initData.seed != 0 ? initData.seed : m_random.next<U64_t>();
+    m_random.seed(m_seed);
+
     // load all available meshes
     m_pieceSetSize        = glm::min(m_pieceSet.size(), initData.pieces.size());
     m_obstacleSetSize     = glm::min(m_obstacleSet.size(), initData.obstacles.size());
@@ -370,7 +393,11 @@ void ScrollingTerrain::updateTilesFromPosition(glm::vec3 position)
     {
         m_shouldCheckPowerUp = true;
         glm::vec3 displacement{ 0.f, pieceSize * numPieces, 0.f };
+
+        // what spawns on a tile depends only on the seed and on the index of the tile
+        m_random.seed(m_seed, m_tileIndex++);
         g_scene.getNodeBySid(m_pieces[m_first]).transform(glm::translate(glm::mat4(1.f), displacement));
+        g_scene.getNodeBySid(m_pieces[m_first]).resetInterpolation();
 
         // remove the obstacle (if any) from the moved piece
         if (m_obstacles[m_first] != nullSid)
@@ -400,12 +427,12 @@ void ScrollingTerrain::updateTilesFromPosition(glm::vec3 position)
         U32_t threshold1 = m_obstacleProbability + threshold0;
         U32_t threshold2 = m_malusProbability + threshold1;
 
-        U32_t const num = g_random.next<U32_t>(0, m_totalProbability);
+        U32_t const num = m_random.next<U32_t>(0, m_totalProbability);
         if (num > threshold0)
         {
             if (num < threshold1)
             {
-                addPropOfType(g_random.next<U32_t>(0, 1), pieceTransform);
+                addPropOfType(m_random.next<U32_t>(0, 1), pieceTransform);
             }
             else if (num < threshold2)
             {
@@ -500,7 +527,7 @@ B8_t ScrollingTerrain::handleShoot(AABB const &playerBox)
 
     if (foundDestroyable)
     {
-        printf("[ScrollingTerrain] destructing one piece\n");
+        CGE_LOG_DEBUG(Game, "[ScrollingTerrain] destructing one piece");
         auto it = std::find(m_destructables.begin(), m_destructables.end(), closestDestructible);
         if (it != m_destructables.end())
         {
@@ -527,7 +554,7 @@ ScrollingTerrain::PowerupList const &ScrollingTerrain::getPowerUps() const
     return m_powerUps;
 }
 
-std::pmr::unordered_map<U32_t, Sid_t> const &ScrollingTerrain::getCoinMap() const
+ScrollingTerrain::CoinMap const &ScrollingTerrain::getCoinMap() const
 { // getter
     return m_coinMap;
 }
@@ -605,14 +632,14 @@ void ScrollingTerrain::addPropOfType(U32_t type, glm::mat4 const &pieceTransform
     glm::mat4 const t{ propDisplacementTransformFromOldPiece(pieceTransform) };
     if (type == 0)
     { // choose an obstacle and spawn it
-        U32_t const obstacleIdx = g_random.next<U32_t>(0, m_obstacleSetSize - 1);
+        U32_t const obstacleIdx = m_random.next<U32_t>(0, m_obstacleSetSize - 1);
         Sid_t const sid         = m_obstacleSet[obstacleIdx];
         m_obstacles[m_first]    = g_scene.addNode(sid);
         g_scene.getNodeBySid(m_obstacles[m_first]).transform(t * glm::scale(glm::mat4{ 1.f }, glm::vec3(9.f)));
     }
     else if (type == 1)
     { // choose a destructable and spawn it
-        U32_t const destructableIdx = g_random.next<U32_t>(0, m_destructableSetSize - 1);
+        U32_t const destructableIdx = m_random.next<U32_t>(0, m_destructableSetSize - 1);
         Sid_t const sid             = m_destructableSet[destructableIdx];
         m_destructables[m_first]    = g_scene.addNode(sid);
         g_scene.getNodeBySid(m_destructables[m_first]).transform(t);
@@ -633,11 +660,11 @@ void ScrollingTerrain::addCoins(F32_t pieceYCoord)
     F32_t const   coinDepth = coinMesh.box.mm.max.y - coinMesh.box.mm.min.y;
     F32_t const   increment = coinDepth + betweenDistance;
 
-    while (g_random.next<U32_t>(0, maxNumCoinsPerTile - numSpawnedCoins) < threshold)
+    while (m_random.next<U32_t>(0, maxNumCoinsPerTile - numSpawnedCoins) < threshold)
     {
         Sid_t coinSceneSid = g_scene.addNode(m_coin);
-        F32_t xCoord       = g_random.next<F32_t>() * coinShift;
-        F32_t zCoord       = (g_random.next<F32_t>() - 0.5f) * heightShift + coinHeight;
+        F32_t xCoord       = m_random.next<F32_t>() * coinShift;
+        F32_t zCoord       = (m_random.next<F32_t>() - 0.5f) * heightShift + coinHeight;
 
         g_scene.getNodeBySid(coinSceneSid)
           .transform(glm::translate(glm::mat4(1.f), glm::vec3(xCoord, lastPos, zCoord)));
@@ -650,7 +677,7 @@ void ScrollingTerrain::addCoins(F32_t pieceYCoord)
 
 void ScrollingTerrain::removeCoins(F32_t threshold)
 {
-    std::erase_if(
+    erase_if(
       m_coinMap,
       [threshold](
         const auto &positionSidPair) { // if the coin is in the y range of the piece begin removed, then remove it
@@ -667,7 +694,7 @@ void ScrollingTerrain::removeCoins(F32_t threshold)
 void ScrollingTerrain::addPowerUp(glm::mat4 const &pieceTransform)
 {
     glm::mat4 const t{ propDisplacementTransformFromOldPiece(pieceTransform) };
-    switch (U32_t const powerUpType = g_random.next<U32_t>(0, numPowerUpTypes - 1))
+    switch (U32_t const powerUpType = m_random.next<U32_t>(0, numPowerUpTypes - 1))
     {
     case 0: // explosive magnet
         m_powerUps[m_first] = g_scene.addNode(m_magnetPowerUp);
@@ -694,9 +721,8 @@ glm::mat4 ScrollingTerrain::propDisplacementTransformFromOldPiece(glm::mat4 cons
 
 F32_t ScrollingTerrain::randomLaneOffset() const
 {
-    std::array<F32_t, 3> arr = { -laneShift, 0, laneShift };
-    std::ranges::shuffle(arr, g_random.getGen());
-    return arr[0];
+    std::array<F32_t, 3> const arr = { -laneShift, 0, laneShift };
+    return arr[m_random.next<U32_t>(0, 2)];
 }
 void ScrollingTerrain::onTick(U64_t deltaTime)
 {
@@ -839,6 +865,40 @@ void ScrollingTerrain::adjustProbabilities(U64_t deltaTime)
     }
 }
 
+static U32_t constexpr noPropHit = ~0U;
+
+/// index of the first prop whose world space box the ray enters within `maxDistance` and moving forward, or
+/// `noPropHit`. Boxes are tested in batches with the SIMD kernel
+static U32_t firstPropHit(Ray const &ray, std::span<Sid_t const> props, F32_t maxDistance)
+{
+    for (U32_t first = 0; first < props.size(); first += aabbBatchWidth)
+    {
+        AABBBatch_t batch;
+        U32_t const count = glm::min(aabbBatchWidth, static_cast<U32_t>(props.size()) - first);
+        for (U32_t lane = 0; lane != count; ++lane)
+        {
+            Sid_t const          sceneSid = props[first + lane];
+            HandleTable_s::Ref_s ref{ nullRef };
+            if (sceneSid != nullSid && (ref = g_handleTable.get(g_scene.getNodeBySid(sceneSid).getSid())).hasValue())
+            { //
+                batch.set(lane, globalSpaceBB(g_scene.getNodeBySid(sceneSid), ref.asMesh().box));
+            }
+        }
+
+        BatchHit_t const hits = intersect(ray, batch);
+        for (U32_t mask = hits.mask; mask != 0; mask &= mask - 1)
+        {
+            U32_t const lane = std::countr_zero(mask);
+            F32_t const t    = hits.t[lane];
+            if (t <= maxDistance && ray.orig.y + t * ray.dir.y > ray.orig.y)
+            {
+                return first + lane;
+            }
+        }
+    }
+    return noPropHit;
+}
+
 bool Player::intersectPlayerWith(ScrollingTerrain &terrain)
 {
     if (!m_ornithopterAlive)
@@ -853,80 +913,34 @@ bool Player::intersectPlayerWith(ScrollingTerrain &terrain)
     m_intersected = false;
     if (!m_invincible)
     {
-        for (Sid_t const &pObs : terrain.getObstacles())
+        if (firstPropHit(playerRay, terrain.getObstacles(), movementDistance) != noPropHit)
         {
-            HandleTable_s::Ref_s ref{ nullRef };
-            Sid_t                meshSid{ nullSid };
-            if (pObs != nullSid && (ref = g_handleTable.get(meshSid = g_scene.getNodeBySid(pObs).getSid())).hasValue())
-            {
-                auto const &mesh   = ref.asMesh();
-                auto const &box    = mesh.box;
-                auto const  obsBox = globalSpaceBB(g_scene.getNodeBySid(pObs), box);
-                Hit_t const res    = intersect(playerRay, obsBox);
-                if (res.isect && (res.t <= movementDistance && res.p.y > m_oldPosition.y))
-                {
-                    m_intersected = true;
-                    printf("\033[31m[PLAYER] INTERSECTIONSIONSIDOFNSDIOFJ\033[0m\n");
-                    return m_intersected;
-                }
-            }
+            m_intersected = true;
+            CGE_LOG_DEBUG(Game, "[Player] hit an obstacle");
+            return m_intersected;
         }
 
-        for (Sid_t const &pObs : terrain.getDestructables())
+        if (firstPropHit(playerRay, terrain.getDestructables(), movementDistance) != noPropHit)
         {
-            HandleTable_s::Ref_s ref{ nullRef };
-            Sid_t                meshSid{ nullSid };
-            if (pObs != nullSid && (ref = g_handleTable.get(meshSid = g_scene.getNodeBySid(pObs).getSid())).hasValue())
-            {
-                auto const &mesh   = ref.asMesh();
-                auto const &box    = mesh.box;
-                auto const  obsBox = globalSpaceBB(g_scene.getNodeBySid(pObs), box);
-                Hit_t const res    = intersect(playerRay, obsBox);
-                if (res.isect && (res.t <= movementDistance && res.p.y > m_oldPosition.y))
-                {
-                    m_intersected = true;
-                    return m_intersected;
-                }
-            }
+            m_intersected = true;
+            return m_intersected;
         }
     }
 
     if (terrain.shouldCheckForPowerUps())
     {
-        U32_t index = 0;
-        for (Sid_t const &sceneSid : terrain.getPowerUps())
+        if (U32_t const index = firstPropHit(playerRay, terrain.getPowerUps(), movementDistance); index != noPropHit)
         {
-            if (sceneSid != nullSid)
-            {
-                Mesh_s const &mesh = g_handleTable.getMesh(g_scene.getNodeBySid(sceneSid).getSid());
-                AABB const   &box  = globalSpaceBB(g_scene.getNodeBySid(sceneSid), mesh.box);
-                Hit_t const   res  = intersect(playerRay, box);
-                if (res.isect && (res.t <= movementDistance && res.p.y > m_oldPosition.y))
-                {
-                    terrain.powerUpAcquired(index);
-                    printf("[Player] POWER UP UP UP\n");
-                    return false;
-                }
-            }
-            ++index;
+            terrain.powerUpAcquired(index);
+            CGE_LOG_DEBUG(Game, "[Player] POWER UP UP UP");
+            return false;
         }
 
-        index = 0;
-        for (Sid_t const &sceneSid : terrain.getPowerDowns())
+        if (U32_t const index = firstPropHit(playerRay, terrain.getPowerDowns(), movementDistance); index != noPropHit)
         {
-            if (sceneSid != nullSid)
-            {
-                Mesh_s const &mesh = g_handleTable.getMesh(g_scene.getNodeBySid(sceneSid).getSid());
-                AABB const   &box  = globalSpaceBB(g_scene.getNodeBySid(sceneSid), mesh.box);
-                Hit_t const   res  = intersect(playerRay, box);
-                if (res.isect && (res.t <= movementDistance && res.p.y > m_oldPosition.y))
-                {
-                    terrain.powerDownAcquired(index);
-                    printf("[Player] POWER DOWN DOWN DOWN\n");
-                    return false;
-                }
-            }
-            ++index;
+            terrain.powerDownAcquired(index);
+            CGE_LOG_DEBUG(Game, "[Player] POWER DOWN DOWN DOWN");
+            return false;
         }
     }
 
@@ -945,8 +959,7 @@ U64_t Player::getCurrentScore() const
 
 F32_t Player::getVelocity() const
 {
-    B8_t cond = m_invincibilityTimer > 0 && m_invincibilityTimer < invincibilityTime;
-    return (cond ? speedBoost : 1.f) * glm::min(baseVelocity + m_velocityIncrement, maxBaseVelocity);
+    return (m_effectActive ? speedBoost : 1.f) * glm::min(baseVelocity + m_velocityIncrement, maxBaseVelocity);
 }
 
 F32_t Player::remainingInvincibleTime() const
@@ -956,7 +969,7 @@ F32_t Player::remainingInvincibleTime() const
         return -1.f;
     }
 
-    return invincibilityTime - m_invincibilityTimer;
+    return remainingEffectTime();
 }
 void Player::kill()
 {
@@ -973,14 +986,14 @@ F32_t Player::getMaxVelocity() const
 }
 
 void Player::onPowerDown()
-{
-    m_invincibilityTimer = 0.f;
+{ //
+    startEffect();
 }
 F32_t Player::remainingMalusTime() const
 {
-    if (!m_invincible && m_invincibilityTimer > 0.f)
+    if (!m_invincible && m_effectActive)
     {
-        return invincibilityTime - m_invincibilityTimer;
+        return remainingEffectTime();
     }
     return -1.f;
 }
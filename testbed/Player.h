@@ -1,9 +1,11 @@
 #pragma once
 
 #include "ConstantsAndStructs.h"
+#include "Core/Containers.h"
 #include "Core/Event.h"
 #include "Core/Random.h"
 #include "Core/StringUtils.h"
+#include "Core/Task.h"
 #include "Core/TimeUtils.h"
 #include "Core/Type.h"
 #include "Ornithopter.h"
@@ -17,7 +19,6 @@
 #include <glm/ext/vector_uint2.hpp>
 #include <span>
 #include <type_traits>
-#include <unordered_map>
 #include <utility>
 
 namespace cge
@@ -56,7 +57,7 @@ class ScrollingTerrain
     using PieceList     = std::array<Sid_t, numPieces>;
     using PowerupList   = std::array<Sid_t, numPieces>;
     using PowerdownList = std::array<Sid_t, numPieces>;
-    using CoinMap       = std::pmr::unordered_map<U32_t, Sid_t>;
+    using CoinMap       = FlatMap<U32_t, Sid_t>;
     struct InitData
     {
         std::span<Sid_t> pieces;
@@ -66,6 +67,7 @@ class ScrollingTerrain
         Sid_t            coin;
         Sid_t            speed;
         Sid_t            down;
+        U32_t            seed = 0; ///< of the random generator of the terrain, 0 = nondeterministic
     };
 
   public:
@@ -105,9 +107,9 @@ class ScrollingTerrain
     F32_t     randomLaneOffset() const;
 
     template<std::integral auto N>
-    static constexpr Sid_t selectRandomFromList(std::array<Sid_t, N> list, U32_t effectiveSize)
+    Sid_t selectRandomFromList(std::array<Sid_t, N> list, U32_t effectiveSize) const
     {
-        auto  rnd = g_random.next<U32_t>(0, effectiveSize - 1);
+        auto  rnd = m_random.next<U32_t>(0, effectiveSize - 1);
         Sid_t ret{ nullSid };
         while (ret == nullSid && rnd >= 0)
         { //
@@ -159,6 +161,11 @@ class ScrollingTerrain
     U32_t m_destructableSetSize{ 0 };
 
     B8_t m_shouldCheckPowerUp{ true };
+
+    // own generator rather than the thread local one, as the terrain systems may run on any worker
+    mutable Random m_random;
+    U64_t          m_seed{ 0 };
+    U64_t          m_tileIndex{ 0 }; ///< tiles recycled so far, key of the generator of each tile
 };
 
 class Player
@@ -178,6 +185,7 @@ class Player
     void onTick(U64_t deltaTime);
     void onSpeedAcquired();
     void onPowerDown();
+    void onEffectExpired();
 
     [[nodiscard]] AABB      boundingBox() const;
     [[nodiscard]] glm::mat4 viewTransform() const;
@@ -206,6 +214,9 @@ class Player
     glm::vec3 displacementTick(F32_t deltaTime);
     void      stopInvincibleMusic();
     void      resumeNormalMusic();
+    Task_s    effectTask(U64_t duration);
+    void      startEffect();
+    F32_t     remainingEffectTime() const;
 
   private:
     // main components
@@ -243,19 +254,23 @@ class Player
         }
         struct S
         {
-            EventDataSidPair keyListener;
-            EventDataSidPair speedAcquiredListener;
-            EventDataSidPair downAcquiredListener;
+            ListenerHandle_t keyListener;
+            ListenerHandle_t speedAcquiredListener;
+            ListenerHandle_t downAcquiredListener;
         };
         S                               s;
-        std::array<EventDataSidPair, 3> arr;
+        std::array<ListenerHandle_t, 3> arr;
         static_assert(std::is_standard_layout_v<S> && sizeof(S) == sizeof(decltype(arr)), "implementation failed");
     };
     U     m_listeners{};
-    F32_t m_invincibilityTimer{ -1.f };
     B8_t  m_invincible{ false };
     B8_t  m_ornithopterAlive = false;
 
+    // speed power up and malus share the same task, which sleeps until the effect expires
+    TaskHandle_t m_effectTask{ nullTaskHandle };
+    U64_t        m_effectDeadline{ 0 };
+    B8_t         m_effectActive{ false };
+
     // sound data
     irrklang::ISoundSource *m_bgmSource{ nullptr };
     irrklang::ISound       *m_bgm{ nullptr };
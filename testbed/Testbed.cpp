@@ -1,8 +1,10 @@
 #include "Testbed.h"
 
 #include "Core/Event.h"
+#include "Core/EventReplay.h"
 #include "Core/Events.h"
 #include "Core/KeyboardKeys.h"
+#include "Core/Log.h"
 #include "Core/StringUtils.h"
 #include "Core/Type.h"
 #include "Core/Utility.h"
@@ -62,17 +64,20 @@ inline ButtonSpec const mainMenuButton{
 
 // -- the rest of the code --
 
-TestbedModule::TestbedModule(Sid_t id) : IModule(id), m_fov(startFOV), m_targetFov(startFOV)
+TestbedModule::TestbedModule(Sid_t id) : IModule(id), m_fov(startFOV), m_targetFov(startFOV), m_previousFov(startFOV)
 {
+#if defined(CGE_DEBUG)
+    m_frameScheduler.setPrintInterval(600);
+#endif
 }
 
 TestbedModule::~TestbedModule()
 {
     if (m_init)
     {
-        for (auto const &pair : m_listeners.arr)
+        for (ListenerHandle_t const handle : m_listeners.arr)
         {
-            g_eventQueue.removeListener(pair);
+            g_eventQueue.removeListener(handle);
         }
 
         g_soundEngine()->removeSoundSource(m_magnetPickedSource);
@@ -112,16 +117,11 @@ void TestbedModule::onInit()
     printf("Opening Scene file\n");
 
     if (!initializedOnce())
-    {
-        g_handleTable.loadFromObj("../assets/ornithepter.obj");
-        g_handleTable.loadFromObj("../assets/plane.obj");
-        g_handleTable.loadFromObj("../assets/piece.obj");
-        g_handleTable.loadFromObj("../assets/prop.obj");
-        g_handleTable.loadFromObj("../assets/destructible.obj");
-        g_handleTable.loadFromObj("../assets/magnet.obj");
-        g_handleTable.loadFromObj("../assets/coin.obj");
-        g_handleTable.loadFromObj("../assets/speed.obj");
-        g_handleTable.loadFromObj("../assets/down.obj");
+    { // the menu has queued them, whatever is left is loaded now
+        for (Char8_t const *path : testbedObjFiles)
+        { //
+            g_handleTable.loadFromObj(path);
+        }
     }
 
     // add light to the scene
@@ -149,13 +149,16 @@ void TestbedModule::onInit()
     Sid_t                   coin{ CGE_SID("Coin") };
     Sid_t                   speed{ CGE_SID("Speed") };
     Sid_t                   down{ CGE_SID("Down") };
+    // recorded and replayed sessions must spawn the same terrain
+    U32_t const terrainSeed = g_eventReplay.mode() != EReplayMode_t::eNone ? g_eventReplay.seed() : 0;
     m_scrollingTerrain.init({ .pieces        = pieces,
                               .obstacles     = obstacles,
                               .destructables = destructables,
                               .magnetPowerUp = magnet,
                               .coin          = coin,
                               .speed         = speed,
-                              .down          = down });
+                              .down          = down,
+                              .seed          = terrainSeed });
 
     // try reading difficulty to initialize acceleration
     EDifficulty difficulty;
@@ -177,6 +180,7 @@ void TestbedModule::onInit()
     camera.up       = glm::vec3(0.f, 0.f, 1.f);
     camera.forward  = glm::vec3(0.f, 1.f, 0.f);
     m_player.spawn(camera, difficulty);
+    m_previousCamera = m_player.getCamera();
 
     // background, terrain, terrain collisions
     stbi_set_flip_vertically_on_load(true);
@@ -218,7 +222,7 @@ void TestbedModule::onMouseButton(I32_t key, I32_t action)
         ndcMousePos *= 2;
         if (action == action::PRESS && key == button::LMB)
         {
-            printf("[Testbed] pressed at NDC { %f %f }\n", ndcMousePos.x, ndcMousePos.y);
+            CGE_LOG_DEBUG(Game, "[Testbed] pressed at NDC { %f %f }", ndcMousePos.x, ndcMousePos.y);
             isAnyCoinClicked(ndcMousePos);
         }
     }
@@ -261,7 +265,7 @@ void TestbedModule::onGameOver(U64_t score)
 
 void TestbedModule::onShoot(Ray const &ray)
 {
-    printf("[TestbedModule] BANG\n");
+    CGE_LOG_DEBUG(Game, "[TestbedModule] BANG");
     B8_t intersected = m_scrollingTerrain.handleShoot(m_player.boundingBox());
     if (intersected)
     {
@@ -275,7 +279,16 @@ void TestbedModule::onMagnetAcquired()
     U32_t numCoins = m_scrollingTerrain.removeAllCoins();
     m_player.incrementScore(coinBonusScore, numCoins);
     m_numCoins += numCoins;
-    printf("[Testbed] MAGNET POWERUP ACQUIRED\n");
+    CGE_LOG_DEBUG(Game, "[Testbed] MAGNET POWERUP ACQUIRED");
+}
+
+// formats like std::to_string would, without the temporary std::string
+template<typename T>
+static void appendNumber(std::pmr::string &str, Char8_t const *format, T value)
+{
+    Char8_t     buf[64];
+    I32_t const length = snprintf(buf, sizeof(buf), format, value);
+    str.append(buf, length);
 }
 
 static glm::vec2 proportions(U32_t length, F32_t base = 0.01f)
@@ -285,94 +298,151 @@ static glm::vec2 proportions(U32_t length, F32_t base = 0.01f)
 
 void TestbedModule::onTick(U64_t deltaTime)
 {
+    // data accessed by the systems of the frame graph
+    static Sid_t const terrainSid      = CGE_SID("Terrain");
+    static Sid_t const playerSid       = CGE_SID("Player");
+    static Sid_t const playerCameraSid = CGE_SID("PlayerCamera");
+    static Sid_t const sceneNodesSid   = CGE_SID("SceneNodes"); // insertion and removal of scene nodes
+    static Sid_t const playerNodesSid  = CGE_SID("PlayerNodes");
+    static Sid_t const propNodesSid    = CGE_SID("PropNodes");
+    static Sid_t const audioSid        = CGE_SID("Audio");
+
+    // state blended with the current one when rendering
+    m_previousCamera = m_player.getCamera();
+    m_previousFov    = m_fov;
     m_elapsedTime += deltaTime;
 
     // Game Tick
     F32_t const deltaTimeF = deltaTime / timeUnit64;
     auto const  p          = m_player.lastDisplacement();
-    auto const  camera     = m_player.getCamera();
-    auto const  proj       = glm::perspective(glm::radians(m_fov), aspectRatio(), CLIPDISTANCE, RENDERDISTANCE);
 
+    m_frameScheduler.beginFrame();
     if (m_gameState == EGameState::eDefault)
     {
         auto const center = m_player.getCentroid();
-        m_scrollingTerrain.updateTilesFromPosition(center);
-        m_player.onTick(deltaTime);
-        m_scrollingTerrain.onTick(deltaTime);
-        m_player.intersectPlayerWith(m_scrollingTerrain);
+        m_frameScheduler.addSystem(
+          CGE_SID("TerrainTiles"),
+          {},
+          { terrainSid, sceneNodesSid, propNodesSid },
+          [this, center]() { m_scrollingTerrain.updateTilesFromPosition(center); });
+        m_frameScheduler.addSystem(
+          CGE_SID("PlayerTick"),
+          { sceneNodesSid },
+          { playerSid, playerCameraSid, playerNodesSid, audioSid },
+          [this, deltaTime]() { m_player.onTick(deltaTime); });
+        m_frameScheduler.addSystem(
+          CGE_SID("TerrainTick"),
+          { sceneNodesSid },
+          { terrainSid, propNodesSid },
+          [this, deltaTime]() { m_scrollingTerrain.onTick(deltaTime); });
+        m_frameScheduler.addSystem(
+          CGE_SID("Intersect"),
+          { playerNodesSid },
+          { playerSid, terrainSid, sceneNodesSid, propNodesSid, audioSid },
+          [this]() { m_player.intersectPlayerWith(m_scrollingTerrain); });
+        m_frameScheduler.addSystem(
+          CGE_SID("Camera"),
+          { playerSid },
+          { playerCameraSid },
+          [this, deltaTime, deltaTimeF]()
+          {
+              F32_t startVelocity = m_player.getStartVelocity();
+              F32_t interpolation =
+                (m_player.getVelocity() - startVelocity) / (m_player.getMaxVelocity() - startVelocity);
+              m_targetFov = glm::mix(startFOV, maxFOV, interpolation);
+              m_fov       = glm::mix(m_fov, m_targetFov, 1.f - glm::pow(baseFovDelay, deltaTimeF));
+
+              shakeCamera(deltaTime);
+          });
+    }
+
+    m_frameScheduler.run();
+}
+
+void TestbedModule::onRender(F32_t alpha)
+{
+    // the camera and the scene nodes are drawn between the last two simulation steps
+    Camera_t const current = m_player.getCamera();
+    Camera_t       camera  = current;
+    camera.position        = glm::mix(m_previousCamera.position, current.position, alpha);
+    camera.forward         = glm::normalize(glm::mix(m_previousCamera.forward, current.forward, alpha));
+    camera.up              = glm::normalize(glm::mix(m_previousCamera.up, current.up, alpha));
+    camera.right           = glm::normalize(glm::mix(m_previousCamera.right, current.right, alpha));
+    F32_t const fov        = glm::mix(m_previousFov, m_fov, alpha);
+    auto const  proj       = glm::perspective(glm::radians(fov), aspectRatio(), CLIPDISTANCE, RENDERDISTANCE);
+
+    // HUD strings are rebuilt every frame, hence allocated from the frame allocator
+    struct HudStrings_t
+    {
+        std::pmr::string velocity{ getScratchBuffer() };
+        std::pmr::string coins{ getScratchBuffer() };
+        std::pmr::string score{ getScratchBuffer() };
+        std::pmr::string invincibility{ getScratchBuffer() };
+        std::pmr::string malus{ getScratchBuffer() };
+    } hud;
+
+    hud.velocity.append("Velocity: ");
+    appendNumber(hud.velocity, "%f", m_player.getVelocity());
+    hud.velocity.resize(hud.velocity.size() - 4);
 
-        F32_t startVelocity = m_player.getStartVelocity();
-        F32_t interpolation = (m_player.getVelocity() - startVelocity) / (m_player.getMaxVelocity() - startVelocity);
-        m_targetFov         = glm::mix(startFOV, maxFOV, interpolation);
-        m_fov               = glm::mix(m_fov, m_targetFov, 1.f - glm::pow(baseFovDelay, deltaTimeF));
+    hud.coins.append("Coins: ");
+    appendNumber(hud.coins, "%u", m_numCoins);
 
-        shakeCamera(deltaTime);
+    hud.score.append("Score: ");
+    appendNumber(hud.score, "%zu", m_player.getCurrentScore());
+
+    if (F32_t time = m_player.remainingInvincibleTime(); time > 0.f && m_gameState == EGameState::eDefault)
+    {
+        hud.invincibility.append("Remaining Invincibility Time: ");
+        appendNumber(hud.invincibility, "%f", time);
     }
 
-    // Rendering
-    getBackgroundRenderer().renderBackground(m_player.getCamera(), proj);
-    g_renderer.renderScene(g_scene, camera.viewTransform(), proj, camera.forward);
+    if (F32_t time = m_player.remainingMalusTime(); time > 0.f && m_gameState == EGameState::eDefault)
+    {
+        hud.malus.append("Remaining Malus Time: ");
+        appendNumber(hud.malus, "%f", time);
+    }
 
-    glClear(GL_DEPTH_BUFFER_BIT);
+    getBackgroundRenderer().renderBackground(camera, proj);
+    g_renderer.renderScene(g_scene, camera.viewTransform(), proj, camera.forward, alpha);
 
-    std::pmr::string str{ getMemoryPool() };
+    glClear(GL_DEPTH_BUFFER_BIT);
 
-    str.clear();
-    str.append("Velocity: ");
-    str.append(std::to_string(m_player.getVelocity()));
-    str.resize(str.size() - 4);
     g_renderer2D.renderButton({ .position{ 0.0f, 0.04f },
                                 .size{ 0.35f, 0.07f },
                                 .borderColor{ 0.5f, 0.5f, 0.5f },
                                 .borderWidth = 0.01f,
                                 .backgroundColor{ 0.5f, 0.5f, 0.5f },
-                                .text = str.c_str(),
+                                .text = hud.velocity.c_str(),
                                 .textColor{ 0.9f, 0.9f, 0.9f } });
 
-    str.clear();
-    str.append("Coins: ");
-    str.append(std::to_string(m_numCoins));
     g_renderer2D.renderButton({ .position{ 0.8f, 0.8f },
                                 .size{ 0.2f, 0.07f },
                                 .borderColor{ 0.5f, 0.5f, 0.5f },
                                 .borderWidth = 0.01f,
                                 .backgroundColor{ 0.5f, 0.5f, 0.5f },
-                                .text = str.c_str(),
+                                .text = hud.coins.c_str(),
                                 .textColor{ 0.9f, 0.9f, 0.9f } });
 
-    str.clear();
-    str.append("Score: ");
-    str.append(std::to_string(m_player.getCurrentScore()));
     g_renderer2D.renderButton({ .position{ 0.8f, 0.8f + 0.07f },
                                 .size{ 0.2f, 0.07f },
                                 .borderColor{ 0.5f, 0.5f, 0.5f },
                                 .borderWidth = 0.01f,
                                 .backgroundColor{ 0.5f, 0.5f, 0.5f },
-                                .text = str.c_str(),
+                                .text = hud.score.c_str(),
                                 .textColor{ 0.9f, 0.9f, 0.9f } });
 
-    if (F32_t time = m_player.remainingInvincibleTime(); time > 0.f && m_gameState == EGameState::eDefault)
+    for (std::pmr::string const *str : { &hud.invincibility, &hud.malus })
     {
-        str.clear();
-        str.append("Remaining Invincibility Time: ");
-        str.append(std::to_string(time));
-        F32_t xSize = g_renderer2D.letterSize().x * str.size();
-        F32_t ySize = g_renderer2D.letterSize().y;
-        F32_t s     = glm::min(0.8f * m_framebufferSize.x / xSize, 0.1f * m_framebufferSize.y / ySize);
-        g_renderer2D.renderText(
-          str.c_str(), { 0.05f * m_framebufferSize.x, 0.9f * m_framebufferSize.y, s }, glm::vec3{ 0.3f });
-    }
-
-    if (F32_t time = m_player.remainingMalusTime(); time > 0.f && m_gameState == EGameState::eDefault)
-    {
-        str.clear();
-        str.append("Remaining Malus Time: ");
-        str.append(std::to_string(time));
-        F32_t xSize = g_renderer2D.letterSize().x * str.size();
+        if (str->empty())
+        {
+            continue;
+        }
+        F32_t xSize = g_renderer2D.letterSize().x * str->size();
         F32_t ySize = g_renderer2D.letterSize().y;
         F32_t s     = glm::min(0.8f * m_framebufferSize.x / xSize, 0.1f * m_framebufferSize.y / ySize);
         g_renderer2D.renderText(
-          str.c_str(), { 0.05f * m_framebufferSize.x, 0.9f * m_framebufferSize.y, s }, glm::vec3{ 0.3f });
+          str->c_str(), { 0.05f * m_framebufferSize.x, 0.9f * m_framebufferSize.y, s }, glm::vec3{ 0.3f });
     }
 
     if (m_gameState == EGameState::eDead)
@@ -404,12 +474,26 @@ B8_t TestbedModule::isAnyCoinClicked(glm::vec2 const &clickPos)
     glm::mat4 const  projectionMatrix{ glm::perspective(
       glm::radians(m_fov), aspectRatio(), CLIPDISTANCE, RENDERDISTANCE) };
 
-    for (auto it = m_scrollingTerrain.getCoinMap().begin(); it != m_scrollingTerrain.getCoinMap().end();)
+    // gathered first, so that the boxes are transformed in a single batch
+    ScrollingTerrain::CoinMap const &coins = m_scrollingTerrain.getCoinMap();
+    std::pmr::vector<AABB>           boxes{ getScratchBuffer() };
+    std::pmr::vector<glm::mat4>      models{ getScratchBuffer() };
+    boxes.reserve(coins.size());
+    models.reserve(coins.size());
+    for (auto const &[key, sid] : coins)
     {
-        AABB box = g_handleTable.getMesh(g_scene.getNodeBySid(it->second).getSid()).box;
-        AABB ndcBox =
-          transformAABBToNDC(box, g_scene.getNodeBySid(it->second).getTransform(), viewMatrix, projectionMatrix);
+        SceneNode_s const &node = g_scene.getNodeBySid(sid);
+        boxes.push_back(g_handleTable.getMesh(node.getSid()).box);
+        models.push_back(node.getTransform());
+    }
 
+    std::pmr::vector<AABB> ndcBoxes{ boxes.size(), getScratchBuffer() };
+    transformAABBsToNDC(boxes, models, projectionMatrix * viewMatrix, ndcBoxes);
+
+    U64_t index = 0;
+    for (auto it = coins.begin(); it != coins.end(); ++it, ++index)
+    {
+        AABB const &ndcBox = ndcBoxes[index];
         if (isBetween(
               clickPos,
               glm::vec2{ ndcBox.mm.min.x, ndcBox.mm.min.y },
@@ -417,13 +501,12 @@ B8_t TestbedModule::isAnyCoinClicked(glm::vec2 const &clickPos)
               { 0.1f, 0.1f }))
         {
             g_soundEngine()->play2D(m_coinPickedSource);
-            printf("[Testbed] coin clicked\n");
+            CGE_LOG_DEBUG(Game, "[Testbed] coin clicked");
             m_scrollingTerrain.removeCoin(it);
             ++m_numCoins;
             m_player.incrementScore(coinBonusScore);
             return true;
         }
-        ++it;
     }
 
     return false;
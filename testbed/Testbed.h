@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Core/Event.h"
+#include "Core/FrameScheduler.h"
 #include "Core/Module.h"
 #include "Core/StringUtils.h"
 #include "Core/Type.h"
@@ -26,6 +27,7 @@ class TestbedModule : public IModule
   public:
     void onInit() override;
     void onTick(U64_t deltaTime) override;
+    void onRender(F32_t alpha) override;
     void onKey(I32_t key, I32_t action);
     void onMouseButton(I32_t key, I32_t action);
     void onMouseMovement(F32_t xPos, F32_t yPos);
@@ -56,25 +58,32 @@ class TestbedModule : public IModule
     U32_t      m_numCoins = 0;
     U64_t      m_elapsedTime = 0;
 
+    // simulation state before the last step, for interpolation
+    Camera_t m_previousCamera{};
+    F32_t    m_previousFov;
+
     // terrain data
     ScrollingTerrain m_scrollingTerrain;
 
+    // systems of the game tick, rebuilt every frame
+    FrameScheduler_s m_frameScheduler;
+
     // event data
     union
     {
         struct S
         {
-            EventDataSidPair keyListener;
-            EventDataSidPair mouseMovementListener;
-            EventDataSidPair mouseButtonListener;
-            EventDataSidPair framebufferSizeListener;
-
-            EventDataSidPair gameOverListener;
-            EventDataSidPair shootListener;
-            EventDataSidPair magnetAcquiredListener;
+            ListenerHandle_t keyListener;
+            ListenerHandle_t mouseMovementListener;
+            ListenerHandle_t mouseButtonListener;
+            ListenerHandle_t framebufferSizeListener;
+
+            ListenerHandle_t gameOverListener;
+            ListenerHandle_t shootListener;
+            ListenerHandle_t magnetAcquiredListener;
         };
         S                               s;
-        std::array<EventDataSidPair, 7> arr;
+        std::array<ListenerHandle_t, 7> arr;
         static_assert(std::is_standard_layout_v<S> && sizeof(S) == sizeof(decltype(arr)), "implementation failed");
     } m_listeners{};
     B8_t m_init{ false };